@@ -47,6 +47,11 @@ DEFINE_int32(erase_percent, 10,
              "Ratio of erase to total workload (expressed as a percentage)");
 
 DEFINE_bool(use_clock_cache, false, "");
+DEFINE_bool(use_lock_free_clock_cache, false,
+            "Use LockFreeClockCache. num_shard_bits is ignored.");
+DEFINE_int64(estimated_entry_charge, 1,
+             "Estimated charge of an entry, used to size the table of "
+             "LockFreeClockCache");
 
 namespace rocksdb {
 
@@ -138,6 +143,14 @@ class CacheBench {
         fprintf(stderr, "Clock cache not supported.\n");
         exit(1);
       }
+    } else if (FLAGS_use_lock_free_clock_cache) {
+      cache_ = NewLockFreeClockCache(
+          static_cast<size_t>(FLAGS_cache_size),
+          static_cast<size_t>(FLAGS_estimated_entry_charge));
+      if (!cache_) {
+        fprintf(stderr, "Invalid estimated_entry_charge.\n");
+        exit(1);
+      }
     } else {
       cache_ = NewLRUCache(FLAGS_cache_size, FLAGS_num_shard_bits);
     }
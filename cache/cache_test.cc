@@ -9,14 +9,19 @@
 
 #include "rocksdb/cache.h"
 
+#include <atomic>
 #include <forward_list>
 #include <functional>
 #include <iostream>
 #include <string>
+#include <thread>
 #include <vector>
 #include "cache/clock_cache.h"
+#include "cache/compressed_tiered_cache.h"
+#include "cache/lock_free_clock_cache.h"
 #include "cache/lru_cache.h"
 #include "util/coding.h"
+#include "util/random.h"
 #include "util/string_util.h"
 #include "util/testharness.h"
 
@@ -39,6 +44,7 @@ static int DecodeValue(void* v) {
 
 const std::string kLRU = "lru";
 const std::string kClock = "clock";
+const std::string kLockFreeClock = "lock_free_clock";
 
 void dumbDeleter(const Slice& /*key*/, void* /*value*/) {}
 
@@ -84,6 +90,9 @@ class CacheTest : public testing::TestWithParam<std::string> {
     if (type == kClock) {
       return NewClockCache(capacity);
     }
+    if (type == kLockFreeClock) {
+      return NewLockFreeClockCache(capacity, 1 /* estimated_entry_charge */);
+    }
     return nullptr;
   }
 
@@ -96,9 +105,22 @@ class CacheTest : public testing::TestWithParam<std::string> {
     if (type == kClock) {
       return NewClockCache(capacity, num_shard_bits, strict_capacity_limit);
     }
+    if (type == kLockFreeClock) {
+      return NewLockFreeClockCache(capacity, 1 /* estimated_entry_charge */,
+                                   strict_capacity_limit);
+    }
     return nullptr;
   }
 
+  // Number of inserts into cache_ after which the entries that were in it
+  // before, and were neither referenced nor looked up since, are evicted.
+  // LockFreeClockCache evicts in the order of its table rather than in the
+  // order of insertion, so its CLOCK hand may need a few passes over the
+  // table for that.
+  int NumInsertsToEvictAll() const {
+    return GetParam() == kLockFreeClock ? 4 * kCacheSize : kCacheSize + 100;
+  }
+
   int Lookup(shared_ptr<Cache> cache, int key) {
     Cache::Handle* handle = cache->Lookup(EncodeKey(key));
     const int r = (handle == nullptr) ? -1 : DecodeValue(cache->Value(handle));
@@ -168,7 +190,12 @@ TEST_P(CacheTest, UsageTest) {
   }
 
   // the usage should be close to the capacity
-  ASSERT_GT(kCapacity, cache->GetUsage());
+  if (GetParam() == kLockFreeClock) {
+    // Not sharded, so it can be filled up to the byte
+    ASSERT_GE(kCapacity, cache->GetUsage());
+  } else {
+    ASSERT_GT(kCapacity, cache->GetUsage());
+  }
   ASSERT_LT(kCapacity * 0.95, cache->GetUsage());
 }
 
@@ -307,7 +334,7 @@ TEST_P(CacheTest, EvictionPolicy) {
   Insert(200, 201);
 
   // Frequently used entry must be kept around
-  for (int i = 0; i < kCacheSize + 100; i++) {
+  for (int i = 0; i < NumInsertsToEvictAll(); i++) {
     Insert(1000+i, 2000+i);
     ASSERT_EQ(101, Lookup(100));
   }
@@ -360,7 +387,7 @@ TEST_P(CacheTest, EvictionPolicyRef) {
   Insert(303, 104);
 
   // Insert entries much more than Cache capacity
-  for (int i = 0; i < kCacheSize + 100; i++) {
+  for (int i = 0; i < NumInsertsToEvictAll(); i++) {
     Insert(1000 + i, 2000 + i);
   }
 
@@ -634,6 +661,20 @@ TEST_P(CacheTest, OverCapacity) {
   // cache is under capacity now since elements were released
   ASSERT_EQ(n, cache->GetUsage());
 
+  if (GetParam() == kLockFreeClock) {
+    // No LRU order, any one of the elements may have been evicted
+    size_t num_found = 0;
+    for (size_t i = 0; i < n + 1; i++) {
+      auto h = cache->Lookup(ToString(i + 1));
+      if (h) {
+        num_found++;
+        cache->Release(h);
+      }
+    }
+    ASSERT_EQ(n, num_found);
+    return;
+  }
+
   // element 0 is evicted and the rest is there
   // This is consistent with the LRU policy since the element 0
   // was released first
@@ -672,6 +713,10 @@ TEST_P(CacheTest, ApplyToAllCacheEntiresTest) {
 }
 
 TEST_P(CacheTest, DefaultShardBits) {
+  if (GetParam() == kLockFreeClock) {
+    // Not sharded
+    return;
+  }
   // test1: set the flag to false. Insert more keys than capacity. See if they
   // all go through.
   std::shared_ptr<Cache> cache = NewCache(16 * 1024L * 1024L);
@@ -687,12 +732,174 @@ TEST_P(CacheTest, DefaultShardBits) {
   ASSERT_EQ(6, sc->GetNumShardBits());
 }
 
+namespace {
+std::atomic<int> live_values;
+void CountingDeleter(const Slice& key, void* value) {
+  ASSERT_EQ(DecodeKey(key), DecodeValue(value));
+  live_values.fetch_sub(1);
+}
+}  // namespace
+
+TEST(LockFreeClockCacheTest, ConcurrentOperations) {
+  const int kNumThreads = 8;
+  const int kOpsPerThread = 100000;
+  const int kNumKeys = 2000;
+  live_values = 0;
+  {
+    // Room for about half of the keys
+    std::shared_ptr<Cache> cache =
+        NewLockFreeClockCache(kNumKeys / 2, 1 /* estimated_entry_charge */);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < kNumThreads; t++) {
+      threads.emplace_back([&cache, t]() {
+        Random rnd(301 + t);
+        std::vector<Cache::Handle*> pinned;
+        for (int i = 0; i < kOpsPerThread; i++) {
+          int key = static_cast<int>(rnd.Uniform(kNumKeys));
+          int op = static_cast<int>(rnd.Uniform(100));
+          if (op < 30) {
+            live_values.fetch_add(1);
+            Cache::Handle* handle = nullptr;
+            ASSERT_OK(cache->Insert(EncodeKey(key), EncodeValue(key), 1,
+                                    &CountingDeleter,
+                                    rnd.OneIn(4) ? &handle : nullptr));
+            if (handle != nullptr) {
+              pinned.push_back(handle);
+            }
+          } else if (op < 90) {
+            Cache::Handle* handle = cache->Lookup(EncodeKey(key));
+            if (handle != nullptr) {
+              ASSERT_EQ(key, DecodeValue(cache->Value(handle)));
+              pinned.push_back(handle);
+            }
+          } else {
+            cache->Erase(EncodeKey(key));
+          }
+          if (pinned.size() > 10) {
+            for (auto* handle : pinned) {
+              cache->Release(handle, rnd.OneIn(10) /* force_erase */);
+            }
+            pinned.clear();
+          }
+        }
+        for (auto* handle : pinned) {
+          cache->Release(handle);
+        }
+      });
+    }
+    for (auto& thread : threads) {
+      thread.join();
+    }
+    ASSERT_EQ(0, cache->GetPinnedUsage());
+    ASSERT_EQ(static_cast<size_t>(live_values.load()), cache->GetUsage());
+  }
+  // Every value was deleted exactly once
+  ASSERT_EQ(0, live_values.load());
+}
+
+namespace {
+size_t StringSize(void* value) {
+  return reinterpret_cast<std::string*>(value)->size();
+}
+void SaveString(void* value, char* buf) {
+  const std::string* str = reinterpret_cast<std::string*>(value);
+  memcpy(buf, str->data(), str->size());
+}
+void DeleteString(const Slice& /*key*/, void* value) {
+  delete reinterpret_cast<std::string*>(value);
+}
+const Cache::CacheItemHelper kStringHelper = {&StringSize, &SaveString,
+                                              &DeleteString};
+}  // namespace
+
+TEST(CompressedTieredCacheTest, DemoteAndPromote) {
+  const size_t kValueSize = 100;
+  std::shared_ptr<Statistics> stats = CreateDBStatistics();
+  CompressedTieredCacheOptions cache_opts;
+  cache_opts.capacity = 20 * kValueSize;
+  cache_opts.compressed_tier_ratio = 0.5;
+  cache_opts.num_shard_bits = 0;
+  cache_opts.statistics = stats;
+  std::shared_ptr<Cache> cache = NewCompressedTieredCache(cache_opts);
+  ASSERT_EQ(20 * kValueSize, cache->GetCapacity());
+  Cache* compressed_tier =
+      static_cast<CompressedTieredCache*>(cache.get())->TEST_GetCompressedTier();
+
+  auto value_of = [&](int k) {
+    return std::string(kValueSize, static_cast<char>('a' + k % 26));
+  };
+  Cache::CreateCallback create_cb = [](const Slice& buf, void** value,
+                                       size_t* charge) {
+    *value = new std::string(buf.data(), buf.size());
+    *charge = buf.size();
+    return Status::OK();
+  };
+
+  // Fill the uncompressed tier, then push those entries out of it
+  for (int k = 0; k < 20; k++) {
+    ASSERT_OK(cache->InsertWithHelper(EncodeKey(k), new std::string(value_of(k)),
+                                      &kStringHelper, kValueSize));
+  }
+  ASSERT_EQ(10, stats->getTickerCount(COMPRESSED_TIER_DEMOTED));
+  ASSERT_EQ(10 * kValueSize,
+            stats->getTickerCount(COMPRESSED_TIER_DEMOTED_BYTES));
+  ASSERT_LE(cache->GetUsage(), cache->GetCapacity());
+
+  // A plain lookup does not promote
+  ASSERT_EQ(nullptr, cache->Lookup(EncodeKey(9)));
+
+  // The most recently demoted entry is promoted back
+  Cache::Handle* handle = cache->LookupWithHelper(EncodeKey(9), &kStringHelper,
+                                                  create_cb);
+  ASSERT_NE(nullptr, handle);
+  ASSERT_EQ(value_of(9), *reinterpret_cast<std::string*>(cache->Value(handle)));
+  cache->Release(handle);
+  ASSERT_EQ(1, stats->getTickerCount(COMPRESSED_TIER_HIT));
+  ASSERT_EQ(nullptr, compressed_tier->Lookup(EncodeKey(9)));
+  // ... and another entry is demoted to make room for it
+  ASSERT_EQ(11, stats->getTickerCount(COMPRESSED_TIER_DEMOTED));
+  handle = compressed_tier->Lookup(EncodeKey(10));
+  ASSERT_NE(nullptr, handle);
+  compressed_tier->Release(handle);
+
+  // The compressed tier evicted the oldest entries if they did not all fit
+  handle = cache->LookupWithHelper(EncodeKey(0), &kStringHelper, create_cb);
+  if (handle == nullptr) {
+    ASSERT_EQ(1, stats->getTickerCount(COMPRESSED_TIER_MISS));
+  } else {
+    ASSERT_EQ(value_of(0),
+              *reinterpret_cast<std::string*>(cache->Value(handle)));
+    cache->Release(handle);
+  }
+
+  // Entries inserted without a helper are not demoted
+  const uint64_t demoted = stats->getTickerCount(COMPRESSED_TIER_DEMOTED);
+  for (int k = 100; k < 120; k++) {
+    ASSERT_OK(cache->Insert(EncodeKey(k), new std::string(value_of(k)),
+                            kValueSize, &DeleteString));
+  }
+  ASSERT_EQ(demoted + 10, stats->getTickerCount(COMPRESSED_TIER_DEMOTED));
+  ASSERT_OK(cache->Insert(EncodeKey(200), new std::string(value_of(200)),
+                          kValueSize * 10, &DeleteString));
+  ASSERT_EQ(demoted + 10, stats->getTickerCount(COMPRESSED_TIER_DEMOTED));
+
+  // Erase() applies to both tiers
+  handle = compressed_tier->Lookup(EncodeKey(19));
+  ASSERT_NE(nullptr, handle);
+  compressed_tier->Release(handle);
+  cache->Erase(EncodeKey(19));
+  ASSERT_EQ(nullptr, compressed_tier->Lookup(EncodeKey(19)));
+  ASSERT_EQ(nullptr, cache->LookupWithHelper(EncodeKey(19), &kStringHelper,
+                                             create_cb));
+}
+
 #ifdef SUPPORT_CLOCK_CACHE
 shared_ptr<Cache> (*new_clock_cache_func)(size_t, int, bool) = NewClockCache;
 INSTANTIATE_TEST_CASE_P(CacheTestInstance, CacheTest,
-                        testing::Values(kLRU, kClock));
+                        testing::Values(kLRU, kClock, kLockFreeClock));
 #else
-INSTANTIATE_TEST_CASE_P(CacheTestInstance, CacheTest, testing::Values(kLRU));
+INSTANTIATE_TEST_CASE_P(CacheTestInstance, CacheTest,
+                        testing::Values(kLRU, kLockFreeClock));
 #endif  // SUPPORT_CLOCK_CACHE
 
 }  // namespace rocksdb
@@ -0,0 +1,266 @@
+//  Copyright (c) 2011-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "cache/compressed_tiered_cache.h"
+
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "monitoring/statistics.h"
+#include "table/block_based_table_builder.h"
+#include "table/format.h"
+#include "util/compression.h"
+
+namespace rocksdb {
+
+namespace {
+
+// The format version the entries of the compressed tier are compressed with,
+// see GetCompressFormatForVersion()
+const uint32_t kCompressFormatVersion = 2;
+
+// An entry of the compressed tier
+struct CompressedEntry {
+  CompressionType type;
+  std::string data;
+};
+
+void DeleteCompressedEntry(const Slice& /*key*/, void* value) {
+  delete reinterpret_cast<CompressedEntry*>(value);
+}
+
+}  // namespace
+
+CompressedTieredCacheOptions::CompressedTieredCacheOptions()
+    : compression_type(kLZ4Compression) {}
+
+CompressedTieredCache::CompressedTieredCache(
+    const CompressedTieredCacheOptions& options)
+    : Cache(options.memory_allocator),
+      compressed_tier_ratio_(options.compressed_tier_ratio),
+      compression_type_(options.compression_type),
+      options_([&options]() {
+        Options opts;
+        opts.statistics = options.statistics;
+        return opts;
+      }()),
+      ioptions_(options_) {
+  int num_shard_bits = options.num_shard_bits;
+  if (num_shard_bits < 0) {
+    num_shard_bits = GetDefaultCacheShardBits(options.capacity);
+  }
+  compressed_tier_ = NewLRUCache(
+      options.capacity - UncompressedTierCapacity(options.capacity),
+      num_shard_bits, false /* strict_capacity_limit */,
+      0.0 /* high_pri_pool_ratio */);
+  uncompressed_tier_ = std::make_shared<LRUCache>(
+      UncompressedTierCapacity(options.capacity), num_shard_bits,
+      options.strict_capacity_limit, options.high_pri_pool_ratio,
+      options.memory_allocator);
+  uncompressed_tier_->SetEvictionCallback(
+      [this](const Slice& key, void* value, const CacheItemHelper* helper) {
+        Demote(key, value, helper);
+      });
+}
+
+CompressedTieredCache::~CompressedTieredCache() {}
+
+size_t CompressedTieredCache::UncompressedTierCapacity(size_t capacity) const {
+  return static_cast<size_t>(capacity * (1.0 - compressed_tier_ratio_));
+}
+
+void CompressedTieredCache::Demote(const Slice& key, void* value,
+                                   const CacheItemHelper* helper) {
+  const size_t size = (*helper->size)(value);
+  std::string buf;
+  buf.resize(size);
+  (*helper->save_to)(value, &buf[0]);
+
+  std::unique_ptr<CompressedEntry> entry(new CompressedEntry);
+  CompressionContext compression_ctx(compression_type_);
+  std::string compressed;
+  CompressBlock(buf, compression_ctx, &entry->type, kCompressFormatVersion,
+                &compressed);
+  // CompressBlock() falls back to kNoCompression if the type is not
+  // supported or the data does not compress well
+  entry->data = entry->type == kNoCompression ? std::move(buf)
+                                              : std::move(compressed);
+  RecordTick(ioptions_.statistics, COMPRESSED_TIER_DEMOTED);
+  RecordTick(ioptions_.statistics, COMPRESSED_TIER_DEMOTED_BYTES, size);
+  RecordTick(ioptions_.statistics, COMPRESSED_TIER_DEMOTED_COMPRESSED_BYTES,
+             entry->data.size());
+
+  const size_t charge = sizeof(CompressedEntry) + entry->data.size();
+  // Without a handle, the entry is deleted if the insertion fails
+  compressed_tier_->Insert(key, entry.release(), charge,
+                           &DeleteCompressedEntry);
+}
+
+Status CompressedTieredCache::Insert(const Slice& key, void* value,
+                                     size_t charge,
+                                     void (*deleter)(const Slice& key,
+                                                     void* value),
+                                     Handle** handle, Priority priority) {
+  return uncompressed_tier_->Insert(key, value, charge, deleter, handle,
+                                    priority);
+}
+
+Status CompressedTieredCache::InsertWithHelper(const Slice& key, void* value,
+                                               const CacheItemHelper* helper,
+                                               size_t charge, Handle** handle,
+                                               Priority priority) {
+  return uncompressed_tier_->InsertWithHelper(key, value, helper, charge,
+                                              handle, priority);
+}
+
+Cache::Handle* CompressedTieredCache::Lookup(const Slice& key,
+                                             Statistics* stats) {
+  return uncompressed_tier_->Lookup(key, stats);
+}
+
+Cache::Handle* CompressedTieredCache::LookupWithHelper(
+    const Slice& key, const CacheItemHelper* helper,
+    const CreateCallback& create_cb, Priority priority, Statistics* stats) {
+  Handle* handle = uncompressed_tier_->Lookup(key, stats);
+  if (handle != nullptr) {
+    return handle;
+  }
+
+  Handle* compressed_handle = compressed_tier_->Lookup(key);
+  if (compressed_handle == nullptr) {
+    RecordTick(ioptions_.statistics, COMPRESSED_TIER_MISS);
+    return nullptr;
+  }
+  RecordTick(ioptions_.statistics, COMPRESSED_TIER_HIT);
+  const CompressedEntry* entry = reinterpret_cast<const CompressedEntry*>(
+      compressed_tier_->Value(compressed_handle));
+
+  Status s;
+  void* value = nullptr;
+  size_t charge = 0;
+  if (entry->type == kNoCompression) {
+    s = create_cb(entry->data, &value, &charge);
+  } else {
+    BlockContents contents;
+    UncompressionContext uncompression_ctx(entry->type);
+    s = UncompressBlockContentsForCompressionType(
+        uncompression_ctx, entry->data.data(), entry->data.size(), &contents,
+        kCompressFormatVersion, ioptions_);
+    if (s.ok()) {
+      s = create_cb(contents.data, &value, &charge);
+    }
+  }
+  compressed_tier_->Release(compressed_handle);
+  if (!s.ok()) {
+    return nullptr;
+  }
+
+  // The entry now lives in the uncompressed tier only
+  compressed_tier_->Erase(key);
+  s = uncompressed_tier_->InsertWithHelper(key, value, helper, charge, &handle,
+                                           priority);
+  if (!s.ok()) {
+    // The uncompressed tier is full and has a strict capacity limit
+    (*helper->deleter)(key, value);
+    return nullptr;
+  }
+  return handle;
+}
+
+bool CompressedTieredCache::Ref(Handle* handle) {
+  return uncompressed_tier_->Ref(handle);
+}
+
+bool CompressedTieredCache::Release(Handle* handle, bool force_erase) {
+  return uncompressed_tier_->Release(handle, force_erase);
+}
+
+void* CompressedTieredCache::Value(Handle* handle) {
+  return uncompressed_tier_->Value(handle);
+}
+
+void CompressedTieredCache::Erase(const Slice& key) {
+  uncompressed_tier_->Erase(key);
+  compressed_tier_->Erase(key);
+}
+
+uint64_t CompressedTieredCache::NewId() { return uncompressed_tier_->NewId(); }
+
+void CompressedTieredCache::SetCapacity(size_t capacity) {
+  compressed_tier_->SetCapacity(capacity - UncompressedTierCapacity(capacity));
+  uncompressed_tier_->SetCapacity(UncompressedTierCapacity(capacity));
+}
+
+void CompressedTieredCache::SetStrictCapacityLimit(
+    bool strict_capacity_limit) {
+  uncompressed_tier_->SetStrictCapacityLimit(strict_capacity_limit);
+}
+
+bool CompressedTieredCache::HasStrictCapacityLimit() const {
+  return uncompressed_tier_->HasStrictCapacityLimit();
+}
+
+size_t CompressedTieredCache::GetCapacity() const {
+  return uncompressed_tier_->GetCapacity() + compressed_tier_->GetCapacity();
+}
+
+size_t CompressedTieredCache::GetUsage() const {
+  return uncompressed_tier_->GetUsage() + compressed_tier_->GetUsage();
+}
+
+size_t CompressedTieredCache::GetUsage(Handle* handle) const {
+  return uncompressed_tier_->GetUsage(handle);
+}
+
+size_t CompressedTieredCache::GetPinnedUsage() const {
+  return uncompressed_tier_->GetPinnedUsage();
+}
+
+void CompressedTieredCache::DisownData() {
+  uncompressed_tier_->DisownData();
+  compressed_tier_->DisownData();
+}
+
+void CompressedTieredCache::ApplyToAllCacheEntries(
+    void (*callback)(void*, size_t), bool thread_safe) {
+  uncompressed_tier_->ApplyToAllCacheEntries(callback, thread_safe);
+}
+
+void CompressedTieredCache::EraseUnRefEntries() {
+  uncompressed_tier_->EraseUnRefEntries();
+  compressed_tier_->EraseUnRefEntries();
+}
+
+std::string CompressedTieredCache::GetPrintableOptions() const {
+  std::string ret;
+  ret.reserve(20000);
+  const int kBufferSize = 200;
+  char buffer[kBufferSize];
+  snprintf(buffer, kBufferSize, "    compressed_tier_ratio : %.3lf\n",
+           compressed_tier_ratio_);
+  ret.append(buffer);
+  snprintf(buffer, kBufferSize, "    compression_type : %s\n",
+           CompressionTypeToString(compression_type_).c_str());
+  ret.append(buffer);
+  ret.append(uncompressed_tier_->GetPrintableOptions());
+  return ret;
+}
+
+std::shared_ptr<Cache> NewCompressedTieredCache(
+    const CompressedTieredCacheOptions& cache_opts) {
+  if (cache_opts.num_shard_bits >= 20) {
+    return nullptr;  // the cache cannot be sharded into too many fine pieces
+  }
+  if (cache_opts.high_pri_pool_ratio < 0.0 ||
+      cache_opts.high_pri_pool_ratio > 1.0 ||
+      cache_opts.compressed_tier_ratio < 0.0 ||
+      cache_opts.compressed_tier_ratio >= 1.0) {
+    return nullptr;
+  }
+  return std::make_shared<CompressedTieredCache>(cache_opts);
+}
+
+}  // namespace rocksdb
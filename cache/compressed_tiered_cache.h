@@ -0,0 +1,100 @@
+//  Copyright (c) 2011-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#pragma once
+
+#include <memory>
+#include <string>
+
+#include "cache/lru_cache.h"
+#include "options/cf_options.h"
+#include "rocksdb/cache.h"
+#include "rocksdb/options.h"
+
+namespace rocksdb {
+
+// CompressedTieredCache
+//
+// A cache made of two LRU caches that share one capacity: the uncompressed
+// tier, which holds the entries as they are inserted, and the compressed
+// tier, which holds flat, compressed copies of entries that the uncompressed
+// tier evicted.
+//
+// Entries inserted with InsertWithHelper() are demoted when the uncompressed
+// tier evicts them to stay within its capacity: their value is saved to a
+// buffer with CacheItemHelper::save_to, compressed, and inserted in the
+// compressed tier under the same key. Entries inserted with Insert() cannot
+// be saved and are dropped as usual.
+//
+// A LookupWithHelper() that misses the uncompressed tier looks the key up in
+// the compressed tier. On a hit the buffer is uncompressed, the value is
+// created back with the given callback and promoted: inserted in the
+// uncompressed tier and erased from the compressed tier, so that an entry is
+// in at most one of the tiers.
+//
+// Everything else, e.g. Ref(), Release() and Value(), applies to the
+// uncompressed tier only. Erase() applies to both.
+class CompressedTieredCache : public Cache {
+ public:
+  explicit CompressedTieredCache(const CompressedTieredCacheOptions& options);
+  virtual ~CompressedTieredCache();
+
+  virtual const char* Name() const override { return "CompressedTieredCache"; }
+
+  virtual Status Insert(const Slice& key, void* value, size_t charge,
+                        void (*deleter)(const Slice& key, void* value),
+                        Handle** handle = nullptr,
+                        Priority priority = Priority::LOW) override;
+  virtual Status InsertWithHelper(const Slice& key, void* value,
+                                  const CacheItemHelper* helper, size_t charge,
+                                  Handle** handle = nullptr,
+                                  Priority priority = Priority::LOW) override;
+  virtual Handle* Lookup(const Slice& key,
+                         Statistics* stats = nullptr) override;
+  virtual Handle* LookupWithHelper(const Slice& key,
+                                   const CacheItemHelper* helper,
+                                   const CreateCallback& create_cb,
+                                   Priority priority = Priority::LOW,
+                                   Statistics* stats = nullptr) override;
+  virtual bool Ref(Handle* handle) override;
+  virtual bool Release(Handle* handle, bool force_erase = false) override;
+  virtual void* Value(Handle* handle) override;
+  virtual void Erase(const Slice& key) override;
+  virtual uint64_t NewId() override;
+
+  // The capacity is split between the tiers as at construction
+  virtual void SetCapacity(size_t capacity) override;
+  virtual void SetStrictCapacityLimit(bool strict_capacity_limit) override;
+  virtual bool HasStrictCapacityLimit() const override;
+  virtual size_t GetCapacity() const override;
+  // Includes the usage of the compressed tier
+  virtual size_t GetUsage() const override;
+  virtual size_t GetUsage(Handle* handle) const override;
+  virtual size_t GetPinnedUsage() const override;
+  virtual void DisownData() override;
+  virtual void ApplyToAllCacheEntries(void (*callback)(void*, size_t),
+                                      bool thread_safe) override;
+  virtual void EraseUnRefEntries() override;
+  virtual std::string GetPrintableOptions() const override;
+
+  Cache* TEST_GetCompressedTier() const { return compressed_tier_.get(); }
+
+ private:
+  // Called by the uncompressed tier with the entries it evicts
+  void Demote(const Slice& key, void* value, const CacheItemHelper* helper);
+
+  size_t UncompressedTierCapacity(size_t capacity) const;
+
+  const double compressed_tier_ratio_;
+  const CompressionType compression_type_;
+  // Holds the statistics, for UncompressBlockContentsForCompressionType()
+  const Options options_;
+  const ImmutableCFOptions ioptions_;
+
+  std::shared_ptr<Cache> compressed_tier_;
+  std::shared_ptr<LRUCache> uncompressed_tier_;
+};
+
+}  // namespace rocksdb
@@ -0,0 +1,83 @@
+//  Copyright (c) 2011-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "cache/frequency_sketch.h"
+
+#include <algorithm>
+
+namespace rocksdb {
+
+namespace {
+
+// Seeds of the rows, odd 64-bit constants
+const uint64_t kSeeds[] = {0xc3a5c85c97cb3127ULL, 0xb492b66fbe98f273ULL,
+                           0x9ae16a3b2f90404fULL, 0xcbf29ce484222325ULL};
+
+}  // namespace
+
+void FrequencySketch::EnsureCapacity(size_t num_entries) {
+  if (num_entries <= num_entries_) {
+    return;
+  }
+  // The hash functions share the counters, at least kDepth per entry,
+  // rounded up to a power of two so that an index is a mask of the hash.
+  // That is 2 bytes per entry, which keeps collisions rare.
+  size_t num_counters = 16;
+  while (num_counters < kDepth * num_entries) {
+    num_counters *= 2;
+  }
+  table_.assign(num_counters / 16, 0);
+  num_entries_ = num_entries;
+  sample_size_ = 10 * num_entries;
+  num_increments_ = 0;
+}
+
+size_t FrequencySketch::CounterIndex(uint32_t hash, int i) const {
+  uint64_t h = (uint64_t{hash} + kSeeds[i]) * kSeeds[i];
+  h ^= h >> 32;
+  return static_cast<size_t>(h) & (table_.size() * 16 - 1);
+}
+
+void FrequencySketch::Increment(uint32_t hash) {
+  if (table_.empty()) {
+    return;
+  }
+  bool incremented = false;
+  for (int i = 0; i < kDepth; i++) {
+    size_t index = CounterIndex(hash, i);
+    uint64_t& word = table_[index / 16];
+    int shift = static_cast<int>(index % 16) * 4;
+    if (((word >> shift) & 0xf) != 0xf) {
+      word += uint64_t{1} << shift;
+      incremented = true;
+    }
+  }
+  if (incremented && ++num_increments_ >= sample_size_) {
+    Age();
+  }
+}
+
+uint32_t FrequencySketch::Estimate(uint32_t hash) const {
+  if (table_.empty()) {
+    return 0;
+  }
+  uint32_t frequency = 0xf;
+  for (int i = 0; i < kDepth; i++) {
+    size_t index = CounterIndex(hash, i);
+    int shift = static_cast<int>(index % 16) * 4;
+    frequency = std::min(
+        frequency, static_cast<uint32_t>((table_[index / 16] >> shift) & 0xf));
+  }
+  return frequency;
+}
+
+void FrequencySketch::Age() {
+  for (auto& word : table_) {
+    word = (word >> 1) & 0x7777777777777777ULL;
+  }
+  num_increments_ /= 2;
+}
+
+}  // namespace rocksdb
@@ -0,0 +1,58 @@
+//  Copyright (c) 2011-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+namespace rocksdb {
+
+// FrequencySketch estimates how often keys were accessed recently, for the
+// TinyLFU admission filter of LRUCache.
+//
+// It is a count-min sketch of 4-bit counters: each key, given by its hash,
+// increments 4 counters, one per hash function, and its frequency is
+// estimated as the smallest of them. Collisions can only make the estimate
+// too high. Counters saturate at 15. Once the number of increments reaches 10 times
+// the number of entries the sketch is sized for, all the counters are
+// halved, so that the frequencies reflect recent accesses.
+//
+// Not thread safe.
+class FrequencySketch {
+ public:
+  FrequencySketch() : num_entries_(0), sample_size_(0), num_increments_(0) {}
+
+  // Resizes the sketch for num_entries keys if it is smaller, which resets
+  // all the counters. A sketch that was never sized ignores increments and
+  // estimates 0.
+  void EnsureCapacity(size_t num_entries);
+
+  // Number of keys the sketch is sized for
+  size_t capacity() const { return num_entries_; }
+
+  void Increment(uint32_t hash);
+
+  // Returns the estimated frequency of hash, in [0, 15]
+  uint32_t Estimate(uint32_t hash) const;
+
+ private:
+  static const int kDepth = 4;
+
+  // Index of the counter of hash for the i-th hash function
+  size_t CounterIndex(uint32_t hash, int i) const;
+
+  // Halves all the counters
+  void Age();
+
+  // 16 counters per word
+  std::vector<uint64_t> table_;
+  size_t num_entries_;
+  size_t sample_size_;
+  size_t num_increments_;
+};
+
+}  // namespace rocksdb
@@ -0,0 +1,442 @@
+//  Copyright (c) 2011-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#ifndef __STDC_FORMAT_MACROS
+#define __STDC_FORMAT_MACROS
+#endif
+
+#include "cache/lock_free_clock_cache.h"
+
+#include <stdio.h>
+#include <algorithm>
+
+#include "port/port.h"
+
+namespace rocksdb {
+
+namespace {
+
+const int kStateShift = 62;
+const int kClockShift = 60;
+const uint64_t kOneRef = 1;
+const uint64_t kRefsMask = (uint64_t{1} << kClockShift) - 1;
+const uint64_t kClockOne = uint64_t{1} << kClockShift;
+const uint64_t kClockMax = 3;
+const uint64_t kStateOne = uint64_t{1} << kStateShift;
+
+const uint64_t kEmpty = 0;
+const uint64_t kConstruction = 1;
+const uint64_t kVisible = 2;
+const uint64_t kInvisible = 3;
+
+const uint64_t kConstructionMeta = kConstruction << kStateShift;
+
+// Keep the table at most that full when the cache is full with entries of
+// the estimated charge
+const double kLoadFactor = 0.7;
+// Never fill the table above this, so that probe sequences stay short even
+// when the entries are smaller than estimated
+const double kMaxLoadFactor = 0.9;
+
+inline uint64_t GetState(uint64_t meta) { return meta >> kStateShift; }
+inline uint64_t GetClock(uint64_t meta) { return (meta >> kClockShift) & 3; }
+inline uint64_t GetRefs(uint64_t meta) { return meta & kRefsMask; }
+
+size_t CalcTableSize(size_t capacity, size_t estimated_entry_charge) {
+  double num_entries = static_cast<double>(capacity) /
+                       std::max(estimated_entry_charge, size_t{1});
+  size_t min_slots = static_cast<size_t>(num_entries / kLoadFactor) + 1;
+  size_t table_size = 16;
+  while (table_size < min_slots) {
+    table_size *= 2;
+  }
+  return table_size;
+}
+}  // anonymous namespace
+
+LockFreeClockCache::LockFreeClockCache(
+    size_t capacity, size_t estimated_entry_charge, bool strict_capacity_limit,
+    std::shared_ptr<MemoryAllocator> memory_allocator)
+    : Cache(std::move(memory_allocator)),
+      table_size_(CalcTableSize(capacity, estimated_entry_charge)),
+      table_mask_(table_size_ - 1),
+      occupancy_limit_(static_cast<size_t>(table_size_ * kMaxLoadFactor)),
+      table_(new LockFreeClockHandle[table_size_]),
+      capacity_(capacity),
+      strict_capacity_limit_(strict_capacity_limit),
+      usage_(0),
+      occupancy_(0),
+      clock_hand_(0),
+      last_id_(1) {}
+
+LockFreeClockCache::~LockFreeClockCache() {
+  if (table_ == nullptr) {
+    // DisownData() was called
+    return;
+  }
+  for (size_t i = 0; i < table_size_; i++) {
+    LockFreeClockHandle* h = &table_[i];
+    uint64_t state = GetState(h->meta.load(std::memory_order_relaxed));
+    if (state != kEmpty && h->deleter != nullptr) {
+      assert(state != kConstruction);
+      (*h->deleter)(h->key(), h->value);
+    }
+  }
+}
+
+void LockFreeClockCache::FreeEntry(LockFreeClockHandle* h) {
+  assert(h->detached ||
+         GetState(h->meta.load(std::memory_order_relaxed)) == kConstruction);
+  if (h->deleter != nullptr) {
+    (*h->deleter)(h->key(), h->value);
+  }
+  usage_.fetch_sub(h->charge, std::memory_order_relaxed);
+  if (h->detached) {
+    delete h;
+    return;
+  }
+
+  // The entry no longer needs to be found past the slots before it
+  size_t idx = static_cast<size_t>(h - table_.get());
+  uint32_t hash = h->hash.load(std::memory_order_relaxed);
+  size_t increment = ProbeIncrement(hash);
+  for (size_t probe = ProbeStart(hash); probe != idx;
+       probe = (probe + increment) & table_mask_) {
+    table_[probe].displacements.fetch_sub(1, std::memory_order_relaxed);
+  }
+  h->key_data.reset();
+  h->value = nullptr;
+  h->deleter = nullptr;
+  occupancy_.fetch_sub(1, std::memory_order_relaxed);
+  // Not a plain store, so that the references that concurrent lookups may
+  // have transiently taken are preserved
+  h->meta.fetch_sub(kConstructionMeta, std::memory_order_release);
+}
+
+bool LockFreeClockCache::Unref(LockFreeClockHandle* h, bool erase_if_last) {
+  uint64_t old_meta = h->meta.fetch_sub(kOneRef, std::memory_order_acq_rel);
+  assert(GetRefs(old_meta) > 0);
+  if (GetRefs(old_meta) != 1) {
+    return false;
+  }
+  uint64_t state = GetState(old_meta);
+  if (state == kInvisible || (state == kVisible && erase_if_last)) {
+    // Take the entry over, unless someone referenced it meanwhile. If that
+    // was a lookup that is going to drop its reference right away, it will
+    // try this again.
+    uint64_t expected = old_meta - kOneRef;
+    if (h->meta.compare_exchange_strong(expected, kConstructionMeta,
+                                        std::memory_order_acq_rel)) {
+      FreeEntry(h);
+      return true;
+    }
+  }
+  return false;
+}
+
+bool LockFreeClockCache::EvictUntilFits(size_t charge) {
+  // An entry is evicted at the latest when the hand passes over it for the
+  // kClockMax + 1-th time
+  const size_t max_steps = (kClockMax + 1) * table_size_;
+  for (size_t step = 0;; step++) {
+    if (usage_.load(std::memory_order_relaxed) + charge <=
+            capacity_.load(std::memory_order_relaxed) &&
+        occupancy_.load(std::memory_order_relaxed) < occupancy_limit_) {
+      return true;
+    }
+    if (step >= max_steps) {
+      return false;
+    }
+    LockFreeClockHandle* h =
+        &table_[clock_hand_.fetch_add(1, std::memory_order_relaxed) &
+                table_mask_];
+    uint64_t meta = h->meta.load(std::memory_order_acquire);
+    if (GetState(meta) != kVisible || GetRefs(meta) != 0) {
+      continue;
+    }
+    if (GetClock(meta) > 0) {
+      h->meta.compare_exchange_strong(meta, meta - kClockOne,
+                                      std::memory_order_acq_rel);
+    } else if (h->meta.compare_exchange_strong(meta, kConstructionMeta,
+                                               std::memory_order_acq_rel)) {
+      FreeEntry(h);
+    }
+  }
+}
+
+Status LockFreeClockCache::Insert(const Slice& key, void* value, size_t charge,
+                                  void (*deleter)(const Slice& key,
+                                                  void* value),
+                                  Cache::Handle** handle,
+                                  Cache::Priority priority) {
+  if (!EvictUntilFits(charge) &&
+      strict_capacity_limit_.load(std::memory_order_relaxed)) {
+    if (handle == nullptr) {
+      // Don't insert the entry but still return ok, as if the entry was
+      // inserted into cache and evicted immediately.
+      if (deleter != nullptr) {
+        (*deleter)(key, value);
+      }
+      return Status::OK();
+    }
+    *handle = nullptr;
+    return Status::Incomplete("Insert failed due to cache being full.");
+  }
+  usage_.fetch_add(charge, std::memory_order_relaxed);
+
+  uint32_t hash = HashSlice(key);
+  size_t increment = ProbeIncrement(hash);
+  size_t probe = ProbeStart(hash);
+  LockFreeClockHandle* h = nullptr;
+  for (size_t i = 0; i < table_size_; i++) {
+    LockFreeClockHandle* slot = &table_[probe];
+    uint64_t expected = kEmpty;
+    if (slot->meta.compare_exchange_strong(expected, kConstructionMeta,
+                                           std::memory_order_acq_rel)) {
+      h = slot;
+      break;
+    }
+    slot->displacements.fetch_add(1, std::memory_order_relaxed);
+    probe = (probe + increment) & table_mask_;
+  }
+
+  if (h == nullptr) {
+    // No free slot at all, undo the displacements
+    probe = ProbeStart(hash);
+    for (size_t i = 0; i < table_size_; i++) {
+      table_[probe].displacements.fetch_sub(1, std::memory_order_relaxed);
+      probe = (probe + increment) & table_mask_;
+    }
+    if (handle == nullptr) {
+      usage_.fetch_sub(charge, std::memory_order_relaxed);
+      if (deleter != nullptr) {
+        (*deleter)(key, value);
+      }
+      return Status::OK();
+    }
+    // The caller needs a handle, give it one that lives outside of the table
+    h = new LockFreeClockHandle();
+    h->detached = true;
+  }
+
+  h->key_data.reset(new char[key.size()]);
+  memcpy(h->key_data.get(), key.data(), key.size());
+  h->key_length = key.size();
+  h->hash.store(hash, std::memory_order_relaxed);
+  h->value = value;
+  h->charge = charge;
+  h->deleter = deleter;
+  uint64_t refs = handle != nullptr ? 1 : 0;
+  if (h->detached) {
+    h->meta.store((kInvisible << kStateShift) | refs,
+                  std::memory_order_release);
+    *handle = reinterpret_cast<Cache::Handle*>(h);
+    return Status::OK();
+  }
+
+  occupancy_.fetch_add(1, std::memory_order_relaxed);
+  uint64_t clock = priority == Cache::Priority::HIGH ? kClockMax : 1;
+  h->meta.fetch_add(((kVisible - kConstruction) << kStateShift) |
+                        (clock << kClockShift) | refs,
+                    std::memory_order_acq_rel);
+  // Hide the previous entries for the same key
+  EraseFromTable(key, hash, h);
+  if (handle != nullptr) {
+    *handle = reinterpret_cast<Cache::Handle*>(h);
+  }
+  return Status::OK();
+}
+
+Cache::Handle* LockFreeClockCache::Lookup(const Slice& key,
+                                          Statistics* /*stats*/) {
+  uint32_t hash = HashSlice(key);
+  size_t increment = ProbeIncrement(hash);
+  size_t probe = ProbeStart(hash);
+  for (size_t i = 0; i < table_size_; i++) {
+    LockFreeClockHandle* h = &table_[probe];
+    uint64_t meta = h->meta.load(std::memory_order_acquire);
+    if (GetState(meta) == kVisible &&
+        h->hash.load(std::memory_order_relaxed) == hash) {
+      meta = h->meta.fetch_add(kOneRef, std::memory_order_acq_rel);
+      if (GetState(meta) == kVisible && h->key() == key) {
+        if (GetClock(meta) < kClockMax) {
+          h->meta.fetch_or(kClockMax << kClockShift, std::memory_order_relaxed);
+        }
+        return reinterpret_cast<Cache::Handle*>(h);
+      }
+      Unref(h, false /* erase_if_last */);
+    }
+    if (h->displacements.load(std::memory_order_acquire) == 0) {
+      break;
+    }
+    probe = (probe + increment) & table_mask_;
+  }
+  return nullptr;
+}
+
+void LockFreeClockCache::EraseFromTable(const Slice& key, uint32_t hash,
+                                        const LockFreeClockHandle* except) {
+  size_t increment = ProbeIncrement(hash);
+  size_t probe = ProbeStart(hash);
+  for (size_t i = 0; i < table_size_; i++) {
+    LockFreeClockHandle* h = &table_[probe];
+    uint64_t meta = h->meta.load(std::memory_order_acquire);
+    if (h != except && GetState(meta) == kVisible &&
+        h->hash.load(std::memory_order_relaxed) == hash) {
+      meta = h->meta.fetch_add(kOneRef, std::memory_order_acq_rel) + kOneRef;
+      if (GetState(meta) == kVisible && h->key() == key) {
+        while (GetState(meta) == kVisible &&
+               !h->meta.compare_exchange_weak(meta, meta + kStateOne,
+                                              std::memory_order_acq_rel)) {
+        }
+      }
+      Unref(h, false /* erase_if_last */);
+    }
+    if (h->displacements.load(std::memory_order_acquire) == 0) {
+      break;
+    }
+    probe = (probe + increment) & table_mask_;
+  }
+}
+
+bool LockFreeClockCache::Ref(Cache::Handle* handle) {
+  LockFreeClockHandle* h = reinterpret_cast<LockFreeClockHandle*>(handle);
+  h->meta.fetch_add(kOneRef, std::memory_order_relaxed);
+  return true;
+}
+
+bool LockFreeClockCache::Release(Cache::Handle* handle, bool force_erase) {
+  if (handle == nullptr) {
+    return false;
+  }
+  LockFreeClockHandle* h = reinterpret_cast<LockFreeClockHandle*>(handle);
+  bool erase_if_last = force_erase || usage_.load(std::memory_order_relaxed) >
+                                          capacity_.load(std::memory_order_relaxed);
+  return Unref(h, erase_if_last);
+}
+
+void* LockFreeClockCache::Value(Cache::Handle* handle) {
+  return reinterpret_cast<LockFreeClockHandle*>(handle)->value;
+}
+
+void LockFreeClockCache::Erase(const Slice& key) {
+  EraseFromTable(key, HashSlice(key), nullptr);
+}
+
+uint64_t LockFreeClockCache::NewId() {
+  return last_id_.fetch_add(1, std::memory_order_relaxed);
+}
+
+void LockFreeClockCache::SetCapacity(size_t capacity) {
+  capacity_.store(capacity, std::memory_order_relaxed);
+  EvictUntilFits(0);
+}
+
+void LockFreeClockCache::SetStrictCapacityLimit(bool strict_capacity_limit) {
+  strict_capacity_limit_.store(strict_capacity_limit,
+                               std::memory_order_relaxed);
+}
+
+bool LockFreeClockCache::HasStrictCapacityLimit() const {
+  return strict_capacity_limit_.load(std::memory_order_relaxed);
+}
+
+size_t LockFreeClockCache::GetCapacity() const {
+  return capacity_.load(std::memory_order_relaxed);
+}
+
+size_t LockFreeClockCache::GetUsage() const {
+  return usage_.load(std::memory_order_relaxed);
+}
+
+size_t LockFreeClockCache::GetUsage(Cache::Handle* handle) const {
+  return reinterpret_cast<const LockFreeClockHandle*>(handle)->charge;
+}
+
+size_t LockFreeClockCache::GetPinnedUsage() const {
+  // Rarely called, so it scans the table rather than having every lookup
+  // update a shared counter
+  size_t pinned_usage = 0;
+  for (size_t i = 0; i < table_size_; i++) {
+    LockFreeClockHandle* h = &table_[i];
+    if (GetState(h->meta.load(std::memory_order_acquire)) != kVisible) {
+      continue;
+    }
+    uint64_t meta = h->meta.fetch_add(kOneRef, std::memory_order_acq_rel);
+    if (GetState(meta) == kVisible && GetRefs(meta) > 0) {
+      pinned_usage += h->charge;
+    }
+    const_cast<LockFreeClockCache*>(this)->Unref(h, false);
+  }
+  return pinned_usage;
+}
+
+void LockFreeClockCache::DisownData() {
+// Do not drop data if compile with ASAN to suppress leak warning.
+#ifndef __SANITIZE_ADDRESS__
+  table_.release();
+#endif  // !__SANITIZE_ADDRESS__
+}
+
+void LockFreeClockCache::ApplyToAllCacheEntries(void (*callback)(void*, size_t),
+                                                bool /*thread_safe*/) {
+  for (size_t i = 0; i < table_size_; i++) {
+    LockFreeClockHandle* h = &table_[i];
+    if (GetState(h->meta.load(std::memory_order_acquire)) != kVisible) {
+      continue;
+    }
+    uint64_t meta = h->meta.fetch_add(kOneRef, std::memory_order_acq_rel);
+    if (GetState(meta) == kVisible) {
+      callback(h->value, h->charge);
+    }
+    Unref(h, false);
+  }
+}
+
+void LockFreeClockCache::EraseUnRefEntries() {
+  for (size_t i = 0; i < table_size_; i++) {
+    LockFreeClockHandle* h = &table_[i];
+    uint64_t meta = h->meta.load(std::memory_order_acquire);
+    if ((GetState(meta) == kVisible || GetState(meta) == kInvisible) &&
+        GetRefs(meta) == 0 &&
+        h->meta.compare_exchange_strong(meta, kConstructionMeta,
+                                        std::memory_order_acq_rel)) {
+      FreeEntry(h);
+    }
+  }
+}
+
+std::string LockFreeClockCache::GetPrintableOptions() const {
+  std::string ret;
+  ret.reserve(20000);
+  const int kBufferSize = 200;
+  char buffer[kBufferSize];
+  snprintf(buffer, kBufferSize, "    capacity : %" ROCKSDB_PRIszt "\n",
+           GetCapacity());
+  ret.append(buffer);
+  snprintf(buffer, kBufferSize, "    table_size : %" ROCKSDB_PRIszt "\n",
+           table_size_);
+  ret.append(buffer);
+  snprintf(buffer, kBufferSize, "    strict_capacity_limit : %d\n",
+           HasStrictCapacityLimit());
+  ret.append(buffer);
+  snprintf(buffer, kBufferSize, "    memory_allocator : %s\n",
+           memory_allocator() ? memory_allocator()->Name() : "None");
+  ret.append(buffer);
+  return ret;
+}
+
+std::shared_ptr<Cache> NewLockFreeClockCache(
+    size_t capacity, size_t estimated_entry_charge, bool strict_capacity_limit,
+    std::shared_ptr<MemoryAllocator> memory_allocator) {
+  if (estimated_entry_charge == 0) {
+    return nullptr;
+  }
+  return std::make_shared<LockFreeClockCache>(
+      capacity, estimated_entry_charge, strict_capacity_limit,
+      std::move(memory_allocator));
+}
+
+}  // namespace rocksdb
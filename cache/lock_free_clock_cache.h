@@ -0,0 +1,163 @@
+//  Copyright (c) 2011-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <string>
+
+#include "rocksdb/cache.h"
+#include "util/hash.h"
+
+namespace rocksdb {
+
+// LockFreeClockCache
+//
+// A cache that never takes a lock, and is not sharded. It is meant for block
+// caches read by many threads at once, where the shard mutex of LRUCache
+// becomes the bottleneck.
+//
+// Entries are stored in a fixed-size open addressing table with double
+// hashing. The size of the table is derived from the capacity and the
+// estimated charge of an entry, so that the table is at most ~70% full when
+// the cache is. If the entries turn out to be smaller than estimated, the
+// table fills up first and entries get evicted before the capacity is
+// reached.
+//
+// Each slot has a 64 bit atomic word, "meta", that holds
+//   bits  0-59: number of references
+//   bits 60-61: CLOCK countdown
+//   bits 62-63: state of the slot, one of
+//     kEmpty: the slot is free.
+//     kConstruction: a thread owns the slot exclusively, to fill it or to
+//       free it.
+//     kVisible: the entry can be looked up.
+//     kInvisible: the entry was erased or replaced, it is freed when the last
+//       reference to it is released.
+//
+// Lookup() takes a reference with a single fetch_add on meta, and only then
+// checks that the slot is visible and holds the key; if not, the reference
+// is dropped again. Since a reference can be added to any slot at any time
+// that way, state changes of a slot are done either with a compare-and-swap
+// that expects zero references, or with an atomic add of the difference
+// between the states, so that such transient references are never lost.
+// Whoever drops the last reference of an invisible entry frees it.
+//
+// Every slot also counts the entries that were displaced past it, i.e. whose
+// probe sequence goes through the slot but which live further down. A lookup
+// stops at the first slot of the probe sequence that has none.
+//
+// Eviction follows the CLOCK algorithm: a shared hand sweeps the table, and
+// unreferenced entries are evicted once their countdown reaches zero. A hit
+// resets the countdown of the entry to its maximum.
+struct LockFreeClockHandle {
+  std::atomic<uint64_t> meta;
+  std::atomic<uint32_t> displacements;
+  // Written before the entry is published. Also read, relaxed, by lookups
+  // that did not take a reference yet, to skip mismatching slots quickly.
+  std::atomic<uint32_t> hash;
+  // Set if the entry could not be stored in the table. It then only lives
+  // as long as the handle that Insert() returned.
+  bool detached;
+  std::unique_ptr<char[]> key_data;
+  size_t key_length;
+  void* value;
+  size_t charge;
+  void (*deleter)(const Slice&, void* value);
+
+  LockFreeClockHandle()
+      : meta(0),
+        displacements(0),
+        hash(0),
+        detached(false),
+        key_length(0),
+        value(nullptr),
+        charge(0),
+        deleter(nullptr) {}
+
+  Slice key() const { return Slice(key_data.get(), key_length); }
+};
+
+class LockFreeClockCache : public Cache {
+ public:
+  LockFreeClockCache(size_t capacity, size_t estimated_entry_charge,
+                     bool strict_capacity_limit,
+                     std::shared_ptr<MemoryAllocator> memory_allocator);
+  virtual ~LockFreeClockCache();
+
+  virtual const char* Name() const override { return "LockFreeClockCache"; }
+
+  virtual Status Insert(const Slice& key, void* value, size_t charge,
+                        void (*deleter)(const Slice& key, void* value),
+                        Handle** handle = nullptr,
+                        Priority priority = Priority::LOW) override;
+  virtual Handle* Lookup(const Slice& key, Statistics* stats = nullptr) override;
+  virtual bool Ref(Handle* handle) override;
+  virtual bool Release(Handle* handle, bool force_erase = false) override;
+  virtual void* Value(Handle* handle) override;
+  virtual void Erase(const Slice& key) override;
+  virtual uint64_t NewId() override;
+  virtual void SetCapacity(size_t capacity) override;
+  virtual void SetStrictCapacityLimit(bool strict_capacity_limit) override;
+  virtual bool HasStrictCapacityLimit() const override;
+  virtual size_t GetCapacity() const override;
+  virtual size_t GetUsage() const override;
+  virtual size_t GetUsage(Handle* handle) const override;
+  virtual size_t GetPinnedUsage() const override;
+  virtual void DisownData() override;
+  virtual void ApplyToAllCacheEntries(void (*callback)(void*, size_t),
+                                      bool thread_safe) override;
+  virtual void EraseUnRefEntries() override;
+  virtual std::string GetPrintableOptions() const override;
+
+  // Number of slots in the table
+  size_t TEST_GetTableSize() const { return table_size_; }
+  // Number of entries in the table
+  size_t TEST_GetOccupancy() const {
+    return occupancy_.load(std::memory_order_relaxed);
+  }
+
+ private:
+  static inline uint32_t HashSlice(const Slice& s) {
+    return Hash(s.data(), s.size(), 0);
+  }
+
+  // Double hashing. The increment is odd, so that the probe sequence goes
+  // through all the slots of the power-of-two sized table.
+  size_t ProbeStart(uint32_t hash) const { return hash & table_mask_; }
+  size_t ProbeIncrement(uint32_t hash) const {
+    return (((hash >> 16) | (hash << 16)) | 1) & table_mask_;
+  }
+
+  // Drops a reference. If it was the last one, frees the entry if it is
+  // invisible, or if erase_if_last is set. Returns true if the entry was
+  // freed.
+  bool Unref(LockFreeClockHandle* h, bool erase_if_last);
+  // Frees an entry that is owned exclusively, i.e. in kConstruction state
+  void FreeEntry(LockFreeClockHandle* h);
+  // Makes all the visible entries for key, except `except`, invisible
+  void EraseFromTable(const Slice& key, uint32_t hash,
+                      const LockFreeClockHandle* except);
+  // Runs the CLOCK hand until `charge` more bytes and one more entry fit in
+  // the cache, or until too many slots were visited. Returns true if they
+  // fit.
+  bool EvictUntilFits(size_t charge);
+
+  const size_t table_size_;
+  const size_t table_mask_;
+  // The table may not be filled above this number of entries
+  const size_t occupancy_limit_;
+  std::unique_ptr<LockFreeClockHandle[]> table_;
+
+  std::atomic<size_t> capacity_;
+  std::atomic<bool> strict_capacity_limit_;
+  std::atomic<size_t> usage_;
+  std::atomic<size_t> occupancy_;
+  std::atomic<uint64_t> clock_hand_;
+  std::atomic<uint64_t> last_id_;
+};
+
+}  // namespace rocksdb
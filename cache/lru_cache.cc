@@ -18,6 +18,7 @@
 #include <stdlib.h>
 #include <string>
 
+#include "monitoring/statistics.h"
 #include "util/mutexlock.h"
 
 namespace rocksdb {
@@ -100,12 +101,17 @@ void LRUHandleTable::Resize() {
 }
 
 LRUCacheShard::LRUCacheShard(size_t capacity, bool strict_capacity_limit,
-                             double high_pri_pool_ratio)
+                             double high_pri_pool_ratio,
+                             bool use_admission_filter,
+                             Statistics* statistics)
     : capacity_(0),
       high_pri_pool_usage_(0),
       strict_capacity_limit_(strict_capacity_limit),
       high_pri_pool_ratio_(high_pri_pool_ratio),
       high_pri_pool_capacity_(0),
+      eviction_callback_(nullptr),
+      use_admission_filter_(use_admission_filter),
+      statistics_(statistics),
       usage_(0),
       lru_usage_(0) {
   // Make empty circular linked list
@@ -257,17 +263,38 @@ void LRUCacheShard::SetCapacity(size_t capacity) {
   // we free the entries here outside of mutex for
   // performance reasons
   for (auto entry : last_reference_list) {
+    NotifyEviction(entry);
     entry->Free();
   }
 }
 
+void LRUCacheShard::NotifyEviction(LRUHandle* e) {
+  if (eviction_callback_ != nullptr && e->helper != nullptr) {
+    (*eviction_callback_)(e->key(), e->value, e->helper);
+  }
+}
+
 void LRUCacheShard::SetStrictCapacityLimit(bool strict_capacity_limit) {
   MutexLock l(&mutex_);
   strict_capacity_limit_ = strict_capacity_limit;
 }
 
+bool LRUCacheShard::Admit(uint32_t hash, const LRUHandle* victim) {
+  // Keep the sketch sized for the number of entries that fit in the shard
+  if (table_.elems() > sketch_.capacity()) {
+    sketch_.EnsureCapacity(2 * table_.elems());
+  }
+  // On a tie, keep the entry that is already cached, so that keys read only
+  // once, e.g. by a scan, do not replace each other
+  return sketch_.Estimate(hash) > sketch_.Estimate(victim->hash);
+}
+
 Cache::Handle* LRUCacheShard::Lookup(const Slice& key, uint32_t hash) {
   MutexLock l(&mutex_);
+  if (use_admission_filter_) {
+    // Misses count too, as they are usually followed by an insertion
+    sketch_.Increment(hash);
+  }
   LRUHandle* e = table_.Lookup(key, hash);
   if (e != nullptr) {
     assert(e->InCache());
@@ -303,6 +330,7 @@ bool LRUCacheShard::Release(Cache::Handle* handle, bool force_erase) {
   }
   LRUHandle* e = reinterpret_cast<LRUHandle*>(handle);
   bool last_reference = false;
+  bool evicted = false;
   {
     MutexLock l(&mutex_);
     last_reference = Unref(e);
@@ -321,6 +349,7 @@ bool LRUCacheShard::Release(Cache::Handle* handle, bool force_erase) {
         Unref(e);
         usage_ -= e->charge;
         last_reference = true;
+        evicted = !force_erase;
       } else {
         // put the item on the list to be potentially freed
         LRU_Insert(e);
@@ -330,6 +359,9 @@ bool LRUCacheShard::Release(Cache::Handle* handle, bool force_erase) {
 
   // free outside of mutex
   if (last_reference) {
+    if (evicted) {
+      NotifyEviction(e);
+    }
     e->Free();
   }
   return last_reference;
@@ -339,6 +371,25 @@ Status LRUCacheShard::Insert(const Slice& key, uint32_t hash, void* value,
                              size_t charge,
                              void (*deleter)(const Slice& key, void* value),
                              Cache::Handle** handle, Cache::Priority priority) {
+  return InsertItem(key, hash, value, charge, deleter, nullptr /* helper */,
+                    handle, priority);
+}
+
+Status LRUCacheShard::InsertWithHelper(const Slice& key, uint32_t hash,
+                                       void* value,
+                                       const Cache::CacheItemHelper* helper,
+                                       size_t charge, Cache::Handle** handle,
+                                       Cache::Priority priority) {
+  return InsertItem(key, hash, value, charge, helper->deleter, helper, handle,
+                    priority);
+}
+
+Status LRUCacheShard::InsertItem(const Slice& key, uint32_t hash, void* value,
+                                 size_t charge,
+                                 void (*deleter)(const Slice& key, void* value),
+                                 const Cache::CacheItemHelper* helper,
+                                 Cache::Handle** handle,
+                                 Cache::Priority priority) {
   // Allocate the memory here outside of the mutex
   // If the cache is full, we'll have to release it
   // It shouldn't happen very often though.
@@ -346,9 +397,13 @@ Status LRUCacheShard::Insert(const Slice& key, uint32_t hash, void* value,
       new char[sizeof(LRUHandle) - 1 + key.size()]);
   Status s;
   autovector<LRUHandle*> last_reference_list;
+  size_t num_evicted = 0;
+  // BLOCK_CACHE_ADMISSION_* ticker to record, if the filter was consulted
+  uint32_t admission_ticker = TICKER_ENUM_MAX;
 
   e->value = value;
   e->deleter = deleter;
+  e->helper = helper;
   e->charge = charge;
   e->key_length = key.size();
   e->flags = 0;
@@ -364,11 +419,36 @@ Status LRUCacheShard::Insert(const Slice& key, uint32_t hash, void* value,
   {
     MutexLock l(&mutex_);
 
-    // Free the space following strict LRU policy until enough space
-    // is freed or the lru list is empty
-    EvictFromLRU(charge, &last_reference_list);
+    // The admission filter only applies to entries that would evict others.
+    // High priority entries are always admitted.
+    bool admitted = true;
+    if (use_admission_filter_ && priority == Cache::Priority::LOW &&
+        usage_ + charge > capacity_ && lru_.next != &lru_) {
+      admitted = Admit(hash, lru_.next);
+      admission_ticker = admitted ? BLOCK_CACHE_ADMISSION_ACCEPT
+                                  : BLOCK_CACHE_ADMISSION_REJECT;
+    }
+
+    if (admitted) {
+      // Free the space following strict LRU policy until enough space
+      // is freed or the lru list is empty
+      EvictFromLRU(charge, &last_reference_list);
+      num_evicted = last_reference_list.size();
+    }
 
-    if (usage_ - lru_usage_ + charge > capacity_ &&
+    if (!admitted) {
+      if (handle == nullptr) {
+        // As if the entry was inserted and evicted immediately
+        last_reference_list.push_back(e);
+      } else {
+        // Hand the entry out without caching it, it is freed on Release()
+        e->SetInCache(false);
+        e->refs = 1;
+        usage_ += e->charge;
+        *handle = reinterpret_cast<Cache::Handle*>(e);
+      }
+      s = Status::OK();
+    } else if (usage_ - lru_usage_ + charge > capacity_ &&
         (strict_capacity_limit_ || handle == nullptr)) {
       if (handle == nullptr) {
         // Don't insert the entry but still return ok, as if the entry inserted
@@ -406,8 +486,14 @@ Status LRUCacheShard::Insert(const Slice& key, uint32_t hash, void* value,
 
   // we free the entries here outside of mutex for
   // performance reasons
-  for (auto entry : last_reference_list) {
-    entry->Free();
+  for (size_t i = 0; i < last_reference_list.size(); i++) {
+    if (i < num_evicted) {
+      NotifyEviction(last_reference_list[i]);
+    }
+    last_reference_list[i]->Free();
+  }
+  if (admission_ticker != TICKER_ENUM_MAX) {
+    RecordTick(statistics_, admission_ticker);
   }
 
   return s;
@@ -457,21 +543,29 @@ std::string LRUCacheShard::GetPrintableOptions() const {
     snprintf(buffer, kBufferSize, "    high_pri_pool_ratio: %.3lf\n",
              high_pri_pool_ratio_);
   }
-  return std::string(buffer);
+  std::string ret(buffer);
+  snprintf(buffer, kBufferSize, "    use_admission_filter: %d\n",
+           use_admission_filter_);
+  ret.append(buffer);
+  return ret;
 }
 
 LRUCache::LRUCache(size_t capacity, int num_shard_bits,
                    bool strict_capacity_limit, double high_pri_pool_ratio,
-                   std::shared_ptr<MemoryAllocator> allocator)
+                   std::shared_ptr<MemoryAllocator> allocator,
+                   bool use_admission_filter,
+                   std::shared_ptr<Statistics> statistics)
     : ShardedCache(capacity, num_shard_bits, strict_capacity_limit,
-                   std::move(allocator)) {
+                   std::move(allocator)),
+      statistics_(std::move(statistics)) {
   num_shards_ = 1 << num_shard_bits;
   shards_ = reinterpret_cast<LRUCacheShard*>(
       port::cacheline_aligned_alloc(sizeof(LRUCacheShard) * num_shards_));
   size_t per_shard = (capacity + (num_shards_ - 1)) / num_shards_;
   for (int i = 0; i < num_shards_; i++) {
     new (&shards_[i])
-        LRUCacheShard(per_shard, strict_capacity_limit, high_pri_pool_ratio);
+        LRUCacheShard(per_shard, strict_capacity_limit, high_pri_pool_ratio,
+                      use_admission_filter, statistics_.get());
   }
 }
 
@@ -528,6 +622,23 @@ size_t LRUCache::TEST_GetLRUSize() {
   return lru_size_of_all_shards;
 }
 
+void LRUCache::SetEvictionCallback(LRUEvictionCallback eviction_callback) {
+  eviction_callback_ = std::move(eviction_callback);
+  for (int i = 0; i < num_shards_; i++) {
+    shards_[i].SetEvictionCallback(&eviction_callback_);
+  }
+}
+
+Status LRUCache::InsertWithHelper(const Slice& key, void* value,
+                                  const CacheItemHelper* helper, size_t charge,
+                                  Handle** handle, Priority priority) {
+  if (!eviction_callback_) {
+    return Insert(key, value, charge, helper->deleter, handle, priority);
+  }
+  return ShardedCache::InsertWithHelper(key, value, helper, charge, handle,
+                                        priority);
+}
+
 double LRUCache::GetHighPriPoolRatio() {
   double result = 0.0;
   if (num_shards_ > 0) {
@@ -537,29 +648,32 @@ double LRUCache::GetHighPriPoolRatio() {
 }
 
 std::shared_ptr<Cache> NewLRUCache(const LRUCacheOptions& cache_opts) {
-  return NewLRUCache(cache_opts.capacity, cache_opts.num_shard_bits,
-                     cache_opts.strict_capacity_limit,
-                     cache_opts.high_pri_pool_ratio,
-                     cache_opts.memory_allocator);
-}
-
-std::shared_ptr<Cache> NewLRUCache(
-    size_t capacity, int num_shard_bits, bool strict_capacity_limit,
-    double high_pri_pool_ratio,
-    std::shared_ptr<MemoryAllocator> memory_allocator) {
-  if (num_shard_bits >= 20) {
+  if (cache_opts.num_shard_bits >= 20) {
     return nullptr;  // the cache cannot be sharded into too many fine pieces
   }
-  if (high_pri_pool_ratio < 0.0 || high_pri_pool_ratio > 1.0) {
+  if (cache_opts.high_pri_pool_ratio < 0.0 ||
+      cache_opts.high_pri_pool_ratio > 1.0) {
     // invalid high_pri_pool_ratio
     return nullptr;
   }
+  int num_shard_bits = cache_opts.num_shard_bits;
   if (num_shard_bits < 0) {
-    num_shard_bits = GetDefaultCacheShardBits(capacity);
+    num_shard_bits = GetDefaultCacheShardBits(cache_opts.capacity);
   }
-  return std::make_shared<LRUCache>(capacity, num_shard_bits,
-                                    strict_capacity_limit, high_pri_pool_ratio,
-                                    std::move(memory_allocator));
+  return std::make_shared<LRUCache>(
+      cache_opts.capacity, num_shard_bits, cache_opts.strict_capacity_limit,
+      cache_opts.high_pri_pool_ratio, cache_opts.memory_allocator,
+      cache_opts.use_admission_filter, cache_opts.statistics);
+}
+
+std::shared_ptr<Cache> NewLRUCache(
+    size_t capacity, int num_shard_bits, bool strict_capacity_limit,
+    double high_pri_pool_ratio,
+    std::shared_ptr<MemoryAllocator> memory_allocator) {
+  return NewLRUCache(LRUCacheOptions(capacity, num_shard_bits,
+                                     strict_capacity_limit,
+                                     high_pri_pool_ratio,
+                                     std::move(memory_allocator)));
 }
 
 }  // namespace rocksdb
@@ -8,8 +8,10 @@
 // found in the LICENSE file. See the AUTHORS file for names of contributors.
 #pragma once
 
+#include <functional>
 #include <string>
 
+#include "cache/frequency_sketch.h"
 #include "cache/sharded_cache.h"
 
 #include "port/port.h"
@@ -46,6 +48,8 @@ namespace rocksdb {
 struct LRUHandle {
   void* value;
   void (*deleter)(const Slice&, void* value);
+  // Set by Cache::InsertWithHelper(), nullptr otherwise
+  const Cache::CacheItemHelper* helper;
   LRUHandle* next_hash;
   LRUHandle* next;
   LRUHandle* prev;
@@ -128,6 +132,9 @@ class LRUHandleTable {
   LRUHandle* Insert(LRUHandle* h);
   LRUHandle* Remove(const Slice& key, uint32_t hash);
 
+  // Number of entries in the table
+  uint32_t elems() const { return elems_; }
+
   template <typename T>
   void ApplyToAllCacheEntries(T func) {
     for (uint32_t i = 0; i < length_; i++) {
@@ -156,11 +163,19 @@ class LRUHandleTable {
   uint32_t elems_;
 };
 
+// Called with each entry inserted with Cache::InsertWithHelper() that the
+// cache evicts to stay within its capacity, outside of the mutex and before
+// the entry is freed. Entries that are erased or overwritten are not passed.
+typedef std::function<void(const Slice& key, void* value,
+                           const Cache::CacheItemHelper* helper)>
+    LRUEvictionCallback;
+
 // A single shard of sharded cache.
 class ALIGN_AS(CACHE_LINE_SIZE) LRUCacheShard : public CacheShard {
  public:
   LRUCacheShard(size_t capacity, bool strict_capacity_limit,
-                double high_pri_pool_ratio);
+                double high_pri_pool_ratio, bool use_admission_filter = false,
+                Statistics* statistics = nullptr);
   virtual ~LRUCacheShard();
 
   // Separate from constructor so caller can easily make an array of LRUCache
@@ -180,6 +195,10 @@ class ALIGN_AS(CACHE_LINE_SIZE) LRUCacheShard : public CacheShard {
                         void (*deleter)(const Slice& key, void* value),
                         Cache::Handle** handle,
                         Cache::Priority priority) override;
+  virtual Status InsertWithHelper(const Slice& key, uint32_t hash, void* value,
+                                  const Cache::CacheItemHelper* helper,
+                                  size_t charge, Cache::Handle** handle,
+                                  Cache::Priority priority) override;
   virtual Cache::Handle* Lookup(const Slice& key, uint32_t hash) override;
   virtual bool Ref(Cache::Handle* handle) override;
   virtual bool Release(Cache::Handle* handle,
@@ -209,7 +228,25 @@ class ALIGN_AS(CACHE_LINE_SIZE) LRUCacheShard : public CacheShard {
   //  Retrives high pri pool ratio
   double GetHighPriPoolRatio();
 
+  // Set before the cache is used, see LRUCache::SetEvictionCallback()
+  void SetEvictionCallback(const LRUEvictionCallback* eviction_callback) {
+    eviction_callback_ = eviction_callback;
+  }
+
  private:
+  Status InsertItem(const Slice& key, uint32_t hash, void* value,
+                    size_t charge,
+                    void (*deleter)(const Slice& key, void* value),
+                    const Cache::CacheItemHelper* helper,
+                    Cache::Handle** handle, Cache::Priority priority);
+
+  // Passes the evicted entry e to eviction_callback_, if any
+  void NotifyEviction(LRUHandle* e);
+
+  // Whether the entry of hash may evict the least recently used entry,
+  // victim, according to the admission filter
+  bool Admit(uint32_t hash, const LRUHandle* victim);
+
   void LRU_Remove(LRUHandle* e);
   void LRU_Insert(LRUHandle* e);
 
@@ -243,6 +280,15 @@ class ALIGN_AS(CACHE_LINE_SIZE) LRUCacheShard : public CacheShard {
   // Remember the value to avoid recomputing each time.
   double high_pri_pool_capacity_;
 
+  // Not owned, may be nullptr
+  const LRUEvictionCallback* eviction_callback_;
+
+  // See LRUCacheOptions::use_admission_filter
+  const bool use_admission_filter_;
+
+  // Not owned, may be nullptr
+  Statistics* const statistics_;
+
   // Dummy head of LRU list.
   // lru.prev is newest entry, lru.next is oldest entry.
   // LRU contains items which can be evicted, ie reference only by cache
@@ -270,6 +316,9 @@ class ALIGN_AS(CACHE_LINE_SIZE) LRUCacheShard : public CacheShard {
   // Memory size for entries residing only in the LRU list
   size_t lru_usage_;
 
+  // Frequencies of the keys looked up, if use_admission_filter_
+  FrequencySketch sketch_;
+
   // mutex_ protects the following state.
   // We don't count mutex_ as the cache's internal state so semantically we
   // don't mind mutex_ invoking the non-const actions.
@@ -280,7 +329,9 @@ class LRUCache : public ShardedCache {
  public:
   LRUCache(size_t capacity, int num_shard_bits, bool strict_capacity_limit,
            double high_pri_pool_ratio,
-           std::shared_ptr<MemoryAllocator> memory_allocator = nullptr);
+           std::shared_ptr<MemoryAllocator> memory_allocator = nullptr,
+           bool use_admission_filter = false,
+           std::shared_ptr<Statistics> statistics = nullptr);
   virtual ~LRUCache();
   virtual const char* Name() const override { return "LRUCache"; }
   virtual CacheShard* GetShard(int shard) override;
@@ -295,9 +346,22 @@ class LRUCache : public ShardedCache {
   //  Retrives high pri pool ratio
   double GetHighPriPoolRatio();
 
+  // Sets the callback called with the entries inserted with
+  // InsertWithHelper() that the cache evicts. Must be called before the
+  // cache is used.
+  void SetEvictionCallback(LRUEvictionCallback eviction_callback);
+
+  // Same as Insert() unless an eviction callback is set
+  virtual Status InsertWithHelper(const Slice& key, void* value,
+                                  const CacheItemHelper* helper, size_t charge,
+                                  Handle** handle = nullptr,
+                                  Priority priority = Priority::LOW) override;
+
  private:
   LRUCacheShard* shards_ = nullptr;
   int num_shards_ = 0;
+  LRUEvictionCallback eviction_callback_;
+  std::shared_ptr<Statistics> statistics_;
 };
 
 }  // namespace rocksdb
@@ -8,6 +8,8 @@
 #include <string>
 #include <vector>
 #include "port/port.h"
+#include "rocksdb/statistics.h"
+#include "util/string_util.h"
 #include "util/testharness.h"
 
 namespace rocksdb {
@@ -188,6 +190,107 @@ TEST_F(LRUCacheTest, EntriesWithPriority) {
   ValidateLRUList({"e", "f", "g", "Z", "d"}, 2);
 }
 
+namespace {
+void DeleteString(const Slice& /*key*/, void* value) {
+  delete reinterpret_cast<std::string*>(value);
+}
+}  // namespace
+
+TEST(LRUCacheAdmissionFilterTest, ScanDoesNotEvictHotEntries) {
+  const int kNumHotKeys = 10;
+  LRUCacheOptions cache_opts(kNumHotKeys /* capacity */, 0 /* num_shard_bits */,
+                             false /* strict_capacity_limit */,
+                             0.0 /* high_pri_pool_ratio */);
+  cache_opts.use_admission_filter = true;
+  cache_opts.statistics = CreateDBStatistics();
+  std::shared_ptr<Cache> cache = NewLRUCache(cache_opts);
+  Statistics* stats = cache_opts.statistics.get();
+
+  auto insert = [&](const std::string& key, Cache::Handle** handle,
+                    Cache::Priority priority) {
+    ASSERT_OK(cache->Insert(key, new std::string(key), 1 /* charge */,
+                            &DeleteString, handle, priority));
+  };
+  // Looks the key up like a reader does, inserting it on a miss
+  auto read = [&](const std::string& key) {
+    Cache::Handle* handle = cache->Lookup(key);
+    if (handle == nullptr) {
+      insert(key, nullptr, Cache::Priority::LOW);
+    } else {
+      cache->Release(handle);
+    }
+  };
+  auto contains = [&](const std::string& key) {
+    Cache::Handle* handle = cache->Lookup(key);
+    if (handle == nullptr) {
+      return false;
+    }
+    cache->Release(handle);
+    return true;
+  };
+
+  for (int i = 0; i < kNumHotKeys; i++) {
+    read("hot" + ToString(i));
+  }
+  ASSERT_EQ(kNumHotKeys, cache->GetUsage());
+  // Nothing was evicted yet
+  ASSERT_EQ(0, stats->getTickerCount(BLOCK_CACHE_ADMISSION_ACCEPT));
+  ASSERT_EQ(0, stats->getTickerCount(BLOCK_CACHE_ADMISSION_REJECT));
+  // The filter starts counting once the cache is full
+  read("cold");
+  ASSERT_EQ(1, stats->getTickerCount(BLOCK_CACHE_ADMISSION_REJECT));
+  for (int round = 0; round < 4; round++) {
+    for (int i = 0; i < kNumHotKeys; i++) {
+      read("hot" + ToString(i));
+    }
+  }
+
+  // Keys read once are not admitted
+  const int kNumScanKeys = 20;
+  for (int i = 0; i < kNumScanKeys; i++) {
+    read("scan" + ToString(i));
+  }
+  ASSERT_EQ(1 + kNumScanKeys,
+            stats->getTickerCount(BLOCK_CACHE_ADMISSION_REJECT));
+  ASSERT_EQ(0, stats->getTickerCount(BLOCK_CACHE_ADMISSION_ACCEPT));
+  for (int i = 0; i < kNumHotKeys; i++) {
+    ASSERT_TRUE(contains("hot" + ToString(i)));
+  }
+  ASSERT_FALSE(contains("scan0"));
+  ASSERT_EQ(kNumHotKeys, cache->GetUsage());
+
+  // A key read more often than the least recently used one replaces it
+  for (int i = 0; i < 8; i++) {
+    read("new");
+  }
+  ASSERT_EQ(1, stats->getTickerCount(BLOCK_CACHE_ADMISSION_ACCEPT));
+  ASSERT_TRUE(contains("new"));
+  ASSERT_EQ(kNumHotKeys, cache->GetUsage());
+
+  // An entry that is not admitted is still returned in its handle, without
+  // being cached
+  Cache::Handle* handle = nullptr;
+  insert("pinned", &handle, Cache::Priority::LOW);
+  ASSERT_NE(nullptr, handle);
+  ASSERT_EQ("pinned", *reinterpret_cast<std::string*>(cache->Value(handle)));
+  ASSERT_EQ(kNumHotKeys + 1, cache->GetUsage());
+  ASSERT_EQ(1, cache->GetPinnedUsage());
+  ASSERT_FALSE(contains("pinned"));
+  cache->Release(handle);
+  ASSERT_EQ(kNumHotKeys, cache->GetUsage());
+  ASSERT_EQ(0, cache->GetPinnedUsage());
+
+  // High priority entries are always admitted
+  const uint64_t num_checked =
+      stats->getTickerCount(BLOCK_CACHE_ADMISSION_ACCEPT) +
+      stats->getTickerCount(BLOCK_CACHE_ADMISSION_REJECT);
+  insert("high", nullptr, Cache::Priority::HIGH);
+  ASSERT_TRUE(contains("high"));
+  ASSERT_EQ(num_checked,
+            stats->getTickerCount(BLOCK_CACHE_ADMISSION_ACCEPT) +
+                stats->getTickerCount(BLOCK_CACHE_ADMISSION_REJECT));
+}
+
 }  // namespace rocksdb
 
 int main(int argc, char** argv) {
@@ -0,0 +1,21 @@
+# - Find liburing
+# Find the liburing library and includes
+#
+# URING_INCLUDE_DIR - where to find liburing.h, etc.
+# URING_LIBRARIES - List of libraries when using liburing.
+# URING_FOUND - True if liburing found.
+
+find_path(URING_INCLUDE_DIR
+  NAMES liburing.h
+  HINTS ${URING_ROOT_DIR}/include)
+
+find_library(URING_LIBRARIES
+  NAMES uring
+  HINTS ${URING_ROOT_DIR}/lib)
+
+include(FindPackageHandleStandardArgs)
+find_package_handle_standard_args(uring DEFAULT_MSG URING_LIBRARIES URING_INCLUDE_DIR)
+
+mark_as_advanced(
+  URING_LIBRARIES
+  URING_INCLUDE_DIR)
@@ -128,6 +128,13 @@ Status CheckCompressionSupported(const ColumnFamilyOptions& cf_options) {
           " is not linked with the binary.");
     }
   }
+  for (auto type : cf_options.adaptive_compression_types) {
+    if (!CompressionTypeSupported(type)) {
+      return Status::InvalidArgument("Compression type " +
+                                     CompressionTypeToString(type) +
+                                     " is not linked with the binary.");
+    }
+  }
   if (cf_options.compression_opts.zstd_max_train_bytes > 0) {
     if (!CompressionTypeSupported(CompressionType::kZSTD)) {
       // Dictionary trainer is available since v0.6.1, but ZSTD was marked
@@ -231,6 +238,12 @@ ColumnFamilyOptions SanitizeOptions(const ImmutableDBOptions& db_options,
   } else if (result.memtable_prefix_bloom_size_ratio < 0) {
     result.memtable_prefix_bloom_size_ratio = 0;
   }
+  // Same for the hash index
+  if (result.memtable_hash_index_size_ratio > 0.25) {
+    result.memtable_hash_index_size_ratio = 0.25;
+  } else if (result.memtable_hash_index_size_ratio < 0) {
+    result.memtable_hash_index_size_ratio = 0;
+  }
 
   if (!result.prefix_extractor) {
     assert(result.memtable_factory);
@@ -430,7 +443,8 @@ ColumnFamilyData::ColumnFamilyData(
       queued_for_compaction_(false),
       prev_compaction_needed_bytes_(0),
       allow_2pc_(db_options.allow_2pc),
-      last_memtable_id_(0) {
+      last_memtable_id_(0),
+      compression_dict_num_files_(0) {
   Ref();
 
   // Convert user defined table properties collector factories to internal ones.
@@ -539,6 +553,16 @@ ColumnFamilyData::~ColumnFamilyData() {
   }
 }
 
+void ColumnFamilyData::SetCompressionDict(uint64_t id,
+                                          const std::string& dict) {
+  std::shared_ptr<SharedCompressionDict> compression_dict(
+      new SharedCompressionDict());
+  compression_dict->id = id;
+  compression_dict->dict = dict;
+  compression_dict_ = std::move(compression_dict);
+  compression_dict_num_files_ = 0;
+}
+
 void ColumnFamilyData::SetDropped() {
   // can't drop default CF
   assert(id_ != 0);
@@ -350,6 +350,25 @@ class ColumnFamilyData {
   bool queued_for_flush() { return queued_for_flush_; }
   bool queued_for_compaction() { return queued_for_compaction_; }
 
+  // The compression dictionary shared by the output files of the bottommost
+  // level compactions, as recorded in the MANIFEST, and the number of files
+  // compressed with it since it was installed or the DB was opened.
+  // Protected by DB mutex
+  struct SharedCompressionDict {
+    uint64_t id;
+    std::string dict;
+  };
+  void SetCompressionDict(uint64_t id, const std::string& dict);
+  std::shared_ptr<const SharedCompressionDict> compression_dict() const {
+    return compression_dict_;
+  }
+  uint64_t compression_dict_num_files() const {
+    return compression_dict_num_files_;
+  }
+  void AddCompressionDictFiles(uint64_t num_files) {
+    compression_dict_num_files_ += num_files;
+  }
+
   enum class WriteStallCause {
     kNone,
     kMemtableLimit,
@@ -469,6 +488,9 @@ class ColumnFamilyData {
 
   // Directories corresponding to cf_paths.
   std::vector<std::unique_ptr<Directory>> data_dirs_;
+
+  std::shared_ptr<const SharedCompressionDict> compression_dict_;
+  uint64_t compression_dict_num_files_;
 };
 
 // ColumnFamilySet has interesting thread-safety requirements
@@ -416,6 +416,21 @@ void CompactionJob::Prepare() {
   // Is this compaction producing files at the bottommost level?
   bottommost_level_ = c->bottommost_level();
 
+  // Reuse the compression dictionary of the column family until it has
+  // compressed shared_dict_max_files files
+  const CompressionOptions& compression_opts = c->output_compression_opts();
+  if (bottommost_level_ && c->output_compression() != kNoCompression &&
+      compression_opts.shared_dict_max_files > 0 &&
+      compression_opts.max_dict_bytes > 0) {
+    db_mutex_->AssertHeld();
+    auto* cfd = c->column_family_data();
+    if (cfd->compression_dict() != nullptr &&
+        cfd->compression_dict_num_files() <
+            compression_opts.shared_dict_max_files) {
+      shared_compression_dict_ = cfd->compression_dict();
+    }
+  }
+
   if (c->ShouldFormSubcompactions()) {
     const uint64_t start_micros = env_->NowMicros();
     GenSubcompactionBoundaries();
@@ -851,7 +866,10 @@ void CompactionJob::ProcessKeyValueCompaction(SubcompactionState* sub_compact) {
           : sub_compact->compaction->output_compression_opts().max_dict_bytes;
   const int kSampleLenShift = 6;  // 2^6 = 64-byte samples
   std::set<size_t> sample_begin_offsets;
-  if (bottommost_level_ && kSampleBytes > 0) {
+  if (shared_compression_dict_ != nullptr) {
+    // All the output files are compressed with the shared dictionary
+    sub_compact->compression_dict = shared_compression_dict_->dict;
+  } else if (bottommost_level_ && kSampleBytes > 0) {
     const size_t kMaxSamples = kSampleBytes >> kSampleLenShift;
     const size_t kOutFileLen =
         static_cast<size_t>(MaxFileSizeForLevel(*mutable_cf_options,
@@ -1045,7 +1063,8 @@ void CompactionJob::ProcessKeyValueCompaction(SubcompactionState* sub_compact) {
                                      &range_del_out_stats, next_key);
       RecordDroppedKeys(range_del_out_stats,
                         &sub_compact->compaction_job_stats);
-      if (sub_compact->outputs.size() == 1) {
+      if (sub_compact->outputs.size() == 1 &&
+          shared_compression_dict_ == nullptr) {
         // Use samples from first output file to create dictionary for
         // compression of subsequent files.
         if (kUseZstdTrainer) {
@@ -1422,14 +1441,39 @@ Status CompactionJob::InstallCompactionResults(
   // Add compaction inputs
   compaction->AddInputDeletions(compact_->compaction->edit());
 
+  size_t num_output_files = 0;
   for (const auto& sub_compact : compact_->sub_compact_states) {
     for (const auto& out : sub_compact.outputs) {
       compaction->edit()->AddFile(compaction->output_level(), out.meta);
     }
+    num_output_files += sub_compact.outputs.size();
+  }
+
+  // Share the dictionary trained by the compaction with the next ones
+  auto* cfd = compaction->column_family_data();
+  const CompressionOptions& compression_opts =
+      compaction->output_compression_opts();
+  if (shared_compression_dict_ == nullptr && bottommost_level_ &&
+      compaction->output_compression() != kNoCompression &&
+      compression_opts.shared_dict_max_files > 0 &&
+      compression_opts.max_dict_bytes > 0) {
+    for (const auto& sub_compact : compact_->sub_compact_states) {
+      if (!sub_compact.compression_dict.empty()) {
+        compaction->edit()->SetCompressionDict(versions_->NewFileNumber(),
+                                               sub_compact.compression_dict);
+        break;
+      }
+    }
+  }
+
+  Status s = versions_->LogAndApply(cfd, mutable_cf_options,
+                                    compaction->edit(), db_mutex_,
+                                    db_directory_);
+  if (s.ok() && shared_compression_dict_ != nullptr &&
+      cfd->compression_dict() == shared_compression_dict_) {
+    cfd->AddCompressionDictFiles(num_output_files);
   }
-  return versions_->LogAndApply(compaction->column_family_data(),
-                                mutable_cf_options, compaction->edit(),
-                                db_mutex_, db_directory_);
+  return s;
 }
 
 void CompactionJob::RecordCompactionIOStats() {
@@ -165,6 +165,10 @@ class CompactionJob {
   EventLogger* event_logger_;
 
   bool bottommost_level_;
+  // The compression dictionary of the column family the output files are
+  // compressed with, instead of training one, if it is shared.
+  std::shared_ptr<const ColumnFamilyData::SharedCompressionDict>
+      shared_compression_dict_;
   bool paranoid_file_checks_;
   bool measure_io_stats_;
   // Stores the Slices that designate the boundaries for each subcompaction
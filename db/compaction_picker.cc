@@ -59,6 +59,26 @@ bool FindIntraL0Compaction(const std::vector<FileMetaData*>& level_files,
     }
     compact_bytes_per_del_file = new_compact_bytes_per_del_file;
   }
+  // The files of a flush split by key range have interleaving sequence
+  // numbers. Do not compact only part of them, which would leave behind a
+  // file with entries newer than the oldest ones of the output.
+  while (span_len > 1 && span_len < level_files.size()) {
+    SequenceNumber smallest_seqno = kMaxSequenceNumber;
+    for (size_t i = 0; i < span_len; ++i) {
+      smallest_seqno =
+          std::min(smallest_seqno, level_files[i]->fd.smallest_seqno);
+    }
+    if (level_files[span_len]->fd.smallest_seqno < smallest_seqno) {
+      break;
+    }
+    --span_len;
+    compact_bytes = 0;
+    for (size_t i = 0; i < span_len; ++i) {
+      compact_bytes += static_cast<size_t>(level_files[i]->fd.file_size);
+    }
+    compact_bytes_per_del_file =
+        span_len > 1 ? compact_bytes / (span_len - 1) : port::kMaxSizet;
+  }
 
   if (span_len >= min_files_to_compact &&
       compact_bytes_per_del_file < max_compact_bytes_per_del_file) {
@@ -1527,9 +1547,12 @@ bool LevelCompactionBuilder::PickIntraL0Compaction() {
   start_level_inputs_.clear();
   const std::vector<FileMetaData*>& level_files =
       vstorage_->LevelFiles(0 /* level */);
-  if (level_files.size() <
-          static_cast<size_t>(
-              mutable_cf_options_.level0_file_num_compaction_trigger + 2) ||
+  int num_sorted_runs =
+      ioptions_.max_flush_subranges > 1
+          ? vstorage_->NumLevel0SortedRuns(false /* skip_being_compacted */)
+          : static_cast<int>(level_files.size());
+  if (num_sorted_runs <
+          mutable_cf_options_.level0_file_num_compaction_trigger + 2 ||
       level_files[0]->being_compacted) {
     // If L0 isn't accumulating much files beyond the regular trigger, don't
     // resort to L0->L0 compaction yet.
@@ -790,6 +790,119 @@ TEST_F(DBBasicTest, MultiGetEmpty) {
   } while (ChangeCompactOptions());
 }
 
+TEST_F(DBBasicTest, MultiGetBatchedMultiLevel) {
+  Options options = CurrentOptions();
+  options.disable_auto_compactions = true;
+  options.target_file_size_base = 512;
+  options.merge_operator = MergeOperators::CreateStringAppendOperator();
+  BlockBasedTableOptions table_options;
+  table_options.filter_policy.reset(NewBloomFilterPolicy(10, false));
+  table_options.block_size = 64;
+  options.table_factory.reset(NewBlockBasedTableFactory(table_options));
+  CreateAndReopenWithCF({"pikachu"}, options);
+  Random rnd(301);
+
+  // Bottommost level: every even key
+  for (int cf = 0; cf < 2; ++cf) {
+    for (int i = 0; i < 200; i += 2) {
+      ASSERT_OK(Put(cf, Key(i), "L2_" + ToString(i)));
+    }
+    ASSERT_OK(Flush(cf));
+    MoveFilesToLevel(2, cf);
+    // L1: overwrite and delete some of the keys, spread over several files
+    for (int i = 0; i < 200; i += 10) {
+      ASSERT_OK(Put(cf, Key(i), "L1_" + ToString(i)));
+      ASSERT_OK(Delete(cf, Key(i + 4)));
+      if (i % 40 == 0) {
+        ASSERT_OK(Flush(cf));
+      }
+    }
+    ASSERT_OK(db_->DeleteRange(WriteOptions(), handles_[cf], Key(100),
+                               Key(120)));
+    ASSERT_OK(Flush(cf));
+    MoveFilesToLevel(1, cf);
+    // L0: overlapping files with merges
+    for (int f = 0; f < 3; ++f) {
+      for (int i = f; i < 200; i += 7) {
+        ASSERT_OK(Merge(cf, Key(i), "L0_" + ToString(f)));
+      }
+      ASSERT_OK(Flush(cf));
+    }
+    ASSERT_EQ("3,2,1", FilesPerLevel(cf));
+    // Memtable
+    for (int i = 0; i < 200; i += 13) {
+      ASSERT_OK(Put(cf, Key(i), "mem_" + ToString(i)));
+      ASSERT_OK(Delete(cf, Key(i + 3)));
+    }
+  }
+
+  std::vector<std::string> key_strs;
+  std::vector<ColumnFamilyHandle*> cfs;
+  for (int i = 0; i < 210; ++i) {
+    int cf = static_cast<int>(rnd.Uniform(2));
+    // Duplicate some keys within the same call
+    int n = rnd.OneIn(10) ? 2 : 1;
+    for (int j = 0; j < n; ++j) {
+      key_strs.push_back(Key(static_cast<int>(rnd.Uniform(205))));
+      cfs.push_back(handles_[cf]);
+    }
+  }
+  std::vector<Slice> keys(key_strs.begin(), key_strs.end());
+  std::vector<std::string> values;
+  std::vector<Status> s = db_->MultiGet(ReadOptions(), cfs, keys, &values);
+  ASSERT_EQ(keys.size(), s.size());
+  ASSERT_EQ(keys.size(), values.size());
+  for (size_t i = 0; i < keys.size(); ++i) {
+    std::string expected;
+    Status expected_s = db_->Get(ReadOptions(), cfs[i], keys[i], &expected);
+    ASSERT_EQ(expected_s.ToString(), s[i].ToString()) << key_strs[i];
+    if (expected_s.ok()) {
+      ASSERT_EQ(expected, values[i]) << key_strs[i];
+    }
+  }
+}
+
+TEST_F(DBBasicTest, MultiGetBatchedColdBlocks) {
+  Options options = CurrentOptions();
+  options.disable_auto_compactions = true;
+  options.statistics = rocksdb::CreateDBStatistics();
+  BlockBasedTableOptions table_options;
+  table_options.block_size = 64;
+  table_options.block_cache = NewLRUCache(8 << 20);
+  options.table_factory.reset(NewBlockBasedTableFactory(table_options));
+  Reopen(options);
+
+  for (int i = 0; i < 100; ++i) {
+    ASSERT_OK(Put(Key(i), "val" + ToString(i)));
+  }
+  ASSERT_OK(Flush());
+  // Start over with an empty block cache
+  table_options.block_cache = NewLRUCache(8 << 20);
+  options.table_factory.reset(NewBlockBasedTableFactory(table_options));
+  Reopen(options);
+
+  std::vector<std::string> key_strs;
+  for (int i = 0; i < 105; i += 3) {
+    key_strs.push_back(Key(i));
+  }
+  std::vector<Slice> keys(key_strs.begin(), key_strs.end());
+  std::vector<std::string> values;
+  std::vector<Status> s = db_->MultiGet(ReadOptions(), keys, &values);
+  ASSERT_EQ(keys.size(), s.size());
+  for (size_t i = 0; i < keys.size(); ++i) {
+    if (i * 3 < 100) {
+      ASSERT_OK(s[i]);
+      ASSERT_EQ("val" + ToString(i * 3), values[i]);
+    } else {
+      ASSERT_TRUE(s[i].IsNotFound());
+    }
+  }
+  // All the data blocks were read in one batch before the keys were looked
+  // up, so the lookups themselves only hit the block cache
+  ASSERT_GT(TestGetTickerCount(options, BLOCK_CACHE_DATA_ADD), 1);
+  ASSERT_EQ(0, TestGetTickerCount(options, BLOCK_CACHE_DATA_MISS));
+}
+
 TEST_F(DBBasicTest, ChecksumTest) {
   BlockBasedTableOptions table_options;
   Options options = CurrentOptions();
@@ -188,6 +188,45 @@ TEST_F(DBBlockCacheTest, TestWithoutCompressedBlockCache) {
   }
 }
 
+TEST_F(DBBlockCacheTest, TestWithCompressedTieredCache) {
+  auto table_options = GetTableOptions();
+  auto options = GetOptions(table_options);
+  InitTable(options);
+
+  CompressedTieredCacheOptions cache_opts;
+  cache_opts.capacity = 1 << 20;
+  cache_opts.compressed_tier_ratio = 0.5;
+  cache_opts.num_shard_bits = 0;
+  cache_opts.statistics = options.statistics;
+  std::shared_ptr<Cache> cache = NewCompressedTieredCache(cache_opts);
+  table_options.block_cache = cache;
+  options.table_factory.reset(new BlockBasedTableFactory(table_options));
+  Reopen(options);
+
+  // Leave room for three blocks in each tier
+  std::string value(kValueSize, 'a');
+  ASSERT_EQ(value, Get(ToString(0)));
+  size_t block_charge = cache->GetUsage();
+  ASSERT_LT(0, block_charge);
+  cache->SetCapacity(6 * block_charge);
+
+  for (size_t i = 1; i < kNumBlocks; i++) {
+    ASSERT_EQ(value, Get(ToString(i)));
+  }
+  ASSERT_EQ(kNumBlocks - 3,
+            TestGetTickerCount(options, COMPRESSED_TIER_DEMOTED));
+  ASSERT_EQ(0, TestGetTickerCount(options, COMPRESSED_TIER_HIT));
+
+  // The last blocks read are still in the uncompressed tier, the ones read
+  // before them are promoted from the compressed tier
+  RecordCacheCounters(options);
+  for (size_t i = kNumBlocks - 1; i >= kNumBlocks - 6; i--) {
+    ASSERT_EQ(value, Get(ToString(i)));
+  }
+  CheckCacheCounters(options, 0, 6, 0, 0);
+  ASSERT_EQ(3, TestGetTickerCount(options, COMPRESSED_TIER_HIT));
+}
+
 #ifdef SNAPPY
 TEST_F(DBBlockCacheTest, TestWithCompressedBlockCache) {
   ReadOptions read_options;
@@ -346,8 +385,8 @@ TEST_F(DBBlockCacheTest, IndexAndFilterBlocksStats) {
   options.statistics = rocksdb::CreateDBStatistics();
   BlockBasedTableOptions table_options;
   table_options.cache_index_and_filter_blocks = true;
-  // 200 bytes are enough to hold the first two blocks
-  std::shared_ptr<Cache> cache = NewLRUCache(200, 0, false);
+  // 256 bytes are enough to hold the first two blocks
+  std::shared_ptr<Cache> cache = NewLRUCache(256, 0, false);
   table_options.block_cache = cache;
   table_options.filter_policy.reset(NewBloomFilterPolicy(20, true));
   options.table_factory.reset(new BlockBasedTableFactory(table_options));
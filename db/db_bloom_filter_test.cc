@@ -635,6 +635,89 @@ TEST_F(DBBloomFilterTest, BloomFilterReverseCompatibility) {
   }
 }
 
+TEST_F(DBBloomFilterTest, BlockedBloomFilter) {
+  Options options = CurrentOptions();
+  options.statistics = rocksdb::CreateDBStatistics();
+  BlockBasedTableOptions table_options;
+  table_options.filter_policy.reset(NewBloomFilterPolicy(10, false));
+  options.table_factory.reset(NewBlockBasedTableFactory(table_options));
+  DestroyAndReopen(options);
+
+  // One file with each full filter format
+  const int maxKey = 10000;
+  for (int i = 0; i < maxKey; i += 4) {
+    ASSERT_OK(Put(Key(i), Key(i)));
+  }
+  Flush();
+  table_options.filter_policy.reset(NewBlockedBloomFilterPolicy(10));
+  options.table_factory.reset(NewBlockBasedTableFactory(table_options));
+  Reopen(options);
+  for (int i = 2; i < maxKey; i += 4) {
+    ASSERT_OK(Put(Key(i), Key(i)));
+  }
+  Flush();
+  ASSERT_EQ("2", FilesPerLevel());
+
+  for (int i = 0; i < maxKey; i += 2) {
+    ASSERT_EQ(Key(i), Get(Key(i)));
+  }
+  for (int i = 1; i < maxKey; i += 2) {
+    ASSERT_EQ("NOT_FOUND", Get(Key(i)));
+  }
+  // Both files filter out most of the keys they do not have: the missing
+  // keys are checked against both, the keys of the older file against the
+  // newer one.
+  ASSERT_GT(TestGetTickerCount(options, BLOOM_FILTER_USEFUL),
+            (maxKey + maxKey / 4) * 95 / 100);
+}
+
+TEST_F(DBBloomFilterTest, RibbonFilter) {
+  for (bool partition_filters : {false, true}) {
+    Options options = CurrentOptions();
+    options.statistics = rocksdb::CreateDBStatistics();
+    BlockBasedTableOptions table_options;
+    if (partition_filters) {
+      table_options.partition_filters = true;
+      table_options.index_type =
+          BlockBasedTableOptions::IndexType::kTwoLevelIndexSearch;
+      table_options.metadata_block_size = 256;
+    }
+    table_options.filter_policy.reset(NewRibbonFilterPolicy(10));
+    options.table_factory.reset(NewBlockBasedTableFactory(table_options));
+    DestroyAndReopen(options);
+
+    const int maxKey = 10000;
+    for (int i = 0; i < maxKey; i += 2) {
+      ASSERT_OK(Put(Key(i), Key(i)));
+    }
+    Flush();
+
+    // No false negatives
+    for (int i = 0; i < maxKey; i += 2) {
+      ASSERT_EQ(Key(i), Get(Key(i)));
+    }
+    ASSERT_EQ(TestGetTickerCount(options, BLOOM_FILTER_USEFUL), 0);
+
+    // About 1% false positives
+    for (int i = 1; i < maxKey; i += 2) {
+      ASSERT_EQ("NOT_FOUND", Get(Key(i)));
+    }
+    ASSERT_GT(TestGetTickerCount(options, BLOOM_FILTER_USEFUL),
+              maxKey / 2 * 98 / 100);
+
+    // Filters of another policy are not used
+    table_options.filter_policy.reset(NewBloomFilterPolicy(10, false));
+    options.table_factory.reset(NewBlockBasedTableFactory(table_options));
+    options.statistics = rocksdb::CreateDBStatistics();
+    Reopen(options);
+    for (int i = 0; i < maxKey; i += 2) {
+      ASSERT_EQ(Key(i), Get(Key(i)));
+    }
+    ASSERT_EQ("NOT_FOUND", Get(Key(1)));
+    ASSERT_EQ(TestGetTickerCount(options, BLOOM_FILTER_USEFUL), 0);
+  }
+}
+
 namespace {
 // A wrapped bloom over default FilterPolicy
 class WrappedBloom : public FilterPolicy {
@@ -290,6 +290,107 @@ TEST_F(DBFlushTest, ManualFlushFailsInReadOnlyMode) {
   Close();
 }
 
+#ifndef ROCKSDB_LITE
+TEST_F(DBFlushTest, FlushSplitByKeyRange) {
+  Options options = CurrentOptions();
+  options.disable_auto_compactions = true;
+  options.level0_file_num_compaction_trigger = 2;
+  options.max_flush_subranges = 4;
+  Reopen(options);
+
+  SyncPoint::GetInstance()->SetCallBack(
+      "FlushJob::GenerateSubrangeBoundaries:MinSubrangeSize",
+      [](void* arg) { *static_cast<uint64_t*>(arg) = 4 << 10; });
+  SyncPoint::GetInstance()->EnableProcessing();
+
+  Random rnd(301);
+  const int kNumKeys = 2000;
+  std::map<std::string, std::string> model;
+  std::vector<std::pair<const Snapshot*, std::map<std::string, std::string>>>
+      snapshots;
+  auto verify = [&]() {
+    for (int i = 0; i < kNumKeys; i++) {
+      auto it = model.find(Key(i));
+      ASSERT_EQ(it == model.end() ? "NOT_FOUND" : it->second, Get(Key(i)));
+    }
+    for (const auto& snapshot : snapshots) {
+      ReadOptions ro;
+      ro.snapshot = snapshot.first;
+      std::unique_ptr<Iterator> iter(db_->NewIterator(ro));
+      auto expected = snapshot.second.begin();
+      for (iter->SeekToFirst(); iter->Valid(); iter->Next(), expected++) {
+        ASSERT_TRUE(expected != snapshot.second.end());
+        ASSERT_EQ(expected->first, iter->key().ToString());
+        ASSERT_EQ(expected->second, iter->value().ToString());
+      }
+      ASSERT_OK(iter->status());
+      ASSERT_TRUE(expected == snapshot.second.end());
+    }
+  };
+  auto verify_l0_files_disjoint = [&]() {
+    std::vector<LiveFileMetaData> metadata;
+    db_->GetLiveFilesMetaData(&metadata);
+    std::sort(metadata.begin(), metadata.end(),
+              [&](const LiveFileMetaData& a, const LiveFileMetaData& b) {
+                return a.smallestkey < b.smallestkey;
+              });
+    for (size_t i = 1; i < metadata.size(); i++) {
+      // A range tombstone clipped to the end of a key range ends right
+      // before the first key of the next one
+      ASSERT_LE(metadata[i - 1].largestkey, metadata[i].smallestkey);
+    }
+  };
+
+  for (int round = 0; round < 3; round++) {
+    for (int i = 0; i < kNumKeys; i++) {
+      int key = rnd.Uniform(kNumKeys);
+      if (rnd.OneIn(10)) {
+        ASSERT_OK(Delete(Key(key)));
+        model.erase(Key(key));
+      } else {
+        std::string value = RandomString(&rnd, 100);
+        ASSERT_OK(Put(Key(key), value));
+        model[Key(key)] = value;
+      }
+      if (i == kNumKeys / 2) {
+        snapshots.emplace_back(db_->GetSnapshot(), model);
+        int begin = rnd.Uniform(kNumKeys);
+        int end = std::min(begin + static_cast<int>(rnd.Uniform(kNumKeys / 2)),
+                           kNumKeys);
+        ASSERT_OK(db_->DeleteRange(WriteOptions(), db_->DefaultColumnFamily(),
+                                   Key(begin), Key(end)));
+        model.erase(model.lower_bound(Key(begin)), model.lower_bound(Key(end)));
+      }
+    }
+    ASSERT_OK(Flush());
+    if (round == 0) {
+      ASSERT_EQ(4, NumTableFilesAtLevel(0));
+      verify_l0_files_disjoint();
+    }
+    // The files of a flush count as a single sorted run for the L0 triggers
+    uint64_t compaction_pending = 0;
+    ASSERT_TRUE(db_->GetIntProperty(DB::Properties::kCompactionPending,
+                                    &compaction_pending));
+    ASSERT_EQ(round == 0 ? 0 : 1, compaction_pending);
+    verify();
+  }
+  ASSERT_EQ(12, NumTableFilesAtLevel(0));
+
+  ASSERT_OK(db_->CompactRange(CompactRangeOptions(), nullptr, nullptr));
+  ASSERT_EQ(0, NumTableFilesAtLevel(0));
+  verify();
+
+  for (const auto& snapshot : snapshots) {
+    db_->ReleaseSnapshot(snapshot.first);
+  }
+  snapshots.clear();
+  Reopen(options);
+  verify();
+  SyncPoint::GetInstance()->DisableProcessing();
+  SyncPoint::GetInstance()->ClearAllCallBacks();
+}
+#endif  // ROCKSDB_LITE
+
 TEST_P(DBAtomicFlushTest, ManualAtomicFlush) {
   Options options = CurrentOptions();
   options.create_if_missing = true;
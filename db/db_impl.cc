@@ -18,6 +18,7 @@
 
 #include <algorithm>
 #include <cstdio>
+#include <deque>
 #include <map>
 #include <set>
 #include <stdexcept>
@@ -76,6 +77,7 @@
 #include "table/block.h"
 #include "table/block_based_table_factory.h"
 #include "table/merging_iterator.h"
+#include "table/multiget_context.h"
 #include "table/table_builder.h"
 #include "table/two_level_iterator.h"
 #include "tools/sst_dump_tool_imp.h"
@@ -240,6 +242,7 @@ DBImpl::DBImpl(const DBOptions& options, const std::string& dbname,
                                  &write_controller_));
   column_family_memtables_.reset(
       new ColumnFamilyMemTablesImpl(versions_->GetColumnFamilySet()));
+  write_watermark_.reset(new WriteWatermark(versions_.get()));
 
   DumpRocksDBBuildVersion(immutable_db_options_.info_log.get());
   DumpDBFileSummary(immutable_db_options_, dbname_);
@@ -1365,9 +1368,6 @@ std::vector<Status> DBImpl::MultiGet(
   }
   mutex_.Unlock();
 
-  // Contain a list of merge operations if merge occurs.
-  MergeContext merge_context;
-
   // Note: this always resizes the values array
   size_t num_keys = keys.size();
   std::vector<Status> stat_list(num_keys);
@@ -1377,50 +1377,99 @@ std::vector<Status> DBImpl::MultiGet(
   uint64_t bytes_read = 0;
   PERF_TIMER_STOP(get_snapshot_time);
 
-  // For each of the given keys, apply the entire "get" process as follows:
-  // First look in the memtable, then in the immutable memtable (if any).
-  // s is both in/out. When in, s could either be OK or MergeInProgress.
-  // merge_operands will contain the sequence of merges in the latter case.
-  size_t num_found = 0;
+  // The keys are looked up in batches, one per column family. Within a batch
+  // the keys are sorted, so that the memtables and every SST file are
+  // searched in key order and each file is visited at most once per batch.
+  std::deque<KeyContext> key_context;
+  std::vector<PinnableSlice> pinnable_vals(num_keys);
+  std::vector<size_t> sorted_keys(num_keys);
   for (size_t i = 0; i < num_keys; ++i) {
-    merge_context.Clear();
-    Status& s = stat_list[i];
-    std::string* value = &(*values)[i];
-
-    LookupKey lkey(keys[i], snapshot);
-    auto cfh = reinterpret_cast<ColumnFamilyHandleImpl*>(column_family[i]);
-    SequenceNumber max_covering_tombstone_seq = 0;
-    auto mgd_iter = multiget_cf_data.find(cfh->cfd()->GetID());
+    key_context.emplace_back(keys[i], snapshot, &pinnable_vals[i],
+                             &stat_list[i]);
+    sorted_keys[i] = i;
+  }
+  std::sort(sorted_keys.begin(), sorted_keys.end(),
+            [&](size_t lhs, size_t rhs) {
+              auto lhs_cfd =
+                  reinterpret_cast<ColumnFamilyHandleImpl*>(column_family[lhs])
+                      ->cfd();
+              auto rhs_cfd =
+                  reinterpret_cast<ColumnFamilyHandleImpl*>(column_family[rhs])
+                      ->cfd();
+              if (lhs_cfd->GetID() != rhs_cfd->GetID()) {
+                return lhs_cfd->GetID() < rhs_cfd->GetID();
+              }
+              return lhs_cfd->user_comparator()->Compare(keys[lhs],
+                                                         keys[rhs]) < 0;
+            });
+
+  bool skip_memtable =
+      (read_options.read_tier == kPersistedTier &&
+       has_unpersisted_data_.load(std::memory_order_relaxed));
+  size_t batch_start = 0;
+  while (batch_start < num_keys) {
+    auto cfd = reinterpret_cast<ColumnFamilyHandleImpl*>(
+                   column_family[sorted_keys[batch_start]])
+                   ->cfd();
+    auto mgd_iter = multiget_cf_data.find(cfd->GetID());
     assert(mgd_iter != multiget_cf_data.end());
-    auto mgd = mgd_iter->second;
-    auto super_version = mgd->super_version;
-    bool skip_memtable =
-        (read_options.read_tier == kPersistedTier &&
-         has_unpersisted_data_.load(std::memory_order_relaxed));
-    bool done = false;
-    if (!skip_memtable) {
-      if (super_version->mem->Get(lkey, value, &s, &merge_context,
-                                  &max_covering_tombstone_seq, read_options)) {
-        done = true;
-        RecordTick(stats_, MEMTABLE_HIT);
-      } else if (super_version->imm->Get(lkey, value, &s, &merge_context,
-                                         &max_covering_tombstone_seq,
-                                         read_options)) {
-        done = true;
-        RecordTick(stats_, MEMTABLE_HIT);
+    auto super_version = mgd_iter->second->super_version;
+
+    // For each of the keys of the batch, first look in the memtable, then in
+    // the immutable memtable (if any). s is both in/out. When in, s could
+    // either be OK or MergeInProgress. merge_operands will contain the
+    // sequence of merges in the latter case.
+    MultiGetRange memtable_range;
+    size_t batch_end = batch_start;
+    for (; batch_end < num_keys; ++batch_end) {
+      size_t idx = sorted_keys[batch_end];
+      if (reinterpret_cast<ColumnFamilyHandleImpl*>(column_family[idx])
+              ->cfd() != cfd) {
+        break;
       }
+      memtable_range.push_back(&key_context[idx]);
     }
-    if (!done) {
-      PinnableSlice pinnable_val;
+    MultiGetRange sst_range;
+    if (skip_memtable) {
+      sst_range = memtable_range;
+    } else {
+      MultiGetRange imm_range;
+      for (auto* key : memtable_range) {
+        if (super_version->mem->Get(key->lkey, key->value->GetSelf(), key->s,
+                                    &key->merge_context,
+                                    &key->max_covering_tombstone_seq,
+                                    read_options)) {
+          key->value->PinSelf();
+          RecordTick(stats_, MEMTABLE_HIT);
+        } else if (key->s->ok() || key->s->IsMergeInProgress()) {
+          imm_range.push_back(key);
+        }
+      }
+      for (auto* key : imm_range) {
+        if (super_version->imm->Get(key->lkey, key->value->GetSelf(), key->s,
+                                    &key->merge_context,
+                                    &key->max_covering_tombstone_seq,
+                                    read_options)) {
+          key->value->PinSelf();
+          RecordTick(stats_, MEMTABLE_HIT);
+        } else if (key->s->ok() || key->s->IsMergeInProgress()) {
+          sst_range.push_back(key);
+        }
+      }
+    }
+    if (!sst_range.empty()) {
       PERF_TIMER_GUARD(get_from_output_files_time);
-      super_version->current->Get(read_options, lkey, &pinnable_val, &s,
-                                  &merge_context, &max_covering_tombstone_seq);
-      value->assign(pinnable_val.data(), pinnable_val.size());
-      RecordTick(stats_, MEMTABLE_MISS);
+      super_version->current->MultiGet(read_options, &sst_range);
+      RecordTick(stats_, MEMTABLE_MISS, sst_range.size());
     }
+    batch_start = batch_end;
+  }
 
-    if (s.ok()) {
-      bytes_read += value->size();
+  size_t num_found = 0;
+  for (size_t i = 0; i < num_keys; ++i) {
+    if (stat_list[i].ok()) {
+      (*values)[i].assign(pinnable_vals[i].data(), pinnable_vals[i].size());
+      bytes_read += (*values)[i].size();
       num_found++;
     }
   }
@@ -1673,6 +1722,7 @@ Status DBImpl::DropColumnFamilyImpl(ColumnFamilyHandle* column_family) {
       // we drop column family from a single write thread
       WriteThread::Writer w;
       write_thread_.EnterUnbatched(&w, &mutex_);
+      WaitForPendingWrites();
       s = versions_->LogAndApply(cfd, *cfd->GetLatestMutableCFOptions(), &edit,
                                  &mutex_);
       write_thread_.ExitUnbatched(&w);
@@ -3114,6 +3164,7 @@ Status DBImpl::IngestExternalFile(
     if (two_write_queues_) {
       nonmem_write_thread_.EnterUnbatched(&nonmem_w, &mutex_);
     }
+    WaitForPendingWrites();
 
     num_running_ingest_file_++;
 
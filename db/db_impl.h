@@ -39,6 +39,7 @@
 #include "db/wal_manager.h"
 #include "db/write_controller.h"
 #include "db/write_thread.h"
+#include "db/write_watermark.h"
 #include "memtable_list.h"
 #include "monitoring/instrumented_mutex.h"
 #include "options/db_options.h"
@@ -799,6 +800,18 @@ class DBImpl : public DB {
                             bool disable_memtable = false,
                             uint64_t* seq_used = nullptr);
 
+  Status UnorderedWriteImpl(const WriteOptions& options, WriteBatch* updates,
+                            WriteCallback* callback = nullptr,
+                            uint64_t* log_used = nullptr, uint64_t log_ref = 0,
+                            bool disable_memtable = false,
+                            uint64_t* seq_used = nullptr);
+
+  // With unordered_write, waits for the writers that left the write queue to
+  // finish inserting into the memtables. Releases mutex_ while waiting.
+  // REQUIRES: mutex_ is held, and this thread is at the front of the writer
+  // queue, so that no new writer gets pending
+  void WaitForPendingWrites();
+
   // batch_cnt is expected to be non-zero in seq_per_batch mode and indicates
   // the number of sub-patches. A sub-patch is a subset of the write batch that
   // does not have duplicate keys.
@@ -961,6 +974,20 @@ class DBImpl : public DB {
   Status WriteLevel0TableForRecovery(int job_id, ColumnFamilyData* cfd,
                                      MemTable* mem, VersionEdit* edit);
 
+  // Flushes the memtables of cfds with WriteLevel0TableForRecovery(), with
+  // up to wal_recovery_threads threads, into the edits of version_edits.
+  Status WriteLevel0TablesForRecovery(
+      int job_id, const autovector<ColumnFamilyData*>& cfds,
+      std::unordered_map<int, VersionEdit>* version_edits);
+
+  // Inserts write batches recovered from log_number into the memtables
+  // concurrently, with up to wal_recovery_threads threads. Returns the error
+  // of the first batch that failed, and its size in *failed_batch_size.
+  // REQUIRES: WriteBatchInternal::HasOnlyPointUpdates() of each batch
+  Status InsertRecoveredBatches(const std::vector<WriteBatch>& batches,
+                                uint64_t log_number, bool* has_valid_writes,
+                                size_t* failed_batch_size);
+
   // Restore alive_log_files_ and total_log_size_ after recovery.
   // It needs to run only when there's no flush during recovery
   // (e.g. avoid_flush_during_recovery=true). May also trigger flush
@@ -1304,6 +1331,9 @@ class DBImpl : public DB {
   // in 2PC to batch the prepares separately from the serial commit.
   WriteThread nonmem_write_thread_;
 
+  // Publishes LastSequence with unordered_write
+  std::unique_ptr<WriteWatermark> write_watermark_;
+
   WriteController write_controller_;
 
   std::unique_ptr<RateLimiter> low_pri_write_rate_limiter_;
@@ -199,6 +199,10 @@ Status DBImpl::FlushMemTableToOutputFile(
       std::string file_path = MakeTableFileName(
           cfd->ioptions()->cf_paths[0].path, file_meta.fd.GetNumber());
       sfm->OnAddFile(file_path);
+      for (const auto& meta : flush_job.GetSubrangeFiles()) {
+        sfm->OnAddFile(MakeTableFileName(cfd->ioptions()->cf_paths[0].path,
+                                         meta.fd.GetNumber()));
+      }
       if (sfm->IsMaxAllowedSpaceReached()) {
         Status new_bg_error = Status::SpaceLimit("Max allowed space was reached");
         TEST_SYNC_POINT_CALLBACK(
@@ -422,6 +426,10 @@ Status DBImpl::AtomicFlushMemTablesToOutputFiles(
         std::string file_path = MakeTableFileName(
             cfds[i]->ioptions()->cf_paths[0].path, file_meta[i].fd.GetNumber());
         sfm->OnAddFile(file_path);
+        for (const auto& meta : jobs[i].GetSubrangeFiles()) {
+          sfm->OnAddFile(MakeTableFileName(
+              cfds[i]->ioptions()->cf_paths[0].path, meta.fd.GetNumber()));
+        }
         if (sfm->IsMaxAllowedSpaceReached() &&
             error_handler_.GetBGError().ok()) {
           Status new_bg_error =
@@ -1437,6 +1445,7 @@ Status DBImpl::FlushMemTable(ColumnFamilyData* cfd,
     if (!writes_stopped) {
       write_thread_.EnterUnbatched(&w, &mutex_);
     }
+    WaitForPendingWrites();
 
     if (cfd->imm()->NumNotFlushed() != 0 || !cfd->mem()->IsEmpty() ||
         !cached_recoverable_state_empty_.load()) {
@@ -1505,6 +1514,7 @@ Status DBImpl::AtomicFlushMemTables(
     if (!writes_stopped) {
       write_thread_.EnterUnbatched(&w, &mutex_);
     }
+    WaitForPendingWrites();
 
     for (auto cfd : column_family_datas) {
       if (cfd->IsDropped()) {
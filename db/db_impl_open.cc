@@ -15,11 +15,13 @@
 
 #include "db/builder.h"
 #include "db/error_handler.h"
+#include "db/wal_prefetcher.h"
 #include "options/options_helper.h"
 #include "rocksdb/wal_filter.h"
 #include "table/block_based_table_factory.h"
 #include "util/rate_limiter.h"
 #include "util/sst_file_manager_impl.h"
+#include "util/streaming_compression.h"
 #include "util/sync_point.h"
 
 namespace rocksdb {
@@ -192,6 +194,25 @@ static Status ValidateOptions(
     }
   }
 
+  if (db_options.unordered_write) {
+    if (!db_options.allow_concurrent_memtable_write) {
+      return Status::InvalidArgument(
+          "unordered_write requires allow_concurrent_memtable_write. ");
+    }
+    if (db_options.enable_pipelined_write || db_options.two_write_queues) {
+      return Status::NotSupported(
+          "unordered_write is not compatible with enable_pipelined_write or "
+          "two_write_queues. ");
+    }
+  }
+
+  if (db_options.wal_compression != kNoCompression &&
+      !StreamingCompressionTypeSupported(db_options.wal_compression)) {
+    return Status::NotSupported(
+        "wal_compression must be kZSTD, kLZ4Compression or kZlibCompression, "
+        "and supported by this build. ");
+  }
+
   if (db_options.db_paths.size() > 4) {
     return Status::NotSupported(
         "More than four DB paths are not supported yet. ");
@@ -216,8 +237,17 @@ static Status ValidateOptions(
     return Status::InvalidArgument("keep_log_file_num must be greater than 0");
   }
 
+  if (db_options.wal_recovery_threads < 1) {
+    return Status::InvalidArgument(
+        "wal_recovery_threads must be greater than 0");
+  }
+
   return Status::OK();
 }
+
+// The maximum size of the groups of write batches that recovery inserts into
+// the memtables concurrently
+const size_t kMaxRecoveryBatchGroupBytes = 1 << 20;
 } // namespace
 Status DBImpl::NewDB() {
   VersionEdit new_db;
@@ -485,21 +515,6 @@ Status DBImpl::Recover(
 // REQUIRES: log_numbers are sorted in ascending order
 Status DBImpl::RecoverLogFiles(const std::vector<uint64_t>& log_numbers,
                                SequenceNumber* next_sequence, bool read_only) {
-  struct LogReporter : public log::Reader::Reporter {
-    Env* env;
-    Logger* info_log;
-    const char* fname;
-    Status* status;  // nullptr if immutable_db_options_.paranoid_checks==false
-    virtual void Corruption(size_t bytes, const Status& s) override {
-      ROCKS_LOG_WARN(info_log, "%s%s: dropping %d bytes; %s",
-                     (this->status == nullptr ? "(ignoring error) " : ""),
-                     fname, static_cast<int>(bytes), s.ToString().c_str());
-      if (this->status != nullptr && this->status->ok()) {
-        *this->status = s;
-      }
-    }
-  };
-
   mutex_.AssertHeld();
   Status status;
   std::unordered_map<int, VersionEdit> version_edits;
@@ -542,6 +557,93 @@ Status DBImpl::RecoverLogFiles(const std::vector<uint64_t>& log_numbers,
   bool stop_replay_for_corruption = false;
   bool flushed = false;
   uint64_t corrupted_log_number = kMaxSequenceNumber;
+
+  // With several recovery threads, the write batches that only hold point
+  // updates are gathered into groups of consecutive batches, which are
+  // inserted into the memtables concurrently.
+  const bool concurrent_inserts =
+      immutable_db_options_.wal_recovery_threads > 1 &&
+      immutable_db_options_.allow_concurrent_memtable_write && !seq_per_batch_;
+  std::vector<WriteBatch> batch_group;
+  size_t batch_group_bytes = 0;
+  // A memtable is only flushed once the group that filled it up is inserted,
+  // so groups are kept small next to the write buffers. The memtables then
+  // fill up about as when the batches are inserted one by one.
+  size_t max_batch_group_bytes = kMaxRecoveryBatchGroupBytes;
+  for (auto cfd : *versions_->GetColumnFamilySet()) {
+    max_batch_group_bytes = std::min(
+        max_batch_group_bytes,
+        cfd->GetLatestMutableCFOptions()->write_buffer_size / 8);
+  }
+
+  std::vector<uint64_t> logs_to_read;
+  for (auto log_number : log_numbers) {
+    if (log_number >= versions_->min_log_number_to_keep_2pc()) {
+      logs_to_read.push_back(log_number);
+    }
+  }
+  WalPrefetcher prefetcher(immutable_db_options_, env_,
+                           env_->OptimizeForLogRead(env_options_),
+                           logs_to_read,
+                           immutable_db_options_.wal_recovery_threads > 1,
+                           concurrent_inserts);
+
+  // Flushes the memtables that filled up while replaying log_number
+  auto flush_scheduled_memtables = [&](uint64_t log_number) {
+#ifdef NDEBUG
+    (void)log_number;
+#endif
+    // we can do this because this is called before client has access to the
+    // DB and there is only a single thread operating on DB
+    autovector<ColumnFamilyData*> cfds;
+    ColumnFamilyData* cfd;
+    while ((cfd = flush_scheduler_.TakeNextColumnFamily()) != nullptr) {
+      cfd->Unref();
+      // If this asserts, it means that InsertInto failed in
+      // filtering updates to already-flushed column families
+      assert(cfd->GetLogNumber() <= log_number);
+      cfds.push_back(cfd);
+    }
+    if (cfds.empty()) {
+      return Status::OK();
+    }
+    Status s = WriteLevel0TablesForRecovery(job_id, cfds, &version_edits);
+    if (s.ok()) {
+      flushed = true;
+      for (auto flushed_cfd : cfds) {
+        flushed_cfd->CreateNewMemtable(
+            *flushed_cfd->GetLatestMutableCFOptions(), *next_sequence);
+      }
+    }
+    return s;
+  };
+
+  // Inserts batch_group into the memtables. A batch that fails to insert is
+  // reported into status, like in the single threaded case, while the
+  // returned status is the error of a flush that must fail the recovery.
+  auto insert_batch_group = [&](uint64_t log_number,
+                                WalRecoveryReporter* reporter) {
+    if (batch_group.empty()) {
+      return Status::OK();
+    }
+    bool has_valid_writes = false;
+    size_t failed_batch_size = 0;
+    Status s = InsertRecoveredBatches(batch_group, log_number,
+                                      &has_valid_writes, &failed_batch_size);
+    batch_group.clear();
+    batch_group_bytes = 0;
+    MaybeIgnoreError(&s);
+    if (!s.ok()) {
+      status = s;
+      reporter->Corruption(failed_batch_size, status);
+      return Status::OK();
+    }
+    if (has_valid_writes && !read_only) {
+      return flush_scheduled_memtables(log_number);
+    }
+    return Status::OK();
+  };
+
   for (auto log_number : log_numbers) {
     if (log_number < versions_->min_log_number_to_keep_2pc()) {
       ROCKS_LOG_INFO(immutable_db_options_.info_log,
@@ -573,27 +675,21 @@ Status DBImpl::RecoverLogFiles(const std::vector<uint64_t>& log_numbers,
       continue;
     }
 
-    std::unique_ptr<SequentialFileReader> file_reader;
-    {
-      std::unique_ptr<SequentialFile> file;
-      status = env_->NewSequentialFile(fname, &file,
-                                       env_->OptimizeForLogRead(env_options_));
+    status = prefetcher.StartLog(log_number);
+    if (!status.ok()) {
+      MaybeIgnoreError(&status);
       if (!status.ok()) {
-        MaybeIgnoreError(&status);
-        if (!status.ok()) {
-          return status;
-        } else {
-          // Fail with one log file, but that's ok.
-          // Try next one.
-          continue;
-        }
+        return status;
+      } else {
+        // Fail with one log file, but that's ok.
+        // Try next one.
+        continue;
       }
-      file_reader.reset(new SequentialFileReader(std::move(file), fname));
     }
 
-    // Create the log reader.
-    LogReporter reporter;
-    reporter.env = env_;
+    // Create the log reporter. The corruptions found while reading the log
+    // are reported by the prefetcher, into prefetcher.status().
+    WalRecoveryReporter reporter;
     reporter.info_log = immutable_db_options_.info_log.get();
     reporter.fname = fname.c_str();
     if (!immutable_db_options_.paranoid_checks ||
@@ -603,30 +699,13 @@ Status DBImpl::RecoverLogFiles(const std::vector<uint64_t>& log_numbers,
     } else {
       reporter.status = &status;
     }
-    // We intentially make log::Reader do checksumming even if
-    // paranoid_checks==false so that corruptions cause entire commits
-    // to be skipped instead of propagating bad information (like overly
-    // large sequence numbers).
-    log::Reader reader(immutable_db_options_.info_log, std::move(file_reader),
-                       &reporter, true /*checksum*/, log_number,
-                       false /* retry_after_eof */);
 
-    // Determine if we should tolerate incomplete records at the tail end of the
     // Read all the records and add to a memtable
-    std::string scratch;
-    Slice record;
     WriteBatch batch;
+    bool only_point_updates = false;
 
-    while (!stop_replay_by_wal_filter &&
-           reader.ReadRecord(&record, &scratch,
-                             immutable_db_options_.wal_recovery_mode) &&
-           status.ok()) {
-      if (record.size() < WriteBatchInternal::kHeader) {
-        reporter.Corruption(record.size(),
-                            Status::Corruption("log record too small"));
-        continue;
-      }
-      WriteBatchInternal::SetContents(&batch, record);
+    while (!stop_replay_by_wal_filter && status.ok() &&
+           prefetcher.ReadBatch(&batch, &only_point_updates)) {
       SequenceNumber sequence = WriteBatchInternal::Sequence(&batch);
 
       if (immutable_db_options_.wal_recovery_mode ==
@@ -670,7 +749,8 @@ Status DBImpl::RecoverLogFiles(const std::vector<uint64_t>& log_numbers,
                                    immutable_db_options_.wal_filter->Name());
             MaybeIgnoreError(&status);
             if (!status.ok()) {
-              reporter.Corruption(record.size(), status);
+              reporter.Corruption(WriteBatchInternal::ByteSize(&batch),
+                                  status);
               continue;
             }
             break;
@@ -717,10 +797,35 @@ Status DBImpl::RecoverLogFiles(const std::vector<uint64_t>& log_numbers,
           WriteBatchInternal::SetSequence(&new_batch,
                                           WriteBatchInternal::Sequence(&batch));
           batch = new_batch;
+          only_point_updates =
+              concurrent_inserts &&
+              WriteBatchInternal::HasOnlyPointUpdates(&batch);
         }
       }
 #endif  // ROCKSDB_LITE
 
+      if (concurrent_inserts && only_point_updates) {
+        // Such a batch uses one sequence number per update
+        *next_sequence = sequence + WriteBatchInternal::Count(&batch);
+        batch_group_bytes += WriteBatchInternal::ByteSize(&batch);
+        batch_group.push_back(std::move(batch));
+        if (batch_group_bytes >= max_batch_group_bytes) {
+          Status s = insert_batch_group(log_number, &reporter);
+          if (!s.ok()) {
+            return s;
+          }
+        }
+        continue;
+      }
+      // The batches before this one must be in the memtables first
+      Status s = insert_batch_group(log_number, &reporter);
+      if (!s.ok()) {
+        return s;
+      }
+      if (!status.ok()) {
+        break;
+      }
+
       // If column family was not found, it might mean that the WAL write
       // batch references to the column family that was dropped after the
       // insert. We don't want to fail the whole write batch in that case --
@@ -735,36 +840,28 @@ Status DBImpl::RecoverLogFiles(const std::vector<uint64_t>& log_numbers,
       if (!status.ok()) {
         // We are treating this as a failure while reading since we read valid
         // blocks that do not form coherent data
-        reporter.Corruption(record.size(), status);
+        reporter.Corruption(WriteBatchInternal::ByteSize(&batch), status);
         continue;
       }
 
       if (has_valid_writes && !read_only) {
-        // we can do this because this is called before client has access to the
-        // DB and there is only a single thread operating on DB
-        ColumnFamilyData* cfd;
-
-        while ((cfd = flush_scheduler_.TakeNextColumnFamily()) != nullptr) {
-          cfd->Unref();
-          // If this asserts, it means that InsertInto failed in
-          // filtering updates to already-flushed column families
-          assert(cfd->GetLogNumber() <= log_number);
-          auto iter = version_edits.find(cfd->GetID());
-          assert(iter != version_edits.end());
-          VersionEdit* edit = &iter->second;
-          status = WriteLevel0TableForRecovery(job_id, cfd, cfd->mem(), edit);
-          if (!status.ok()) {
-            // Reflect errors immediately so that conditions like full
-            // file-systems cause the DB::Open() to fail.
-            return status;
-          }
-          flushed = true;
-
-          cfd->CreateNewMemtable(*cfd->GetLatestMutableCFOptions(),
-                                 *next_sequence);
+        status = flush_scheduled_memtables(log_number);
+        if (!status.ok()) {
+          // Reflect errors immediately so that conditions like full
+          // file-systems cause the DB::Open() to fail.
+          return status;
         }
       }
     }
+    {
+      Status s = insert_batch_group(log_number, &reporter);
+      if (!s.ok()) {
+        return s;
+      }
+    }
+    if (status.ok()) {
+      status = prefetcher.status();
+    }
 
     if (!status.ok()) {
       if (status.IsNotSupported()) {
@@ -832,7 +929,40 @@ Status DBImpl::RecoverLogFiles(const std::vector<uint64_t>& log_numbers,
     // no need to refcount since client still doesn't have access
     // to the DB and can not drop column families while we iterate
     auto max_log_number = log_numbers.back();
+
+    // flush the final memtables (if non-empty), in parallel across column
+    // families
+    autovector<ColumnFamilyData*> cfds_to_flush;
+    for (auto cfd : *versions_->GetColumnFamilySet()) {
+      if (cfd->GetLogNumber() > max_log_number ||
+          cfd->mem()->GetFirstSequenceNumber() == 0) {
+        continue;
+      }
+      // If flush happened in the middle of recovery (e.g. due to memtable
+      // being full), we flush at the end. Otherwise we'll need to record
+      // where we were on last flush, which make the logic complicated.
+      if (flushed || !immutable_db_options_.avoid_flush_during_recovery) {
+        cfds_to_flush.push_back(cfd);
+      }
+      data_seen = true;
+    }
+    if (!cfds_to_flush.empty()) {
+      status = WriteLevel0TablesForRecovery(job_id, cfds_to_flush,
+                                            &version_edits);
+      if (status.ok()) {
+        flushed = true;
+        for (auto cfd : cfds_to_flush) {
+          cfd->CreateNewMemtable(*cfd->GetLatestMutableCFOptions(),
+                                 versions_->LastSequence());
+        }
+      }
+    }
+
     for (auto cfd : *versions_->GetColumnFamilySet()) {
+      if (!status.ok()) {
+        // Recovery failed
+        break;
+      }
       auto iter = version_edits.find(cfd->GetID());
       assert(iter != version_edits.end());
       VersionEdit* edit = &iter->second;
@@ -847,25 +977,6 @@ Status DBImpl::RecoverLogFiles(const std::vector<uint64_t>& log_numbers,
         continue;
       }
 
-      // flush the final memtable (if non-empty)
-      if (cfd->mem()->GetFirstSequenceNumber() != 0) {
-        // If flush happened in the middle of recovery (e.g. due to memtable
-        // being full), we flush at the end. Otherwise we'll need to record
-        // where we were on last flush, which make the logic complicated.
-        if (flushed || !immutable_db_options_.avoid_flush_during_recovery) {
-          status = WriteLevel0TableForRecovery(job_id, cfd, cfd->mem(), edit);
-          if (!status.ok()) {
-            // Recovery failed
-            break;
-          }
-          flushed = true;
-
-          cfd->CreateNewMemtable(*cfd->GetLatestMutableCFOptions(),
-                                 versions_->LastSequence());
-        }
-        data_seen = true;
-      }
-
       // write MANIFEST with update
       // writing log_number in the manifest means that any log file
       // with number strongly less than (log_number + 1) is already
@@ -882,10 +993,6 @@ Status DBImpl::RecoverLogFiles(const std::vector<uint64_t>& log_numbers,
       versions_->MarkFileNumberUsed(max_log_number + 1);
       status = versions_->LogAndApply(
           cfd, *cfd->GetLatestMutableCFOptions(), edit, &mutex_);
-      if (!status.ok()) {
-        // Recovery failed
-        break;
-      }
     }
   }
 
@@ -899,6 +1006,127 @@ Status DBImpl::RecoverLogFiles(const std::vector<uint64_t>& log_numbers,
   return status;
 }
 
+Status DBImpl::WriteLevel0TablesForRecovery(
+    int job_id, const autovector<ColumnFamilyData*>& cfds,
+    std::unordered_map<int, VersionEdit>* version_edits) {
+  mutex_.AssertHeld();
+  std::vector<VersionEdit*> edits;
+  for (auto cfd : cfds) {
+    auto iter = version_edits->find(cfd->GetID());
+    assert(iter != version_edits->end());
+    edits.push_back(&iter->second);
+  }
+  const size_t num_threads = std::min(
+      cfds.size(),
+      static_cast<size_t>(immutable_db_options_.wal_recovery_threads));
+  if (num_threads <= 1) {
+    for (size_t i = 0; i < cfds.size(); i++) {
+      Status s =
+          WriteLevel0TableForRecovery(job_id, cfds[i], cfds[i]->mem(), edits[i]);
+      if (!s.ok()) {
+        return s;
+      }
+    }
+    return Status::OK();
+  }
+
+  // WriteLevel0TableForRecovery() releases the mutex while it builds the
+  // table, so that the tables of several column families are built in
+  // parallel
+  std::vector<Status> statuses(cfds.size());
+  std::atomic<size_t> next_cfd_idx(0);
+  auto write_tables = [&]() {
+    InstrumentedMutexLock l(&mutex_);
+    while (true) {
+      size_t cfd_idx = next_cfd_idx.fetch_add(1);
+      if (cfd_idx >= cfds.size()) {
+        break;
+      }
+      statuses[cfd_idx] = WriteLevel0TableForRecovery(
+          job_id, cfds[cfd_idx], cfds[cfd_idx]->mem(), edits[cfd_idx]);
+    }
+  };
+  mutex_.Unlock();
+  std::vector<port::Thread> thread_pool;
+  thread_pool.reserve(num_threads - 1);
+  for (size_t i = 1; i < num_threads; i++) {
+    thread_pool.emplace_back(write_tables);
+  }
+  write_tables();
+  for (auto& thread : thread_pool) {
+    thread.join();
+  }
+  mutex_.Lock();
+  for (const auto& s : statuses) {
+    if (!s.ok()) {
+      return s;
+    }
+  }
+  return Status::OK();
+}
+
+Status DBImpl::InsertRecoveredBatches(const std::vector<WriteBatch>& batches,
+                                      uint64_t log_number,
+                                      bool* has_valid_writes,
+                                      size_t* failed_batch_size) {
+  mutex_.AssertHeld();
+  const size_t num_threads = std::min(
+      batches.size(),
+      static_cast<size_t>(immutable_db_options_.wal_recovery_threads));
+  std::vector<Status> statuses(batches.size());
+  std::atomic<size_t> next_batch_idx(0);
+  std::atomic<bool> valid_writes(false);
+  auto insert_batches = [&]() {
+    // Each thread needs its own ColumnFamilyMemTables
+    ColumnFamilyMemTablesImpl column_family_memtables(
+        versions_->GetColumnFamilySet());
+    bool thread_has_valid_writes = false;
+    while (true) {
+      size_t batch_idx = next_batch_idx.fetch_add(1);
+      if (batch_idx >= batches.size()) {
+        break;
+      }
+      statuses[batch_idx] = WriteBatchInternal::InsertInto(
+          &batches[batch_idx], &column_family_memtables, &flush_scheduler_,
+          true, log_number, this, true /* concurrent_memtable_writes */,
+          nullptr /* next_seq */, &thread_has_valid_writes, seq_per_batch_,
+          batch_per_txn_);
+    }
+    if (thread_has_valid_writes) {
+      valid_writes.store(true, std::memory_order_relaxed);
+    }
+  };
+  TEST_SYNC_POINT_CALLBACK("DBImpl::InsertRecoveredBatches:Start",
+                           const_cast<std::vector<WriteBatch>*>(&batches));
+  std::vector<port::Thread> thread_pool;
+  thread_pool.reserve(num_threads - 1);
+  for (size_t i = 1; i < num_threads; i++) {
+    thread_pool.emplace_back(insert_batches);
+  }
+  insert_batches();
+  for (auto& thread : thread_pool) {
+    thread.join();
+  }
+
+  // A memtable written concurrently updates its flush state once a batch is
+  // inserted, after the inserter checked whether it is full
+  for (auto cfd : *versions_->GetColumnFamilySet()) {
+    if (cfd->mem()->ShouldScheduleFlush() &&
+        cfd->mem()->MarkFlushScheduled()) {
+      flush_scheduler_.ScheduleFlush(cfd);
+    }
+  }
+
+  *has_valid_writes = valid_writes.load(std::memory_order_relaxed);
+  for (size_t i = 0; i < batches.size(); i++) {
+    if (!statuses[i].ok()) {
+      *failed_batch_size = WriteBatchInternal::ByteSize(&batches[i]);
+      return statuses[i];
+    }
+  }
+  return Status::OK();
+}
+
 Status DBImpl::RestoreAliveLogFiles(const std::vector<uint64_t>& log_numbers) {
   if (log_numbers.empty()) {
     return Status::OK();
@@ -1156,7 +1384,8 @@ Status DBImpl::Open(const DBOptions& db_options, const std::string& dbname,
             new log::Writer(
                 std::move(file_writer), new_log_number,
                 impl->immutable_db_options_.recycle_log_file_num > 0,
-                impl->immutable_db_options_.manual_wal_flush));
+                impl->immutable_db_options_.manual_wal_flush,
+                impl->immutable_db_options_.wal_compression));
       }
 
       // set column family handles
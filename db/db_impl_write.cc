@@ -94,6 +94,10 @@ Status DBImpl::WriteImpl(const WriteOptions& write_options,
     return Status::NotSupported(
         "pipelined_writes is not compatible with seq_per_batch");
   }
+  if (seq_per_batch_ && immutable_db_options_.unordered_write) {
+    return Status::NotSupported(
+        "unordered_write is not compatible with seq_per_batch");
+  }
   // Otherwise IsLatestPersistentState optimization does not make sense
   assert(!WriteBatchInternal::IsLatestPersistentState(my_batch) ||
          disable_memtable);
@@ -116,6 +120,11 @@ Status DBImpl::WriteImpl(const WriteOptions& write_options,
                               log_ref, disable_memtable, seq_used);
   }
 
+  if (immutable_db_options_.unordered_write) {
+    return UnorderedWriteImpl(write_options, my_batch, callback, log_used,
+                              log_ref, disable_memtable, seq_used);
+  }
+
   PERF_TIMER_GUARD(write_pre_and_post_process_time);
   WriteThread::Writer w(write_options, my_batch, callback, log_ref,
                         disable_memtable, batch_cnt, pre_release_callback);
@@ -542,6 +551,157 @@ Status DBImpl::PipelinedWriteImpl(const WriteOptions& write_options,
   return w.FinalStatus();
 }
 
+// With unordered_write, the write group leader only assigns the sequences and
+// writes the WAL. Each writer then inserts its own batch into the memtables,
+// while the next write groups go on, and write_watermark_ publishes
+// LastSequence once all the writes with a smaller sequence are inserted.
+Status DBImpl::UnorderedWriteImpl(const WriteOptions& write_options,
+                                  WriteBatch* my_batch, WriteCallback* callback,
+                                  uint64_t* log_used, uint64_t log_ref,
+                                  bool disable_memtable, uint64_t* seq_used) {
+  PERF_TIMER_GUARD(write_pre_and_post_process_time);
+  StopWatch write_sw(env_, immutable_db_options_.statistics.get(), DB_WRITE);
+
+  WriteContext write_context;
+
+  WriteThread::Writer w(write_options, my_batch, callback, log_ref,
+                        disable_memtable);
+  if (!write_options.disableWAL) {
+    RecordTick(stats_, WRITE_WITH_WAL);
+  }
+
+  write_thread_.JoinBatchGroup(&w);
+  if (w.state == WriteThread::STATE_GROUP_LEADER) {
+    WriteThread::WriteGroup write_group;
+    mutex_.Lock();
+    bool need_log_sync = write_options.sync;
+    bool need_log_dir_sync = need_log_sync && !log_dir_synced_;
+    // PreprocessWrite does its own perf timing.
+    PERF_TIMER_STOP(write_pre_and_post_process_time);
+    w.status = PreprocessWrite(write_options, &need_log_sync, &write_context);
+    PERF_TIMER_START(write_pre_and_post_process_time);
+    log::Writer* log_writer = logs_.back().writer;
+    mutex_.Unlock();
+
+    TEST_SYNC_POINT("DBImpl::UnorderedWriteImpl:BeforeLeaderEnters");
+    last_batch_group_size_ =
+        write_thread_.EnterAsBatchGroupLeader(&w, &write_group);
+    // The leader is the only one allocating sequences
+    const SequenceNumber current_sequence =
+        versions_->LastAllocatedSequence() + 1;
+    SequenceNumber next_sequence = current_sequence;
+    size_t total_count = 0;
+    size_t total_byte_size = 0;
+
+    if (w.status.ok()) {
+      for (auto* writer : write_group) {
+        if (writer->CheckCallback(this)) {
+          if (writer->ShouldWriteToMemtable()) {
+            writer->sequence = next_sequence;
+            size_t count = WriteBatchInternal::Count(writer->batch);
+            next_sequence += count;
+            total_count += count;
+          }
+          total_byte_size = WriteBatchInternal::AppendedByteSize(
+              total_byte_size, WriteBatchInternal::ByteSize(writer->batch));
+        }
+      }
+      if (write_options.disableWAL) {
+        has_unpersisted_data_.store(true, std::memory_order_relaxed);
+      }
+    }
+
+    auto stats = default_cf_internal_stats_;
+    stats->AddDBStats(InternalStats::NUMBER_KEYS_WRITTEN, total_count);
+    RecordTick(stats_, NUMBER_KEYS_WRITTEN, total_count);
+    stats->AddDBStats(InternalStats::BYTES_WRITTEN, total_byte_size);
+    RecordTick(stats_, BYTES_WRITTEN, total_byte_size);
+    stats->AddDBStats(InternalStats::WRITE_DONE_BY_SELF, 1);
+    RecordTick(stats_, WRITE_DONE_BY_SELF);
+    if (write_group.size > 1) {
+      stats->AddDBStats(InternalStats::WRITE_DONE_BY_OTHER,
+                        write_group.size - 1);
+      RecordTick(stats_, WRITE_DONE_BY_OTHER, write_group.size - 1);
+    }
+    MeasureTime(stats_, BYTES_PER_WRITE, total_byte_size);
+
+    PERF_TIMER_STOP(write_pre_and_post_process_time);
+
+    if (w.status.ok() && !write_options.disableWAL) {
+      PERF_TIMER_GUARD(write_wal_time);
+      w.status = WriteToWAL(write_group, log_writer, log_used, need_log_sync,
+                            need_log_dir_sync, current_sequence);
+    }
+
+    if (w.status.ok()) {
+      // The writers must be registered before any of them can complete,
+      // hence before leaving the write group
+      for (auto* writer : write_group) {
+        if (writer->ShouldWriteToMemtable() &&
+            WriteBatchInternal::Count(writer->batch) > 0) {
+          write_watermark_->Add(writer->sequence +
+                                WriteBatchInternal::Count(writer->batch) - 1);
+        }
+      }
+      versions_->SetLastAllocatedSequence(next_sequence - 1);
+    }
+
+    PERF_TIMER_START(write_pre_and_post_process_time);
+
+    if (!w.CallbackFailed()) {
+      WriteStatusCheck(w.status);
+    }
+
+    if (need_log_sync) {
+      mutex_.Lock();
+      MarkLogsSynced(logfile_number_, need_log_dir_sync, w.status);
+      mutex_.Unlock();
+    }
+
+    write_thread_.ExitAsBatchGroupLeader(write_group, w.status);
+  }
+  assert(w.state == WriteThread::STATE_GROUP_LEADER ||
+         w.state == WriteThread::STATE_COMPLETED);
+
+  // The status of the group is ok at this point only if the writer was
+  // registered above
+  if (w.ShouldWriteToMemtable() && WriteBatchInternal::Count(my_batch) > 0) {
+    PERF_TIMER_GUARD(write_memtable_time);
+    TEST_SYNC_POINT_CALLBACK("DBImpl::UnorderedWriteImpl:BeforeMemTableInsert",
+                             my_batch);
+    ColumnFamilyMemTablesImpl column_family_memtables(
+        versions_->GetColumnFamilySet());
+    w.status = WriteBatchInternal::InsertInto(
+        &w, w.sequence, &column_family_memtables, &flush_scheduler_,
+        write_options.ignore_missing_column_families, 0 /*log_number*/, this,
+        true /*concurrent_memtable_writes*/);
+    TEST_SYNC_POINT_CALLBACK("DBImpl::UnorderedWriteImpl:AfterMemTableInsert",
+                             my_batch);
+    // Completes even on failure, not to hold back the later writes.
+    // MemTableInsertStatusCheck() may lock mutex_, which a memtable switch
+    // holds while waiting for the pending writes.
+    write_watermark_->Complete(w.sequence +
+                               WriteBatchInternal::Count(my_batch) - 1);
+    MemTableInsertStatusCheck(w.status);
+  }
+  if (seq_used != nullptr) {
+    *seq_used = w.sequence;
+  }
+  return w.FinalStatus();
+}
+
+void DBImpl::WaitForPendingWrites() {
+  mutex_.AssertHeld();
+  if (!immutable_db_options_.unordered_write) {
+    return;
+  }
+  // The pending writers do not need mutex_ to complete, but they are
+  // allowed to lock it once completed
+  mutex_.Unlock();
+  write_watermark_->WaitForPendingWrites();
+  mutex_.Lock();
+}
+
 // The 2nd write queue. If enabled it will be used only for WAL-only writes.
 // This is the only queue that updates LastPublishedSequence which is only
 // applicable in a two-queue setting.
@@ -989,8 +1149,10 @@ Status DBImpl::WriteRecoverableState() {
         false /* concurrent_memtable_writes */, &next_seq, &dont_care_bool,
         seq_per_batch_);
     auto last_seq = next_seq - 1;
-    if (two_write_queues_) {
+    if (two_write_queues_ || immutable_db_options_.unordered_write) {
       versions_->FetchAddLastAllocatedSequence(last_seq - seq);
+    }
+    if (two_write_queues_) {
       versions_->SetLastPublishedSequence(last_seq);
     }
     versions_->SetLastSequence(last_seq);
@@ -1375,6 +1537,10 @@ Status DBImpl::SwitchMemtable(ColumnFamilyData* cfd, WriteContext* context) {
   log::Writer* new_log = nullptr;
   MemTable* new_mem = nullptr;
 
+  // With unordered_write, the writes of the previous write groups may still
+  // be inserting into the memtable to switch.
+  WaitForPendingWrites();
+
   // Recoverable state is persisted in WAL. After memtable switch, WAL might
   // be deleted, so we write the state to memtable to be persisted as well.
   Status s = WriteRecoverableState();
@@ -1460,7 +1626,8 @@ Status DBImpl::SwitchMemtable(ColumnFamilyData* cfd, WriteContext* context) {
             immutable_db_options_.listeners));
         new_log = new log::Writer(
             std::move(file_writer), new_log_number,
-            immutable_db_options_.recycle_log_file_num > 0, manual_wal_flush_);
+            immutable_db_options_.recycle_log_file_num > 0, manual_wal_flush_,
+            immutable_db_options_.wal_compression);
       }
     }
 
@@ -1982,6 +1982,47 @@ TEST_P(DBIteratorTest, ReadAhead) {
   delete iter;
 }
 
+TEST_P(DBIteratorTest, AsyncReadAhead) {
+  Options options = CurrentOptions();
+  options.disable_auto_compactions = true;
+  BlockBasedTableOptions table_options;
+  table_options.block_size = 1024;
+  table_options.no_block_cache = true;
+  options.table_factory.reset(new BlockBasedTableFactory(table_options));
+  Reopen(options);
+
+  Random rnd(301);
+  std::vector<std::string> values;
+  for (int i = 0; i < 2000; i++) {
+    values.push_back(RandomString(&rnd, 1000));
+    ASSERT_OK(Put(Key(i), values.back()));
+  }
+  ASSERT_OK(Flush());
+
+  ReadOptions read_options;
+  read_options.readahead_buffers_in_flight = 2;
+  std::unique_ptr<Iterator> iter(NewIterator(read_options));
+  int count = 0;
+  for (iter->SeekToFirst(); iter->Valid(); iter->Next()) {
+    ASSERT_EQ(Key(count), iter->key().ToString());
+    ASSERT_EQ(values[count], iter->value().ToString());
+    count++;
+  }
+  ASSERT_OK(iter->status());
+  ASSERT_EQ(2000, count);
+
+  // Scans interrupted by seeks forward and backward
+  for (int start = 1500; start >= 0; start -= 500) {
+    iter->Seek(Key(start));
+    for (int i = start; i < start + 300; i++) {
+      ASSERT_TRUE(iter->Valid());
+      ASSERT_EQ(values[i], iter->value().ToString());
+      iter->Next();
+    }
+  }
+  ASSERT_OK(iter->status());
+}
+
 // Insert a key, create a snapshot iterator, overwrite key lots of times,
 // seek to a smaller key. Expect DBIter to fall back to a seek instead of
 // going through all the overwrites linearly.
@@ -11,6 +11,7 @@
 #include "port/stack_trace.h"
 #include "rocksdb/memtablerep.h"
 #include "rocksdb/slice_transform.h"
+#include "utilities/merge_operators.h"
 
 namespace rocksdb {
 
@@ -262,6 +263,162 @@ TEST_F(DBMemTableTest, ColumnFamilyId) {
   }
 }
 
+TEST_F(DBMemTableTest, HashIndex) {
+  Options options = CurrentOptions();
+  options.create_if_missing = true;
+  options.memtable_hash_index_size_ratio = 0.01;
+  options.merge_operator = MergeOperators::CreateStringAppendOperator();
+  Reopen(options);
+
+  // Gets with the hash index must read what the iterators read, which
+  // search the memtable in order
+  const int kNumKeys = 50;
+  Random rnd(301);
+  std::vector<const Snapshot*> snapshots;
+  for (int i = 0; i < 2000; i++) {
+    int k = rnd.Uniform(kNumKeys);
+    std::string key = Key(k);
+    switch (rnd.Uniform(6)) {
+      case 0:
+      case 1:
+        ASSERT_OK(Put(key, "v" + ToString(i)));
+        break;
+      case 2:
+        ASSERT_OK(Merge(key, "m" + ToString(i)));
+        break;
+      case 3:
+        ASSERT_OK(Delete(key));
+        break;
+      case 4:
+        ASSERT_OK(SingleDelete(key));
+        break;
+      case 5:
+        if (rnd.OneIn(10)) {
+          ASSERT_OK(db_->DeleteRange(WriteOptions(), db_->DefaultColumnFamily(),
+                                     key, Key(k + 1 + rnd.Uniform(5))));
+        } else {
+          ASSERT_OK(Put(key, "v" + ToString(i)));
+        }
+        break;
+    }
+    if (rnd.OneIn(100)) {
+      snapshots.push_back(db_->GetSnapshot());
+    }
+  }
+  snapshots.push_back(nullptr);
+  // Everything was read from the memtable
+  ASSERT_EQ(0, NumTableFilesAtLevel(0));
+
+  for (auto snapshot : snapshots) {
+    ReadOptions read_options;
+    read_options.snapshot = snapshot;
+    std::map<std::string, std::string> expected;
+    std::unique_ptr<Iterator> iter(db_->NewIterator(read_options));
+    for (iter->SeekToFirst(); iter->Valid(); iter->Next()) {
+      expected[iter->key().ToString()] = iter->value().ToString();
+    }
+    // Include a key that was never written
+    for (int k = 0; k <= kNumKeys; k++) {
+      std::string value;
+      Status s = db_->Get(read_options, Key(k), &value);
+      auto it = expected.find(Key(k));
+      if (it == expected.end()) {
+        ASSERT_TRUE(s.IsNotFound());
+      } else {
+        ASSERT_OK(s);
+        ASSERT_EQ(it->second, value);
+      }
+    }
+    if (snapshot != nullptr) {
+      db_->ReleaseSnapshot(snapshot);
+    }
+  }
+
+  // Concurrent writers adding the same new keys to the index
+  options.allow_concurrent_memtable_write = true;
+  Reopen(options);
+  std::vector<port::Thread> threads;
+  for (int t = 0; t < 4; t++) {
+    threads.emplace_back([&, t]() {
+      for (int i = 0; i < 1000; i++) {
+        db_->Put(WriteOptions(), Key(i % kNumKeys), ToString(t));
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  std::unique_ptr<Iterator> iter(db_->NewIterator(ReadOptions()));
+  int count = 0;
+  for (iter->SeekToFirst(); iter->Valid(); iter->Next()) {
+    ASSERT_EQ(iter->value().ToString(), Get(iter->key().ToString()));
+    count++;
+  }
+  ASSERT_EQ(kNumKeys, count);
+}
+
+#ifndef ROCKSDB_LITE
+TEST_F(DBMemTableTest, PartitionedSkipList) {
+  Options options = CurrentOptions();
+  options.create_if_missing = true;
+  options.memtable_factory.reset(NewPartitionedSkipListRepFactory(4));
+  options.allow_concurrent_memtable_write = true;
+  Reopen(options);
+
+  const int kNumKeys = 1000;
+  const int kNumThreads = 4;
+  // The first memtables split on the first byte, which all the keys share.
+  // The memtable created after the first one became immutable splits on the
+  // boundaries learned from it.
+  for (int round = 0; round < 3; round++) {
+    std::string value = "value" + ToString(round);
+    std::vector<port::Thread> threads;
+    for (int t = 0; t < kNumThreads; t++) {
+      threads.emplace_back([&, t]() {
+        for (int i = t; i < kNumKeys; i += kNumThreads) {
+          if (i % 10 == 9) {
+            db_->Delete(WriteOptions(), Key(i));
+          } else {
+            db_->Put(WriteOptions(), Key(i), value);
+          }
+        }
+      });
+    }
+    for (auto& thread : threads) {
+      thread.join();
+    }
+
+    for (int i = 0; i < kNumKeys; i++) {
+      ASSERT_EQ(i % 10 == 9 ? "NOT_FOUND" : value, Get(Key(i)));
+    }
+    std::unique_ptr<Iterator> iter(db_->NewIterator(ReadOptions()));
+    int count = 0;
+    std::string last_key;
+    for (iter->SeekToFirst(); iter->Valid(); iter->Next()) {
+      ASSERT_LT(last_key, iter->key().ToString());
+      last_key = iter->key().ToString();
+      count++;
+    }
+    ASSERT_EQ(kNumKeys - kNumKeys / 10, count);
+    count = 0;
+    for (iter->SeekToLast(); iter->Valid(); iter->Prev()) {
+      count++;
+    }
+    ASSERT_EQ(kNumKeys - kNumKeys / 10, count);
+    iter->Seek(Key(499));
+    ASSERT_TRUE(iter->Valid());
+    ASSERT_EQ(Key(500), iter->key().ToString());
+    iter->SeekForPrev(Key(499));
+    ASSERT_TRUE(iter->Valid());
+    ASSERT_EQ(Key(498), iter->key().ToString());
+    iter.reset();
+
+    ASSERT_OK(Flush());
+  }
+  ASSERT_EQ("value2", Get(Key(0)));
+}
+#endif  // ROCKSDB_LITE
+
 }  // namespace rocksdb
 
 int main(int argc, char** argv) {
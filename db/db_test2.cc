@@ -1148,6 +1148,94 @@ TEST_F(DBTest2, PresetCompressionDict) {
   }
 }
 
+TEST_F(DBTest2, SharedCompressionDict) {
+  const size_t kBlockSizeBytes = 4 << 10;
+  const size_t kL0FileBytes = 128 << 10;
+  const size_t kApproxPerBlockOverheadBytes = 50;
+  const int kNumL0Files = 2;
+
+  Options options = CurrentOptions();
+  options.compaction_style = kCompactionStyleUniversal;
+  options.disable_auto_compactions = true;
+  options.memtable_factory.reset(
+      new SpecialSkipListFactory(kL0FileBytes / kBlockSizeBytes));
+  options.num_levels = 2;
+  options.target_file_size_base = kL0FileBytes;
+  options.write_buffer_size = kL0FileBytes;
+  options.compression_opts.max_dict_bytes = kBlockSizeBytes;
+  options.compression_opts.shared_dict_max_files = 100;
+  BlockBasedTableOptions table_options;
+  table_options.block_size = kBlockSizeBytes;
+  table_options.block_cache = NewLRUCache(8 << 20);
+  options.table_factory.reset(NewBlockBasedTableFactory(table_options));
+  std::vector<CompressionType> compression_types;
+  if (Zlib_Supported()) {
+    compression_types.push_back(kZlibCompression);
+  }
+#if LZ4_VERSION_NUMBER >= 10400  // r124+
+  compression_types.push_back(kLZ4Compression);
+#endif                          // LZ4_VERSION_NUMBER >= 10400
+  if (ZSTD_Supported()) {
+    compression_types.push_back(kZSTD);
+  }
+
+  for (auto compression_type : compression_types) {
+    options.compression = compression_type;
+    DestroyAndReopen(options);
+    auto get_compression_dict = [&]() {
+      auto cfd = reinterpret_cast<ColumnFamilyHandleImpl*>(
+                     db_->DefaultColumnFamily())
+                     ->cfd();
+      InstrumentedMutexLock l(dbfull()->mutex());
+      return cfd->compression_dict();
+    };
+
+    Random rnd(301);
+    std::string seq_data =
+        RandomString(&rnd, kBlockSizeBytes - kApproxPerBlockOverheadBytes);
+    int num_keys = 0;
+    auto write_and_compact = [&]() {
+      for (int j = 0; j < kNumL0Files; ++j) {
+        for (size_t k = 0; k < kL0FileBytes / kBlockSizeBytes + 1; ++k) {
+          ASSERT_OK(Put(Key(num_keys++), seq_data));
+        }
+        dbfull()->TEST_WaitForFlushMemTable();
+      }
+      ASSERT_OK(db_->CompactRange(CompactRangeOptions(), nullptr, nullptr));
+      ASSERT_EQ(0, NumTableFilesAtLevel(0));
+    };
+
+    // The dictionary trained by the first bottommost compaction is kept
+    write_and_compact();
+    auto compression_dict = get_compression_dict();
+    ASSERT_NE(nullptr, compression_dict);
+    ASSERT_FALSE(compression_dict->dict.empty());
+
+    // and used by the next ones, including after a reopen
+    write_and_compact();
+    ASSERT_EQ(compression_dict, get_compression_dict());
+    Reopen(options);
+    ASSERT_EQ(compression_dict->id, get_compression_dict()->id);
+    ASSERT_EQ(compression_dict->dict, get_compression_dict()->dict);
+    write_and_compact();
+    ASSERT_EQ(compression_dict->id, get_compression_dict()->id);
+    for (int j = 0; j < num_keys; j++) {
+      ASSERT_EQ(seq_data, Get(Key(j)));
+    }
+
+    // A new dictionary is trained once the files limit is reached
+    options.compression_opts.shared_dict_max_files = 1;
+    Reopen(options);
+    write_and_compact();
+    ASSERT_EQ(compression_dict->id, get_compression_dict()->id);
+    write_and_compact();
+    ASSERT_NE(compression_dict->id, get_compression_dict()->id);
+    for (int j = 0; j < num_keys; j++) {
+      ASSERT_EQ(seq_data, Get(Key(j)));
+    }
+  }
+}
+
 class CompactionCompressionListener : public EventListener {
  public:
   explicit CompactionCompressionListener(Options* db_options)
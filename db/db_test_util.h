@@ -16,6 +16,7 @@
 #include <inttypes.h>
 
 #include <algorithm>
+#include <atomic>
 #include <map>
 #include <set>
 #include <string>
@@ -140,6 +141,11 @@ class SpecialMemTableRep : public MemTableRep {
     memtable_->Insert(handle);
   }
 
+  virtual void InsertConcurrently(KeyHandle handle) override {
+    num_entries_++;
+    memtable_->InsertConcurrently(handle);
+  }
+
   // Returns true iff an entry that compares equal to key is in the list.
   virtual bool Contains(const char* key) const override {
     return memtable_->Contains(key);
@@ -171,7 +177,7 @@ class SpecialMemTableRep : public MemTableRep {
  private:
   std::unique_ptr<MemTableRep> memtable_;
   int num_entries_flush_;
-  int num_entries_;
+  std::atomic<int> num_entries_;
 };
 
 // The factory for the hacky skip list mem table that triggers flush after
@@ -676,6 +682,7 @@ class DBTestBase : public testing::Test {
     kPartitionedFilterWithNewTableReaderForCompactions,
     kUniversalSubcompactions,
     kxxHash64Checksum,
+    kUnorderedWrite,
     // This must be the last line
     kEnd,
   };
@@ -12,6 +12,7 @@
 #include "port/port.h"
 #include "port/stack_trace.h"
 #include "util/fault_injection_test_env.h"
+#include "util/streaming_compression.h"
 #include "util/sync_point.h"
 
 namespace rocksdb {
@@ -532,6 +533,40 @@ TEST_F(DBWALTest, FullPurgePreservesRecycledLog) {
   }
 }
 
+TEST_F(DBWALTest, WalCompression) {
+  for (auto type : {kZlibCompression, kLZ4Compression, kZSTD}) {
+    Options options = CurrentOptions();
+    options.create_if_missing = true;
+    options.wal_compression = type;
+    if (!StreamingCompressionTypeSupported(type)) {
+      ASSERT_TRUE(TryReopen(options).IsNotSupported());
+      continue;
+    }
+    for (size_t recycle_log_file_num : {0, 2}) {
+      options.recycle_log_file_num = recycle_log_file_num;
+      DestroyAndReopen(options);
+      for (int i = 0; i < 100; ++i) {
+        ASSERT_OK(Put(Key(i), "value" + ToString(i)));
+      }
+      ASSERT_OK(Delete(Key(0)));
+      Reopen(options);
+      ASSERT_EQ("NOT_FOUND", Get(Key(0)));
+      for (int i = 1; i < 100; ++i) {
+        ASSERT_EQ("value" + ToString(i), Get(Key(i)));
+      }
+
+      // Write into a (possibly recycled) log after a flush
+      ASSERT_OK(Flush());
+      ASSERT_OK(Put(Key(0), "new_value"));
+      Reopen(options);
+      ASSERT_EQ("new_value", Get(Key(0)));
+
+      std::unique_ptr<TransactionLogIterator> iter;
+      ASSERT_OK(dbfull()->GetUpdatesSince(0, &iter));
+    }
+  }
+}
+
 TEST_F(DBWALTest, GetSortedWalFiles) {
   do {
     CreateAndReopenWithCF({"pikachu"}, CurrentOptions());
@@ -1107,6 +1142,97 @@ TEST_F(DBWALTest, kSkipAnyCorruptedRecords) {
   }
 }
 
+// Test scope:
+// - We expect recovery with several threads to give the same result as with a
+// single thread, under every recovery mode
+TEST_F(DBWALTest, ParallelRecovery) {
+  const int jstart = RecoveryTestHelper::kWALFileOffset;
+  const int jend = jstart + RecoveryTestHelper::kWALFilesCount;
+  const int maxkeys =
+      RecoveryTestHelper::kWALFilesCount * RecoveryTestHelper::kKeysPerWALFile;
+
+  for (auto mode : {WALRecoveryMode::kTolerateCorruptedTailRecords,
+                    WALRecoveryMode::kAbsoluteConsistency,
+                    WALRecoveryMode::kPointInTimeRecovery,
+                    WALRecoveryMode::kSkipAnyCorruptedRecords}) {
+    for (auto trunc : {true, false}) {           /* Corruption style */
+      for (int j = jstart; j < jend; j += 3) {   /* WAL file */
+        std::vector<std::string> results;
+        for (int threads : {1, 4}) {
+          Options options = CurrentOptions();
+          options.allow_concurrent_memtable_write = true;
+          RecoveryTestHelper::FillData(this, &options);
+          RecoveryTestHelper::CorruptWAL(this, options, /*off=*/.5,
+                                         /*len%=*/.1, j, trunc);
+
+          options.wal_recovery_mode = mode;
+          options.wal_recovery_threads = threads;
+          options.create_if_missing = false;
+          Status s = TryReopen(options);
+          std::string result = s.ok() ? "OK:" : "NOK";
+          if (s.ok()) {
+            for (int k = 0; k < maxkeys; ++k) {
+              result += Get("key" + ToString(k)) != "NOT_FOUND" ? '1' : '0';
+            }
+          }
+          results.push_back(result);
+        }
+        ASSERT_EQ(results[0], results[1]);
+      }
+    }
+  }
+}
+
+TEST_F(DBWALTest, ParallelRecoveryWithFlushes) {
+  Options options = CurrentOptions();
+  options.allow_concurrent_memtable_write = true;
+  options.disable_auto_compactions = true;
+  CreateAndReopenWithCF({"one", "two", "three"}, options);
+
+  Random rnd(301);
+  std::vector<std::map<std::string, std::string>> expected(4);
+  for (int i = 0; i < 2000; i++) {
+    for (int cf = 0; cf < 4; cf++) {
+      std::string value = RandomString(&rnd, 100);
+      ASSERT_OK(Put(cf, Key(i), value));
+      expected[cf][Key(i)] = value;
+    }
+    if (i % 500 == 0) {
+      // A batch that is not inserted concurrently
+      ASSERT_OK(db_->DeleteRange(WriteOptions(), handles_[3], Key(i),
+                                 Key(i + 10)));
+      for (int k = i; k < i + 10; k++) {
+        expected[3].erase(Key(k));
+      }
+    }
+  }
+
+  std::atomic<size_t> concurrent_batches(0);
+  rocksdb::SyncPoint::GetInstance()->SetCallBack(
+      "DBImpl::InsertRecoveredBatches:Start", [&](void* arg) {
+        auto* batches = static_cast<std::vector<WriteBatch>*>(arg);
+        concurrent_batches += batches->size();
+      });
+  rocksdb::SyncPoint::GetInstance()->EnableProcessing();
+
+  // Memtables fill up during recovery
+  options.write_buffer_size = 100000;
+  options.wal_recovery_threads = 4;
+  ReopenWithColumnFamilies({"default", "one", "two", "three"}, options);
+  rocksdb::SyncPoint::GetInstance()->DisableProcessing();
+  rocksdb::SyncPoint::GetInstance()->ClearAllCallBacks();
+  // All the batches but the range deletions
+  ASSERT_EQ(4 * 2000, concurrent_batches.load());
+  for (int cf = 0; cf < 4; cf++) {
+    ASSERT_GT(NumTableFilesAtLevel(0, cf), 0);
+    for (int i = 0; i < 2000; i++) {
+      auto it = expected[cf].find(Key(i));
+      ASSERT_EQ(it == expected[cf].end() ? "NOT_FOUND" : it->second,
+                Get(cf, Key(i)));
+    }
+  }
+}
+
 TEST_F(DBWALTest, AvoidFlushDuringRecovery) {
   Options options = CurrentOptions();
   options.disable_auto_compactions = true;
@@ -140,10 +140,105 @@ TEST_P(DBWriteTest, IOErrorOnWALWriteTriggersReadOnlyMode) {
   Close();
 }
 
+// With unordered_write, a write that is inserted into the memtable before a
+// write with a smaller sequence stays invisible until the latter is inserted.
+TEST_P(DBWriteTest, UnorderedWriteVisibleInSequenceOrder) {
+  Options options = GetOptions();
+  if (!options.unordered_write) {
+    return;
+  }
+  Reopen(options);
+  const SequenceNumber start = dbfull()->GetLatestSequenceNumber();
+
+  std::atomic<bool> first_blocked{false};
+  std::atomic<bool> release_first{false};
+  std::atomic<bool> second_inserted{false};
+  SyncPoint::GetInstance()->SetCallBack(
+      "DBImpl::UnorderedWriteImpl:BeforeMemTableInsert", [&](void* arg) {
+        auto* batch = reinterpret_cast<WriteBatch*>(arg);
+        if (batch->Data().find("key1") != std::string::npos) {
+          first_blocked = true;
+          while (!release_first) {
+            Env::Default()->SleepForMicroseconds(100);
+          }
+        }
+      });
+  SyncPoint::GetInstance()->SetCallBack(
+      "DBImpl::UnorderedWriteImpl:AfterMemTableInsert", [&](void* arg) {
+        auto* batch = reinterpret_cast<WriteBatch*>(arg);
+        if (batch->Data().find("key2") != std::string::npos) {
+          second_inserted = true;
+        }
+      });
+  SyncPoint::GetInstance()->EnableProcessing();
+
+  port::Thread first([&]() { ASSERT_OK(Put("key1", "value1")); });
+  while (!first_blocked) {
+    Env::Default()->SleepForMicroseconds(100);
+  }
+  port::Thread second([&]() { ASSERT_OK(Put("key2", "value2")); });
+  while (!second_inserted) {
+    Env::Default()->SleepForMicroseconds(100);
+  }
+
+  // key2 is in the memtable, but key1 with a smaller sequence is not yet
+  ASSERT_EQ(start, dbfull()->GetLatestSequenceNumber());
+  const Snapshot* snapshot = db_->GetSnapshot();
+  ASSERT_EQ(start, snapshot->GetSequenceNumber());
+  ASSERT_EQ("NOT_FOUND", Get("key2"));
+
+  release_first = true;
+  first.join();
+  second.join();
+  SyncPoint::GetInstance()->DisableProcessing();
+  SyncPoint::GetInstance()->ClearAllCallBacks();
+
+  ASSERT_EQ(start + 2, dbfull()->GetLatestSequenceNumber());
+  ASSERT_EQ("value1", Get("key1"));
+  ASSERT_EQ("value2", Get("key2"));
+  ASSERT_EQ("NOT_FOUND", Get("key2", snapshot));
+  db_->ReleaseSnapshot(snapshot);
+}
+
+TEST_P(DBWriteTest, UnorderedWriteConcurrentWriters) {
+  Options options = GetOptions();
+  if (!options.unordered_write) {
+    return;
+  }
+  options.write_buffer_size = 64 << 10;
+  Reopen(options);
+  constexpr int kNumThreads = 8;
+  constexpr int kNumKeys = 1000;
+  std::vector<port::Thread> threads;
+  for (int t = 0; t < kNumThreads; t++) {
+    threads.emplace_back([&, t]() {
+      for (int i = 0; i < kNumKeys; i++) {
+        std::string key = "key" + ToString(t) + "_" + ToString(i);
+        ASSERT_OK(Put(key, "value" + ToString(i)));
+        // Writers always see their own writes
+        ASSERT_EQ("value" + ToString(i), Get(key));
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  ASSERT_EQ(static_cast<SequenceNumber>(kNumThreads * kNumKeys),
+            dbfull()->GetLatestSequenceNumber());
+  Reopen(options);
+  for (int t = 0; t < kNumThreads; t++) {
+    for (int i = 0; i < kNumKeys; i++) {
+      ASSERT_EQ("value" + ToString(i),
+                Get("key" + ToString(t) + "_" + ToString(i)));
+    }
+  }
+}
+
 INSTANTIATE_TEST_CASE_P(DBWriteTestInstance, DBWriteTest,
                         testing::Values(DBTestBase::kDefault,
                                         DBTestBase::kConcurrentWALWrites,
-                                        DBTestBase::kPipelinedWrite));
+                                        DBTestBase::kPipelinedWrite,
+                                        DBTestBase::kUnorderedWrite));
 
 }  // namespace rocksdb
 
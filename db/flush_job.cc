@@ -16,6 +16,7 @@
 #include <inttypes.h>
 
 #include <algorithm>
+#include <numeric>
 #include <vector>
 
 #include "db/builder.h"
@@ -51,9 +52,100 @@
 #include "util/mutexlock.h"
 #include "util/stop_watch.h"
 #include "util/sync_point.h"
+#include "util/vector_iterator.h"
 
 namespace rocksdb {
 
+namespace {
+// A flush is only split into key ranges holding at least this much data
+const uint64_t kMinFlushSubrangeSize = 8 << 20;
+// Number of keys sampled from each memtable for each key range a flush may be
+// split into
+const size_t kFlushSubrangeSamples = 16;
+
+// Iterates over the entries of iter whose user keys are in
+// [*lower_bound, *upper_bound), a null bound leaving the range open on that
+// side. Only supports the forward iteration BuildTable() does.
+class SubrangeIterator : public InternalIterator {
+ public:
+  SubrangeIterator(InternalIterator* iter, const Slice* lower_bound,
+                   const Slice* upper_bound, const Comparator* ucmp)
+      : iter_(iter),
+        lower_bound_(lower_bound),
+        upper_bound_(upper_bound),
+        ucmp_(ucmp),
+        valid_(false) {}
+
+  virtual bool Valid() const override { return valid_; }
+
+  virtual void SeekToFirst() override {
+    if (lower_bound_ == nullptr) {
+      iter_->SeekToFirst();
+    } else {
+      InternalKey target(*lower_bound_, kMaxSequenceNumber, kValueTypeForSeek);
+      iter_->Seek(target.Encode());
+    }
+    UpdateValid();
+  }
+
+  virtual void SeekToLast() override {
+    assert(false);
+    valid_ = false;
+  }
+
+  virtual void Seek(const Slice& target) override {
+    if (lower_bound_ != nullptr &&
+        ucmp_->Compare(ExtractUserKey(target), *lower_bound_) < 0) {
+      SeekToFirst();
+      return;
+    }
+    iter_->Seek(target);
+    UpdateValid();
+  }
+
+  virtual void SeekForPrev(const Slice& /*target*/) override {
+    assert(false);
+    valid_ = false;
+  }
+
+  virtual void Next() override {
+    iter_->Next();
+    UpdateValid();
+  }
+
+  virtual void Prev() override {
+    assert(false);
+    valid_ = false;
+  }
+
+  virtual Slice key() const override { return iter_->key(); }
+  virtual Slice value() const override { return iter_->value(); }
+  virtual Status status() const override { return iter_->status(); }
+
+  virtual void SetPinnedItersMgr(
+      PinnedIteratorsManager* pinned_iters_mgr) override {
+    iter_->SetPinnedItersMgr(pinned_iters_mgr);
+  }
+  virtual bool IsKeyPinned() const override { return iter_->IsKeyPinned(); }
+  virtual bool IsValuePinned() const override {
+    return iter_->IsValuePinned();
+  }
+
+ private:
+  void UpdateValid() {
+    valid_ = iter_->Valid() &&
+             (upper_bound_ == nullptr ||
+              ucmp_->Compare(ExtractUserKey(iter_->key()), *upper_bound_) < 0);
+  }
+
+  InternalIterator* iter_;
+  const Slice* lower_bound_;
+  const Slice* upper_bound_;
+  const Comparator* ucmp_;
+  bool valid_;
+};
+}  // namespace
+
 const char* GetFlushReasonString (FlushReason flush_reason) {
   switch (flush_reason) {
     case FlushReason::kOthers:
@@ -279,6 +371,111 @@ void FlushJob::Cancel() {
   base_->Unref();
 }
 
+void FlushJob::GenerateSubrangeBoundaries(
+    std::vector<std::string>* boundaries) {
+  uint64_t min_subrange_size = kMinFlushSubrangeSize;
+  TEST_SYNC_POINT_CALLBACK(
+      "FlushJob::GenerateSubrangeBoundaries:MinSubrangeSize",
+      &min_subrange_size);
+  const size_t max_subranges = db_options_.max_flush_subranges;
+  std::vector<Slice> keys;
+  std::vector<uint64_t> sizes;
+  uint64_t total_size = 0;
+  for (MemTable* m : mems_) {
+    m->SampleUserKeys(kFlushSubrangeSamples * max_subranges, &keys, &sizes);
+  }
+  for (uint64_t size : sizes) {
+    total_size += size;
+  }
+  size_t num_subranges = static_cast<size_t>(
+      std::min<uint64_t>(max_subranges, total_size / min_subrange_size));
+  if (num_subranges < 2) {
+    return;
+  }
+
+  // The keys sampled from each memtable are sorted, but not across them
+  const Comparator* ucmp = cfd_->user_comparator();
+  std::vector<size_t> order(keys.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+    return ucmp->Compare(keys[a], keys[b]) < 0;
+  });
+  uint64_t cumulative_size = 0;
+  for (size_t i : order) {
+    if (boundaries->size() + 1 == num_subranges) {
+      break;
+    }
+    uint64_t target = total_size * (boundaries->size() + 1) / num_subranges;
+    if (cumulative_size >= target &&
+        (boundaries->empty() || ucmp->Compare(boundaries->back(), keys[i]) < 0)) {
+      boundaries->push_back(keys[i].ToString());
+    }
+    cumulative_size += sizes[i];
+  }
+}
+
+void FlushJob::BuildSubrangeTable(
+    SubrangeState* state,
+    const std::vector<std::pair<std::string, std::string>>& range_dels,
+    uint64_t current_time, uint64_t oldest_key_time,
+    Env::WriteLifeTimeHint write_hint) {
+  const InternalKeyComparator& icmp = cfd_->internal_comparator();
+  const Comparator* ucmp = cfd_->user_comparator();
+  ReadOptions ro;
+  ro.total_order_seek = true;
+  Arena arena;
+  std::vector<InternalIterator*> memtables;
+  for (MemTable* m : mems_) {
+    memtables.push_back(m->NewIterator(ro, &arena));
+  }
+  ScopedArenaIterator merging_iter(
+      NewMergingIterator(&icmp, &memtables[0],
+                         static_cast<int>(memtables.size()), &arena));
+  SubrangeIterator iter(merging_iter.get(), state->lower_bound,
+                        state->upper_bound, ucmp);
+
+  // Clip the range tombstones to the bounds, so that the files do not
+  // overlap
+  std::vector<std::string> keys;
+  std::vector<std::string> values;
+  for (const auto& range_del : range_dels) {
+    ParsedInternalKey parsed_key;
+    if (!ParseInternalKey(range_del.first, &parsed_key)) {
+      state->status = Status::Corruption("Unable to parse range tombstone");
+      return;
+    }
+    RangeTombstone tombstone(parsed_key, range_del.second);
+    if (state->lower_bound != nullptr &&
+        ucmp->Compare(tombstone.start_key_, *state->lower_bound) < 0) {
+      tombstone.start_key_ = *state->lower_bound;
+    }
+    if (state->upper_bound != nullptr &&
+        ucmp->Compare(tombstone.end_key_, *state->upper_bound) > 0) {
+      tombstone.end_key_ = *state->upper_bound;
+    }
+    if (ucmp->Compare(tombstone.start_key_, tombstone.end_key_) >= 0) {
+      continue;
+    }
+    auto kv = tombstone.Serialize();
+    keys.push_back(kv.first.Encode().ToString());
+    values.push_back(kv.second.ToString());
+  }
+  std::unique_ptr<InternalIterator> range_del_iter(
+      new VectorIterator(std::move(keys), std::move(values), &icmp));
+
+  state->status = BuildTable(
+      dbname_, db_options_.env, *cfd_->ioptions(), mutable_cf_options_,
+      env_options_, cfd_->table_cache(), &iter, std::move(range_del_iter),
+      &state->meta, icmp, cfd_->int_tbl_prop_collector_factories(),
+      cfd_->GetID(), cfd_->GetName(), existing_snapshots_,
+      earliest_write_conflict_snapshot_, snapshot_checker_,
+      output_compression_, cfd_->ioptions()->compression_opts,
+      mutable_cf_options_.paranoid_file_checks, cfd_->internal_stats(),
+      TableFileCreationReason::kFlush, event_logger_, job_context_->job_id,
+      Env::IO_HIGH, &state->table_properties, 0 /* level */, current_time,
+      oldest_key_time, write_hint);
+}
+
 Status FlushJob::WriteLevel0Table() {
   AutoThreadOperationStageUpdater stage_updater(
       ThreadStatus::STAGE_FLUSH_WRITE_L0);
@@ -291,6 +488,12 @@ Status FlushJob::WriteLevel0Table() {
     if (log_buffer_) {
       log_buffer_->FlushBufferToLog();
     }
+    // The user keys splitting the flush into several key ranges, if any
+    std::vector<std::string> boundaries;
+    if (db_options_.max_flush_subranges > 1 &&
+        cfd_->ioptions()->compaction_style == kCompactionStyleLevel) {
+      GenerateSubrangeBoundaries(&boundaries);
+    }
     // memtables and range_del_iters store internal iterators over each data
     // memtable and its associated range deletion memtable, respectively, at
     // corresponding indexes.
@@ -306,7 +509,9 @@ Status FlushJob::WriteLevel0Table() {
           db_options_.info_log,
           "[%s] [JOB %d] Flushing memtable with next log file: %" PRIu64 "\n",
           cfd_->GetName().c_str(), job_context_->job_id, m->GetNextLogNumber());
-      memtables.push_back(m->NewIterator(ro, &arena));
+      if (boundaries.empty()) {
+        memtables.push_back(m->NewIterator(ro, &arena));
+      }
       auto* range_del_iter =
           m->NewRangeTombstoneIterator(ro, versions_->LastSequence());
       if (range_del_iter != nullptr) {
@@ -325,7 +530,23 @@ Status FlushJob::WriteLevel0Table() {
         << total_memory_usage << "flush_reason"
         << GetFlushReasonString(cfd_->GetFlushReason());
 
-    {
+    TEST_SYNC_POINT_CALLBACK("FlushJob::WriteLevel0Table:output_compression",
+                             &output_compression_);
+    int64_t _current_time = 0;
+    auto status = db_options_.env->GetCurrentTime(&_current_time);
+    // Safe to proceed even if GetCurrentTime fails. So, log and proceed.
+    if (!status.ok()) {
+      ROCKS_LOG_WARN(
+          db_options_.info_log,
+          "Failed to get current time to populate creation_time property. "
+          "Status: %s",
+          status.ToString().c_str());
+    }
+    const uint64_t current_time = static_cast<uint64_t>(_current_time);
+
+    uint64_t oldest_key_time = mems_.front()->ApproximateOldestKeyTime();
+
+    if (boundaries.empty()) {
       ScopedArenaIterator iter(
           NewMergingIterator(&cfd_->internal_comparator(), &memtables[0],
                              static_cast<int>(memtables.size()), &arena));
@@ -338,23 +559,6 @@ Status FlushJob::WriteLevel0Table() {
                      cfd_->GetName().c_str(), job_context_->job_id,
                      meta_.fd.GetNumber());
 
-      TEST_SYNC_POINT_CALLBACK("FlushJob::WriteLevel0Table:output_compression",
-                               &output_compression_);
-      int64_t _current_time = 0;
-      auto status = db_options_.env->GetCurrentTime(&_current_time);
-      // Safe to proceed even if GetCurrentTime fails. So, log and proceed.
-      if (!status.ok()) {
-        ROCKS_LOG_WARN(
-            db_options_.info_log,
-            "Failed to get current time to populate creation_time property. "
-            "Status: %s",
-            status.ToString().c_str());
-      }
-      const uint64_t current_time = static_cast<uint64_t>(_current_time);
-
-      uint64_t oldest_key_time =
-          mems_.front()->ApproximateOldestKeyTime();
-
       s = BuildTable(
           dbname_, db_options_.env, *cfd_->ioptions(), mutable_cf_options_,
           env_options_, cfd_->table_cache(), iter.get(),
@@ -368,15 +572,97 @@ Status FlushJob::WriteLevel0Table() {
           Env::IO_HIGH, &table_properties_, 0 /* level */, current_time,
           oldest_key_time, write_hint);
       LogFlush(db_options_.info_log);
+      ROCKS_LOG_INFO(db_options_.info_log,
+                     "[%s] [JOB %d] Level-0 flush table #%" PRIu64 ": %" PRIu64
+                     " bytes %s"
+                     "%s",
+                     cfd_->GetName().c_str(), job_context_->job_id,
+                     meta_.fd.GetNumber(), meta_.fd.GetFileSize(),
+                     s.ToString().c_str(),
+                     meta_.marked_for_compaction ? " (needs compaction)" : "");
+    } else {
+      // Every key range clips the range tombstones of all the memtables
+      std::vector<std::pair<std::string, std::string>> range_dels;
+      for (auto* range_del_iter : range_del_iters) {
+        std::unique_ptr<InternalIterator> iter_guard(range_del_iter);
+        for (range_del_iter->SeekToFirst(); range_del_iter->Valid();
+             range_del_iter->Next()) {
+          range_dels.emplace_back(range_del_iter->key().ToString(),
+                                  range_del_iter->value().ToString());
+        }
+        if (s.ok()) {
+          s = range_del_iter->status();
+        }
+      }
+
+      std::vector<Slice> bounds(boundaries.begin(), boundaries.end());
+      std::vector<SubrangeState> subranges(bounds.size() + 1);
+      for (size_t i = 0; i < subranges.size(); i++) {
+        if (i > 0) {
+          subranges[i].lower_bound = &bounds[i - 1];
+          // path 0 for level 0 file.
+          subranges[i].meta.fd =
+              FileDescriptor(versions_->NewFileNumber(), 0, 0);
+        } else {
+          subranges[i].meta.fd = meta_.fd;
+        }
+        if (i < bounds.size()) {
+          subranges[i].upper_bound = &bounds[i];
+        }
+        ROCKS_LOG_INFO(db_options_.info_log,
+                       "[%s] [JOB %d] Level-0 flush table #%" PRIu64
+                       " (key range %" ROCKSDB_PRIszt "): started",
+                       cfd_->GetName().c_str(), job_context_->job_id,
+                       subranges[i].meta.fd.GetNumber(), i);
+      }
+
+      if (s.ok()) {
+        // Build the first key range in this thread, and the others in new
+        // ones, like subcompactions
+        std::vector<port::Thread> thread_pool;
+        thread_pool.reserve(subranges.size() - 1);
+        for (size_t i = 1; i < subranges.size(); i++) {
+          thread_pool.emplace_back([&, i]() {
+            BuildSubrangeTable(&subranges[i], range_dels, current_time,
+                               oldest_key_time, write_hint);
+            // The IO stats of this thread are not reported by
+            // RecordFlushIOStats()
+            RecordTick(stats_, FLUSH_WRITE_BYTES, IOSTATS(bytes_written));
+          });
+        }
+        BuildSubrangeTable(&subranges[0], range_dels, current_time,
+                           oldest_key_time, write_hint);
+        for (auto& thread : thread_pool) {
+          thread.join();
+        }
+        LogFlush(db_options_.info_log);
+
+        meta_ = subranges[0].meta;
+        table_properties_ = subranges[0].table_properties;
+        for (size_t i = 0; i < subranges.size(); i++) {
+          const FileMetaData& meta = subranges[i].meta;
+          ROCKS_LOG_INFO(
+              db_options_.info_log,
+              "[%s] [JOB %d] Level-0 flush table #%" PRIu64 ": %" PRIu64
+              " bytes %s"
+              "%s",
+              cfd_->GetName().c_str(), job_context_->job_id,
+              meta.fd.GetNumber(), meta.fd.GetFileSize(),
+              subranges[i].status.ToString().c_str(),
+              meta.marked_for_compaction ? " (needs compaction)" : "");
+          if (s.ok()) {
+            s = subranges[i].status;
+          }
+          if (i > 0 && meta.fd.GetFileSize() > 0) {
+            table_properties_.Add(subranges[i].table_properties);
+            subrange_metas_.push_back(meta);
+          }
+        }
+        if (!s.ok()) {
+          subrange_metas_.clear();
+        }
+      }
     }
-    ROCKS_LOG_INFO(db_options_.info_log,
-                   "[%s] [JOB %d] Level-0 flush table #%" PRIu64 ": %" PRIu64
-                   " bytes %s"
-                   "%s",
-                   cfd_->GetName().c_str(), job_context_->job_id,
-                   meta_.fd.GetNumber(), meta_.fd.GetFileSize(),
-                   s.ToString().c_str(),
-                   meta_.marked_for_compaction ? " (needs compaction)" : "");
 
     if (s.ok() && output_file_directory_ != nullptr && sync_output_directory_) {
       s = output_file_directory_->Fsync();
@@ -388,6 +674,7 @@ Status FlushJob::WriteLevel0Table() {
 
   // Note that if file_size is zero, the file has been deleted and
   // should not be added to the manifest.
+  uint64_t bytes_written = meta_.fd.GetFileSize();
   if (s.ok() && meta_.fd.GetFileSize() > 0) {
     // if we have more than 1 background thread, then we cannot
     // insert files directly into higher levels because some other
@@ -399,15 +686,26 @@ Status FlushJob::WriteLevel0Table() {
                    meta_.fd.smallest_seqno, meta_.fd.largest_seqno,
                    meta_.marked_for_compaction);
   }
+  // The files of the other key ranges do not overlap it, and are installed
+  // in L0 along with it
+  for (const auto& meta : subrange_metas_) {
+    if (s.ok()) {
+      edit_->AddFile(0 /* level */, meta.fd.GetNumber(), meta.fd.GetPathId(),
+                     meta.fd.GetFileSize(), meta.smallest, meta.largest,
+                     meta.fd.smallest_seqno, meta.fd.largest_seqno,
+                     meta.marked_for_compaction);
+    }
+    bytes_written += meta.fd.GetFileSize();
+  }
 
   // Note that here we treat flush as level 0 compaction in internal stats
   InternalStats::CompactionStats stats(CompactionReason::kFlush, 1);
   stats.micros = db_options_.env->NowMicros() - start_micros;
-  stats.bytes_written = meta_.fd.GetFileSize();
+  stats.bytes_written = bytes_written;
   MeasureTime(stats_, FLUSH_TIME, stats.micros);
   cfd_->internal_stats()->AddCompactionStats(0 /* level */, stats);
   cfd_->internal_stats()->AddCFStats(InternalStats::BYTES_FLUSHED,
-                                     meta_.fd.GetFileSize());
+                                     bytes_written);
   RecordFlushIOStats();
   return s;
 }
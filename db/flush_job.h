@@ -80,12 +80,41 @@ class FlushJob {
   void Cancel();
   TableProperties GetTableProperties() const { return table_properties_; }
   const autovector<MemTable*>& GetMemTables() const { return mems_; }
+  // The files written for the key ranges after the first one, in key order,
+  // when the flush was split. The file of the first range is the one Run()
+  // returns.
+  const std::vector<FileMetaData>& GetSubrangeFiles() const {
+    return subrange_metas_;
+  }
 
  private:
+  // A key range of a flush split across several threads, and the table that
+  // is built from it
+  struct SubrangeState {
+    // Inclusive, or null if the range starts with the first key
+    const Slice* lower_bound = nullptr;
+    // Exclusive, or null if the range ends with the last key
+    const Slice* upper_bound = nullptr;
+    FileMetaData meta;
+    TableProperties table_properties;
+    Status status;
+  };
+
   void ReportStartedFlush();
   void ReportFlushInputSize(const autovector<MemTable*>& mems);
   void RecordFlushIOStats();
   Status WriteLevel0Table();
+  // Samples the memtables to split their key range into up to
+  // max_flush_subranges ranges of about the same size, and stores the user
+  // keys starting each range but the first one in *boundaries.
+  void GenerateSubrangeBoundaries(std::vector<std::string>* boundaries);
+  // range_dels holds the range tombstones of all the memtables, as pairs of
+  // internal start key and end user key.
+  void BuildSubrangeTable(
+      SubrangeState* state,
+      const std::vector<std::pair<std::string, std::string>>& range_dels,
+      uint64_t current_time, uint64_t oldest_key_time,
+      Env::WriteLifeTimeHint write_hint);
 
   const std::string& dbname_;
   ColumnFamilyData* cfd_;
@@ -131,6 +160,10 @@ class FlushJob {
   // commit to the MANIFEST.
   const bool write_manifest_;
 
+  // The files of the key ranges after the first one, set by
+  // WriteLevel0Table() when the flush is split
+  std::vector<FileMetaData> subrange_metas_;
+
   // Variables below are set by PickMemTable():
   FileMetaData meta_;
   autovector<MemTable*> mems_;
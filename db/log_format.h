@@ -29,8 +29,14 @@ enum RecordType {
   kRecyclableFirstType = 6,
   kRecyclableMiddleType = 7,
   kRecyclableLastType = 8,
+
+  // Compression type of the records that follow, the first record of a log
+  // file written with wal_compression. Its payload is the CompressionType,
+  // on one byte.
+  kSetCompressionType = 9,
+  kRecyclableSetCompressionType = 10,
 };
-static const int kMaxRecordType = kRecyclableLastType;
+static const int kMaxRecordType = kRecyclableSetCompressionType;
 
 static const unsigned int kBlockSize = 32768;
 
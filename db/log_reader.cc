@@ -39,7 +39,9 @@ Reader::Reader(std::shared_ptr<Logger> info_log,
       end_of_buffer_offset_(0),
       log_number_(log_num),
       recycled_(false),
-      retry_after_eof_(retry_after_eof) {}
+      retry_after_eof_(retry_after_eof),
+      compression_type_(kNoCompression),
+      compression_type_record_read_(false) {}
 
 Reader::~Reader() {
   delete[] backing_store_;
@@ -79,6 +81,10 @@ bool Reader::ReadRecord(Slice* record, std::string* scratch,
         prospective_record_offset = physical_record_offset;
         scratch->clear();
         *record = fragment;
+        if (!UncompressRecord(record)) {
+          in_fragmented_record = false;
+          break;
+        }
         last_record_offset_ = prospective_record_offset;
         return true;
 
@@ -114,11 +120,26 @@ bool Reader::ReadRecord(Slice* record, std::string* scratch,
         } else {
           scratch->append(fragment.data(), fragment.size());
           *record = Slice(*scratch);
+          if (!UncompressRecord(record)) {
+            in_fragmented_record = false;
+            scratch->clear();
+            break;
+          }
           last_record_offset_ = prospective_record_offset;
           return true;
         }
         break;
 
+      case kSetCompressionType:
+      case kRecyclableSetCompressionType:
+        if (in_fragmented_record) {
+          ReportCorruption(scratch->size(), "partial record without end(3)");
+          in_fragmented_record = false;
+          scratch->clear();
+        }
+        ReadCompressionTypeRecord(fragment);
+        break;
+
       case kBadHeader:
         if (wal_recovery_mode == WALRecoveryMode::kAbsoluteConsistency) {
           // in clean shutdown we don't expect any error in the log files
@@ -199,6 +220,37 @@ bool Reader::ReadRecord(Slice* record, std::string* scratch,
   return false;
 }
 
+bool Reader::UncompressRecord(Slice* record) {
+  if (!compression_type_record_read_) {
+    return true;
+  }
+  if (uncompress_ == nullptr) {
+    ReportCorruption(record->size(), "unsupported compression type");
+    return false;
+  }
+  Status s = uncompress_->Uncompress(*record, &uncompressed_record_);
+  if (!s.ok()) {
+    ReportDrop(record->size(), s);
+    return false;
+  }
+  *record = Slice(uncompressed_record_);
+  return true;
+}
+
+void Reader::ReadCompressionTypeRecord(const Slice& fragment) {
+  if (compression_type_record_read_) {
+    ReportCorruption(fragment.size(), "multiple SetCompressionType records");
+    return;
+  }
+  if (fragment.size() != 1) {
+    ReportCorruption(fragment.size(), "bad SetCompressionType record");
+    return;
+  }
+  compression_type_ = static_cast<CompressionType>(fragment[0]);
+  compression_type_record_read_ = true;
+  uncompress_.reset(StreamingUncompress::Create(compression_type_));
+}
+
 uint64_t Reader::LastRecordOffset() {
   return last_record_offset_;
 }
@@ -336,7 +388,8 @@ unsigned int Reader::ReadPhysicalRecord(Slice* result, size_t* drop_size) {
     const unsigned int type = header[6];
     const uint32_t length = a | (b << 8);
     int header_size = kHeaderSize;
-    if (type >= kRecyclableFullType && type <= kRecyclableLastType) {
+    if ((type >= kRecyclableFullType && type <= kRecyclableLastType) ||
+        type == kRecyclableSetCompressionType) {
       if (end_of_buffer_offset_ - buffer_.size() == 0) {
         recycled_ = true;
       }
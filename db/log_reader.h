@@ -15,6 +15,7 @@
 #include "rocksdb/slice.h"
 #include "rocksdb/status.h"
 #include "rocksdb/options.h"
+#include "util/streaming_compression.h"
 
 namespace rocksdb {
 
@@ -27,6 +28,7 @@ namespace log {
 /**
  * Reader is a general purpose log stream reader implementation. The actual job
  * of reading from the device is implemented by the SequentialFile interface.
+ * Compressed records are uncompressed as they are read.
  *
  * Please see Writer for details on the file and record layout.
  */
@@ -115,6 +117,14 @@ class Reader {
   // etc.
   const bool retry_after_eof_;
 
+  // Set by the kSetCompressionType record of a compressed log
+  CompressionType compression_type_;
+  bool compression_type_record_read_;
+  // nullptr if the compression type is not supported
+  std::unique_ptr<StreamingUncompress> uncompress_;
+  // Holds the last record returned by ReadRecord, if compressed
+  std::string uncompressed_record_;
+
   // Extend record types with the following special values
   enum {
     kEof = kMaxRecordType + 1,
@@ -139,6 +149,12 @@ class Reader {
   // Read some more
   bool ReadMore(size_t* drop_size, int *error);
 
+  // Uncompresses *record in place, if the log is compressed. Reports a
+  // corruption and returns false if it fails.
+  bool UncompressRecord(Slice* record);
+
+  void ReadCompressionTypeRecord(const Slice& fragment);
+
   // Reports dropped bytes to the reporter.
   // buffer_ must be updated to remove the dropped bytes prior to invocation.
   void ReportCorruption(size_t bytes, const char* reason);
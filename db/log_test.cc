@@ -7,6 +7,9 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file. See the AUTHORS file for names of contributors.
 
+#include <tuple>
+#include <vector>
+
 #include "db/log_reader.h"
 #include "db/log_writer.h"
 #include "rocksdb/env.h"
@@ -43,7 +46,9 @@ static std::string RandomSkewedString(int i, Random* rnd) {
   return BigString(NumberString(i), rnd->Skewed(17));
 }
 
-class LogTest : public ::testing::TestWithParam<int> {
+// Param 0: recycle log files, param 1: compression type of the writer
+class LogTest
+    : public ::testing::TestWithParam<std::tuple<int, CompressionType>> {
  private:
   class StringSource : public SequentialFile {
    public:
@@ -162,11 +167,12 @@ class LogTest : public ::testing::TestWithParam<int> {
             new test::StringSink(&reader_contents_), "" /* don't care */)),
         source_holder_(test::GetSequentialFileReader(
             new StringSource(reader_contents_), "" /* file name */)),
-        writer_(std::move(dest_holder_), 123, GetParam()),
+        writer_(std::move(dest_holder_), 123, std::get<0>(GetParam()),
+                false /* manual_flush */, std::get<1>(GetParam())),
         reader_(nullptr, std::move(source_holder_), &report_,
                 true /* checksum */, 123 /* log_number */,
                 false /* retry_after_eof */) {
-    int header_size = GetParam() ? kRecyclableHeaderSize : kHeaderSize;
+    int header_size = std::get<0>(GetParam()) ? kRecyclableHeaderSize : kHeaderSize;
     initial_offset_last_record_offsets_[0] = 0;
     initial_offset_last_record_offsets_[1] = header_size + 10000;
     initial_offset_last_record_offsets_[2] = 2 * (header_size + 10000);
@@ -312,7 +318,7 @@ TEST_P(LogTest, Fragmentation) {
 
 TEST_P(LogTest, MarginalTrailer) {
   // Make a trailer that is exactly the same length as an empty record.
-  int header_size = GetParam() ? kRecyclableHeaderSize : kHeaderSize;
+  int header_size = std::get<0>(GetParam()) ? kRecyclableHeaderSize : kHeaderSize;
   const int n = kBlockSize - 2 * header_size;
   Write(BigString("foo", n));
   ASSERT_EQ((unsigned int)(kBlockSize - header_size), WrittenBytes());
@@ -326,7 +332,7 @@ TEST_P(LogTest, MarginalTrailer) {
 
 TEST_P(LogTest, MarginalTrailer2) {
   // Make a trailer that is exactly the same length as an empty record.
-  int header_size = GetParam() ? kRecyclableHeaderSize : kHeaderSize;
+  int header_size = std::get<0>(GetParam()) ? kRecyclableHeaderSize : kHeaderSize;
   const int n = kBlockSize - 2 * header_size;
   Write(BigString("foo", n));
   ASSERT_EQ((unsigned int)(kBlockSize - header_size), WrittenBytes());
@@ -339,7 +345,7 @@ TEST_P(LogTest, MarginalTrailer2) {
 }
 
 TEST_P(LogTest, ShortTrailer) {
-  int header_size = GetParam() ? kRecyclableHeaderSize : kHeaderSize;
+  int header_size = std::get<0>(GetParam()) ? kRecyclableHeaderSize : kHeaderSize;
   const int n = kBlockSize - 2 * header_size + 4;
   Write(BigString("foo", n));
   ASSERT_EQ((unsigned int)(kBlockSize - header_size + 4), WrittenBytes());
@@ -352,7 +358,7 @@ TEST_P(LogTest, ShortTrailer) {
 }
 
 TEST_P(LogTest, AlignedEof) {
-  int header_size = GetParam() ? kRecyclableHeaderSize : kHeaderSize;
+  int header_size = std::get<0>(GetParam()) ? kRecyclableHeaderSize : kHeaderSize;
   const int n = kBlockSize - 2 * header_size + 4;
   Write(BigString("foo", n));
   ASSERT_EQ((unsigned int)(kBlockSize - header_size + 4), WrittenBytes());
@@ -412,13 +418,13 @@ TEST_P(LogTest, TruncatedTrailingRecordIsNotIgnored) {
 }
 
 TEST_P(LogTest, BadLength) {
-  int header_size = GetParam() ? kRecyclableHeaderSize : kHeaderSize;
+  int header_size = std::get<0>(GetParam()) ? kRecyclableHeaderSize : kHeaderSize;
   const int kPayloadSize = kBlockSize - header_size;
   Write(BigString("bar", kPayloadSize));
   Write("foo");
   // Least significant size byte is stored in header[4].
   IncrementByte(4, 1);
-  if (!GetParam()) {
+  if (!std::get<0>(GetParam())) {
     ASSERT_EQ("foo", Read());
     ASSERT_EQ(kBlockSize, DroppedBytes());
     ASSERT_EQ("OK", MatchError("bad record length"));
@@ -447,7 +453,7 @@ TEST_P(LogTest, ChecksumMismatch) {
   Write("foooooo");
   IncrementByte(0, 14);
   ASSERT_EQ("EOF", Read());
-  if (!GetParam()) {
+  if (!std::get<0>(GetParam())) {
     ASSERT_EQ(14U, DroppedBytes());
     ASSERT_EQ("OK", MatchError("checksum mismatch"));
   } else {
@@ -458,8 +464,8 @@ TEST_P(LogTest, ChecksumMismatch) {
 
 TEST_P(LogTest, UnexpectedMiddleType) {
   Write("foo");
-  SetByte(6, static_cast<char>(GetParam() ? kRecyclableMiddleType : kMiddleType));
-  FixChecksum(0, 3, !!GetParam());
+  SetByte(6, static_cast<char>(std::get<0>(GetParam()) ? kRecyclableMiddleType : kMiddleType));
+  FixChecksum(0, 3, !!std::get<0>(GetParam()));
   ASSERT_EQ("EOF", Read());
   ASSERT_EQ(3U, DroppedBytes());
   ASSERT_EQ("OK", MatchError("missing start"));
@@ -467,8 +473,8 @@ TEST_P(LogTest, UnexpectedMiddleType) {
 
 TEST_P(LogTest, UnexpectedLastType) {
   Write("foo");
-  SetByte(6, static_cast<char>(GetParam() ? kRecyclableLastType : kLastType));
-  FixChecksum(0, 3, !!GetParam());
+  SetByte(6, static_cast<char>(std::get<0>(GetParam()) ? kRecyclableLastType : kLastType));
+  FixChecksum(0, 3, !!std::get<0>(GetParam()));
   ASSERT_EQ("EOF", Read());
   ASSERT_EQ(3U, DroppedBytes());
   ASSERT_EQ("OK", MatchError("missing start"));
@@ -477,8 +483,8 @@ TEST_P(LogTest, UnexpectedLastType) {
 TEST_P(LogTest, UnexpectedFullType) {
   Write("foo");
   Write("bar");
-  SetByte(6, static_cast<char>(GetParam() ? kRecyclableFirstType : kFirstType));
-  FixChecksum(0, 3, !!GetParam());
+  SetByte(6, static_cast<char>(std::get<0>(GetParam()) ? kRecyclableFirstType : kFirstType));
+  FixChecksum(0, 3, !!std::get<0>(GetParam()));
   ASSERT_EQ("bar", Read());
   ASSERT_EQ("EOF", Read());
   ASSERT_EQ(3U, DroppedBytes());
@@ -488,8 +494,8 @@ TEST_P(LogTest, UnexpectedFullType) {
 TEST_P(LogTest, UnexpectedFirstType) {
   Write("foo");
   Write(BigString("bar", 100000));
-  SetByte(6, static_cast<char>(GetParam() ? kRecyclableFirstType : kFirstType));
-  FixChecksum(0, 3, !!GetParam());
+  SetByte(6, static_cast<char>(std::get<0>(GetParam()) ? kRecyclableFirstType : kFirstType));
+  FixChecksum(0, 3, !!std::get<0>(GetParam()));
   ASSERT_EQ(BigString("bar", 100000), Read());
   ASSERT_EQ("EOF", Read());
   ASSERT_EQ(3U, DroppedBytes());
@@ -550,7 +556,7 @@ TEST_P(LogTest, ErrorJoinsRecords) {
     SetByte(offset, 'x');
   }
 
-  if (!GetParam()) {
+  if (!std::get<0>(GetParam())) {
     ASSERT_EQ("correct", Read());
     ASSERT_EQ("EOF", Read());
     size_t dropped = DroppedBytes();
@@ -564,7 +570,7 @@ TEST_P(LogTest, ErrorJoinsRecords) {
 TEST_P(LogTest, ClearEofSingleBlock) {
   Write("foo");
   Write("bar");
-  int header_size = GetParam() ? kRecyclableHeaderSize : kHeaderSize;
+  int header_size = std::get<0>(GetParam()) ? kRecyclableHeaderSize : kHeaderSize;
   ForceEOF(3 + header_size + 2);
   ASSERT_EQ("foo", Read());
   UnmarkEOF();
@@ -579,7 +585,7 @@ TEST_P(LogTest, ClearEofSingleBlock) {
 
 TEST_P(LogTest, ClearEofMultiBlock) {
   size_t num_full_blocks = 5;
-  int header_size = GetParam() ? kRecyclableHeaderSize : kHeaderSize;
+  int header_size = std::get<0>(GetParam()) ? kRecyclableHeaderSize : kHeaderSize;
   size_t n = (kBlockSize - header_size) * num_full_blocks + 25;
   Write(BigString("foo", n));
   Write(BigString("bar", n));
@@ -628,7 +634,7 @@ TEST_P(LogTest, ClearEofError2) {
 }
 
 TEST_P(LogTest, Recycle) {
-  if (!GetParam()) {
+  if (!std::get<0>(GetParam())) {
     return;  // test is only valid for recycled logs
   }
   Write("foo");
@@ -651,7 +657,130 @@ TEST_P(LogTest, Recycle) {
   ASSERT_EQ("EOF", Read());
 }
 
-INSTANTIATE_TEST_CASE_P(bool, LogTest, ::testing::Values(0, 2));
+INSTANTIATE_TEST_CASE_P(bool, LogTest,
+                        ::testing::Combine(::testing::Values(0, 2),
+                                           ::testing::Values(kNoCompression)));
+
+// Tests of logs whose records are compressed. They are skipped for the
+// compression types that this build does not support.
+class CompressionLogTest : public LogTest {
+ public:
+  bool Supported() const {
+    return StreamingCompressionTypeSupported(std::get<1>(GetParam()));
+  }
+};
+
+TEST_P(CompressionLogTest, Empty) {
+  if (!Supported()) {
+    return;
+  }
+  ASSERT_EQ("EOF", Read());
+}
+
+TEST_P(CompressionLogTest, ReadWrite) {
+  if (!Supported()) {
+    return;
+  }
+  Write("foo");
+  Write("bar");
+  Write("");
+  Write("xxxx");
+  ASSERT_EQ("foo", Read());
+  ASSERT_EQ("bar", Read());
+  ASSERT_EQ("", Read());
+  ASSERT_EQ("xxxx", Read());
+  ASSERT_EQ("EOF", Read());
+  ASSERT_EQ("EOF", Read());
+}
+
+TEST_P(CompressionLogTest, ManyBlocks) {
+  if (!Supported()) {
+    return;
+  }
+  for (int i = 0; i < 100000; i++) {
+    Write(NumberString(i));
+  }
+  for (int i = 0; i < 100000; i++) {
+    ASSERT_EQ(NumberString(i), Read());
+  }
+  ASSERT_EQ("EOF", Read());
+}
+
+TEST_P(CompressionLogTest, Fragmentation) {
+  if (!Supported()) {
+    return;
+  }
+  Random rnd(301);
+  std::vector<std::string> records;
+  records.push_back("small");
+  records.push_back(BigString("medium", 50000));
+  // Barely compresses, hence spans several blocks
+  std::string random_record;
+  test::RandomString(&rnd, 100000, &random_record);
+  records.push_back(random_record);
+  records.push_back(BigString("large", 1000000));
+  for (const auto& record : records) {
+    Write(record);
+  }
+  for (const auto& record : records) {
+    ASSERT_EQ(record, Read());
+  }
+  ASSERT_EQ("EOF", Read());
+  ASSERT_EQ(0U, DroppedBytes());
+}
+
+TEST_P(CompressionLogTest, CompressesAcrossRecords) {
+  if (!Supported()) {
+    return;
+  }
+  // The records compress well only with the previous ones as history
+  Random rnd(301);
+  std::string value;
+  test::RandomString(&rnd, 1000, &value);
+  size_t total_size = 0;
+  for (int i = 0; i < 100; i++) {
+    std::string record = NumberString(i) + value;
+    total_size += record.size();
+    Write(record);
+  }
+  ASSERT_LT(WrittenBytes(), total_size / 10);
+  for (int i = 0; i < 100; i++) {
+    ASSERT_EQ(NumberString(i) + value, Read());
+  }
+  ASSERT_EQ("EOF", Read());
+}
+
+TEST_P(CompressionLogTest, Recycle) {
+  if (!Supported() || !std::get<0>(GetParam())) {
+    return;  // test is only valid for recycled logs
+  }
+  Random rnd(301);
+  for (int i = 0; i < 5; i++) {
+    Write(NumberString(i));
+  }
+  while (get_reader_contents()->size() < log::kBlockSize * 2) {
+    std::string record;
+    test::RandomString(&rnd, 100, &record);
+    Write(record);
+  }
+  std::unique_ptr<WritableFileWriter> dest_holder(test::GetWritableFileWriter(
+      new test::OverwritingStringSink(get_reader_contents()),
+      "" /* don't care */));
+  Writer recycle_writer(std::move(dest_holder), 123, true,
+                        false /* manual_flush */, std::get<1>(GetParam()));
+  recycle_writer.AddRecord(Slice("foooo"));
+  recycle_writer.AddRecord(Slice("bar"));
+  ASSERT_GE(get_reader_contents()->size(), log::kBlockSize * 2);
+  ASSERT_EQ("foooo", Read());
+  ASSERT_EQ("bar", Read());
+  ASSERT_EQ("EOF", Read());
+}
+
+INSTANTIATE_TEST_CASE_P(
+    Compression, CompressionLogTest,
+    ::testing::Combine(::testing::Values(0, 2),
+                       ::testing::Values(kZlibCompression, kLZ4Compression,
+                                         kZSTD)));
 
 class RetriableLogTest : public ::testing::TestWithParam<int> {
  private:
@@ -19,16 +19,25 @@ namespace rocksdb {
 namespace log {
 
 Writer::Writer(unique_ptr<WritableFileWriter>&& dest, uint64_t log_number,
-               bool recycle_log_files, bool manual_flush)
+               bool recycle_log_files, bool manual_flush,
+               CompressionType compression_type)
     : dest_(std::move(dest)),
       block_offset_(0),
       log_number_(log_number),
       recycle_log_files_(recycle_log_files),
-      manual_flush_(manual_flush) {
+      manual_flush_(manual_flush),
+      compression_type_(kNoCompression),
+      compression_type_record_added_(false) {
   for (int i = 0; i <= kMaxRecordType; i++) {
     char t = static_cast<char>(i);
     type_crc_[i] = crc32c::Value(&t, 1);
   }
+  if (compression_type != kNoCompression) {
+    compress_.reset(StreamingCompress::Create(compression_type));
+    if (compress_ != nullptr) {
+      compression_type_ = compression_type;
+    }
+  }
 }
 
 Writer::~Writer() { WriteBuffer(); }
@@ -39,6 +48,23 @@ Status Writer::AddRecord(const Slice& slice) {
   const char* ptr = slice.data();
   size_t left = slice.size();
 
+  Status s;
+  if (compress_ != nullptr) {
+    if (!compression_type_record_added_) {
+      s = AddCompressionTypeRecord();
+      if (!s.ok()) {
+        return s;
+      }
+    }
+    compressed_buffer_.clear();
+    s = compress_->Compress(slice, &compressed_buffer_);
+    if (!s.ok()) {
+      return s;
+    }
+    ptr = compressed_buffer_.data();
+    left = compressed_buffer_.size();
+  }
+
   // Header size varies depending on whether we are recycling or not.
   const int header_size =
       recycle_log_files_ ? kRecyclableHeaderSize : kHeaderSize;
@@ -46,7 +72,6 @@ Status Writer::AddRecord(const Slice& slice) {
   // Fragment the record if necessary and emit it.  Note that if slice
   // is empty, we still want to iterate once to emit a single
   // zero-length record
-  Status s;
   bool begin = true;
   do {
     const int64_t leftover = kBlockSize - block_offset_;
@@ -92,6 +117,19 @@ Status Writer::AddRecord(const Slice& slice) {
   return s;
 }
 
+Status Writer::AddCompressionTypeRecord() {
+  // The first record of the file, so there is room for it in the block
+  assert(block_offset_ == 0);
+  const char type = static_cast<char>(compression_type_);
+  Status s = EmitPhysicalRecord(
+      recycle_log_files_ ? kRecyclableSetCompressionType : kSetCompressionType,
+      &type, 1);
+  if (s.ok()) {
+    compression_type_record_added_ = true;
+  }
+  return s;
+}
+
 bool Writer::TEST_BufferIsEmpty() { return dest_->TEST_BufferIsEmpty(); }
 
 Status Writer::EmitPhysicalRecord(RecordType t, const char* ptr, size_t n) {
@@ -106,7 +144,7 @@ Status Writer::EmitPhysicalRecord(RecordType t, const char* ptr, size_t n) {
   buf[6] = static_cast<char>(t);
 
   uint32_t crc = type_crc_[t];
-  if (t < kRecyclableFullType) {
+  if (t < kRecyclableFullType || t == kSetCompressionType) {
     // Legacy record format
     assert(block_offset_ + kHeaderSize + n <= kBlockSize);
     header_size = kHeaderSize;
@@ -13,8 +13,10 @@
 #include <memory>
 
 #include "db/log_format.h"
+#include "rocksdb/options.h"
 #include "rocksdb/slice.h"
 #include "rocksdb/status.h"
+#include "util/streaming_compression.h"
 
 namespace rocksdb {
 
@@ -66,14 +68,27 @@ namespace log {
  * Same as above, with the addition of
  * Log number = 32bit log file number, so that we can distinguish between
  * records written by the most recent log writer vs a previous one.
+ *
+ * Compressed records:
+ *
+ * When the writer compresses the records, the first record of the file is a
+ * kSetCompressionType (or kRecyclableSetCompressionType) record, whose
+ * payload is the compression type. Every following record is compressed
+ * before it is fragmented as above, with a compression context kept across
+ * the records of the file, so the records must be read in order.
  */
 class Writer {
  public:
   // Create a writer that will append data to "*dest".
   // "*dest" must be initially empty.
   // "*dest" must remain live while this Writer is in use.
+  //
+  // If compression_type is not kNoCompression, the records are compressed
+  // with it, if StreamingCompressionTypeSupported(), and written as they are
+  // otherwise.
   explicit Writer(unique_ptr<WritableFileWriter>&& dest, uint64_t log_number,
-                  bool recycle_log_files, bool manual_flush = false);
+                  bool recycle_log_files, bool manual_flush = false,
+                  CompressionType compression_type = kNoCompression);
   ~Writer();
 
   Status AddRecord(const Slice& slice);
@@ -100,6 +115,16 @@ class Writer {
 
   Status EmitPhysicalRecord(RecordType type, const char* ptr, size_t length);
 
+  // Emits the kSetCompressionType record, before the first record
+  Status AddCompressionTypeRecord();
+
+  // Compresses the records if not nullptr
+  std::unique_ptr<StreamingCompress> compress_;
+  CompressionType compression_type_;
+  bool compression_type_record_added_;
+  // The last compressed record, reused across records
+  std::string compressed_buffer_;
+
   // If true, it does not flush after each write. Instead it relies on the upper
   // layer to manually does the flush by calling ::WriteBuffer()
   bool manual_flush_;
@@ -50,6 +50,10 @@ ImmutableMemTableOptions::ImmutableMemTableOptions(
               static_cast<double>(mutable_cf_options.write_buffer_size) *
               mutable_cf_options.memtable_prefix_bloom_size_ratio) *
           8u),
+      memtable_hash_index_buckets(static_cast<size_t>(
+          static_cast<double>(mutable_cf_options.write_buffer_size) *
+          mutable_cf_options.memtable_hash_index_size_ratio /
+          sizeof(void*))),
       memtable_huge_page_size(mutable_cf_options.memtable_huge_page_size),
       inplace_update_support(ioptions.inplace_update_support),
       inplace_update_num_locks(mutable_cf_options.inplace_update_num_locks),
@@ -115,6 +119,11 @@ MemTable::MemTable(const InternalKeyComparator& cmp,
         6 /* hard coded 6 probes */, nullptr, moptions_.memtable_huge_page_size,
         ioptions.info_log));
   }
+  if (moptions_.memtable_hash_index_buckets > 0) {
+    hash_index_.reset(new MemTableHashIndex(
+        &arena_, moptions_.memtable_hash_index_buckets,
+        moptions_.memtable_huge_page_size, ioptions.info_log));
+  }
 }
 
 MemTable::~MemTable() {
@@ -458,6 +467,22 @@ MemTable::MemTableStats MemTable::ApproximateStats(const Slice& start_ikey,
   return {entry_count * (data_size / n), entry_count};
 }
 
+void MemTable::SampleUserKeys(size_t min_keys, std::vector<Slice>* user_keys,
+                              std::vector<uint64_t>* sizes) {
+  std::vector<const char*> keys;
+  std::vector<uint64_t> weights;
+  table_->SampleKeys(min_keys, &keys, &weights);
+  uint64_t n = num_entries_.load(std::memory_order_relaxed);
+  if (keys.empty() || n == 0) {
+    return;
+  }
+  uint64_t entry_size = data_size_.load(std::memory_order_relaxed) / n;
+  for (size_t i = 0; i < keys.size(); i++) {
+    user_keys->push_back(ExtractUserKey(GetLengthPrefixedSlice(keys[i])));
+    sizes->push_back(weights[i] * entry_size);
+  }
+}
+
 bool MemTable::Add(SequenceNumber s, ValueType type,
                    const Slice& key, /* user key */
                    const Slice& value, bool allow_concurrent,
@@ -519,6 +544,9 @@ bool MemTable::Add(SequenceNumber s, ValueType type,
       assert(prefix_extractor_);
       prefix_bloom_->Add(prefix_extractor_->Transform(key));
     }
+    if (hash_index_ && type != kTypeRangeDeletion) {
+      hash_index_->Add(key, s, buf);
+    }
 
     // The first sequence number inserted into the memtable
     assert(first_seqno_ == 0 || s >= first_seqno_);
@@ -550,6 +578,9 @@ bool MemTable::Add(SequenceNumber s, ValueType type,
       assert(prefix_extractor_);
       prefix_bloom_->AddConcurrently(prefix_extractor_->Transform(key));
     }
+    if (hash_index_ && type != kTypeRangeDeletion) {
+      hash_index_->Add(key, s, buf);
+    }
 
     // atomically update first_seqno_ and earliest_seqno_.
     uint64_t cur_seq_num = first_seqno_.load(std::memory_order_relaxed);
@@ -784,7 +815,11 @@ bool MemTable::Get(const LookupKey& key, std::string* value, Status* s,
     saver.env_ = env_;
     saver.callback_ = callback;
     saver.is_blob_index = is_blob_index;
-    table_->Get(key, &saver, SaveValue);
+    if (hash_index_ != nullptr && callback == nullptr) {
+      GetFromHashIndex(key, &saver);
+    } else {
+      table_->Get(key, &saver, SaveValue);
+    }
 
     *seq = saver.seq;
   }
@@ -797,6 +832,28 @@ bool MemTable::Get(const LookupKey& key, std::string* value, Status* s,
   return found_final_value;
 }
 
+void MemTable::GetFromHashIndex(const LookupKey& key, void* saver) {
+  // All the writes up to the sequence number of the read were added to the
+  // index before that sequence number became visible, so a key missing from
+  // the index has no entry visible to the read.
+  const char* entry = hash_index_->Get(key.user_key());
+  if (entry == nullptr) {
+    return;
+  }
+  uint32_t key_length = 0;
+  const char* key_ptr = GetVarint32Ptr(entry, entry + 5, &key_length);
+  ValueType type;
+  SequenceNumber seq;
+  UnPackSequenceAndType(DecodeFixed64(key_ptr + key_length - 8), &seq, &type);
+  if (seq > GetInternalKeySeqno(key.internal_key()) || type == kTypeMerge) {
+    // The newest entry is not in the snapshot, or its merge operands have to
+    // be collected in order
+    table_->Get(key, saver, SaveValue);
+  } else {
+    SaveValue(saver, entry);
+  }
+}
+
 void MemTable::Update(SequenceNumber seq,
                       const Slice& key,
                       const Slice& value) {
@@ -19,6 +19,7 @@
 #include "db/range_tombstone_fragmenter.h"
 #include "db/read_callback.h"
 #include "db/version_edit.h"
+#include "memtable/memtable_hash_index.h"
 #include "monitoring/instrumented_mutex.h"
 #include "options/cf_options.h"
 #include "rocksdb/db.h"
@@ -40,6 +41,7 @@ struct ImmutableMemTableOptions {
                                     const MutableCFOptions& mutable_cf_options);
   size_t arena_block_size;
   uint32_t memtable_prefix_bloom_bits;
+  size_t memtable_hash_index_buckets;
   size_t memtable_huge_page_size;
   bool inplace_update_support;
   size_t inplace_update_num_locks;
@@ -366,6 +368,14 @@ class MemTable {
   MemTableStats ApproximateStats(const Slice& start_ikey,
                                  const Slice& end_ikey);
 
+  // Append to *user_keys the user keys of some of the entries, in order, and
+  // to *sizes the approximate size of the data each of them stands for. At
+  // least min_keys keys are sampled if the memtable holds that many entries
+  // and its MemTableRep supports sampling. The user keys point into the
+  // memtable.
+  void SampleUserKeys(size_t min_keys, std::vector<Slice>* user_keys,
+                      std::vector<uint64_t>* sizes);
+
   // Get the lock associated for the key
   port::RWMutex* GetLock(const Slice& key);
 
@@ -449,6 +459,7 @@ class MemTable {
 
   const SliceTransform* const prefix_extractor_;
   std::unique_ptr<DynamicBloom> prefix_bloom_;
+  std::unique_ptr<MemTableHashIndex> hash_index_;
 
   std::atomic<FlushStateEnum> flush_state_;
 
@@ -480,6 +491,10 @@ class MemTable {
 
   void UpdateOldestKeyTime();
 
+  // Looks key up in hash_index_, passing the entry found to the Saver of
+  // Get(), or searches table_ if the entry cannot be used
+  void GetFromHashIndex(const LookupKey& key, void* saver);
+
   // No copying allowed
   MemTable(const MemTable&);
   MemTable& operator=(const MemTable&);
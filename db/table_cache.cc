@@ -418,6 +418,69 @@ Status TableCache::Get(const ReadOptions& options,
   return s;
 }
 
+Status TableCache::MultiGet(const ReadOptions& options,
+                            const InternalKeyComparator& internal_comparator,
+                            const FileMetaData& file_meta,
+                            const MultiGetRange& keys,
+                            const SliceTransform* prefix_extractor,
+                            HistogramImpl* file_read_hist, bool skip_filters,
+                            int level) {
+  Status s;
+#ifndef ROCKSDB_LITE
+  // The row cache is keyed by user key, so it cannot be shared across the
+  // batch. Fall back to individual lookups.
+  if (ioptions_.row_cache) {
+    for (auto* key : keys) {
+      *key->s = Get(options, internal_comparator, file_meta,
+                    key->internal_key(), key->get_context, prefix_extractor,
+                    file_read_hist, skip_filters, level);
+    }
+    return s;
+  }
+#endif  // ROCKSDB_LITE
+  auto& fd = file_meta.fd;
+  TableReader* t = fd.table_reader;
+  Cache::Handle* handle = nullptr;
+  if (t == nullptr) {
+    s = FindTable(
+        env_options_, internal_comparator, fd, &handle, prefix_extractor,
+        options.read_tier == kBlockCacheTier /* no_io */,
+        true /* record_read_stats */, file_read_hist, skip_filters, level);
+    if (s.ok()) {
+      t = GetTableReaderFromHandle(handle);
+    }
+  }
+  if (s.ok() && !options.ignore_range_deletions) {
+    std::unique_ptr<FragmentedRangeTombstoneIterator> range_del_iter(
+        t->NewRangeTombstoneIterator(options));
+    if (range_del_iter != nullptr) {
+      for (auto* key : keys) {
+        SequenceNumber* max_covering_tombstone_seq =
+            key->get_context->max_covering_tombstone_seq();
+        if (max_covering_tombstone_seq != nullptr) {
+          *max_covering_tombstone_seq = std::max(
+              *max_covering_tombstone_seq,
+              range_del_iter->MaxCoveringTombstoneSeqnum(key->user_key()));
+        }
+      }
+    }
+  }
+  if (s.ok()) {
+    t->MultiGet(options, keys, prefix_extractor, skip_filters);
+  } else if (options.read_tier == kBlockCacheTier && s.IsIncomplete()) {
+    // Couldn't find Table in cache but treat as kFound if no_io set
+    for (auto* key : keys) {
+      key->get_context->MarkKeyMayExist();
+    }
+    s = Status::OK();
+  }
+
+  if (handle != nullptr) {
+    ReleaseHandle(handle);
+  }
+  return s;
+}
+
 Status TableCache::GetTableProperties(
     const EnvOptions& env_options,
     const InternalKeyComparator& internal_comparator, const FileDescriptor& fd,
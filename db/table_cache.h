@@ -76,6 +76,20 @@ class TableCache {
              HistogramImpl* file_read_hist = nullptr, bool skip_filters = false,
              int level = -1);
 
+  // Batched version of Get(). Looks up all the keys of "keys" in the
+  // specified file, finding the table reader and the range tombstones only
+  // once for the whole batch. The result of each key is stored in its
+  // KeyContext::s. Returns non-ok status if the table could not be opened.
+  // @param keys Keys sorted in ascending order, each with its GetContext set
+  // @param skip_filters Disables loading/accessing the filter block
+  // @param level The level this table is at, -1 for "not set / don't know"
+  Status MultiGet(const ReadOptions& options,
+                  const InternalKeyComparator& internal_comparator,
+                  const FileMetaData& file_meta, const MultiGetRange& keys,
+                  const SliceTransform* prefix_extractor = nullptr,
+                  HistogramImpl* file_read_hist = nullptr,
+                  bool skip_filters = false, int level = -1);
+
   // Evict any entry for the specified file number
   static void Evict(Cache* cache, uint64_t file_number);
 
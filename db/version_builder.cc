@@ -162,7 +162,11 @@ class VersionBuilder::Rep {
             abort();
           }
 
-          if (f2->fd.smallest_seqno == f2->fd.largest_seqno) {
+          if (!FileKeyRangesOverlap(
+                  vstorage->InternalComparator()->user_comparator(), f1, f2)) {
+            // The files of a flush split by key range do not overlap, but
+            // their sequence numbers interleave
+          } else if (f2->fd.smallest_seqno == f2->fd.largest_seqno) {
             // This is an external file that we ingested
             SequenceNumber external_file_seqno = f2->fd.smallest_seqno;
             if (!(external_file_seqno < f1->fd.largest_seqno ||
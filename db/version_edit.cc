@@ -42,6 +42,8 @@ enum Tag : uint32_t {
   kMaxColumnFamily = 203,
 
   kInAtomicGroup = 300,
+
+  kCompressionDict = 400,
 };
 
 enum CustomTag : uint32_t {
@@ -87,6 +89,9 @@ void VersionEdit::Clear() {
   column_family_name_.clear();
   is_in_atomic_group_ = false;
   remaining_entries_ = 0;
+  has_compression_dict_ = false;
+  compression_dict_id_ = 0;
+  compression_dict_.clear();
 }
 
 bool VersionEdit::EncodeTo(std::string* dst) const {
@@ -209,6 +214,11 @@ bool VersionEdit::EncodeTo(std::string* dst) const {
     PutVarint32(dst, kInAtomicGroup);
     PutVarint32(dst, remaining_entries_);
   }
+
+  if (has_compression_dict_) {
+    PutVarint32Varint64(dst, kCompressionDict, compression_dict_id_);
+    PutLengthPrefixedSlice(dst, compression_dict_);
+  }
   return true;
 }
 
@@ -500,6 +510,18 @@ Status VersionEdit::DecodeFrom(const Slice& src) {
         }
         break;
 
+      case kCompressionDict:
+        if (GetVarint64(&input, &compression_dict_id_) &&
+            GetLengthPrefixedSlice(&input, &str)) {
+          has_compression_dict_ = true;
+          compression_dict_ = str.ToString();
+        } else {
+          if (!msg) {
+            msg = "compression dictionary";
+          }
+        }
+        break;
+
       default:
         msg = "unknown tag";
         break;
@@ -583,6 +605,12 @@ std::string VersionEdit::DebugString(bool hex_key) const {
     AppendNumberTo(&r, remaining_entries_);
     r.append(" entries remains");
   }
+  if (has_compression_dict_) {
+    r.append("\n  CompressionDict: ");
+    AppendNumberTo(&r, compression_dict_id_);
+    r.append(" size ");
+    AppendNumberTo(&r, compression_dict_.size());
+  }
   r.append("\n}\n");
   return r;
 }
@@ -658,6 +686,10 @@ std::string VersionEdit::DebugJSON(int edit_num, bool hex_key) const {
   if (is_in_atomic_group_) {
     jw << "AtomicGroup" << remaining_entries_;
   }
+  if (has_compression_dict_) {
+    jw << "CompressionDictID" << compression_dict_id_;
+    jw << "CompressionDictSize" << compression_dict_.size();
+  }
 
   jw.EndObject();
 
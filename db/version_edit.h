@@ -225,6 +225,14 @@ class VersionEdit {
     min_log_number_to_keep_ = num;
   }
 
+  // Set the compression dictionary shared by the output files of the
+  // compactions of the column family, replacing the previous one
+  void SetCompressionDict(uint64_t id, const std::string& dict) {
+    has_compression_dict_ = true;
+    compression_dict_id_ = id;
+    compression_dict_ = dict;
+  }
+
   bool has_log_number() { return has_log_number_; }
 
   uint64_t log_number() { return log_number_; }
@@ -330,6 +338,9 @@ class VersionEdit {
   bool has_last_sequence_;
   bool has_max_column_family_;
   bool has_min_log_number_to_keep_;
+  bool has_compression_dict_;
+  uint64_t compression_dict_id_;
+  std::string compression_dict_;
 
   DeletedFileSet deleted_files_;
   std::vector<std::pair<int, FileMetaData>> new_files_;
@@ -197,6 +197,17 @@ TEST_F(VersionEditTest, AtomicGroupTest) {
   TestEncodeDecode(edit);
 }
 
+TEST_F(VersionEditTest, CompressionDict) {
+  VersionEdit edit;
+  edit.SetColumnFamily(3);
+  edit.SetCompressionDict(42, std::string("dict\0data", 9));
+  TestEncodeDecode(edit);
+
+  edit.Clear();
+  edit.SetCompressionDict(43, "");
+  TestEncodeDecode(edit);
+}
+
 }  // namespace rocksdb
 
 int main(int argc, char** argv) {
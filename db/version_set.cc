@@ -450,6 +450,19 @@ bool SomeFileOverlapsRange(
   return !BeforeFile(ucmp, largest_user_key, &file_level.files[index]);
 }
 
+static bool EndsBeforeFile(const Comparator* ucmp, const FileMetaData* a,
+                           const FileMetaData* b) {
+  int cmp = ucmp->Compare(a->largest.user_key(), b->smallest.user_key());
+  return cmp < 0 ||
+         (cmp == 0 &&
+          GetInternalKeySeqno(a->largest.Encode()) == kMaxSequenceNumber);
+}
+
+bool FileKeyRangesOverlap(const Comparator* ucmp, const FileMetaData* a,
+                          const FileMetaData* b) {
+  return !EndsBeforeFile(ucmp, a, b) && !EndsBeforeFile(ucmp, b, a);
+}
+
 namespace {
 
 class LevelIterator final : public InternalIterator {
@@ -1307,6 +1320,247 @@ void Version::Get(const ReadOptions& read_options, const LookupKey& k,
   }
 }
 
+namespace {
+// Returns true if the lookup of key has not been resolved by the files seen
+// so far and has to continue in older files.
+bool MultiGetKeyPending(KeyContext* key) {
+  GetContext::GetState state = key->get_context->State();
+  return (state == GetContext::kNotFound || state == GetContext::kMerge) &&
+         (key->s->ok() || key->s->IsMergeInProgress()) &&
+         key->max_covering_tombstone_seq == 0;
+}
+}  // anonymous namespace
+
+void Version::MultiGet(const ReadOptions& read_options,
+                       MultiGetRange* range) {
+  // GetContext and PinnedIteratorsManager are neither copyable nor movable,
+  // so keep them in deques which never relocate their elements.
+  std::deque<PinnedIteratorsManager> pinned_iters_mgrs;
+  std::deque<GetContext> get_contexts;
+  MultiGetRange pending;
+  for (auto* key : *range) {
+    assert(key->s->ok() || key->s->IsMergeInProgress());
+    pinned_iters_mgrs.emplace_back();
+    PinnedIteratorsManager* pinned_iters_mgr = &pinned_iters_mgrs.back();
+    get_contexts.emplace_back(
+        user_comparator(), merge_operator_, info_log_, db_statistics_,
+        key->s->ok() ? GetContext::kNotFound : GetContext::kMerge,
+        key->user_key(), key->value, nullptr /* value_found */,
+        &key->merge_context, &key->max_covering_tombstone_seq, this->env_,
+        nullptr /* seq */, merge_operator_ ? pinned_iters_mgr : nullptr);
+    key->get_context = &get_contexts.back();
+    // Pin blocks that we read to hold merge operands
+    if (merge_operator_) {
+      pinned_iters_mgr->StartPinning();
+    }
+    if (MultiGetKeyPending(key)) {
+      pending.push_back(key);
+    }
+  }
+
+  const InternalKeyComparator* icmp = internal_comparator();
+  const Comparator* ucmp = user_comparator();
+  for (int level = 0;
+       level < storage_info_.num_non_empty_levels_ && !pending.empty();
+       ++level) {
+    LevelFilesBrief& file_level = storage_info_.level_files_brief_[level];
+    const uint32_t num_files = static_cast<uint32_t>(file_level.num_files);
+    if (level == 0) {
+      // Level-0 files may overlap each other, so every file is checked
+      // against the whole batch, from the newest file to the oldest.
+      for (uint32_t i = 0; i < num_files && !pending.empty(); ++i) {
+        FdWithKeyRange* f = &file_level.files[i];
+        MultiGetRange batch;
+        for (auto* key : pending) {
+          if (ucmp->Compare(key->user_key(), ExtractUserKey(f->smallest_key)) >=
+                  0 &&
+              ucmp->Compare(key->user_key(), ExtractUserKey(f->largest_key)) <=
+                  0) {
+            batch.push_back(key);
+          }
+        }
+        if (!batch.empty()) {
+          MultiGetFromFile(read_options, f, level, i == num_files - 1, batch);
+          MultiGetRange remaining;
+          for (auto* key : pending) {
+            if (MultiGetKeyPending(key)) {
+              remaining.push_back(key);
+            }
+          }
+          pending = remaining;
+        }
+      }
+      continue;
+    }
+
+    // On Level-n (n>=1), files are sorted and so is the batch, so both are
+    // walked together and every file is searched once for the consecutive
+    // run of keys that fall into it. A user key that equals the largest key
+    // of a file may continue in the next file (e.g. merge operands), so such
+    // keys are carried over to the next file if they are still pending.
+    MultiGetRange carry;
+    size_t pos = 0;
+    uint32_t file_index = 0;
+    while (pos < pending.size() || !carry.empty()) {
+      uint32_t target;
+      if (!carry.empty()) {
+        target = file_index + 1;
+      } else {
+        target = static_cast<uint32_t>(
+            FindFileInRange(*icmp, file_level, pending[pos]->internal_key(),
+                            file_index, num_files));
+      }
+      if (target >= num_files) {
+        // The remaining keys are larger than any key of this level.
+        break;
+      }
+      FdWithKeyRange* f = &file_level.files[target];
+      Slice smallest_user_key = ExtractUserKey(f->smallest_key);
+      MultiGetRange batch;
+      for (auto* key : carry) {
+        if (ucmp->Compare(key->user_key(), smallest_user_key) >= 0) {
+          batch.push_back(key);
+        }
+      }
+      carry.clear();
+      for (; pos < pending.size(); ++pos) {
+        KeyContext* key = pending[pos];
+        if (icmp->Compare(key->internal_key(), f->largest_key) > 0) {
+          // Belongs to a later file
+          break;
+        }
+        if (ucmp->Compare(key->user_key(), smallest_user_key) >= 0) {
+          batch.push_back(key);
+        }
+        // Otherwise the key falls in the gap before this file and does not
+        // exist in this level.
+      }
+      file_index = target;
+      if (batch.empty()) {
+        continue;
+      }
+      MultiGetFromFile(read_options, f, level, target == num_files - 1,
+                       batch);
+      Slice largest_user_key = ExtractUserKey(f->largest_key);
+      for (auto* key : batch) {
+        if (MultiGetKeyPending(key) &&
+            ucmp->Equal(key->user_key(), largest_user_key)) {
+          carry.push_back(key);
+        }
+      }
+    }
+    MultiGetRange remaining;
+    for (auto* key : pending) {
+      if (MultiGetKeyPending(key)) {
+        remaining.push_back(key);
+      }
+    }
+    pending = remaining;
+  }
+
+  for (auto* key : *range) {
+    GetContext* get_context = key->get_context;
+    if (db_statistics_ != nullptr) {
+      get_context->ReportCounters();
+    }
+    GetContext::GetState state = get_context->State();
+    if ((state != GetContext::kNotFound && state != GetContext::kMerge) ||
+        !(key->s->ok() || key->s->IsMergeInProgress())) {
+      // Resolved by one of the files
+      continue;
+    }
+    if (GetContext::kMerge == state) {
+      if (!merge_operator_) {
+        *key->s = Status::InvalidArgument(
+            "merge_operator is not properly initialized.");
+        continue;
+      }
+      // merge_operands are in saver and we hit the beginning of the key
+      // history do a final merge of nullptr and operands;
+      std::string* str_value =
+          key->value != nullptr ? key->value->GetSelf() : nullptr;
+      *key->s = MergeHelper::TimedFullMerge(
+          merge_operator_, key->user_key(), nullptr,
+          key->merge_context.GetOperands(), str_value, info_log_,
+          db_statistics_, env_, nullptr /* result_operand */, true);
+      if (LIKELY(key->value != nullptr)) {
+        key->value->PinSelf();
+      }
+    } else {
+      *key->s = Status::NotFound();  // Use an empty error message for speed
+    }
+  }
+  // The GetContexts are about to go away
+  for (auto* key : *range) {
+    key->get_context = nullptr;
+  }
+}
+
+void Version::MultiGetFromFile(const ReadOptions& read_options,
+                               FdWithKeyRange* f, int level,
+                               bool is_file_last_in_level,
+                               const MultiGetRange& batch) {
+  if (batch[0]->get_context->sample()) {
+    sample_file_read_inc(f->file_metadata);
+  }
+
+  bool timer_enabled =
+      GetPerfLevel() >= PerfLevel::kEnableTimeExceptForMutex &&
+      get_perf_context()->per_level_perf_context_enabled;
+  StopWatchNano timer(env_, timer_enabled /* auto_start */);
+  Status s = table_cache_->MultiGet(
+      read_options, *internal_comparator(), *f->file_metadata, batch,
+      mutable_cf_options_.prefix_extractor.get(),
+      cfd_->internal_stats()->GetFileReadHist(level),
+      IsFilterSkipped(level, is_file_last_in_level), level);
+  if (timer_enabled) {
+    PERF_COUNTER_BY_LEVEL_ADD(get_from_table_nanos, timer.ElapsedNanos(),
+                              level);
+  }
+
+  for (auto* key : batch) {
+    if (!s.ok()) {
+      // The table could not be opened
+      *key->s = s;
+      continue;
+    }
+    if (!key->s->ok()) {
+      continue;
+    }
+    switch (key->get_context->State()) {
+      case GetContext::kNotFound:
+        // Keep searching in other files
+        break;
+      case GetContext::kMerge:
+        // TODO: update per-level perfcontext user_key_return_count for kMerge
+        break;
+      case GetContext::kFound:
+        if (level == 0) {
+          RecordTick(db_statistics_, GET_HIT_L0);
+        } else if (level == 1) {
+          RecordTick(db_statistics_, GET_HIT_L1);
+        } else if (level >= 2) {
+          RecordTick(db_statistics_, GET_HIT_L2_AND_UP);
+        }
+        PERF_COUNTER_BY_LEVEL_ADD(user_key_return_count, 1, level);
+        break;
+      case GetContext::kDeleted:
+        // Use empty error message for speed
+        *key->s = Status::NotFound();
+        break;
+      case GetContext::kCorrupt:
+        *key->s = Status::Corruption("corrupted key for ", key->user_key());
+        break;
+      case GetContext::kBlobIndex:
+        ROCKS_LOG_ERROR(info_log_, "Encounter unexpected blob index.");
+        *key->s = Status::NotSupported(
+            "Encounter unexpected blob index. Please open DB with "
+            "rocksdb::blob_db::BlobDB instead.");
+        break;
+    }
+  }
+}
+
 bool Version::IsFilterSkipped(int level, bool is_file_last_in_level) {
   // Reaching the bottom level implies misses at all upper levels, so we'll
   // skip checking the filters when we predict a hit.
@@ -1597,6 +1851,26 @@ uint32_t GetExpiredTtlFilesCount(const ImmutableCFOptions& ioptions,
 }
 }  // anonymous namespace
 
+int VersionStorageInfo::NumLevel0SortedRuns(bool skip_being_compacted) const {
+  int num_sorted_runs = 0;
+  std::vector<const FileMetaData*> run;
+  for (auto* f : files_[0]) {
+    if (skip_being_compacted && f->being_compacted) {
+      continue;
+    }
+    bool overlap = run.empty();
+    for (size_t i = 0; i < run.size() && !overlap; i++) {
+      overlap = FileKeyRangesOverlap(user_comparator_, f, run[i]);
+    }
+    if (overlap) {
+      num_sorted_runs++;
+      run.clear();
+    }
+    run.push_back(f);
+  }
+  return num_sorted_runs;
+}
+
 void VersionStorageInfo::ComputeCompactionScore(
     const ImmutableCFOptions& immutable_cf_options,
     const MutableCFOptions& mutable_cf_options) {
@@ -1622,6 +1896,10 @@ void VersionStorageInfo::ComputeCompactionScore(
           num_sorted_runs++;
         }
       }
+      if (compaction_style_ == kCompactionStyleLevel &&
+          immutable_cf_options.max_flush_subranges > 1) {
+        num_sorted_runs = NumLevel0SortedRuns(true /* skip_being_compacted */);
+      }
       if (compaction_style_ == kCompactionStyleUniversal) {
         // For universal compaction, we use level0 score to indicate
         // compaction score for the whole DB. Adding other levels as if
@@ -2481,7 +2759,10 @@ void VersionStorageInfo::CalculateBaseBytes(const ImmutableCFOptions& ioptions,
   // Special logic to set number of sorted runs.
   // It is to match the previous behavior when all files are in L0.
   int num_l0_count = static_cast<int>(files_[0].size());
-  if (compaction_style_ == kCompactionStyleUniversal) {
+  if (compaction_style_ == kCompactionStyleLevel &&
+      ioptions.max_flush_subranges > 1) {
+    num_l0_count = NumLevel0SortedRuns(false /* skip_being_compacted */);
+  } else if (compaction_style_ == kCompactionStyleUniversal) {
     // For universal compaction, we use level0 score to indicate
     // compaction score for the whole DB. Adding other levels as if
     // they are L0 files.
@@ -3072,6 +3353,16 @@ Status VersionSet::ProcessManifestWrites(
         MarkMinLogNumberToKeep2PC(last_min_log_number_to_keep);
       }
 
+      for (auto& e : batch_edits) {
+        if (e->has_compression_dict_) {
+          ColumnFamilyData* cfd =
+              column_family_set_->GetColumnFamily(e->column_family_);
+          assert(cfd != nullptr);
+          cfd->SetCompressionDict(e->compression_dict_id_,
+                                  e->compression_dict_);
+        }
+      }
+
       for (int i = 0; i < static_cast<int>(versions.size()); ++i) {
         ColumnFamilyData* cfd = versions[i]->cfd_;
         AppendVersion(cfd, versions[i]);
@@ -3220,8 +3511,10 @@ void VersionSet::LogAndApplyCFHelper(VersionEdit* edit) {
   // expecting some new data that is not written yet. Since LastSequence is an
   // upper bound on the sequence, it is ok to record
   // last_allocated_sequence_ as the last sequence.
-  edit->SetLastSequence(db_options_->two_write_queues ? last_allocated_sequence_
-                                                      : last_sequence_);
+  edit->SetLastSequence(
+      db_options_->two_write_queues || db_options_->unordered_write
+          ? last_allocated_sequence_
+          : last_sequence_);
   if (edit->is_column_family_drop_) {
     // if we drop column family, we have to make sure to save max column family,
     // so that we don't reuse existing ID
@@ -3252,8 +3545,10 @@ void VersionSet::LogAndApplyHelper(ColumnFamilyData* cfd,
   // expecting some new data that is not written yet. Since LastSequence is an
   // upper bound on the sequence, it is ok to record
   // last_allocated_sequence_ as the last sequence.
-  edit->SetLastSequence(db_options_->two_write_queues ? last_allocated_sequence_
-                                                      : last_sequence_);
+  edit->SetLastSequence(
+      db_options_->two_write_queues || db_options_->unordered_write
+          ? last_allocated_sequence_
+          : last_sequence_);
 
   builder->Apply(edit);
 }
@@ -3351,6 +3646,10 @@ Status VersionSet::ApplyOneVersionEdit(
         *have_log_number = true;
       }
     }
+    if (edit.has_compression_dict_) {
+      cfd->SetCompressionDict(edit.compression_dict_id_,
+                              edit.compression_dict_);
+    }
     if (edit.has_comparator_ &&
         edit.comparator_ != cfd->user_comparator()->Name()) {
       return Status::InvalidArgument(
@@ -3924,6 +4223,10 @@ Status VersionSet::DumpManifest(Options& options, std::string& dscname,
       if (cfd != nullptr && edit.has_log_number_) {
         cfd->SetLogNumber(edit.log_number_);
       }
+      if (cfd != nullptr && edit.has_compression_dict_) {
+        cfd->SetCompressionDict(edit.compression_dict_id_,
+                                edit.compression_dict_);
+      }
 
 
       if (edit.has_prev_log_number_) {
@@ -4084,6 +4387,10 @@ Status VersionSet::WriteSnapshot(log::Writer* log) {
         }
       }
       edit.SetLogNumber(cfd->GetLogNumber());
+      auto compression_dict = cfd->compression_dict();
+      if (compression_dict != nullptr) {
+        edit.SetCompressionDict(compression_dict->id, compression_dict->dict);
+      }
       std::string record;
       if (!edit.EncodeTo(&record)) {
         return Status::Corruption(
@@ -44,6 +44,7 @@
 #include "options/db_options.h"
 #include "port/port.h"
 #include "rocksdb/env.h"
+#include "table/multiget_context.h"
 
 namespace rocksdb {
 
@@ -82,6 +83,12 @@ extern bool SomeFileOverlapsRange(const InternalKeyComparator& icmp,
                                   const Slice* smallest_user_key,
                                   const Slice* largest_user_key);
 
+// Returns true iff the user key ranges of the files a and b overlap. A file
+// whose largest key is the end of a range tombstone, which the key range of
+// the file was clipped to, ends right before that user key.
+extern bool FileKeyRangesOverlap(const Comparator* ucmp, const FileMetaData* a,
+                                 const FileMetaData* b);
+
 // Generate LevelFilesBrief from vector<FdWithKeyRange*>
 // Would copy smallest_key and largest_key data to sequential memory
 // arena: Arena used to allocate the memory
@@ -260,6 +267,13 @@ class VersionStorageInfo {
 
   void set_l0_delay_trigger_count(int v) { l0_delay_trigger_count_ = v; }
 
+  // Number of sorted runs in level 0, not counting the files being compacted
+  // if skip_being_compacted. Consecutive files whose key ranges do not
+  // overlap, like the files of a flush split by key range, form a single
+  // sorted run.
+  // REQUIRES: This version has been saved (see VersionSet::SaveTo)
+  int NumLevel0SortedRuns(bool skip_being_compacted) const;
+
   // REQUIRES: This version has been saved (see VersionSet::SaveTo)
   int NumLevelFiles(int level) const {
     assert(finalized_);
@@ -572,6 +586,18 @@ class Version {
            SequenceNumber* seq = nullptr, ReadCallback* callback = nullptr,
            bool* is_blob = nullptr);
 
+  // Batched version of Get(). Looks up all the keys of *range, which must be
+  // sorted in ascending user key order and belong to this column family.
+  // Instead of running the file search separately for every key, the batch
+  // is moved through the levels together, so that each file is visited at
+  // most once per batch with all the keys that fall in its range.
+  //
+  // On return, *KeyContext::s and *KeyContext::value hold the result of each
+  // key, with the same semantics as Get().
+  //
+  // REQUIRES: lock is not held
+  void MultiGet(const ReadOptions&, MultiGetRange* range);
+
   // Loads some stats information from files. Call without mutex held. It needs
   // to be called before applying the version to the version set.
   void PrepareApply(const MutableCFOptions& mutable_cf_options,
@@ -663,6 +689,13 @@ class Version {
   // that it eventually expires from the cache.
   bool IsFilterSkipped(int level, bool is_file_last_in_level = false);
 
+  // Looks up the keys of batch, all of which fall in the key range of file
+  // f at the given level, and updates the status of the keys resolved by
+  // this file. Used by MultiGet().
+  void MultiGetFromFile(const ReadOptions& read_options, FdWithKeyRange* f,
+                        int level, bool is_file_last_in_level,
+                        const MultiGetRange& batch);
+
   // The helper function of UpdateAccumulatedStats, which may fill the missing
   // fields of file_meta from its associated TableProperties.
   // Returns true if it does initialize FileMetaData.
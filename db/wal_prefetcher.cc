@@ -0,0 +1,194 @@
+//  Copyright (c) 2011-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "db/wal_prefetcher.h"
+
+#include <assert.h>
+
+#include "db/write_batch_internal.h"
+#include "util/file_reader_writer.h"
+#include "util/filename.h"
+#include "util/logging.h"
+
+namespace rocksdb {
+
+void WalRecoveryReporter::Corruption(size_t bytes, const Status& s) {
+  ROCKS_LOG_WARN(info_log, "%s%s: dropping %d bytes; %s",
+                 (this->status == nullptr ? "(ignoring error) " : ""), fname,
+                 static_cast<int>(bytes), s.ToString().c_str());
+  if (this->status != nullptr && this->status->ok()) {
+    *this->status = s;
+  }
+}
+
+WalPrefetcher::WalPrefetcher(const ImmutableDBOptions& db_options, Env* env,
+                             const EnvOptions& env_options,
+                             const std::vector<uint64_t>& log_numbers,
+                             bool read_ahead, bool check_batches)
+    : db_options_(db_options),
+      env_(env),
+      env_options_(env_options),
+      log_numbers_(log_numbers),
+      check_batches_(check_batches),
+      next_log_index_(0),
+      in_log_(false),
+      buffered_bytes_(0),
+      read_ahead_done_(false),
+      stop_(false) {
+  reporter_.info_log = db_options_.info_log.get();
+  reporter_.fname = nullptr;
+  if (!db_options_.paranoid_checks ||
+      db_options_.wal_recovery_mode ==
+          WALRecoveryMode::kSkipAnyCorruptedRecords) {
+    reporter_.status = nullptr;
+  } else {
+    reporter_.status = &read_status_;
+  }
+  if (read_ahead) {
+    thread_ = port::Thread(&WalPrefetcher::BackgroundRead, this);
+  }
+}
+
+WalPrefetcher::~WalPrefetcher() {
+  if (thread_.joinable()) {
+    {
+      std::lock_guard<std::mutex> lock(mu_);
+      stop_ = true;
+    }
+    cv_.notify_all();
+    thread_.join();
+  }
+}
+
+Status WalPrefetcher::StartLog(uint64_t log_number) {
+  if (!thread_.joinable()) {
+    // Skip the files before log_number without reading them
+    reader_.reset();
+    while (next_log_index_ < log_numbers_.size() &&
+           log_numbers_[next_log_index_] < log_number) {
+      next_log_index_++;
+    }
+  }
+  in_log_ = false;
+  status_ = Status::OK();
+  Item item;
+  while (NextItem(&item)) {
+    if (item.type == Item::kStartLog && item.log_number == log_number) {
+      in_log_ = item.status.ok();
+      return item.status;
+    }
+  }
+  assert(false);
+  return Status::Corruption("Log file not found for recovery");
+}
+
+bool WalPrefetcher::ReadBatch(WriteBatch* batch, bool* only_point_updates) {
+  if (!in_log_) {
+    return false;
+  }
+  Item item;
+  if (!NextItem(&item) || item.type != Item::kBatch) {
+    assert(item.type == Item::kEndOfLog);
+    status_ = item.status;
+    in_log_ = false;
+    return false;
+  }
+  *batch = std::move(item.batch);
+  *only_point_updates = item.only_point_updates;
+  return true;
+}
+
+bool WalPrefetcher::ReadItem(Item* item) {
+  if (reader_ == nullptr) {
+    if (next_log_index_ == log_numbers_.size()) {
+      return false;
+    }
+    uint64_t log_number = log_numbers_[next_log_index_++];
+    item->type = Item::kStartLog;
+    item->log_number = log_number;
+    fname_ = LogFileName(db_options_.wal_dir, log_number);
+    std::unique_ptr<SequentialFile> file;
+    item->status = env_->NewSequentialFile(fname_, &file, env_options_);
+    if (item->status.ok()) {
+      read_status_ = Status::OK();
+      reporter_.fname = fname_.c_str();
+      std::unique_ptr<SequentialFileReader> file_reader(
+          new SequentialFileReader(std::move(file), fname_));
+      // We intentially make log::Reader do checksumming even if
+      // paranoid_checks==false so that corruptions cause entire commits
+      // to be skipped instead of propagating bad information (like overly
+      // large sequence numbers).
+      reader_.reset(new log::Reader(db_options_.info_log,
+                                    std::move(file_reader), &reporter_,
+                                    true /*checksum*/, log_number,
+                                    false /* retry_after_eof */));
+    }
+    return true;
+  }
+
+  Slice record;
+  while (reader_->ReadRecord(&record, &scratch_,
+                             db_options_.wal_recovery_mode) &&
+         read_status_.ok()) {
+    if (record.size() < WriteBatchInternal::kHeader) {
+      reporter_.Corruption(record.size(),
+                           Status::Corruption("log record too small"));
+      continue;
+    }
+    item->type = Item::kBatch;
+    WriteBatchInternal::SetContents(&item->batch, record);
+    if (check_batches_) {
+      item->only_point_updates =
+          WriteBatchInternal::HasOnlyPointUpdates(&item->batch);
+    }
+    return true;
+  }
+  item->type = Item::kEndOfLog;
+  item->status = read_status_;
+  reader_.reset();
+  return true;
+}
+
+bool WalPrefetcher::NextItem(Item* item) {
+  if (!thread_.joinable()) {
+    return ReadItem(item);
+  }
+  std::unique_lock<std::mutex> lock(mu_);
+  while (items_.empty() && !read_ahead_done_) {
+    cv_.wait(lock);
+  }
+  if (items_.empty()) {
+    return false;
+  }
+  *item = std::move(items_.front());
+  items_.pop_front();
+  buffered_bytes_ -= WriteBatchInternal::ByteSize(&item->batch);
+  cv_.notify_all();
+  return true;
+}
+
+void WalPrefetcher::BackgroundRead() {
+  while (true) {
+    Item item;
+    bool has_item = ReadItem(&item);
+    std::unique_lock<std::mutex> lock(mu_);
+    if (!has_item) {
+      read_ahead_done_ = true;
+      cv_.notify_all();
+      return;
+    }
+    while (!stop_ && buffered_bytes_ >= kMaxBufferedBytes) {
+      cv_.wait(lock);
+    }
+    if (stop_) {
+      return;
+    }
+    buffered_bytes_ += WriteBatchInternal::ByteSize(&item.batch);
+    items_.push_back(std::move(item));
+    cv_.notify_all();
+  }
+}
+
+}  // namespace rocksdb
@@ -0,0 +1,116 @@
+//  Copyright (c) 2011-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "db/log_reader.h"
+#include "options/db_options.h"
+#include "port/port.h"
+#include "rocksdb/env.h"
+#include "rocksdb/status.h"
+#include "rocksdb/write_batch.h"
+
+namespace rocksdb {
+
+// Logs the corruptions found while recovering a WAL file, and reports the
+// first one into *status.
+struct WalRecoveryReporter : public log::Reader::Reporter {
+  Logger* info_log;
+  const char* fname;
+  Status* status;  // nullptr if immutable_db_options_.paranoid_checks==false
+  virtual void Corruption(size_t bytes, const Status& s) override;
+};
+
+// Reads the write batches of the WAL files recovered by DB::Open(), one
+// file after the other.
+//
+// With read_ahead, a background thread opens the files, reads, checksums
+// and uncompresses their records ahead of the caller, buffering up to
+// kMaxBufferedBytes of records. Otherwise the records are read as the caller
+// asks for them.
+class WalPrefetcher {
+ public:
+  // log_numbers must be sorted in ascending order. If check_batches is
+  // true, the batches are classified with
+  // WriteBatchInternal::HasOnlyPointUpdates().
+  WalPrefetcher(const ImmutableDBOptions& db_options, Env* env,
+                const EnvOptions& env_options,
+                const std::vector<uint64_t>& log_numbers, bool read_ahead,
+                bool check_batches);
+
+  ~WalPrefetcher();
+
+  // Starts reading the log file log_number, skipping what is left of the
+  // current one and of the files before log_number. Returns the error if
+  // the file could not be opened.
+  Status StartLog(uint64_t log_number);
+
+  // Reads the next write batch of the current log file into *batch, and
+  // whether it only holds point updates if check_batches. Returns false at
+  // the end of the file, or once status() is not ok.
+  bool ReadBatch(WriteBatch* batch, bool* only_point_updates);
+
+  // The first corruption reported while reading the current log file, if
+  // paranoid_checks and the recovery mode does not skip corrupted records
+  const Status& status() const { return status_; }
+
+  static const size_t kMaxBufferedBytes = 16 << 20;
+
+ private:
+  struct Item {
+    enum Type { kStartLog, kBatch, kEndOfLog };
+    Type type = kBatch;
+    // For kStartLog
+    uint64_t log_number = 0;
+    // For kStartLog: the status of opening the file. For kEndOfLog: the
+    // status the file was read with
+    Status status;
+    WriteBatch batch;
+    bool only_point_updates = false;
+  };
+
+  // Reads the next item of the log files into *item. Returns false after
+  // the end of the last file.
+  bool ReadItem(Item* item);
+  // Returns the next item, read ahead or not
+  bool NextItem(Item* item);
+  void BackgroundRead();
+
+  const ImmutableDBOptions& db_options_;
+  Env* const env_;
+  const EnvOptions env_options_;
+  const std::vector<uint64_t> log_numbers_;
+  const bool check_batches_;
+
+  // The log file being read by ReadItem()
+  size_t next_log_index_;
+  std::string fname_;
+  Status read_status_;
+  WalRecoveryReporter reporter_;
+  std::unique_ptr<log::Reader> reader_;
+  std::string scratch_;
+
+  // The log file being returned to the caller
+  bool in_log_;
+  Status status_;
+
+  // The items read ahead by the background thread
+  std::mutex mu_;
+  std::condition_variable cv_;
+  std::deque<Item> items_;
+  size_t buffered_bytes_;
+  bool read_ahead_done_;
+  bool stop_;
+  port::Thread thread_;
+};
+
+}  // namespace rocksdb
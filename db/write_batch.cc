@@ -134,6 +134,15 @@ struct BatchContentClassifier : public WriteBatch::Handler {
   }
 };
 
+struct PointUpdateClassifier : public BatchContentClassifier {
+  bool has_noop = false;
+
+  Status MarkNoop(bool) override {
+    has_noop = true;
+    return Status::OK();
+  }
+};
+
 }  // anon namespace
 
 struct SavePoints {
@@ -595,6 +604,16 @@ Status WriteBatch::Iterate(Handler* handler) const {
   }
 }
 
+bool WriteBatchInternal::HasOnlyPointUpdates(const WriteBatch* b) {
+  PointUpdateClassifier classifier;
+  if (!b->Iterate(&classifier).ok() || classifier.has_noop) {
+    return false;
+  }
+  return (classifier.content_flags &
+          ~(ContentFlags::HAS_PUT | ContentFlags::HAS_DELETE |
+            ContentFlags::HAS_SINGLE_DELETE | ContentFlags::HAS_MERGE)) == 0;
+}
+
 bool WriteBatchInternal::IsLatestPersistentState(const WriteBatch* b) {
   return b->is_latest_persistent_state_;
 }
@@ -1473,7 +1492,6 @@ class MemTableInserter : public WriteBatch::Handler {
 
   virtual Status MergeCF(uint32_t column_family_id, const Slice& key,
                          const Slice& value) override {
-    assert(!concurrent_memtable_writes_);
     // optimize for non-recovery mode
     if (UNLIKELY(write_after_commit_ && rebuilding_trx_ != nullptr)) {
       WriteBatchInternal::Merge(rebuilding_trx_, column_family_id, key, value);
@@ -1504,9 +1522,10 @@ class MemTableInserter : public WriteBatch::Handler {
     // If we pass DB through and options.max_successive_merges is hit
     // during recovery, Get() will be issued which will try to acquire
     // DB mutex and cause deadlock, as DB mutex is already held.
-    // So we disable merge in recovery
+    // So we disable merge in recovery. Merge operands are only inserted
+    // concurrently with unordered_write, which ignores max_successive_merges.
     if (moptions->max_successive_merges > 0 && db_ != nullptr &&
-        recovering_log_number_ == 0) {
+        recovering_log_number_ == 0 && !concurrent_memtable_writes_) {
       LookupKey lkey(key, sequence_);
 
       // Count the number of successive merges at the head
@@ -1564,7 +1583,9 @@ class MemTableInserter : public WriteBatch::Handler {
 
     if (!perform_merge) {
       // Add merge operator to memtable
-      bool mem_res = mem->Add(sequence_, kTypeMerge, key, value);
+      bool mem_res =
+          mem->Add(sequence_, kTypeMerge, key, value,
+                   concurrent_memtable_writes_, get_post_process_info(mem));
       if (UNLIKELY(!mem_res)) {
         assert(seq_per_batch_);
         ret_status = Status::TryAgain("key+seq exists");
@@ -142,6 +142,12 @@ class WriteBatchInternal {
   static Status CheckSlicePartsLength(const SliceParts& key,
                                       const SliceParts& value);
 
+  // Returns true if batch is well formed and only holds Put, Delete,
+  // SingleDelete and Merge updates, besides log data. Such batches do not
+  // depend on the state of the DB and use one sequence number per update, so
+  // that recovery can insert them concurrently with each other.
+  static bool HasOnlyPointUpdates(const WriteBatch* batch);
+
   // Inserts batches[i] into memtable, for i in 0..num_batches-1 inclusive.
   //
   // If ignore_missing_column_families == true. WriteBatch
@@ -0,0 +1,55 @@
+//  Copyright (c) 2011-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "db/write_watermark.h"
+
+#include <algorithm>
+#include <assert.h>
+
+#include "db/version_set.h"
+
+namespace rocksdb {
+
+void WriteWatermark::Add(SequenceNumber last_sequence) {
+  std::lock_guard<std::mutex> lock(mu_);
+  assert(pending_.empty() || pending_.back().first < last_sequence);
+  pending_.emplace_back(last_sequence, false);
+}
+
+void WriteWatermark::Complete(SequenceNumber last_sequence) {
+  std::unique_lock<std::mutex> lock(mu_);
+  auto it = std::lower_bound(
+      pending_.begin(), pending_.end(),
+      std::make_pair(last_sequence, false),
+      [](const std::pair<SequenceNumber, bool>& a,
+         const std::pair<SequenceNumber, bool>& b) {
+        return a.first < b.first;
+      });
+  assert(it != pending_.end() && it->first == last_sequence && !it->second);
+  it->second = true;
+
+  if (it == pending_.begin()) {
+    SequenceNumber published = 0;
+    while (!pending_.empty() && pending_.front().second) {
+      published = pending_.front().first;
+      pending_.pop_front();
+    }
+    versions_->SetLastSequence(published);
+    cv_.notify_all();
+  } else {
+    while (versions_->LastSequence() < last_sequence) {
+      cv_.wait(lock);
+    }
+  }
+}
+
+void WriteWatermark::WaitForPendingWrites() {
+  std::unique_lock<std::mutex> lock(mu_);
+  while (!pending_.empty()) {
+    cv_.wait(lock);
+  }
+}
+
+}  // namespace rocksdb
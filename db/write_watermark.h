@@ -0,0 +1,52 @@
+//  Copyright (c) 2011-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <utility>
+
+#include "rocksdb/types.h"
+
+namespace rocksdb {
+
+class VersionSet;
+
+// WriteWatermark publishes the last sequence (VersionSet::LastSequence) when
+// writers insert into the memtables out of order, with unordered_write.
+//
+// The write group leader registers, in sequence order, the last sequence
+// assigned to each writer of the group. Each writer then inserts its batch
+// into the memtables on its own and completes. The last sequence is the
+// watermark below which all the writers completed, so that a snapshot never
+// sees a write before all the writes with a smaller sequence.
+class WriteWatermark {
+ public:
+  explicit WriteWatermark(VersionSet* versions) : versions_(versions) {}
+
+  // Registers a writer that was assigned the sequences up to last_sequence.
+  // REQUIRES: called by the write group leader, with increasing sequences
+  void Add(SequenceNumber last_sequence);
+
+  // Marks the writer registered with last_sequence as inserted, and publishes
+  // the last sequence up to the first writer still inserting. Returns once
+  // last_sequence is published, so that the writer sees its own write.
+  void Complete(SequenceNumber last_sequence);
+
+  // Blocks until all the registered writers completed
+  void WaitForPendingWrites();
+
+ private:
+  VersionSet* versions_;
+  std::mutex mu_;
+  std::condition_variable cv_;
+  // The last sequence of the registered writers, in sequence order, and
+  // whether they completed
+  std::deque<std::pair<SequenceNumber, bool>> pending_;
+};
+
+}  // namespace rocksdb
@@ -1506,6 +1506,51 @@ TEST_P(EnvPosixTestWithParam, WritableFileWrapper) {
   EXPECT_EQ(24, step);
 }
 
+TEST_P(EnvPosixTestWithParam, MultiRead) {
+  EnvOptions soptions;
+  std::string fname = test::PerThreadDBPath(env_, "testfile");
+
+  const size_t kSectorSize = 4096;
+  const size_t kNumSectors = 8;
+
+  // Create file.
+  {
+    std::unique_ptr<WritableFile> wfile;
+    ASSERT_OK(env_->NewWritableFile(fname, &wfile, soptions));
+    for (size_t i = 0; i < kNumSectors; ++i) {
+      auto data = NewAligned(kSectorSize, static_cast<char>(i + 1));
+      Slice slice(data.get(), kSectorSize);
+      ASSERT_OK(wfile->Append(slice));
+    }
+    ASSERT_OK(wfile->Close());
+  }
+
+  // Read the sectors back in reverse order, starting with a read past the
+  // end of the file.
+  {
+    std::unique_ptr<RandomAccessFile> file;
+    std::vector<ReadRequest> reqs(kNumSectors + 1);
+    std::vector<std::unique_ptr<char, Deleter>> data;
+    for (size_t i = 0; i < reqs.size(); ++i) {
+      reqs[i].offset = (kNumSectors - i) * kSectorSize;
+      reqs[i].len = kSectorSize;
+      data.emplace_back(NewAligned(kSectorSize, 0));
+      reqs[i].scratch = data.back().get();
+    }
+    ASSERT_OK(env_->NewRandomAccessFile(fname, &file, soptions));
+    ASSERT_OK(file->MultiRead(reqs.data(), reqs.size()));
+    ASSERT_OK(reqs[0].status);
+    ASSERT_EQ(0, reqs[0].result.size());
+    for (size_t i = 1; i < reqs.size(); ++i) {
+      auto expected =
+          NewAligned(kSectorSize, static_cast<char>(kNumSectors - i + 1));
+      ASSERT_OK(reqs[i].status);
+      ASSERT_EQ(Slice(expected.get(), kSectorSize), reqs[i].result);
+    }
+  }
+  ASSERT_OK(env_->DeleteFile(fname));
+}
+
 TEST_P(EnvPosixTestWithParam, PosixRandomRWFile) {
   const std::string path = test::PerThreadDBPath(env_, "random_rw_file");
 
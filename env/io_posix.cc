@@ -27,6 +27,10 @@
 #include <sys/syscall.h>
 #include <sys/sysmacros.h>
 #endif
+#ifdef ROCKSDB_IOURING_PRESENT
+#include <liburing.h>
+#include <sys/uio.h>
+#endif
 #include "env/posix_logger.h"
 #include "monitoring/iostats_context_imp.h"
 #include "port/port.h"
@@ -34,6 +38,9 @@
 #include "util/coding.h"
 #include "util/string_util.h"
 #include "util/sync_point.h"
+#ifdef ROCKSDB_IOURING_PRESENT
+#include "util/thread_local.h"
+#endif
 
 #if defined(OS_LINUX) && !defined(F_SET_RW_HINT)
 #define F_LINUX_SPECIFIC_BASE 1024
@@ -356,6 +363,103 @@ Status PosixRandomAccessFile::Read(uint64_t offset, size_t n, Slice* result,
   return s;
 }
 
+#ifdef ROCKSDB_IOURING_PRESENT
+namespace {
+// Number of reads submitted to the ring at a time
+const unsigned int kIoUringDepth = 256;
+
+void DeleteIOUring(void* ptr) {
+  struct io_uring* iu = static_cast<struct io_uring*>(ptr);
+  io_uring_queue_exit(iu);
+  delete iu;
+}
+
+// Returns the io_uring of the calling thread, creating it on first use.
+// Returns nullptr if the kernel does not support io_uring.
+struct io_uring* GetThreadLocalIOUring() {
+  // Never deleted, so that threads exiting during shutdown can still
+  // release their rings
+  static ThreadLocalPtr* thread_local_io_urings =
+      new ThreadLocalPtr(&DeleteIOUring);
+  struct io_uring* iu =
+      static_cast<struct io_uring*>(thread_local_io_urings->Get());
+  if (iu == nullptr) {
+    iu = new struct io_uring;
+    if (io_uring_queue_init(kIoUringDepth, iu, 0) != 0) {
+      delete iu;
+      return nullptr;
+    }
+    thread_local_io_urings->Reset(iu);
+  }
+  return iu;
+}
+}  // anonymous namespace
+#endif  // ROCKSDB_IOURING_PRESENT
+
+Status PosixRandomAccessFile::MultiRead(ReadRequest* reqs, size_t num_reqs) {
+  if (num_reqs <= 1) {
+    return RandomAccessFile::MultiRead(reqs, num_reqs);
+  }
+#ifdef ROCKSDB_IOURING_PRESENT
+  struct io_uring* iu = GetThreadLocalIOUring();
+  if (iu != nullptr) {
+    struct iovec iov[kIoUringDepth];
+    size_t done = 0;
+    while (done < num_reqs) {
+      size_t batch = std::min(num_reqs - done, size_t{kIoUringDepth});
+      for (size_t i = 0; i < batch; ++i) {
+        ReadRequest& req = reqs[done + i];
+        iov[i].iov_base = req.scratch;
+        iov[i].iov_len = req.len;
+        struct io_uring_sqe* sqe = io_uring_get_sqe(iu);
+        io_uring_prep_readv(sqe, fd_, &iov[i], 1,
+                            static_cast<off_t>(req.offset));
+        io_uring_sqe_set_data(sqe, &req);
+      }
+      int ret = io_uring_submit_and_wait(iu, static_cast<unsigned int>(batch));
+      if (ret < 0) {
+        return IOError("While submitting reads to io_uring", filename_, -ret);
+      }
+      for (size_t i = 0; i < batch; ++i) {
+        struct io_uring_cqe* cqe;
+        ret = io_uring_wait_cqe(iu, &cqe);
+        if (ret < 0) {
+          return IOError("While waiting for io_uring reads", filename_, -ret);
+        }
+        ReadRequest* req =
+            static_cast<ReadRequest*>(io_uring_cqe_get_data(cqe));
+        if (cqe->res >= 0 && static_cast<size_t>(cqe->res) == req->len) {
+          req->result = Slice(req->scratch, req->len);
+          req->status = Status::OK();
+        } else if (cqe->res >= 0) {
+          // Short read, e.g. at the end of the file. Let pread() sort it out.
+          req->status =
+              Read(req->offset, req->len, &req->result, req->scratch);
+        } else {
+          req->result = Slice(req->scratch, 0);
+          req->status = IOError("While reading offset " +
+                                    ToString(req->offset) + " len " +
+                                    ToString(req->len) + " with io_uring",
+                                filename_, -cqe->res);
+        }
+        io_uring_cqe_seen(iu, cqe);
+      }
+      done += batch;
+    }
+    return Status::OK();
+  }
+#endif  // ROCKSDB_IOURING_PRESENT
+  // Without io_uring, hand the whole batch to the kernel's readahead first so
+  // that the device sees all the reads at once, then collect them with
+  // pread() which mostly hits the page cache by then.
+  if (!use_direct_io()) {
+    for (size_t i = 0; i < num_reqs; ++i) {
+      Prefetch(reqs[i].offset, reqs[i].len);
+    }
+  }
+  return RandomAccessFile::MultiRead(reqs, num_reqs);
+}
+
 Status PosixRandomAccessFile::Prefetch(uint64_t offset, size_t n) {
   Status s;
   if (!use_direct_io()) {
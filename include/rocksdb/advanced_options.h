@@ -137,13 +137,40 @@ struct CompressionOptions {
   // Default: false.
   bool enabled;
 
+  // Number of threads used to compress the data blocks of each SST file of
+  // the block based table format. When greater than 1, the thread building
+  // the file hands each finished data block to that many background threads,
+  // and writes the compressed blocks in order as they complete. This keeps
+  // flushes and compactions from being limited by the compression speed of a
+  // single thread, at the cost of buffering a few data blocks per thread.
+  // It has no effect when the data blocks are not compressed.
+  //
+  // Default: 1.
+  uint32_t parallel_threads;
+
+  // When greater than 0, and `max_dict_bytes` is nonzero, the dictionary
+  // trained by a bottommost level compaction is kept in the MANIFEST and used
+  // to compress the output files of the next bottommost level compactions of
+  // the column family, instead of training a new dictionary for each of them.
+  // A new dictionary is trained once that many files were compressed with the
+  // current one. The readers of the files share a single copy of the
+  // dictionary through the block cache.
+  //
+  // Note that a MANIFEST containing a shared dictionary can't be read by
+  // older versions of RocksDB.
+  //
+  // Default: 0.
+  uint32_t shared_dict_max_files;
+
   CompressionOptions()
       : window_bits(-14),
         level(kDefaultCompressionLevel),
         strategy(0),
         max_dict_bytes(0),
         zstd_max_train_bytes(0),
-        enabled(false) {}
+        enabled(false),
+        parallel_threads(1),
+        shared_dict_max_files(0) {}
   CompressionOptions(int wbits, int _lev, int _strategy, int _max_dict_bytes,
                      int _zstd_max_train_bytes, bool _enabled)
       : window_bits(wbits),
@@ -151,7 +178,9 @@ struct CompressionOptions {
         strategy(_strategy),
         max_dict_bytes(_max_dict_bytes),
         zstd_max_train_bytes(_zstd_max_train_bytes),
-        enabled(_enabled) {}
+        enabled(_enabled),
+        parallel_threads(1),
+        shared_dict_max_files(0) {}
 };
 
 enum UpdateStatus {    // Return status For inplace update callback
@@ -281,6 +310,20 @@ struct AdvancedColumnFamilyOptions {
   // Dynamically changeable through SetOptions() API
   double memtable_prefix_bloom_size_ratio = 0.0;
 
+  // If not 0, the memtable keeps a hash index from each user key to its
+  // newest entry, with write_buffer_size * memtable_hash_index_size_ratio
+  // bytes of buckets. Get() then finds the entry of a key without searching
+  // the memtable, unless that entry is newer than the snapshot read or is a
+  // merge operand, and a key missing from the index is known to be missing
+  // from the memtable. Worth it for workloads of point lookups of recently
+  // written keys. It requires a comparator where equal keys have the same
+  // bytes. If it is larger than 0.25, it is sanitized to 0.25.
+  //
+  // Default: 0 (disable)
+  //
+  // Dynamically changeable through SetOptions() API
+  double memtable_hash_index_size_ratio = 0.0;
+
   // Page size for huge page for the arena used by the memtable. If <=0, it
   // won't allocate from huge page but from malloc.
   // Users are responsible to reserve huge pages for it to be allocated. For
@@ -363,6 +406,33 @@ struct AdvancedColumnFamilyOptions {
   // change when data grows.
   std::vector<CompressionType> compression_per_level;
 
+  // If non-empty, block based tables choose the compression type of each
+  // region of their data blocks among the compression type of the file and
+  // these ones, instead of always using the former. The first data blocks of
+  // each region are compressed with all of the types to sample their
+  // compression ratio and speed, and the rest of the region uses the fastest
+  // type whose compressed size is within 1/16 of the smallest one. A region
+  // is not compressed at all when none of the types compresses the samples by
+  // at least adaptive_compression_min_ratio, which saves the CPU spent on
+  // incompressible data.
+  //
+  // It has no effect on the files whose compression type is kNoCompression.
+  // The number of data blocks written with each type is recorded in the
+  // "rocksdb.block.based.table.compression.types" table property, and the
+  // blocks skipped or sampled are counted by the
+  // ADAPTIVE_COMPRESSION_SKIPPED_BLOCKS and
+  // ADAPTIVE_COMPRESSION_SAMPLED_BLOCKS tickers.
+  //
+  // Default: empty
+  std::vector<CompressionType> adaptive_compression_types;
+
+  // The minimum ratio of the raw size to the compressed size of the data
+  // blocks sampled by the adaptive compression for a region to be
+  // compressed. See adaptive_compression_types.
+  //
+  // Default: 1.125
+  double adaptive_compression_min_ratio = 1.125;
+
   // Number of levels for this database
   int num_levels = 7;
 
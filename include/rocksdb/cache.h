@@ -23,6 +23,7 @@
 #pragma once
 
 #include <stdint.h>
+#include <functional>
 #include <memory>
 #include <string>
 #include "rocksdb/memory_allocator.h"
@@ -33,6 +34,7 @@
 namespace rocksdb {
 
 class Cache;
+enum CompressionType : unsigned char;
 
 struct LRUCacheOptions {
   // Capacity of the cache.
@@ -68,6 +70,21 @@ struct LRUCacheOptions {
   // internally (currently only XPRESS).
   std::shared_ptr<MemoryAllocator> memory_allocator;
 
+  // If true, an entry that needs other entries to be evicted to fit is only
+  // inserted if its key was looked up more often, recently, than the key of
+  // the least recently used entry. The frequencies are estimated with a
+  // count-min sketch of the lookups, hits and misses, in each shard
+  // (TinyLFU). This keeps keys read once, e.g. by a scan or a compaction,
+  // from flushing out the frequently read ones. An entry that is not
+  // admitted is still returned in the handle, if any, and freed when it is
+  // released. High priority entries are always admitted.
+  bool use_admission_filter = false;
+
+  // If not nullptr, the cache records in it how many entries the admission
+  // filter accepted and rejected, usually the same object as
+  // DBOptions::statistics.
+  std::shared_ptr<Statistics> statistics;
+
   LRUCacheOptions() {}
   LRUCacheOptions(size_t _capacity, int _num_shard_bits,
                   bool _strict_capacity_limit, double _high_pri_pool_ratio,
@@ -103,6 +120,59 @@ extern std::shared_ptr<Cache> NewClockCache(size_t capacity,
                                             int num_shard_bits = -1,
                                             bool strict_capacity_limit = false);
 
+// Create a cache based on the CLOCK algorithm that never takes a lock and is
+// not sharded, for block caches that are read by many threads at once.
+// Entries are kept in a fixed-size hash table, sized upfront for
+// `capacity / estimated_entry_charge` entries, e.g. the block size when the
+// cache is used as a block cache. If the entries turn out to be smaller than
+// estimated, the table fills up first and the cache holds less than its
+// capacity. See cache/lock_free_clock_cache.h for more detail.
+//
+// Return nullptr if estimated_entry_charge is 0.
+extern std::shared_ptr<Cache> NewLockFreeClockCache(
+    size_t capacity, size_t estimated_entry_charge,
+    bool strict_capacity_limit = false,
+    std::shared_ptr<MemoryAllocator> memory_allocator = nullptr);
+
+struct CompressedTieredCacheOptions {
+  // Capacity of the cache, shared by both tiers.
+  size_t capacity = 0;
+
+  // Fraction of the capacity given to the compressed tier. The uncompressed
+  // tier, an LRU cache, gets the rest.
+  double compressed_tier_ratio = 0.3;
+
+  // Compression of the entries demoted to the compressed tier. Entries that
+  // do not compress well, or all of them if the compression type is not
+  // supported, are kept uncompressed. Defaults to kLZ4Compression.
+  CompressionType compression_type;
+
+  // Options of the uncompressed tier, see LRUCacheOptions. The compressed
+  // tier is an LRU cache with the same number of shards.
+  int num_shard_bits = -1;
+  bool strict_capacity_limit = false;
+  double high_pri_pool_ratio = 0.0;
+  std::shared_ptr<MemoryAllocator> memory_allocator;
+
+  // If not nullptr, the compressed tier records its hits, misses and
+  // demotions in it, usually the same object as DBOptions::statistics.
+  std::shared_ptr<Statistics> statistics;
+
+  CompressedTieredCacheOptions();
+};
+
+// Create a cache with two tiers in memory sharing one capacity: an LRU cache
+// of uncompressed entries, and a compressed tier. The entries inserted with
+// Cache::InsertWithHelper() that the LRU cache evicts are compressed and
+// demoted to the compressed tier rather than dropped, and a
+// Cache::LookupWithHelper() that finds its key there promotes the entry back
+// to the LRU cache. Block based tables insert their data and index blocks
+// this way, so that the compressed tier holds several times as many blocks as
+// the same amount of memory in the LRU cache would, without a separate
+// BlockBasedTableOptions::block_cache_compressed.
+extern std::shared_ptr<Cache> NewCompressedTieredCache(
+    const CompressedTieredCacheOptions& cache_opts);
+
 class Cache {
  public:
   // Depending on implementation, cache entries with high priority could be less
@@ -153,6 +223,45 @@ class Cache {
   // function.
   virtual Handle* Lookup(const Slice& key, Statistics* stats = nullptr) = 0;
 
+  // Saves the value of an entry to a flat buffer, so that a cache with a
+  // compressed tier can demote the entry to that tier when it is evicted.
+  struct CacheItemHelper {
+    // Returns the number of bytes save_to writes
+    size_t (*size)(void* value);
+    // Writes the value to buf, of size(value) bytes
+    void (*save_to)(void* value, char* buf);
+    // Deletes the value, like the deleter passed to Insert()
+    void (*deleter)(const Slice& key, void* value);
+  };
+
+  // Creates back a value out of a buffer written by
+  // CacheItemHelper::save_to, and returns it with its charge.
+  typedef std::function<Status(const Slice& buf, void** value,
+                               size_t* charge)>
+      CreateCallback;
+
+  // Same as Insert(), with the deleter of helper. If the cache has a
+  // compressed tier, the entry is demoted to it rather than dropped when it
+  // is evicted. The default implementation only uses the deleter.
+  virtual Status InsertWithHelper(const Slice& key, void* value,
+                                  const CacheItemHelper* helper, size_t charge,
+                                  Handle** handle = nullptr,
+                                  Priority priority = Priority::LOW) {
+    return Insert(key, value, charge, helper->deleter, handle, priority);
+  }
+
+  // Same as Lookup(). If the key is not found but the compressed tier of the
+  // cache has it, create_cb creates its value back and the entry is
+  // promoted: inserted with helper and priority, and returned. The default
+  // implementation is Lookup().
+  virtual Handle* LookupWithHelper(const Slice& key,
+                                   const CacheItemHelper* /*helper*/,
+                                   const CreateCallback& /*create_cb*/,
+                                   Priority /*priority*/ = Priority::LOW,
+                                   Statistics* stats = nullptr) {
+    return Lookup(key, stats);
+  }
+
   // Increments the reference count for the handle if it refers to an entry in
   // the cache. Returns true if refcount was incremented; otherwise, returns
   // false.
@@ -41,6 +41,9 @@ class Cleanable {
   typedef void (*CleanupFunction)(void* arg1, void* arg2);
   void RegisterCleanup(CleanupFunction function, void* arg1, void* arg2);
   void DelegateCleanupsTo(Cleanable* other);
+  // Returns true if any cleanup is registered, i.e. the resources it guards
+  // have not been released or delegated to another Cleanable.
+  inline bool HasCleanups() const { return cleanup_.function != nullptr; }
   // DoCleanup and also resets the pointers for reuse
   inline void Reset() {
     DoCleanup();
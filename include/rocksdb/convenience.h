@@ -219,6 +219,11 @@ Status GetDBOptionsFromMap(
 //     - Pass {"filter_policy", "bloomfilter:4:true"} in
 //       GetBlockBasedTableOptionsFromMap to use a BloomFilter with 4-bits
 //       per key and use_block_based_builder enabled.
+//   - Blocked BloomFilter: use "blockedbloomfilter:[bits_per_key]", equivalent
+//     to calling NewBlockedBloomFilterPolicy(bits_per_key).
+//   - RibbonFilter: use "ribbonfilter:[bloom_equivalent_bits_per_key]",
+//     equivalent to calling
+//     NewRibbonFilterPolicy(bloom_equivalent_bits_per_key).
 //
 // * block_cache / block_cache_compressed:
 //   We currently only support LRU cache in the GetOptions API.  The LRU
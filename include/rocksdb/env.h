@@ -17,6 +17,7 @@
 #pragma once
 
 #include <stdint.h>
+#include <cassert>
 #include <cstdarg>
 #include <functional>
 #include <limits>
@@ -549,6 +550,27 @@ class SequentialFile {
 };
 
 // A file abstraction for randomly reading the contents of a file.
+// A single read of a batch of reads issued through
+// RandomAccessFile::MultiRead().
+struct ReadRequest {
+  // File offset in bytes
+  uint64_t offset;
+
+  // Length to read in bytes
+  size_t len;
+
+  // A buffer that MultiRead() can optionally place data in. It can
+  // ignore this and allocate its own buffer
+  char* scratch;
+
+  // Output parameter set by MultiRead() to point to the data buffer, and
+  // the number of valid bytes
+  Slice result;
+
+  // Status of read
+  Status status;
+};
+
 class RandomAccessFile {
  public:
 
@@ -573,6 +595,26 @@ class RandomAccessFile {
     return Status::OK();
   }
 
+  // Read a bunch of blocks as described by reqs. The blocks can
+  // optionally be read in parallel. This is a synchronous call, i.e it
+  // should return after all reads have completed. The reads will be
+  // non-overlapping. If the function return Status is not ok, status of
+  // individual requests will be ignored and return status will be assumed
+  // for all read requests. The function return status is only meant for
+  // errors that occur before even processing specific read requests.
+  //
+  // Safe for concurrent use by multiple threads.
+  // If Direct I/O enabled, offset, len, and scratch of every request should
+  // be aligned properly.
+  virtual Status MultiRead(ReadRequest* reqs, size_t num_reqs) {
+    assert(reqs != nullptr);
+    for (size_t i = 0; i < num_reqs; ++i) {
+      ReadRequest& req = reqs[i];
+      req.status = Read(req.offset, req.len, &req.result, req.scratch);
+    }
+    return Status::OK();
+  }
+
   // Tries to get an unique ID for this file that will be the same each time
   // the file is opened (and will stay the same while the file is open).
   // Furthermore, it tries to make this ID at most "max_size" bytes. If such an
@@ -147,4 +147,33 @@ class FilterPolicy {
 // trailing spaces in keys.
 extern const FilterPolicy* NewBloomFilterPolicy(
     int bits_per_key, bool use_block_based_builder = false);
+
+// Like NewBloomFilterPolicy(bits_per_key, false), but full filters are built
+// in a blocked format: all the probes of a key fall into the same 32 byte
+// block, one bit in each of its 32-bit words, so that a lookup is a single
+// SIMD test on CPUs with AVX2 or SSE4.1 (detected at runtime) and a few
+// branch-free operations otherwise. The false positive rate is slightly
+// higher than with NewBloomFilterPolicy() for the same bits_per_key.
+//
+// Both policies have the same name and read both formats, so a database can
+// switch between them. RocksDB versions that predate the blocked format
+// treat its filters as matching every key.
+extern const FilterPolicy* NewBlockedBloomFilterPolicy(int bits_per_key);
+
+// Return a new filter policy that uses a Ribbon filter, with about the same
+// false positive rate as NewBloomFilterPolicy(bloom_equivalent_bits_per_key)
+// but taking about 30% less space, e.g. ~7.4 bits per key instead of 10 for
+// a false positive rate below 1%. In exchange, filters take several times
+// more CPU to build than Bloom filters, and queries are somewhat slower.
+//
+// The filter is only built by GetFilterBitsBuilder(), i.e. full and
+// partitioned filters; the block based filter format stores a full filter
+// per block. Filters built by this policy can not be read by a Bloom filter
+// policy and vice versa, since the policy name differs.
+//
+// Callers must delete the result after any database that is using the
+// result has been closed. The same caveat as for NewBloomFilterPolicy()
+// applies to comparators that ignore parts of the keys.
+extern const FilterPolicy* NewRibbonFilterPolicy(
+    double bloom_equivalent_bits_per_key);
 }
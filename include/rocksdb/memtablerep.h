@@ -39,6 +39,7 @@
 #include <stdexcept>
 #include <stdint.h>
 #include <stdlib.h>
+#include <vector>
 #include <rocksdb/slice.h>
 
 namespace rocksdb {
@@ -172,6 +173,15 @@ class MemTableRep {
     return 0;
   }
 
+  // Append to *keys some of the keys in the mem table, in order, and to
+  // *weights the approximate number of entries each of them stands for.
+  // At least min_keys keys are sampled if the mem table holds that many.
+  // It is used to split the flush of the mem table by key range. By default,
+  // samples nothing.
+  virtual void SampleKeys(size_t /*min_keys*/,
+                          std::vector<const char*>* /*keys*/,
+                          std::vector<uint64_t>* /*weights*/) {}
+
   // Report an approximation of how much memory has been used other than memory
   // that was allocated through the allocator.  Safe to call from any thread.
   virtual size_t ApproximateMemoryUsage() = 0;
@@ -340,6 +350,16 @@ extern MemTableRepFactory* NewHashSkipListRepFactory(
     int32_t skiplist_branching_factor = 4
 );
 
+// This factory creates memtables that partition the key space by range
+// into num_partitions skip lists, so that concurrent writers rarely contend
+// on the same list and each search walks a smaller one. The memtables of a
+// column family first split on the first byte of the user keys; once one
+// of them becomes immutable, the memtables created afterwards split the key
+// distribution sampled from it into partitions of about the same size.
+// Supports concurrent inserts.
+extern MemTableRepFactory* NewPartitionedSkipListRepFactory(
+    size_t num_partitions = 16);
+
 // The factory is to create memtables based on a hash table:
 // it contains a fixed array of buckets, each pointing to either a linked list
 // or a skip list if number of entries inside the bucket exceeds
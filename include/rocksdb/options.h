@@ -846,6 +846,20 @@ struct DBOptions {
   // Default: false
   bool enable_pipelined_write = false;
 
+  // If true, the write batch group leader only assigns the sequence numbers
+  // and writes the WAL, and each writer then inserts its own batch into the
+  // memtables, concurrently with the next write groups. A write becomes
+  // visible to reads, and to new snapshots, once all the writes with a
+  // smaller sequence are inserted, so that snapshots remain consistent. This
+  // improves write throughput with many concurrent writers.
+  //
+  // Requires allow_concurrent_memtable_write, and is not compatible with
+  // enable_pipelined_write or two_write_queues. max_successive_merges is
+  // ignored, as the merge operands are inserted concurrently.
+  //
+  // Default: false
+  bool unordered_write = false;
+
   // If true, allow multi-writers to update mem tables in parallel.
   // Only some memtable_factory-s support concurrent writes; currently it
   // is implemented only for SkipListFactory.  Concurrent memtable writes
@@ -992,6 +1006,40 @@ struct DBOptions {
   // Currently, any WAL-enabled writes after atomic flush may be replayed
   // independently if the process crashes later and tries to recover.
   bool atomic_flush = false;
+
+  // If not kNoCompression, the records of the WAL files are compressed with
+  // this compression type. One compression context is kept per WAL file, so
+  // that each record is compressed with the previous ones of the file as
+  // history. Only kZSTD, kLZ4Compression and kZlibCompression are supported.
+  // WAL files written with compression can only be read by versions of
+  // RocksDB that support it, whatever the value of this option.
+  //
+  // Default: kNoCompression
+  CompressionType wal_compression = kNoCompression;
+
+  // Number of threads used to recover the WAL files when opening the DB. If
+  // greater than 1, the WAL files are read ahead by a background thread while
+  // their records are replayed, and the memtables that recovery flushes are
+  // written in parallel across column families. If
+  // allow_concurrent_memtable_write is also set, the write batches are
+  // inserted into the memtables by up to this many threads.
+  //
+  // Recovery gives the same result as with a single thread, under every
+  // wal_recovery_mode.
+  //
+  // Default: 1
+  int wal_recovery_threads = 1;
+
+  // The maximum number of key ranges a flush is split into. If greater than
+  // 1, a flush of large enough memtables samples their keys, splits them into
+  // up to this many ranges of about the same size, and builds one L0 file
+  // per range in parallel threads. The files do not overlap and are installed
+  // together. EventListener::OnFlushCompleted() is still called once per
+  // flush, with the file of the first range. Only applies to
+  // kCompactionStyleLevel column families.
+  //
+  // Default: 1 (no split)
+  uint32_t max_flush_subranges = 1;
 };
 
 // Options to control the behavior of a database (passed to DB::Open)
@@ -1082,6 +1130,13 @@ struct ReadOptions {
   // Default: 0
   size_t readahead_size;
 
+  // If non-zero, the readahead that iterators start on their own when
+  // readahead_size is 0 becomes asynchronous: while the scan consumes one
+  // readahead buffer, up to this many of the following buffers are read in
+  // the background, so that the scan does not wait for each refill.
+  // Default: 0 (synchronous readahead)
+  size_t readahead_buffers_in_flight;
+
   // A threshold for the number of keys that can be skipped before failing an
   // iterator seek as incomplete. The default value of 0 should be used to
   // never fail a request as incomplete, even on skipping too many keys.
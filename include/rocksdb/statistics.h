@@ -326,6 +326,32 @@ enum Tickers : uint32_t {
 
   NO_ITERATOR_CREATED,  // number of iterators created
   NO_ITERATOR_DELETED,  // number of iterators deleted
+
+  // Lookups that missed the uncompressed tier of a CompressedTieredCache and
+  // found (resp. did not find) the key in its compressed tier.
+  COMPRESSED_TIER_HIT,
+  COMPRESSED_TIER_MISS,
+  // # of entries demoted to the compressed tier of a CompressedTieredCache.
+  COMPRESSED_TIER_DEMOTED,
+  // # of bytes of the entries demoted to the compressed tier, before and
+  // after compression.
+  COMPRESSED_TIER_DEMOTED_BYTES,
+  COMPRESSED_TIER_DEMOTED_COMPRESSED_BYTES,
+
+  // # of insertions into an LRU cache that the admission filter accepted
+  // (resp. rejected), see LRUCacheOptions::use_admission_filter. Insertions
+  // that fit without evicting other entries are not counted.
+  BLOCK_CACHE_ADMISSION_ACCEPT,
+  BLOCK_CACHE_ADMISSION_REJECT,
+
+  // # of data blocks compressed with each of the compression types to choose
+  // the type of their region, # of data blocks left uncompressed because none
+  // of the types compressed the samples of their region well enough, and # of
+  // data blocks compressed with another type than the one of their file, see
+  // AdvancedColumnFamilyOptions::adaptive_compression_types.
+  ADAPTIVE_COMPRESSION_SAMPLED_BLOCKS,
+  ADAPTIVE_COMPRESSION_SKIPPED_BLOCKS,
+  ADAPTIVE_COMPRESSION_ALTERNATE_BLOCKS,
   TICKER_ENUM_MAX
 };
 
@@ -98,6 +98,15 @@ struct BlockBasedTableOptions {
 
     // A two-level index implementation. Both levels are binary search indexes.
     kTwoLevelIndexSearch,
+
+    // A binary search index, with a metablock that maps each restart point of
+    // the index to an integer made of the first bytes of its key. Seeks look
+    // the key up in these integers first, with an interpolation search, which
+    // leaves few or no keys of the index block to decode and compare. It
+    // requires a bytewise comparator, and is the same as kBinarySearch with
+    // other comparators. Files written with it cannot be read by older
+    // versions of RocksDB.
+    kInterpolationSearch,
   };
 
   IndexType index_type = kBinarySearch;
@@ -106,6 +115,12 @@ struct BlockBasedTableOptions {
   enum DataBlockIndexType : char {
     kDataBlockBinarySearch = 0,   // traditional block type
     kDataBlockBinaryAndHash = 1,  // additional hash index
+    // Additional array with an integer made of the first bytes of the key of
+    // each restart point, searched by Seek() and Get() before the restart
+    // points themselves. Requires a bytewise comparator, blocks are written
+    // as kDataBlockBinarySearch with other comparators. Files written with it
+    // cannot be read by older versions of RocksDB.
+    kDataBlockBinaryAndKeyPrefixes = 2,
   };
 
   DataBlockIndexType data_block_index_type = kDataBlockBinarySearch;
@@ -267,6 +282,9 @@ struct BlockBasedTablePropertyNames {
   static const std::string kWholeKeyFiltering;
   // value is "1" for true and "0" for false.
   static const std::string kPrefixFiltering;
+  // value is the number of data blocks written with each compression type,
+  // e.g. "NoCompression:3,ZSTD:61". Only set with adaptive compression.
+  static const std::string kCompressionTypes;
 };
 
 // Create default block based table factory.
@@ -22,7 +22,13 @@ public enum IndexType {
   /**
    * A two-level index implementation. Both levels are binary search indexes.
    */
-  kTwoLevelIndexSearch((byte) 2);
+  kTwoLevelIndexSearch((byte) 2),
+  /**
+   * A binary search index whose seeks first look the key up in an array of
+   * integers made of the first bytes of the index keys, with an interpolation
+   * search. Requires a bytewise comparator.
+   */
+  kInterpolationSearch((byte) 3);
 
   /**
    * Returns the byte value of the enumerations value
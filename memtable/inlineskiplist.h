@@ -46,6 +46,7 @@
 #include <algorithm>
 #include <atomic>
 #include <type_traits>
+#include <vector>
 #include "port/likely.h"
 #include "port/port.h"
 #include "rocksdb/slice.h"
@@ -129,6 +130,11 @@ class InlineSkipList {
   // Return estimated number of entries smaller than `key`.
   uint64_t EstimateCount(const char* key) const;
 
+  // Appends to *keys the keys linked at the highest level of the list that
+  // holds at least min_keys of them (level 0 if none does), in order, and
+  // returns the approximate number of entries each of them stands for.
+  uint64_t SampleKeys(size_t min_keys, std::vector<const char*>* keys) const;
+
   // Validate correctness of the skip-list.
   void TEST_Validate() const;
 
@@ -578,6 +584,30 @@ uint64_t InlineSkipList<Comparator>::EstimateCount(const char* key) const {
   }
 }
 
+template <class Comparator>
+uint64_t InlineSkipList<Comparator>::SampleKeys(
+    size_t min_keys, std::vector<const char*>* keys) const {
+  int level = GetMaxHeight() - 1;
+  uint64_t weight = 1;
+  for (int i = 0; i < level; i++) {
+    weight *= kBranching_;
+  }
+  for (; level > 0; level--, weight /= kBranching_) {
+    size_t count = 0;
+    for (Node* x = head_->Next(level); x != nullptr && count < min_keys;
+         x = x->Next(level)) {
+      count++;
+    }
+    if (count >= min_keys) {
+      break;
+    }
+  }
+  for (Node* x = head_->Next(level); x != nullptr; x = x->Next(level)) {
+    keys->push_back(x->Key());
+  }
+  return weight;
+}
+
 template <class Comparator>
 InlineSkipList<Comparator>::InlineSkipList(const Comparator cmp,
                                            Allocator* allocator,
@@ -212,6 +212,37 @@ TEST_F(InlineSkipTest, InsertAndLookup) {
   }
 }
 
+TEST_F(InlineSkipTest, SampleKeys) {
+  const int N = 10000;
+  Arena arena;
+  TestComparator cmp;
+  TestInlineSkipList list(cmp, &arena);
+  std::vector<const char*> samples;
+  ASSERT_EQ(1, list.SampleKeys(10, &samples));
+  ASSERT_TRUE(samples.empty());
+
+  for (int i = 0; i < N; i++) {
+    Insert(&list, i);
+  }
+  for (size_t min_keys : {1, 10, 100, 10000, 20000}) {
+    samples.clear();
+    uint64_t weight = list.SampleKeys(min_keys, &samples);
+    ASSERT_GE(weight, 1U);
+    ASSERT_TRUE(samples.size() >= min_keys || weight == 1);
+    for (size_t i = 1; i < samples.size(); i++) {
+      ASSERT_LT(Decode(samples[i - 1]), Decode(samples[i]));
+    }
+    if (weight == 1) {
+      // Every key of level 0
+      ASSERT_EQ(static_cast<size_t>(N), samples.size());
+    } else {
+      // Stands for roughly the whole list
+      ASSERT_GT(weight * samples.size(), static_cast<uint64_t>(N / 4));
+      ASSERT_LT(weight * samples.size(), static_cast<uint64_t>(N * 4));
+    }
+  }
+}
+
 TEST_F(InlineSkipTest, InsertWithHint_Sequential) {
   const int N = 100000;
   Arena arena;
@@ -0,0 +1,94 @@
+//  Copyright (c) 2011-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "memtable/memtable_hash_index.h"
+
+#include <assert.h>
+
+#include "db/dbformat.h"
+#include "util/allocator.h"
+#include "util/coding.h"
+#include "util/hash.h"
+
+namespace rocksdb {
+
+namespace {
+// Decodes the internal key of a memtable entry
+Slice EntryInternalKey(const char* entry) {
+  uint32_t key_length = 0;
+  const char* key_ptr = GetVarint32Ptr(entry, entry + 5, &key_length);
+  return Slice(key_ptr, key_length);
+}
+}  // namespace
+
+MemTableHashIndex::MemTableHashIndex(Allocator* allocator, size_t num_buckets,
+                                     size_t huge_page_tlb_size, Logger* logger)
+    : allocator_(allocator), num_buckets_(num_buckets) {
+  assert(num_buckets_ > 0);
+  char* mem = allocator_->AllocateAligned(
+      num_buckets_ * sizeof(std::atomic<Node*>), huge_page_tlb_size, logger);
+  buckets_ = reinterpret_cast<std::atomic<Node*>*>(mem);
+  for (size_t i = 0; i < num_buckets_; i++) {
+    new (&buckets_[i]) std::atomic<Node*>(nullptr);
+  }
+}
+
+std::atomic<MemTableHashIndex::Node*>* MemTableHashIndex::GetBucket(
+    const Slice& user_key) const {
+  return &buckets_[GetSliceHash(user_key) % num_buckets_];
+}
+
+MemTableHashIndex::Node* MemTableHashIndex::FindNode(Node* head, Node* end,
+                                                     const Slice& user_key) {
+  for (Node* node = head; node != end; node = node->next) {
+    Slice node_key = ExtractUserKey(
+        EntryInternalKey(node->entry.load(std::memory_order_acquire)));
+    if (node_key == user_key) {
+      return node;
+    }
+  }
+  return nullptr;
+}
+
+void MemTableHashIndex::Add(const Slice& user_key, SequenceNumber seq,
+                            const char* entry) {
+  std::atomic<Node*>* bucket = GetBucket(user_key);
+  Node* head = bucket->load(std::memory_order_acquire);
+  Node* node = FindNode(head, nullptr, user_key);
+  if (node == nullptr) {
+    Node* new_node = reinterpret_cast<Node*>(
+        allocator_->AllocateAligned(sizeof(Node)));
+    new (&new_node->entry) std::atomic<const char*>(entry);
+    new_node->next = head;
+    while (!bucket->compare_exchange_weak(new_node->next, new_node,
+                                          std::memory_order_release,
+                                          std::memory_order_acquire)) {
+      // Another writer may have added a node of the same key meanwhile
+      node = FindNode(new_node->next, head, user_key);
+      if (node != nullptr) {
+        break;
+      }
+      head = new_node->next;
+    }
+    if (node == nullptr) {
+      return;
+    }
+  }
+  const char* newest = node->entry.load(std::memory_order_acquire);
+  while (GetInternalKeySeqno(EntryInternalKey(newest)) < seq &&
+         !node->entry.compare_exchange_weak(newest, entry,
+                                            std::memory_order_release,
+                                            std::memory_order_acquire)) {
+  }
+}
+
+const char* MemTableHashIndex::Get(const Slice& user_key) const {
+  Node* node =
+      FindNode(GetBucket(user_key)->load(std::memory_order_acquire), nullptr,
+               user_key);
+  return node == nullptr ? nullptr : node->entry.load(std::memory_order_acquire);
+}
+
+}  // namespace rocksdb
@@ -0,0 +1,59 @@
+//  Copyright (c) 2011-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#pragma once
+
+#include <atomic>
+
+#include "rocksdb/slice.h"
+#include "rocksdb/types.h"
+
+namespace rocksdb {
+
+class Allocator;
+class Logger;
+
+// A hash index from the user keys of a memtable to their newest entry,
+// which lets MemTable::Get() find the entry of a key without searching the
+// memtable rep. The entries are the ones built by MemTable::Add(), and must
+// stay allocated as long as the index.
+//
+// The buckets are linked lists of nodes allocated from the allocator of the
+// memtable. Nodes are only ever prepended to a bucket and never removed,
+// and the newest entry of a node is replaced with a compare-and-swap, so
+// both Add() and Get() may be called concurrently with any other call.
+class MemTableHashIndex {
+ public:
+  // huge_page_tlb_size: if >0, try to allocate the buckets from huge page
+  //                     TLB within this page size
+  MemTableHashIndex(Allocator* allocator, size_t num_buckets,
+                    size_t huge_page_tlb_size = 0, Logger* logger = nullptr);
+
+  // Records entry, which holds user_key with sequence number seq, unless
+  // the index already holds a newer entry of user_key.
+  void Add(const Slice& user_key, SequenceNumber seq, const char* entry);
+
+  // Returns the newest entry recorded for user_key, or nullptr if there is
+  // none.
+  const char* Get(const Slice& user_key) const;
+
+ private:
+  struct Node {
+    std::atomic<const char*> entry;
+    Node* next;
+  };
+
+  std::atomic<Node*>* GetBucket(const Slice& user_key) const;
+
+  // Returns the node of user_key in the list starting at head, up to but
+  // excluding end, or nullptr
+  static Node* FindNode(Node* head, Node* end, const Slice& user_key);
+
+  Allocator* const allocator_;
+  const size_t num_buckets_;
+  std::atomic<Node*>* buckets_;
+};
+
+}  // namespace rocksdb
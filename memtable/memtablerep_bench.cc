@@ -36,6 +36,7 @@ int main() {
 #include "rocksdb/slice_transform.h"
 #include "rocksdb/write_buffer_manager.h"
 #include "util/arena.h"
+#include "util/concurrent_arena.h"
 #include "util/gflags_compat.h"
 #include "util/mutexlock.h"
 #include "util/stop_watch.h"
@@ -49,8 +50,12 @@ DEFINE_string(benchmarks, "fillrandom",
               "Comma-separated list of benchmarks to run. Options:\n"
               "\tfillrandom             -- write N random values\n"
               "\tfillseq                -- write N values in sequential order\n"
+              "\tfillrandomconcurrent   -- N threads concurrently write random "
+              "values\n"
               "\treadrandom             -- read N values in random order\n"
               "\treadseq                -- scan the DB\n"
+              "\tseekrandom             -- seek an iterator to N values in "
+              "random order\n"
               "\treadwrite              -- 1 thread writes while N - 1 threads "
               "do random\n"
               "\t                          reads\n"
@@ -65,7 +70,9 @@ DEFINE_string(memtablerep, "skiplist",
               "\tvector              -- backed by an std::vector\n"
               "\thashskiplist        -- backed by a hash skip list\n"
               "\thashlinklist        -- backed by a hash linked list\n"
-              "\tcuckoo              -- backed by a cuckoo hash table");
+              "\tcuckoo              -- backed by a cuckoo hash table\n"
+              "\tpartitionedskiplist -- backed by skip lists partitioned by "
+              "key range");
 
 DEFINE_int64(bucket_count, 1000000,
              "bucket_count parameter to pass into NewHashSkiplistRepFactory or "
@@ -79,6 +86,10 @@ DEFINE_int32(
     hashskiplist_branching_factor, 4,
     "branching_factor parameter to pass into NewHashSkiplistRepFactory");
 
+DEFINE_int32(
+    num_partitions, 16,
+    "num_partitions parameter to pass into NewPartitionedSkipListRepFactory");
+
 DEFINE_int32(
     huge_page_tlb_size, 0,
     "huge_page_tlb_size parameter to pass into NewHashLinkListRepFactory");
@@ -298,6 +309,42 @@ class ConcurrentFillBenchmarkThread : public FillBenchmarkThread {
   std::atomic_int* threads_done_;
 };
 
+// Inserts concurrently with the other threads, drawing its sequence numbers
+// from a shared counter
+class ConcurrentInsertBenchmarkThread : public BenchmarkThread {
+ public:
+  ConcurrentInsertBenchmarkThread(MemTableRep* table, KeyGenerator* key_gen,
+                                  uint64_t* bytes_written,
+                                  std::atomic<uint64_t>* sequence,
+                                  uint64_t num_ops)
+      : BenchmarkThread(table, key_gen, bytes_written, nullptr, nullptr,
+                        num_ops, nullptr),
+        atomic_sequence_(sequence) {}
+
+  void operator()() override {
+    auto internal_key_size = 16;
+    auto encoded_len =
+        FLAGS_item_size + VarintLength(internal_key_size) + internal_key_size;
+    for (unsigned int i = 0; i < num_ops_; ++i) {
+      char* buf = nullptr;
+      KeyHandle handle = table_->Allocate(encoded_len, &buf);
+      assert(buf != nullptr);
+      char* p = EncodeVarint32(buf, internal_key_size);
+      EncodeFixed64(p, key_gen_->Next());
+      p += 8;
+      EncodeFixed64(p, atomic_sequence_->fetch_add(1) + 1);
+      p += 8;
+      Slice bytes = generator_.Generate(FLAGS_item_size);
+      memcpy(p, bytes.data(), FLAGS_item_size);
+      table_->InsertConcurrently(handle);
+      *bytes_written_ += encoded_len;
+    }
+  }
+
+ private:
+  std::atomic<uint64_t>* atomic_sequence_;
+};
+
 class ReadBenchmarkThread : public BenchmarkThread {
  public:
   ReadBenchmarkThread(MemTableRep* table, KeyGenerator* key_gen,
@@ -344,6 +391,29 @@ class ReadBenchmarkThread : public BenchmarkThread {
   }
 };
 
+class SeekBenchmarkThread : public BenchmarkThread {
+ public:
+  SeekBenchmarkThread(MemTableRep* table, KeyGenerator* key_gen,
+                      uint64_t* bytes_written, uint64_t* bytes_read,
+                      uint64_t* sequence, uint64_t num_ops, uint64_t* read_hits)
+      : BenchmarkThread(table, key_gen, bytes_written, bytes_read, sequence,
+                        num_ops, read_hits) {}
+
+  void operator()() override {
+    std::unique_ptr<MemTableRep::Iterator> iter(table_->GetIterator());
+    for (unsigned int i = 0; i < num_ops_; ++i) {
+      std::string user_key;
+      PutFixed64(&user_key, key_gen_->Next());
+      LookupKey lookup_key(user_key, *sequence_);
+      iter->Seek(lookup_key.internal_key(), lookup_key.memtable_key().data());
+      if (iter->Valid()) {
+        *bytes_read_ += VarintLength(16) + 16 + FLAGS_item_size;
+        ++*read_hits_;
+      }
+    }
+  }
+};
+
 class SeqReadBenchmarkThread : public BenchmarkThread {
  public:
   SeqReadBenchmarkThread(MemTableRep* table, KeyGenerator* key_gen,
@@ -487,6 +557,42 @@ class FillBenchmark : public Benchmark {
   }
 };
 
+class ConcurrentFillBenchmark : public Benchmark {
+ public:
+  explicit ConcurrentFillBenchmark(MemTableRep* table, uint64_t* sequence)
+      : Benchmark(table, nullptr, sequence, FLAGS_num_threads) {
+    num_write_ops_per_thread_ = FLAGS_num_operations / FLAGS_num_threads;
+  }
+
+  void RunThreads(std::vector<port::Thread>* threads, uint64_t* bytes_written,
+                  uint64_t* /*bytes_read*/, bool /*write*/,
+                  uint64_t* /*read_hits*/) override {
+    // Each thread draws its keys from its own generator
+    std::vector<std::unique_ptr<Random64>> rands;
+    std::vector<std::unique_ptr<KeyGenerator>> key_gens;
+    std::vector<uint64_t> thread_bytes_written(FLAGS_num_threads, 0);
+    std::atomic<uint64_t> atomic_sequence(*sequence_);
+    for (int i = 0; i < FLAGS_num_threads; ++i) {
+      rands.emplace_back(new Random64(FLAGS_seed + i));
+      key_gens.emplace_back(new KeyGenerator(rands.back().get(), RANDOM,
+                                             FLAGS_num_operations));
+    }
+    for (int i = 0; i < FLAGS_num_threads; ++i) {
+      threads->emplace_back(ConcurrentInsertBenchmarkThread(
+          table_, key_gens[i].get(), &thread_bytes_written[i],
+          &atomic_sequence, num_write_ops_per_thread_));
+    }
+    for (auto& thread : *threads) {
+      thread.join();
+    }
+    for (auto thread_bytes : thread_bytes_written) {
+      *bytes_written += thread_bytes;
+    }
+    *sequence_ = atomic_sequence.load();
+  }
+};
+
+template <class ReadThreadType>
 class ReadBenchmark : public Benchmark {
  public:
   explicit ReadBenchmark(MemTableRep* table, KeyGenerator* key_gen,
@@ -500,8 +606,8 @@ class ReadBenchmark : public Benchmark {
                   uint64_t* read_hits) override {
     for (int i = 0; i < FLAGS_num_threads; ++i) {
       threads->emplace_back(
-          ReadBenchmarkThread(table_, key_gen_, bytes_written, bytes_read,
-                              sequence_, num_read_ops_per_thread_, read_hits));
+          ReadThreadType(table_, key_gen_, bytes_written, bytes_read,
+                         sequence_, num_read_ops_per_thread_, read_hits));
     }
     for (auto& thread : *threads) {
       thread.join();
@@ -613,6 +719,9 @@ int main(int argc, char** argv) {
         static_cast<uint32_t>(FLAGS_hash_function_count)));
     options.prefix_extractor.reset(
         rocksdb::NewFixedPrefixTransform(FLAGS_prefix_length));
+  } else if (FLAGS_memtablerep == "partitionedskiplist") {
+    factory.reset(rocksdb::NewPartitionedSkipListRepFactory(
+        static_cast<size_t>(FLAGS_num_partitions)));
 #endif  // ROCKSDB_LITE
   } else {
     fprintf(stdout, "Unknown memtablerep: %s\n", FLAGS_memtablerep.c_str());
@@ -622,7 +731,8 @@ int main(int argc, char** argv) {
   rocksdb::InternalKeyComparator internal_key_comp(
       rocksdb::BytewiseComparator());
   rocksdb::MemTable::KeyComparator key_comp(internal_key_comp);
-  rocksdb::Arena arena;
+  // Thread-safe, for the concurrent inserts
+  rocksdb::ConcurrentArena arena;
   rocksdb::WriteBufferManager wb(FLAGS_write_buffer_size);
   uint64_t sequence;
   auto createMemtableRep = [&] {
@@ -658,11 +768,27 @@ int main(int argc, char** argv) {
                                               FLAGS_num_operations));
       benchmark.reset(new rocksdb::FillBenchmark(memtablerep.get(),
                                                  key_gen.get(), &sequence));
+    } else if (name == rocksdb::Slice("fillrandomconcurrent")) {
+      if (!factory->IsInsertConcurrentlySupported()) {
+        std::cout << "WARNING: skipping fillrandomconcurrent, " << factory->Name()
+                  << " does not support concurrent inserts" << std::endl;
+        continue;
+      }
+      memtablerep.reset(createMemtableRep());
+      benchmark.reset(
+          new rocksdb::ConcurrentFillBenchmark(memtablerep.get(), &sequence));
     } else if (name == rocksdb::Slice("readrandom")) {
       key_gen.reset(new rocksdb::KeyGenerator(&rng, rocksdb::RANDOM,
                                               FLAGS_num_operations));
-      benchmark.reset(new rocksdb::ReadBenchmark(memtablerep.get(),
-                                                 key_gen.get(), &sequence));
+      benchmark.reset(
+          new rocksdb::ReadBenchmark<rocksdb::ReadBenchmarkThread>(
+              memtablerep.get(), key_gen.get(), &sequence));
+    } else if (name == rocksdb::Slice("seekrandom")) {
+      key_gen.reset(new rocksdb::KeyGenerator(&rng, rocksdb::RANDOM,
+                                              FLAGS_num_operations));
+      benchmark.reset(
+          new rocksdb::ReadBenchmark<rocksdb::SeekBenchmarkThread>(
+              memtablerep.get(), key_gen.get(), &sequence));
     } else if (name == rocksdb::Slice("readseq")) {
       key_gen.reset(new rocksdb::KeyGenerator(&rng, rocksdb::SEQUENTIAL,
                                               FLAGS_num_operations));
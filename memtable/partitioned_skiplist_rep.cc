@@ -0,0 +1,362 @@
+//  Copyright (c) 2011-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+//
+
+#ifndef ROCKSDB_LITE
+#include "memtable/partitioned_skiplist_rep.h"
+
+#include <algorithm>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "db/dbformat.h"
+#include "db/memtable.h"
+#include "memtable/inlineskiplist.h"
+#include "util/arena.h"
+#include "util/coding.h"
+
+namespace rocksdb {
+
+struct PartitionBoundaryStore {
+  std::mutex mutex;
+  // The user keys starting each partition but the first one, per column
+  // family
+  std::unordered_map<uint32_t, std::shared_ptr<const std::vector<std::string>>>
+      boundaries;
+};
+
+namespace {
+
+typedef InlineSkipList<const MemTableRep::KeyComparator&> Shard;
+
+// Number of keys sampled for each partition when learning the boundaries
+// of the next memtables
+const size_t kSamplesPerPartition = 8;
+
+// The memtable keys are partitioned by range into several skip lists, so
+// that the concurrent writers only contend on the shard their key falls in,
+// and each search only walks a smaller list. The memtables of a column
+// family first split on the first byte of the user keys; then each memtable
+// samples its keys when it is marked read-only, and the ones created
+// afterwards split its key distribution into partitions of about the same
+// size.
+class PartitionedSkipListRep : public MemTableRep {
+ public:
+  PartitionedSkipListRep(const MemTableRep::KeyComparator& compare,
+                         Allocator* allocator, size_t num_partitions,
+                         const std::vector<std::string>& boundary_user_keys,
+                         std::shared_ptr<PartitionBoundaryStore> store,
+                         uint32_t column_family_id);
+
+  virtual KeyHandle Allocate(const size_t len, char** buf) override {
+    // All the shards use the same height and branching factor, so the node
+    // may be allocated by any of them
+    *buf = shards_[0]->AllocateKey(len);
+    return static_cast<KeyHandle>(*buf);
+  }
+
+  virtual void Insert(KeyHandle handle) override {
+    const char* key = static_cast<char*>(handle);
+    shards_[FindShard(key)]->Insert(key);
+  }
+
+  virtual bool InsertKey(KeyHandle handle) override {
+    const char* key = static_cast<char*>(handle);
+    return shards_[FindShard(key)]->Insert(key);
+  }
+
+  virtual void InsertConcurrently(KeyHandle handle) override {
+    const char* key = static_cast<char*>(handle);
+    shards_[FindShard(key)]->InsertConcurrently(key);
+  }
+
+  virtual bool InsertKeyConcurrently(KeyHandle handle) override {
+    const char* key = static_cast<char*>(handle);
+    return shards_[FindShard(key)]->InsertConcurrently(key);
+  }
+
+  virtual bool Contains(const char* key) const override {
+    return shards_[FindShard(key)]->Contains(key);
+  }
+
+  virtual void MarkReadOnly() override;
+
+  virtual size_t ApproximateMemoryUsage() override {
+    // All memory is allocated through allocator; nothing to report here
+    return 0;
+  }
+
+  virtual void Get(const LookupKey& k, void* callback_args,
+                   bool (*callback_func)(void* arg,
+                                         const char* entry)) override {
+    PartitionedSkipListRep::Iterator iter(this);
+    Slice dummy_slice;
+    for (iter.Seek(dummy_slice, k.memtable_key().data());
+         iter.Valid() && callback_func(callback_args, iter.key());
+         iter.Next()) {
+    }
+  }
+
+  virtual uint64_t ApproximateNumEntries(const Slice& start_ikey,
+                                         const Slice& end_ikey) override {
+    std::string start_tmp;
+    std::string end_tmp;
+    const char* start = EncodeKey(&start_tmp, start_ikey);
+    const char* end = EncodeKey(&end_tmp, end_ikey);
+    uint64_t count = 0;
+    for (size_t i = FindShard(start), last = FindShard(end); i <= last; i++) {
+      uint64_t start_count = shards_[i]->EstimateCount(start);
+      uint64_t end_count = shards_[i]->EstimateCount(end);
+      count += (end_count >= start_count) ? (end_count - start_count) : 0;
+    }
+    return count;
+  }
+
+  virtual void SampleKeys(size_t min_keys, std::vector<const char*>* keys,
+                          std::vector<uint64_t>* weights) override {
+    // The keys sampled from each shard stand for the number of entries that
+    // shard returned
+    for (const auto& shard : shards_) {
+      uint64_t weight = shard->SampleKeys(min_keys, keys);
+      weights->resize(keys->size(), weight);
+    }
+  }
+
+  virtual ~PartitionedSkipListRep() override {}
+
+  // Iterates over the shards one after the other
+  class Iterator : public MemTableRep::Iterator {
+   public:
+    explicit Iterator(const PartitionedSkipListRep* rep)
+        : rep_(rep), shard_(0), iter_(rep->shards_[0].get()) {}
+
+    virtual ~Iterator() override {}
+
+    virtual bool Valid() const override { return iter_.Valid(); }
+
+    virtual const char* key() const override { return iter_.key(); }
+
+    virtual void Next() override {
+      iter_.Next();
+      SkipEmptyShardsForward();
+    }
+
+    virtual void Prev() override {
+      iter_.Prev();
+      SkipEmptyShardsBackward();
+    }
+
+    virtual void Seek(const Slice& internal_key,
+                      const char* memtable_key) override {
+      const char* target = (memtable_key != nullptr)
+                               ? memtable_key
+                               : EncodeKey(&tmp_, internal_key);
+      SetShard(rep_->FindShard(target));
+      iter_.Seek(target);
+      SkipEmptyShardsForward();
+    }
+
+    virtual void SeekForPrev(const Slice& internal_key,
+                             const char* memtable_key) override {
+      const char* target = (memtable_key != nullptr)
+                               ? memtable_key
+                               : EncodeKey(&tmp_, internal_key);
+      SetShard(rep_->FindShard(target));
+      iter_.SeekForPrev(target);
+      SkipEmptyShardsBackward();
+    }
+
+    virtual void SeekToFirst() override {
+      SetShard(0);
+      iter_.SeekToFirst();
+      SkipEmptyShardsForward();
+    }
+
+    virtual void SeekToLast() override {
+      SetShard(rep_->shards_.size() - 1);
+      iter_.SeekToLast();
+      SkipEmptyShardsBackward();
+    }
+
+   private:
+    void SetShard(size_t shard) {
+      shard_ = shard;
+      iter_.SetList(rep_->shards_[shard].get());
+    }
+
+    void SkipEmptyShardsForward() {
+      while (!iter_.Valid() && shard_ + 1 < rep_->shards_.size()) {
+        SetShard(shard_ + 1);
+        iter_.SeekToFirst();
+      }
+    }
+
+    void SkipEmptyShardsBackward() {
+      while (!iter_.Valid() && shard_ > 0) {
+        SetShard(shard_ - 1);
+        iter_.SeekToLast();
+      }
+    }
+
+    const PartitionedSkipListRep* rep_;
+    size_t shard_;
+    Shard::Iterator iter_;
+    std::string tmp_;  // For passing to EncodeKey
+  };
+
+  virtual MemTableRep::Iterator* GetIterator(Arena* arena = nullptr) override {
+    void* mem =
+        arena ? arena->AllocateAligned(sizeof(PartitionedSkipListRep::Iterator))
+              : operator new(sizeof(PartitionedSkipListRep::Iterator));
+    return new (mem) PartitionedSkipListRep::Iterator(this);
+  }
+
+ private:
+  // Returns the index of the shard that holds key
+  size_t FindShard(const char* key) const {
+    size_t left = 0;
+    size_t right = boundaries_.size();
+    while (left < right) {
+      size_t mid = left + (right - left) / 2;
+      if (cmp_(boundaries_[mid].data(), key) <= 0) {
+        left = mid + 1;
+      } else {
+        right = mid;
+      }
+    }
+    return left;
+  }
+
+  const MemTableRep::KeyComparator& cmp_;
+  const size_t num_partitions_;
+  // The memtable keys starting each shard but the first one. They sort
+  // before every entry of their user key, so that all the versions of a
+  // user key land in the same shard.
+  std::vector<std::string> boundaries_;
+  std::vector<std::unique_ptr<Shard>> shards_;
+  // Where the boundaries learned from this memtable are published; nullptr
+  // if they are not learned
+  const std::shared_ptr<PartitionBoundaryStore> store_;
+  const uint32_t column_family_id_;
+};
+
+PartitionedSkipListRep::PartitionedSkipListRep(
+    const MemTableRep::KeyComparator& compare, Allocator* allocator,
+    size_t num_partitions, const std::vector<std::string>& boundary_user_keys,
+    std::shared_ptr<PartitionBoundaryStore> store, uint32_t column_family_id)
+    : MemTableRep(allocator),
+      cmp_(compare),
+      num_partitions_(num_partitions),
+      store_(std::move(store)),
+      column_family_id_(column_family_id) {
+  const uint64_t seek_tag =
+      PackSequenceAndType(kMaxSequenceNumber, kValueTypeForSeek);
+  for (const auto& user_key : boundary_user_keys) {
+    std::string boundary;
+    PutVarint32(&boundary, static_cast<uint32_t>(user_key.size() + 8));
+    boundary.append(user_key);
+    PutFixed64(&boundary, seek_tag);
+    // Skip the boundaries that are out of order for this comparator
+    if (boundaries_.empty() || cmp_(boundaries_.back().data(),
+                                    boundary.data()) < 0) {
+      boundaries_.push_back(std::move(boundary));
+    }
+  }
+  shards_.reserve(boundaries_.size() + 1);
+  for (size_t i = 0; i <= boundaries_.size(); i++) {
+    shards_.emplace_back(new Shard(compare, allocator));
+  }
+}
+
+void PartitionedSkipListRep::MarkReadOnly() {
+  if (store_ == nullptr) {
+    return;
+  }
+  std::vector<const char*> keys;
+  std::vector<uint64_t> weights;
+  SampleKeys(kSamplesPerPartition * num_partitions_, &keys, &weights);
+  uint64_t total_weight = 0;
+  for (uint64_t weight : weights) {
+    total_weight += weight;
+  }
+  if (keys.size() < num_partitions_) {
+    // Too few entries to learn from
+    return;
+  }
+
+  std::shared_ptr<std::vector<std::string>> boundaries(
+      new std::vector<std::string>());
+  uint64_t cumulative_weight = 0;
+  for (size_t i = 0; i < keys.size() &&
+                     boundaries->size() + 1 < num_partitions_;
+       i++) {
+    uint64_t target =
+        total_weight * (boundaries->size() + 1) / num_partitions_;
+    if (cumulative_weight >= target) {
+      Slice user_key = UserKey(keys[i]);
+      if (boundaries->empty() || boundaries->back() != user_key) {
+        boundaries->push_back(user_key.ToString());
+      }
+    }
+    cumulative_weight += weights[i];
+  }
+
+  std::lock_guard<std::mutex> lock(store_->mutex);
+  store_->boundaries[column_family_id_] = std::move(boundaries);
+}
+
+// The boundaries splitting the range of the first byte of the user keys
+// into num_partitions
+std::vector<std::string> FirstByteBoundaries(size_t num_partitions) {
+  std::vector<std::string> boundaries;
+  for (size_t i = 1; i < num_partitions; i++) {
+    boundaries.emplace_back(1, static_cast<char>(i * 256 / num_partitions));
+  }
+  return boundaries;
+}
+
+}  // anon namespace
+
+PartitionedSkipListRepFactory::PartitionedSkipListRepFactory(
+    size_t num_partitions)
+    : num_partitions_(std::max<size_t>(num_partitions, 1)),
+      boundary_store_(std::make_shared<PartitionBoundaryStore>()) {}
+
+MemTableRep* PartitionedSkipListRepFactory::CreateMemTableRep(
+    const MemTableRep::KeyComparator& compare, Allocator* allocator,
+    const SliceTransform* /*transform*/, Logger* /*logger*/) {
+  // Without a column family to learn for, keep splitting on the first byte
+  return new PartitionedSkipListRep(compare, allocator, num_partitions_,
+                                    FirstByteBoundaries(num_partitions_),
+                                    nullptr /* store */,
+                                    0 /* column_family_id */);
+}
+
+MemTableRep* PartitionedSkipListRepFactory::CreateMemTableRep(
+    const MemTableRep::KeyComparator& compare, Allocator* allocator,
+    const SliceTransform* /*transform*/, Logger* /*logger*/,
+    uint32_t column_family_id) {
+  std::shared_ptr<const std::vector<std::string>> learned;
+  {
+    std::lock_guard<std::mutex> lock(boundary_store_->mutex);
+    auto it = boundary_store_->boundaries.find(column_family_id);
+    if (it != boundary_store_->boundaries.end()) {
+      learned = it->second;
+    }
+  }
+  return new PartitionedSkipListRep(
+      compare, allocator, num_partitions_,
+      learned != nullptr ? *learned : FirstByteBoundaries(num_partitions_),
+      boundary_store_, column_family_id);
+}
+
+MemTableRepFactory* NewPartitionedSkipListRepFactory(size_t num_partitions) {
+  return new PartitionedSkipListRepFactory(num_partitions);
+}
+
+}  // namespace rocksdb
+#endif  // ROCKSDB_LITE
@@ -0,0 +1,48 @@
+//  Copyright (c) 2011-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#pragma once
+#ifndef ROCKSDB_LITE
+#include <memory>
+
+#include "rocksdb/memtablerep.h"
+
+namespace rocksdb {
+
+struct PartitionBoundaryStore;
+
+class PartitionedSkipListRepFactory : public MemTableRepFactory {
+ public:
+  explicit PartitionedSkipListRepFactory(size_t num_partitions);
+
+  virtual ~PartitionedSkipListRepFactory() {}
+
+  virtual MemTableRep* CreateMemTableRep(
+      const MemTableRep::KeyComparator& compare, Allocator* allocator,
+      const SliceTransform* transform, Logger* logger) override;
+
+  virtual MemTableRep* CreateMemTableRep(
+      const MemTableRep::KeyComparator& compare, Allocator* allocator,
+      const SliceTransform* transform, Logger* logger,
+      uint32_t column_family_id) override;
+
+  virtual const char* Name() const override {
+    return "PartitionedSkipListRepFactory";
+  }
+
+  bool IsInsertConcurrentlySupported() const override { return true; }
+
+  bool CanHandleDuplicatedKey() const override { return true; }
+
+ private:
+  const size_t num_partitions_;
+  // The boundaries learned from the memtables that were marked read-only,
+  // per column family. Shared with the memtables, which may outlive the
+  // factory.
+  std::shared_ptr<PartitionBoundaryStore> boundary_store_;
+};
+
+}  // namespace rocksdb
+#endif  // ROCKSDB_LITE
@@ -88,6 +88,12 @@ public:
     return (end_count >= start_count) ? (end_count - start_count) : 0;
   }
 
+  void SampleKeys(size_t min_keys, std::vector<const char*>* keys,
+                  std::vector<uint64_t>* weights) override {
+    uint64_t weight = skip_list_.SampleKeys(min_keys, keys);
+    weights->resize(keys->size(), weight);
+  }
+
   virtual ~SkipListRep() override { }
 
   // Iteration over the contents of a skip list
@@ -168,6 +168,20 @@ const std::vector<std::pair<Tickers, std::string>> TickersNameMap = {
     {NUMBER_MULTIGET_KEYS_FOUND, "rocksdb.number.multiget.keys.found"},
     {NO_ITERATOR_CREATED, "rocksdb.num.iterator.created"},
     {NO_ITERATOR_DELETED, "rocksdb.num.iterator.deleted"},
+    {COMPRESSED_TIER_HIT, "rocksdb.compressed.tier.hit"},
+    {COMPRESSED_TIER_MISS, "rocksdb.compressed.tier.miss"},
+    {COMPRESSED_TIER_DEMOTED, "rocksdb.compressed.tier.demoted"},
+    {COMPRESSED_TIER_DEMOTED_BYTES, "rocksdb.compressed.tier.demoted.bytes"},
+    {COMPRESSED_TIER_DEMOTED_COMPRESSED_BYTES,
+     "rocksdb.compressed.tier.demoted.compressed.bytes"},
+    {BLOCK_CACHE_ADMISSION_ACCEPT, "rocksdb.block.cache.admission.accept"},
+    {BLOCK_CACHE_ADMISSION_REJECT, "rocksdb.block.cache.admission.reject"},
+    {ADAPTIVE_COMPRESSION_SAMPLED_BLOCKS,
+     "rocksdb.adaptive.compression.sampled.blocks"},
+    {ADAPTIVE_COMPRESSION_SKIPPED_BLOCKS,
+     "rocksdb.adaptive.compression.skipped.blocks"},
+    {ADAPTIVE_COMPRESSION_ALTERNATE_BLOCKS,
+     "rocksdb.adaptive.compression.alternate.blocks"},
 };
 
 const std::vector<std::pair<Histograms, std::string>> HistogramsNameMap = {
@@ -56,6 +56,8 @@ ImmutableCFOptions::ImmutableCFOptions(const ImmutableDBOptions& db_options,
           cf_options.purge_redundant_kvs_while_flush),
       use_fsync(db_options.use_fsync),
       compression_per_level(cf_options.compression_per_level),
+      adaptive_compression_types(cf_options.adaptive_compression_types),
+      adaptive_compression_min_ratio(cf_options.adaptive_compression_min_ratio),
       bottommost_compression(cf_options.bottommost_compression),
       bottommost_compression_opts(cf_options.bottommost_compression_opts),
       compression_opts(cf_options.compression_opts),
@@ -73,6 +75,7 @@ ImmutableCFOptions::ImmutableCFOptions(const ImmutableDBOptions& db_options,
       listeners(db_options.listeners),
       row_cache(db_options.row_cache),
       max_subcompactions(db_options.max_subcompactions),
+      max_flush_subranges(db_options.max_flush_subranges),
       memtable_insert_with_hint_prefix_extractor(
           cf_options.memtable_insert_with_hint_prefix_extractor.get()),
       cf_paths(cf_options.cf_paths) {}
@@ -133,6 +136,8 @@ void MutableCFOptions::Dump(Logger* log) const {
                  arena_block_size);
   ROCKS_LOG_INFO(log, "              memtable_prefix_bloom_ratio: %f",
                  memtable_prefix_bloom_size_ratio);
+  ROCKS_LOG_INFO(log, "           memtable_hash_index_size_ratio: %f",
+                 memtable_hash_index_size_ratio);
   ROCKS_LOG_INFO(log,
                  "                  memtable_huge_page_size: %" ROCKSDB_PRIszt,
                  memtable_huge_page_size);
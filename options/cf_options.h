@@ -87,6 +87,10 @@ struct ImmutableCFOptions {
 
   std::vector<CompressionType> compression_per_level;
 
+  std::vector<CompressionType> adaptive_compression_types;
+
+  double adaptive_compression_min_ratio;
+
   CompressionType bottommost_compression;
 
   CompressionOptions bottommost_compression_opts;
@@ -117,6 +121,8 @@ struct ImmutableCFOptions {
 
   uint32_t max_subcompactions;
 
+  uint32_t max_flush_subranges;
+
   const SliceTransform* memtable_insert_with_hint_prefix_extractor;
 
   std::vector<DbPath> cf_paths;
@@ -129,6 +135,7 @@ struct MutableCFOptions {
         arena_block_size(options.arena_block_size),
         memtable_prefix_bloom_size_ratio(
             options.memtable_prefix_bloom_size_ratio),
+        memtable_hash_index_size_ratio(options.memtable_hash_index_size_ratio),
         memtable_huge_page_size(options.memtable_huge_page_size),
         max_successive_merges(options.max_successive_merges),
         inplace_update_num_locks(options.inplace_update_num_locks),
@@ -165,6 +172,7 @@ struct MutableCFOptions {
         max_write_buffer_number(0),
         arena_block_size(0),
         memtable_prefix_bloom_size_ratio(0),
+        memtable_hash_index_size_ratio(0),
         memtable_huge_page_size(0),
         max_successive_merges(0),
         inplace_update_num_locks(0),
@@ -211,6 +219,7 @@ struct MutableCFOptions {
   int max_write_buffer_number;
   size_t arena_block_size;
   double memtable_prefix_bloom_size_ratio;
+  double memtable_hash_index_size_ratio;
   size_t memtable_huge_page_size;
   size_t max_successive_merges;
   size_t inplace_update_num_locks;
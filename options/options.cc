@@ -51,12 +51,15 @@ AdvancedColumnFamilyOptions::AdvancedColumnFamilyOptions(const Options& options)
       inplace_callback(options.inplace_callback),
       memtable_prefix_bloom_size_ratio(
           options.memtable_prefix_bloom_size_ratio),
+      memtable_hash_index_size_ratio(options.memtable_hash_index_size_ratio),
       memtable_huge_page_size(options.memtable_huge_page_size),
       memtable_insert_with_hint_prefix_extractor(
           options.memtable_insert_with_hint_prefix_extractor),
       bloom_locality(options.bloom_locality),
       arena_block_size(options.arena_block_size),
       compression_per_level(options.compression_per_level),
+      adaptive_compression_types(options.adaptive_compression_types),
+      adaptive_compression_min_ratio(options.adaptive_compression_min_ratio),
       num_levels(options.num_levels),
       level0_slowdown_writes_trigger(options.level0_slowdown_writes_trigger),
       level0_stop_writes_trigger(options.level0_stop_writes_trigger),
@@ -141,6 +144,14 @@ void ColumnFamilyOptions::Dump(Logger* log) const {
       ROCKS_LOG_HEADER(log, "         Options.compression: %s",
                        CompressionTypeToString(compression).c_str());
     }
+    for (size_t i = 0; i < adaptive_compression_types.size(); i++) {
+      ROCKS_LOG_HEADER(
+          log, "       Options.adaptive_compression_types[%" ROCKSDB_PRIszt
+               "]: %s",
+          i, CompressionTypeToString(adaptive_compression_types[i]).c_str());
+    }
+    ROCKS_LOG_HEADER(log, "  Options.adaptive_compression_min_ratio: %f",
+                     adaptive_compression_min_ratio);
     ROCKS_LOG_HEADER(
         log, "                 Options.bottommost_compression: %s",
         bottommost_compression == kDisableCompressionOption
@@ -181,6 +192,15 @@ void ColumnFamilyOptions::Dump(Logger* log) const {
     ROCKS_LOG_HEADER(
         log, "                 Options.bottommost_compression_opts.enabled: %s",
         bottommost_compression_opts.enabled ? "true" : "false");
+    ROCKS_LOG_HEADER(
+        log,
+        "        Options.bottommost_compression_opts.parallel_threads: %" PRIu32,
+        bottommost_compression_opts.parallel_threads);
+    ROCKS_LOG_HEADER(
+        log,
+        "   Options.bottommost_compression_opts.shared_dict_max_files: "
+        "%" PRIu32,
+        bottommost_compression_opts.shared_dict_max_files);
     ROCKS_LOG_HEADER(log, "           Options.compression_opts.window_bits: %d",
                      compression_opts.window_bits);
     ROCKS_LOG_HEADER(log, "                 Options.compression_opts.level: %d",
@@ -198,6 +218,12 @@ void ColumnFamilyOptions::Dump(Logger* log) const {
     ROCKS_LOG_HEADER(log,
                      "                 Options.compression_opts.enabled: %s",
                      compression_opts.enabled ? "true" : "false");
+    ROCKS_LOG_HEADER(log,
+                     "        Options.compression_opts.parallel_threads: %" PRIu32,
+                     compression_opts.parallel_threads);
+    ROCKS_LOG_HEADER(
+        log, "   Options.compression_opts.shared_dict_max_files: %" PRIu32,
+        compression_opts.shared_dict_max_files);
     ROCKS_LOG_HEADER(log, "     Options.level0_file_num_compaction_trigger: %d",
                      level0_file_num_compaction_trigger);
     ROCKS_LOG_HEADER(log, "         Options.level0_slowdown_writes_trigger: %d",
@@ -327,6 +353,9 @@ void ColumnFamilyOptions::Dump(Logger* log) const {
     ROCKS_LOG_HEADER(
         log, "              Options.memtable_prefix_bloom_size_ratio: %f",
         memtable_prefix_bloom_size_ratio);
+    ROCKS_LOG_HEADER(
+        log, "                Options.memtable_hash_index_size_ratio: %f",
+        memtable_hash_index_size_ratio);
 
     ROCKS_LOG_HEADER(log, "  Options.memtable_huge_page_size: %" ROCKSDB_PRIszt,
                      memtable_huge_page_size);
@@ -550,6 +579,7 @@ ReadOptions::ReadOptions()
       iterate_lower_bound(nullptr),
       iterate_upper_bound(nullptr),
       readahead_size(0),
+      readahead_buffers_in_flight(0),
       max_skippable_internal_keys(0),
       read_tier(kReadAllTier),
       verify_checksums(true),
@@ -568,6 +598,7 @@ ReadOptions::ReadOptions(bool cksum, bool cache)
       iterate_lower_bound(nullptr),
       iterate_upper_bound(nullptr),
       readahead_size(0),
+      readahead_buffers_in_flight(0),
       max_skippable_internal_keys(0),
       read_tier(kReadAllTier),
       verify_checksums(cksum),
@@ -97,6 +97,7 @@ DBOptions BuildDBOptions(const ImmutableDBOptions& immutable_db_options,
   options.enable_thread_tracking = immutable_db_options.enable_thread_tracking;
   options.delayed_write_rate = mutable_db_options.delayed_write_rate;
   options.enable_pipelined_write = immutable_db_options.enable_pipelined_write;
+  options.unordered_write = immutable_db_options.unordered_write;
   options.allow_concurrent_memtable_write =
       immutable_db_options.allow_concurrent_memtable_write;
   options.enable_write_thread_adaptive_yield =
@@ -127,6 +128,9 @@ DBOptions BuildDBOptions(const ImmutableDBOptions& immutable_db_options,
   options.two_write_queues = immutable_db_options.two_write_queues;
   options.manual_wal_flush = immutable_db_options.manual_wal_flush;
   options.atomic_flush = immutable_db_options.atomic_flush;
+  options.wal_compression = immutable_db_options.wal_compression;
+  options.wal_recovery_threads = immutable_db_options.wal_recovery_threads;
+  options.max_flush_subranges = immutable_db_options.max_flush_subranges;
 
   return options;
 }
@@ -142,6 +146,8 @@ ColumnFamilyOptions BuildColumnFamilyOptions(
   cf_opts.arena_block_size = mutable_cf_options.arena_block_size;
   cf_opts.memtable_prefix_bloom_size_ratio =
       mutable_cf_options.memtable_prefix_bloom_size_ratio;
+  cf_opts.memtable_hash_index_size_ratio =
+      mutable_cf_options.memtable_hash_index_size_ratio;
   cf_opts.memtable_huge_page_size = mutable_cf_options.memtable_huge_page_size;
   cf_opts.max_successive_merges = mutable_cf_options.max_successive_merges;
   cf_opts.inplace_update_num_locks =
@@ -923,8 +929,34 @@ Status ParseCompressionOptions(const std::string& value, const std::string& name
       return Status::InvalidArgument(
           "unable to parse the specified CF option " + name);
     }
+    end = value.find(':', start);
     compression_opts.enabled =
-        ParseBoolean("", value.substr(start, value.size() - start));
+        ParseBoolean("", value.substr(start, end == std::string::npos
+                                                 ? value.size() - start
+                                                 : end - start));
+  }
+  // parallel_threads is optional for backwards compatibility
+  if (end != std::string::npos) {
+    start = end + 1;
+    if (start >= value.size()) {
+      return Status::InvalidArgument(
+          "unable to parse the specified CF option " + name);
+    }
+    end = value.find(':', start);
+    compression_opts.parallel_threads =
+        ParseUint32(value.substr(start, end == std::string::npos
+                                            ? value.size() - start
+                                            : end - start));
+  }
+  // shared_dict_max_files is optional for backwards compatibility
+  if (end != std::string::npos) {
+    start = end + 1;
+    if (start >= value.size()) {
+      return Status::InvalidArgument(
+          "unable to parse the specified CF option " + name);
+    }
+    compression_opts.shared_dict_max_files =
+        ParseUint32(value.substr(start, value.size() - start));
   }
   return Status::OK();
 }
@@ -1499,6 +1531,9 @@ std::unordered_map<std::string, OptionTypeInfo>
         {"enable_pipelined_write",
          {offsetof(struct DBOptions, enable_pipelined_write),
           OptionType::kBoolean, OptionVerificationType::kNormal, false, 0}},
+        {"unordered_write",
+         {offsetof(struct DBOptions, unordered_write), OptionType::kBoolean,
+          OptionVerificationType::kNormal, false, 0}},
         {"allow_concurrent_memtable_write",
          {offsetof(struct DBOptions, allow_concurrent_memtable_write),
           OptionType::kBoolean, OptionVerificationType::kNormal, false, 0}},
@@ -1560,21 +1595,38 @@ std::unordered_map<std::string, OptionTypeInfo>
         {"atomic_flush",
          {offsetof(struct DBOptions, atomic_flush), OptionType::kBoolean,
           OptionVerificationType::kNormal, false,
-          offsetof(struct ImmutableDBOptions, atomic_flush)}}};
+          offsetof(struct ImmutableDBOptions, atomic_flush)}},
+        {"wal_compression",
+         {offsetof(struct DBOptions, wal_compression),
+          OptionType::kCompressionType, OptionVerificationType::kNormal, false,
+          offsetof(struct ImmutableDBOptions, wal_compression)}},
+        {"wal_recovery_threads",
+         {offsetof(struct DBOptions, wal_recovery_threads), OptionType::kInt,
+          OptionVerificationType::kNormal, false,
+          offsetof(struct ImmutableDBOptions, wal_recovery_threads)}},
+        {"max_flush_subranges",
+         {offsetof(struct DBOptions, max_flush_subranges), OptionType::kUInt32T,
+          OptionVerificationType::kNormal, false,
+          offsetof(struct ImmutableDBOptions, max_flush_subranges)}}};
 
 std::unordered_map<std::string, BlockBasedTableOptions::IndexType>
     OptionsHelper::block_base_table_index_type_string_map = {
         {"kBinarySearch", BlockBasedTableOptions::IndexType::kBinarySearch},
         {"kHashSearch", BlockBasedTableOptions::IndexType::kHashSearch},
         {"kTwoLevelIndexSearch",
-         BlockBasedTableOptions::IndexType::kTwoLevelIndexSearch}};
+         BlockBasedTableOptions::IndexType::kTwoLevelIndexSearch},
+        {"kInterpolationSearch",
+         BlockBasedTableOptions::IndexType::kInterpolationSearch}};
 
 std::unordered_map<std::string, BlockBasedTableOptions::DataBlockIndexType>
     OptionsHelper::block_base_table_data_block_index_type_string_map = {
         {"kDataBlockBinarySearch",
          BlockBasedTableOptions::DataBlockIndexType::kDataBlockBinarySearch},
         {"kDataBlockBinaryAndHash",
-         BlockBasedTableOptions::DataBlockIndexType::kDataBlockBinaryAndHash}};
+         BlockBasedTableOptions::DataBlockIndexType::kDataBlockBinaryAndHash},
+        {"kDataBlockBinaryAndKeyPrefixes",
+         BlockBasedTableOptions::DataBlockIndexType::
+             kDataBlockBinaryAndKeyPrefixes}};
 
 std::unordered_map<std::string, EncodingType>
     OptionsHelper::encoding_type_string_map = {{"kPlain", kPlain},
@@ -1798,6 +1850,10 @@ std::unordered_map<std::string, OptionTypeInfo>
          {offset_of(&ColumnFamilyOptions::memtable_prefix_bloom_size_ratio),
           OptionType::kDouble, OptionVerificationType::kNormal, true,
           offsetof(struct MutableCFOptions, memtable_prefix_bloom_size_ratio)}},
+        {"memtable_hash_index_size_ratio",
+         {offset_of(&ColumnFamilyOptions::memtable_hash_index_size_ratio),
+          OptionType::kDouble, OptionVerificationType::kNormal, true,
+          offsetof(struct MutableCFOptions, memtable_hash_index_size_ratio)}},
         {"memtable_prefix_bloom_probes",
          {0, OptionType::kUInt32T, OptionVerificationType::kDeprecated, true,
           0}},
@@ -1837,6 +1893,13 @@ std::unordered_map<std::string, OptionTypeInfo>
          {offset_of(&ColumnFamilyOptions::compression_per_level),
           OptionType::kVectorCompressionType, OptionVerificationType::kNormal,
           false, 0}},
+        {"adaptive_compression_types",
+         {offset_of(&ColumnFamilyOptions::adaptive_compression_types),
+          OptionType::kVectorCompressionType, OptionVerificationType::kNormal,
+          false, 0}},
+        {"adaptive_compression_min_ratio",
+         {offset_of(&ColumnFamilyOptions::adaptive_compression_min_ratio),
+          OptionType::kDouble, OptionVerificationType::kNormal, false, 0}},
         {"bottommost_compression",
          {offset_of(&ColumnFamilyOptions::bottommost_compression),
           OptionType::kCompressionType, OptionVerificationType::kNormal, false,
@@ -1966,7 +2029,11 @@ std::unordered_map<std::string, OptionTypeInfo>
         {"high_pri_pool_ratio",
          {offset_of(&LRUCacheOptions::high_pri_pool_ratio), OptionType::kDouble,
           OptionVerificationType::kNormal, true,
-          offsetof(struct LRUCacheOptions, high_pri_pool_ratio)}}};
+          offsetof(struct LRUCacheOptions, high_pri_pool_ratio)}},
+        {"use_admission_filter",
+         {offset_of(&LRUCacheOptions::use_admission_filter),
+          OptionType::kBoolean, OptionVerificationType::kNormal, true,
+          offsetof(struct LRUCacheOptions, use_admission_filter)}}};
 
 #endif  // !ROCKSDB_LITE
 
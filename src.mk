@@ -1,6 +1,9 @@
 # These are the sources from which librocksdb.a is built:
 LIB_SOURCES =                                                   \
   cache/clock_cache.cc                                          \
+  cache/compressed_tiered_cache.cc                              \
+  cache/frequency_sketch.cc                                     \
+  cache/lock_free_clock_cache.cc                                \
   cache/lru_cache.cc                                            \
   cache/sharded_cache.cc                                        \
   db/builder.cc                                                 \
@@ -55,10 +58,12 @@ LIB_SOURCES =                                                   \
   db/version_edit.cc                                            \
   db/version_set.cc                                             \
   db/wal_manager.cc                                             \
+  db/wal_prefetcher.cc                                          \
   db/write_batch.cc                                             \
   db/write_batch_base.cc                                        \
   db/write_controller.cc                                        \
   db/write_thread.cc                                            \
+  db/write_watermark.cc                                         \
   env/env.cc                                                    \
   env/env_chroot.cc                                             \
   env/env_encryption.cc                                         \
@@ -70,6 +75,8 @@ LIB_SOURCES =                                                   \
   memtable/hash_cuckoo_rep.cc                                   \
   memtable/hash_linklist_rep.cc                                 \
   memtable/hash_skiplist_rep.cc                                 \
+  memtable/memtable_hash_index.cc                               \
+  memtable/partitioned_skiplist_rep.cc                          \
   memtable/skiplistrep.cc                                       \
   memtable/vectorrep.cc                                         \
   memtable/write_buffer_manager.cc                              \
@@ -123,6 +130,7 @@ LIB_SOURCES =                                                   \
   table/plain_table_index.cc                                    \
   table/plain_table_key_coding.cc                               \
   table/plain_table_reader.cc                                   \
+  table/restart_key_prefixes.cc                                 \
   table/sst_file_reader.cc                                      \
   table/sst_file_writer.cc                                      \
   table/table_properties.cc                                     \
@@ -151,9 +159,11 @@ LIB_SOURCES =                                                   \
   util/murmurhash.cc                                            \
   util/random.cc                                                \
   util/rate_limiter.cc                                          \
+  util/ribbon.cc                                                \
   util/slice.cc                                                 \
   util/sst_file_manager_impl.cc                                 \
   util/status.cc                                                \
+  util/streaming_compression.cc                                 \
   util/string_util.cc                                           \
   util/sync_point.cc                                            \
   util/sync_point_impl.cc                                       \
@@ -208,8 +208,12 @@ void DataBlockIter::Seek(const Slice& target) {
     return;
   }
   uint32_t index = 0;
-  bool ok = BinarySeek<DecodeKey>(seek_key, 0, num_restarts_ - 1, &index,
-                                  comparator_);
+  uint32_t left = 0;
+  uint32_t right = num_restarts_ - 1;
+  if (key_prefixes_) {
+    key_prefixes_->Narrow(ExtractUserKey(target), &left, &right);
+  }
+  bool ok = BinarySeek<DecodeKey>(seek_key, left, right, &index, comparator_);
 
   if (!ok) {
     return;
@@ -354,12 +358,18 @@ void IndexBlockIter::Seek(const Slice& target) {
   bool ok = false;
   if (prefix_index_) {
     ok = PrefixSeek(target, &index);
-  } else if (value_delta_encoded_) {
-    ok = BinarySeek<DecodeKeyV4>(seek_key, 0, num_restarts_ - 1, &index,
-                                 comparator_);
   } else {
-    ok = BinarySeek<DecodeKey>(seek_key, 0, num_restarts_ - 1, &index,
-                               comparator_);
+    uint32_t left = 0;
+    uint32_t right = num_restarts_ - 1;
+    if (key_prefixes_) {
+      key_prefixes_->Narrow(ExtractUserKey(target), &left, &right);
+    }
+    if (value_delta_encoded_) {
+      ok = BinarySeek<DecodeKeyV4>(seek_key, left, right, &index,
+                                   comparator_);
+    } else {
+      ok = BinarySeek<DecodeKey>(seek_key, left, right, &index, comparator_);
+    }
   }
 
   if (!ok) {
@@ -382,8 +392,12 @@ void DataBlockIter::SeekForPrev(const Slice& target) {
     return;
   }
   uint32_t index = 0;
-  bool ok = BinarySeek<DecodeKey>(seek_key, 0, num_restarts_ - 1, &index,
-                                  comparator_);
+  uint32_t left = 0;
+  uint32_t right = num_restarts_ - 1;
+  if (key_prefixes_) {
+    key_prefixes_->Narrow(ExtractUserKey(target), &left, &right);
+  }
+  bool ok = BinarySeek<DecodeKey>(seek_key, left, right, &index, comparator_);
 
   if (!ok) {
     return;
@@ -816,6 +830,27 @@ Block::Block(BlockContents&& contents, SequenceNumber _global_seqno,
           break;
         }
         break;
+      case BlockBasedTableOptions::kDataBlockBinaryAndKeyPrefixes: {
+        size_t key_prefixes_size = 0;
+        Status s = key_prefixes_.Initialize(
+            Slice(data_, size_ - sizeof(uint32_t)), &key_prefixes_size);
+        if (!s.ok() || key_prefixes_.num_restarts() != num_restarts_) {
+          key_prefixes_ = RestartKeyPrefixes();
+          size_ = 0;
+          break;
+        }
+        uint32_t key_prefixes_offset = static_cast<uint32_t>(
+            size_ - sizeof(uint32_t) - key_prefixes_size);
+        restart_offset_ =
+            key_prefixes_offset - num_restarts_ * sizeof(uint32_t);
+        if (restart_offset_ > key_prefixes_offset) {
+          // key_prefixes_offset is too small for NumRestarts() and
+          // therefore restart_offset_ wrapped around.
+          key_prefixes_ = RestartKeyPrefixes();
+          size_ = 0;
+        }
+        break;
+      }
       default:
         size_ = 0;  // Error marker
     }
@@ -833,7 +868,9 @@ DataBlockIter* Block::NewIterator(const Comparator* cmp, const Comparator* ucmp,
                                   bool /*key_includes_seq*/,
                                   bool /*value_is_full*/,
                                   bool block_contents_pinned,
-                                  BlockPrefixIndex* /*prefix_index*/) {
+                                  BlockPrefixIndex* /*prefix_index*/,
+                                  const RestartKeyPrefixes* /*key_prefixes*/) {
+  // A data block carries its own key prefixes, if any
   DataBlockIter* ret_iter;
   if (iter != nullptr) {
     ret_iter = iter;
@@ -852,7 +889,8 @@ DataBlockIter* Block::NewIterator(const Comparator* cmp, const Comparator* ucmp,
     ret_iter->Initialize(
         cmp, ucmp, data_, restart_offset_, num_restarts_, global_seqno_,
         read_amp_bitmap_.get(), block_contents_pinned,
-        data_block_hash_index_.Valid() ? &data_block_hash_index_ : nullptr);
+        data_block_hash_index_.Valid() ? &data_block_hash_index_ : nullptr,
+        key_prefixes_.Valid() ? &key_prefixes_ : nullptr);
     if (read_amp_bitmap_) {
       if (read_amp_bitmap_->GetStatistics() != stats) {
         // DB changed the Statistics pointer, we need to notify read_amp_bitmap_
@@ -870,7 +908,8 @@ IndexBlockIter* Block::NewIterator(const Comparator* cmp,
                                    Statistics* /*stats*/, bool total_order_seek,
                                    bool key_includes_seq, bool value_is_full,
                                    bool block_contents_pinned,
-                                   BlockPrefixIndex* prefix_index) {
+                                   BlockPrefixIndex* prefix_index,
+                                   const RestartKeyPrefixes* key_prefixes) {
   IndexBlockIter* ret_iter;
   if (iter != nullptr) {
     ret_iter = iter;
@@ -888,10 +927,13 @@ IndexBlockIter* Block::NewIterator(const Comparator* cmp,
   } else {
     BlockPrefixIndex* prefix_index_ptr =
         total_order_seek ? nullptr : prefix_index;
+    // The key prefixes describe the restart points of this very block
+    assert(key_prefixes == nullptr ||
+           key_prefixes->num_restarts() == num_restarts_);
     ret_iter->Initialize(cmp, ucmp, data_, restart_offset_, num_restarts_,
                          prefix_index_ptr, key_includes_seq, value_is_full,
                          block_contents_pinned,
-                         nullptr /* data_block_hash_index */);
+                         nullptr /* data_block_hash_index */, key_prefixes);
   }
 
   return ret_iter;
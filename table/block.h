@@ -30,6 +30,7 @@
 #include "table/block_prefix_index.h"
 #include "table/data_block_hash_index.h"
 #include "table/internal_iterator.h"
+#include "table/restart_key_prefixes.h"
 #include "util/random.h"
 #include "util/sync_point.h"
 
@@ -177,6 +178,8 @@ class Block {
   // NewIterator<IndexBlockIter>
   // If `prefix_index` is not nullptr this block will do hash lookup for the key
   // prefix. If total_order_seek is true, prefix_index_ is ignored.
+  // If `key_prefixes` is not nullptr, it is used to narrow down the binary
+  // search of seeks that do not use the hash lookup.
   //
   // If `block_contents_pinned` is true, the caller will guarantee that when
   // the cleanup functions are transferred from the iterator to other
@@ -195,7 +198,8 @@ class Block {
       TBlockIter* iter = nullptr, Statistics* stats = nullptr,
       bool total_order_seek = true, bool key_includes_seq = true,
       bool value_is_full = true, bool block_contents_pinned = false,
-      BlockPrefixIndex* prefix_index = nullptr);
+      BlockPrefixIndex* prefix_index = nullptr,
+      const RestartKeyPrefixes* key_prefixes = nullptr);
 
   // Report an approximation of how much memory has been used.
   size_t ApproximateMemoryUsage() const;
@@ -214,6 +218,7 @@ class Block {
   const SequenceNumber global_seqno_;
 
   DataBlockHashIndex data_block_hash_index_;
+  RestartKeyPrefixes key_prefixes_;
 
   // No copying allowed
   Block(const Block&) = delete;
@@ -307,6 +312,8 @@ class BlockIter : public InternalIteratorBase<TValue> {
   // e.g. PinnableSlice, the pointer to the bytes will still be valid.
   bool block_contents_pinned_;
   SequenceNumber global_seqno_;
+  // Narrows down the restart points searched by Seek() if not nullptr
+  const RestartKeyPrefixes* key_prefixes_ = nullptr;
 
  public:
   // Return the offset in data_ just past the end of the current entry.
@@ -345,11 +352,12 @@ class DataBlockIter final : public BlockIter<Slice> {
                 const char* data, uint32_t restarts, uint32_t num_restarts,
                 SequenceNumber global_seqno,
                 BlockReadAmpBitmap* read_amp_bitmap, bool block_contents_pinned,
-                DataBlockHashIndex* data_block_hash_index)
+                DataBlockHashIndex* data_block_hash_index,
+                const RestartKeyPrefixes* key_prefixes = nullptr)
       : DataBlockIter() {
     Initialize(comparator, user_comparator, data, restarts, num_restarts,
                global_seqno, read_amp_bitmap, block_contents_pinned,
-               data_block_hash_index);
+               data_block_hash_index, key_prefixes);
   }
   void Initialize(const Comparator* comparator,
                   const Comparator* user_comparator, const char* data,
@@ -357,7 +365,8 @@ class DataBlockIter final : public BlockIter<Slice> {
                   SequenceNumber global_seqno,
                   BlockReadAmpBitmap* read_amp_bitmap,
                   bool block_contents_pinned,
-                  DataBlockHashIndex* data_block_hash_index) {
+                  DataBlockHashIndex* data_block_hash_index,
+                  const RestartKeyPrefixes* key_prefixes = nullptr) {
     InitializeBase(comparator, data, restarts, num_restarts, global_seqno,
                    block_contents_pinned);
     user_comparator_ = user_comparator;
@@ -365,6 +374,7 @@ class DataBlockIter final : public BlockIter<Slice> {
     read_amp_bitmap_ = read_amp_bitmap;
     last_bitmap_offset_ = current_ + 1;
     data_block_hash_index_ = data_block_hash_index;
+    key_prefixes_ = key_prefixes;
   }
 
   virtual Slice value() const override {
@@ -476,13 +486,15 @@ class IndexBlockIter final : public BlockIter<BlockHandle> {
                   uint32_t restarts, uint32_t num_restarts,
                   BlockPrefixIndex* prefix_index, bool key_includes_seq,
                   bool value_is_full, bool block_contents_pinned,
-                  DataBlockHashIndex* /*data_block_hash_index*/) {
+                  DataBlockHashIndex* /*data_block_hash_index*/,
+                  const RestartKeyPrefixes* key_prefixes = nullptr) {
     InitializeBase(key_includes_seq ? comparator : user_comparator, data,
                    restarts, num_restarts, kDisableGlobalSequenceNumber,
                    block_contents_pinned);
     key_includes_seq_ = key_includes_seq;
     key_.SetIsUserKey(!key_includes_seq_);
     prefix_index_ = prefix_index;
+    key_prefixes_ = key_prefixes;
     value_delta_encoded_ = !value_is_full;
   }
 
@@ -11,10 +11,15 @@
 
 #include <assert.h>
 #include <stdio.h>
+#include <string.h>
 
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
 #include <list>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <unordered_map>
 #include <utility>
@@ -47,6 +52,7 @@
 #include "util/string_util.h"
 #include "util/xxhash.h"
 
+#include "port/port.h"
 #include "table/index_builder.h"
 #include "table/partitioned_filter_block.h"
 
@@ -96,11 +102,64 @@ FilterBlockBuilder* CreateFilterBlockBuilder(
   }
 }
 
+// Returns the data block index type the data blocks can actually use with
+// the given user comparator
+BlockBasedTableOptions::DataBlockIndexType GetDataBlockIndexType(
+    const BlockBasedTableOptions& table_opt, const Comparator* ucmp) {
+  switch (table_opt.data_block_index_type) {
+    case BlockBasedTableOptions::kDataBlockBinaryAndHash:
+      if (ucmp->CanKeysWithDifferentByteContentsBeEqual()) {
+        return BlockBasedTableOptions::kDataBlockBinarySearch;
+      }
+      break;
+    case BlockBasedTableOptions::kDataBlockBinaryAndKeyPrefixes:
+      // The key prefixes only sort like the keys in bytewise order
+      if (strcmp(ucmp->Name(), BytewiseComparator()->Name()) != 0) {
+        return BlockBasedTableOptions::kDataBlockBinarySearch;
+      }
+      break;
+    default:
+      break;
+  }
+  return table_opt.data_block_index_type;
+}
+
 bool GoodCompressionRatio(size_t compressed_size, size_t raw_size) {
   // Check to see if compressed less than 12.5%
   return compressed_size < raw_size - (raw_size / 8u);
 }
 
+// Returns the index of the fastest of the compression types whose compressed
+// size is within 1/16 of the smallest one, given their compressed sizes and
+// compression times of the same raw_size bytes, or sizes.size() if none of
+// them compresses the data by min_ratio
+size_t ChooseCompressionType(uint64_t raw_size,
+                             const std::vector<uint64_t>& sizes,
+                             const std::vector<uint64_t>& nanos,
+                             double min_ratio) {
+  assert(sizes.size() == nanos.size());
+  size_t smallest = sizes.size();
+  for (size_t i = 0; i < sizes.size(); i++) {
+    if (static_cast<double>(raw_size) >= min_ratio * sizes[i] &&
+        (smallest == sizes.size() || sizes[i] < sizes[smallest])) {
+      smallest = i;
+    }
+  }
+  if (smallest == sizes.size()) {
+    return smallest;
+  }
+  size_t chosen = smallest;
+  const uint64_t max_size = sizes[smallest] + sizes[smallest] / 16;
+  for (size_t i = 0; i < sizes.size(); i++) {
+    if (sizes[i] <= max_size &&
+        static_cast<double>(raw_size) >= min_ratio * sizes[i] &&
+        nanos[i] < nanos[chosen]) {
+      chosen = i;
+    }
+  }
+  return chosen;
+}
+
 }  // namespace
 
 // format_version is the block format as defined in include/rocksdb/table.h
@@ -195,6 +254,74 @@ const uint64_t kBlockBasedTableMagicNumber = 0x88e241b785f4cff7ull;
 // backwards compatibility)
 const uint64_t kLegacyBlockBasedTableMagicNumber = 0xdb4775248b80fb57ull;
 
+// The contexts to compress and verify blocks with each of the compression
+// types of the adaptive compression, used by a single thread
+struct BlockBasedTableBuilder::AdaptiveCompressionContexts {
+  std::vector<std::unique_ptr<CompressionContext>> compression_ctxs;
+  std::vector<std::unique_ptr<UncompressionContext>> verify_ctxs;
+};
+
+// State of the adaptive compression of the data blocks, see
+// AdvancedColumnFamilyOptions::adaptive_compression_types. The data blocks are
+// divided into regions of kRegionBlocks blocks. The first kSampleBlocks blocks
+// of a region are compressed with each of the compression types, and the
+// rest of the region is compressed with the type chosen from the samples.
+struct BlockBasedTableBuilder::AdaptiveCompressionRep {
+  static const uint64_t kRegionBlocks = 64;
+  static const uint64_t kSampleBlocks = 4;
+
+  AdaptiveCompressionRep(CompressionType compression_type,
+                         const std::vector<CompressionType>& adaptive_types,
+                         double _min_ratio)
+      : min_ratio(_min_ratio) {
+    types.push_back(compression_type);
+    for (auto type : adaptive_types) {
+      if (type != kNoCompression && type != kDisableCompressionOption &&
+          CompressionTypeSupported(type) &&
+          std::find(types.begin(), types.end(), type) == types.end()) {
+        types.push_back(type);
+      }
+    }
+    sampled_bytes.resize(types.size());
+    sampled_nanos.resize(types.size());
+  }
+
+  std::unique_ptr<AdaptiveCompressionContexts> NewContexts(
+      const CompressionOptions& compression_opts,
+      bool verify_compression) const {
+    std::unique_ptr<AdaptiveCompressionContexts> ctxs(
+        new AdaptiveCompressionContexts);
+    for (auto type : types) {
+      ctxs->compression_ctxs.emplace_back(
+          new CompressionContext(type, compression_opts));
+      ctxs->verify_ctxs.emplace_back(
+          verify_compression ? new UncompressionContext(
+                                   UncompressionContext::NoCache(), type)
+                             : nullptr);
+    }
+    return ctxs;
+  }
+
+  // The compression type of the file comes first
+  std::vector<CompressionType> types;
+  const double min_ratio;
+
+  std::mutex mu;
+  // The samples of the region collected so far, per type. Protected by mu.
+  uint64_t region = 0;
+  uint64_t num_samples = 0;
+  uint64_t sampled_raw_bytes = 0;
+  std::vector<uint64_t> sampled_bytes;
+  std::vector<uint64_t> sampled_nanos;
+  // Index in types of the type the blocks of the region that are not
+  // sampled are compressed with, types.size() if they are not compressed.
+  // Protected by mu.
+  size_t chosen = 0;
+
+  // Number of data blocks written with each compression type. Only used by
+  // the thread calling Add().
+  std::map<CompressionType, uint64_t> block_counts;
+};
 // A collector that collects properties of interest to block-based table.
 // For now this class looks heavy-weight since we only write one additional
 // property.
@@ -205,10 +332,11 @@ class BlockBasedTableBuilder::BlockBasedTablePropertiesCollector
  public:
   explicit BlockBasedTablePropertiesCollector(
       BlockBasedTableOptions::IndexType index_type, bool whole_key_filtering,
-      bool prefix_filtering)
+      bool prefix_filtering, const AdaptiveCompressionRep* adaptive_rep)
       : index_type_(index_type),
         whole_key_filtering_(whole_key_filtering),
-        prefix_filtering_(prefix_filtering) {}
+        prefix_filtering_(prefix_filtering),
+        adaptive_rep_(adaptive_rep) {}
 
   virtual Status InternalAdd(const Slice& /*key*/, const Slice& /*value*/,
                              uint64_t /*file_size*/) override {
@@ -225,6 +353,19 @@ class BlockBasedTableBuilder::BlockBasedTablePropertiesCollector
                         whole_key_filtering_ ? kPropTrue : kPropFalse});
     properties->insert({BlockBasedTablePropertyNames::kPrefixFiltering,
                         prefix_filtering_ ? kPropTrue : kPropFalse});
+    if (adaptive_rep_ != nullptr) {
+      std::string compression_types;
+      for (const auto& type_count : adaptive_rep_->block_counts) {
+        if (!compression_types.empty()) {
+          compression_types.append(",");
+        }
+        compression_types.append(CompressionTypeToString(type_count.first));
+        compression_types.append(":");
+        compression_types.append(ToString(type_count.second));
+      }
+      properties->insert(
+          {BlockBasedTablePropertyNames::kCompressionTypes, compression_types});
+    }
     return Status::OK();
   }
 
@@ -242,6 +383,76 @@ class BlockBasedTableBuilder::BlockBasedTablePropertiesCollector
   BlockBasedTableOptions::IndexType index_type_;
   bool whole_key_filtering_;
   bool prefix_filtering_;
+  const AdaptiveCompressionRep* adaptive_rep_;
+};
+
+
+// State of the data blocks handed over to the compression threads. The
+// blocks are written to the file, and their keys added to the index and
+// filter, by the thread calling Add(), in the order they were built.
+struct BlockBasedTableBuilder::ParallelCompressionRep {
+  struct BlockRep {
+    // Uncompressed contents of the block
+    std::string raw;
+    // Set by the compression thread. contents points to either raw or
+    // compressed.
+    std::string compressed;
+    Slice contents;
+    CompressionType type = kNoCompression;
+    Status status;
+    bool compressed_done = false;
+    // The keys of the block, each prefixed with its length
+    std::string keys;
+    std::string last_key;
+    // First key of the next data block, if has_next_key
+    std::string next_key;
+    bool has_next_key = false;
+    // Position of the block among the data blocks of the file
+    uint64_t index = 0;
+  };
+
+  ParallelCompressionRep(uint32_t parallel_threads,
+                         CompressionType compression_type,
+                         const CompressionOptions& compression_opts,
+                         bool verify_compression)
+      : max_pending_blocks(2 * parallel_threads) {
+    for (uint32_t i = 0; i < parallel_threads; i++) {
+      compression_ctxs.emplace_back(
+          new CompressionContext(compression_type, compression_opts));
+      if (verify_compression) {
+        verify_ctxs.emplace_back(new UncompressionContext(
+            UncompressionContext::NoCache(), compression_type));
+      } else {
+        verify_ctxs.emplace_back(nullptr);
+      }
+    }
+  }
+
+  const size_t max_pending_blocks;
+  std::vector<std::unique_ptr<CompressionContext>> compression_ctxs;
+  std::vector<std::unique_ptr<UncompressionContext>> verify_ctxs;
+  std::vector<port::Thread> threads;
+
+  std::mutex mu;
+  // Signaled when a block is queued for compression, or on shutdown
+  std::condition_variable work_cv;
+  // Signaled when a block is compressed
+  std::condition_variable done_cv;
+  // The blocks not written yet, in file order. Protected by mu.
+  std::deque<std::unique_ptr<BlockRep>> pending_blocks;
+  // The blocks waiting for a compression thread. Protected by mu.
+  std::deque<BlockRep*> compression_queue;
+  bool shutdown = false;
+
+  // With adaptive compression, the contexts of each compression thread
+  std::vector<std::unique_ptr<AdaptiveCompressionContexts>>
+      adaptive_ctxs;
+
+  // Only used by the thread calling Add()
+  std::string curr_block_keys;
+  uint64_t num_blocks = 0;
+  uint64_t pending_raw_bytes = 0;
+  uint64_t written_raw_bytes = 0;
 };
 
 struct BlockBasedTableBuilder::Rep {
@@ -284,6 +495,15 @@ struct BlockBasedTableBuilder::Rep {
 
   std::vector<std::unique_ptr<IntTblPropCollector>> table_properties_collectors;
 
+  // Set when the data blocks are compressed by background threads
+  std::unique_ptr<ParallelCompressionRep> pc_rep;
+
+  // Set when the compression type of the data blocks is chosen adaptively.
+  // adaptive_ctxs are the contexts of the thread calling Add(), when the
+  // data blocks are not compressed by background threads.
+  std::unique_ptr<AdaptiveCompressionRep> adaptive_rep;
+  std::unique_ptr<AdaptiveCompressionContexts> adaptive_ctxs;
+
   Rep(const ImmutableCFOptions& _ioptions, const MutableCFOptions& _moptions,
       const BlockBasedTableOptions& table_opt,
       const InternalKeyComparator& icomparator,
@@ -306,10 +526,8 @@ struct BlockBasedTableBuilder::Rep {
         data_block(table_options.block_restart_interval,
                    table_options.use_delta_encoding,
                    false /* use_value_delta_encoding */,
-                   icomparator.user_comparator()
-                           ->CanKeysWithDifferentByteContentsBeEqual()
-                       ? BlockBasedTableOptions::kDataBlockBinarySearch
-                       : table_options.data_block_index_type,
+                   GetDataBlockIndexType(table_options,
+                                         icomparator.user_comparator()),
                    table_options.data_block_hash_table_util_ratio),
         range_del_block(1 /* block_restart_interval */),
         internal_prefix_transform(_moptions.prefix_extractor.get()),
@@ -345,6 +563,13 @@ struct BlockBasedTableBuilder::Rep {
           use_delta_encoding_for_index_values, p_index_builder_));
     }
 
+    if (!_ioptions.adaptive_compression_types.empty() &&
+        _compression_type != kNoCompression) {
+      adaptive_rep.reset(new AdaptiveCompressionRep(
+          _compression_type, _ioptions.adaptive_compression_types,
+          _ioptions.adaptive_compression_min_ratio));
+    }
+
     for (auto& collector_factories : *int_tbl_prop_collector_factories) {
       table_properties_collectors.emplace_back(
           collector_factories->CreateIntTblPropCollector(column_family_id));
@@ -352,7 +577,7 @@ struct BlockBasedTableBuilder::Rep {
     table_properties_collectors.emplace_back(
         new BlockBasedTablePropertiesCollector(
             table_options.index_type, table_options.whole_key_filtering,
-            _moptions.prefix_extractor != nullptr));
+            _moptions.prefix_extractor != nullptr, adaptive_rep.get()));
     if (table_options.verify_compression) {
       verify_ctx.reset(new UncompressionContext(UncompressionContext::NoCache(),
                                                 compression_ctx.type()));
@@ -404,6 +629,27 @@ BlockBasedTableBuilder::BlockBasedTableBuilder(
         &rep_->compressed_cache_key_prefix[0],
         &rep_->compressed_cache_key_prefix_size);
   }
+
+  if (compression_opts.parallel_threads > 1 &&
+      rep_->compression_ctx.type() != kNoCompression) {
+    rep_->pc_rep.reset(new ParallelCompressionRep(
+        compression_opts.parallel_threads, rep_->compression_ctx.type(),
+        compression_opts, rep_->table_options.verify_compression));
+    if (rep_->adaptive_rep != nullptr) {
+      for (uint32_t i = 0; i < compression_opts.parallel_threads; i++) {
+        rep_->pc_rep->adaptive_ctxs.emplace_back(
+            rep_->adaptive_rep->NewContexts(
+                compression_opts, rep_->table_options.verify_compression));
+      }
+    }
+    for (uint32_t i = 0; i < compression_opts.parallel_threads; i++) {
+      rep_->pc_rep->threads.emplace_back(
+          &BlockBasedTableBuilder::BGWorkCompression, this, i);
+    }
+  } else if (rep_->adaptive_rep != nullptr) {
+    rep_->adaptive_ctxs = rep_->adaptive_rep->NewContexts(
+        compression_opts, rep_->table_options.verify_compression);
+  }
 }
 
 BlockBasedTableBuilder::~BlockBasedTableBuilder() {
@@ -424,24 +670,34 @@ void BlockBasedTableBuilder::Add(const Slice& key, const Slice& value) {
     auto should_flush = r->flush_block_policy->Update(key, value);
     if (should_flush) {
       assert(!r->data_block.empty());
-      Flush();
-
-      // Add item to index block.
-      // We do not emit the index entry for a block until we have seen the
-      // first key for the next data block.  This allows us to use shorter
-      // keys in the index block.  For example, consider a block boundary
-      // between the keys "the quick brown fox" and "the who".  We can use
-      // "the r" as the key for the index block entry since it is >= all
-      // entries in the first block and < all entries in subsequent
-      // blocks.
-      if (ok()) {
-        r->index_builder->AddIndexEntry(&r->last_key, &key, r->pending_handle);
+      if (r->pc_rep != nullptr) {
+        // The index entry is added when the block is written
+        ParallelFlush(&key);
+      } else {
+        Flush();
+
+        // Add item to index block.
+        // We do not emit the index entry for a block until we have seen the
+        // first key for the next data block.  This allows us to use shorter
+        // keys in the index block.  For example, consider a block boundary
+        // between the keys "the quick brown fox" and "the who".  We can use
+        // "the r" as the key for the index block entry since it is >= all
+        // entries in the first block and < all entries in subsequent
+        // blocks.
+        if (ok()) {
+          r->index_builder->AddIndexEntry(&r->last_key, &key,
+                                          r->pending_handle);
+        }
       }
     }
 
-    // Note: PartitionedFilterBlockBuilder requires key being added to filter
-    // builder after being added to index builder.
-    if (r->filter_builder != nullptr) {
+    if (r->pc_rep != nullptr) {
+      // The keys are added to the filter and index builders when the block
+      // is written, after the index entries of the blocks before it
+      PutLengthPrefixedSlice(&r->pc_rep->curr_block_keys, key);
+    } else if (r->filter_builder != nullptr) {
+      // Note: PartitionedFilterBlockBuilder requires key being added to filter
+      // builder after being added to index builder.
       r->filter_builder->Add(ExtractUserKey(key));
     }
 
@@ -456,7 +712,9 @@ void BlockBasedTableBuilder::Add(const Slice& key, const Slice& value) {
       r->props.num_merge_operands++;
     }
 
-    r->index_builder->OnKeyAdded(key);
+    if (r->pc_rep == nullptr) {
+      r->index_builder->OnKeyAdded(key);
+    }
     NotifyCollectTableCollectorsOnAdd(key, value, r->offset,
                                       r->table_properties_collectors,
                                       r->ioptions.info_log);
@@ -487,6 +745,129 @@ void BlockBasedTableBuilder::Flush() {
   ++r->props.num_data_blocks;
 }
 
+void BlockBasedTableBuilder::ParallelFlush(
+    const Slice* first_key_in_next_block) {
+  Rep* r = rep_;
+  assert(!r->closed);
+  if (!ok()) return;
+  if (r->data_block.empty()) return;
+  ParallelCompressionRep* pc = r->pc_rep.get();
+  std::unique_ptr<ParallelCompressionRep::BlockRep> block(
+      new ParallelCompressionRep::BlockRep);
+  Slice raw = r->data_block.Finish();
+  block->raw.assign(raw.data(), raw.size());
+  r->data_block.Reset();
+  block->keys.swap(pc->curr_block_keys);
+  block->last_key = r->last_key;
+  block->index = pc->num_blocks++;
+  if (first_key_in_next_block != nullptr) {
+    block->next_key = first_key_in_next_block->ToString();
+    block->has_next_key = true;
+  }
+  pc->pending_raw_bytes += block->raw.size();
+  {
+    std::lock_guard<std::mutex> lock(pc->mu);
+    pc->compression_queue.push_back(block.get());
+    pc->pending_blocks.push_back(std::move(block));
+  }
+  pc->work_cv.notify_one();
+  WriteCompressedBlocks(pc->max_pending_blocks);
+}
+
+void BlockBasedTableBuilder::WriteCompressedBlocks(size_t max_pending_blocks) {
+  Rep* r = rep_;
+  ParallelCompressionRep* pc = r->pc_rep.get();
+  std::unique_lock<std::mutex> lock(pc->mu);
+  while (!pc->pending_blocks.empty()) {
+    if (!pc->pending_blocks.front()->compressed_done) {
+      if (pc->pending_blocks.size() <= max_pending_blocks) {
+        break;
+      }
+      pc->done_cv.wait(lock);
+      continue;
+    }
+    std::unique_ptr<ParallelCompressionRep::BlockRep> block =
+        std::move(pc->pending_blocks.front());
+    pc->pending_blocks.pop_front();
+    lock.unlock();
+
+    pc->pending_raw_bytes -= block->raw.size();
+    if (ok() && !block->status.ok()) {
+      r->status = block->status;
+    }
+    if (ok()) {
+      Slice keys(block->keys);
+      Slice key;
+      while (GetLengthPrefixedSlice(&keys, &key)) {
+        if (r->filter_builder != nullptr) {
+          r->filter_builder->Add(ExtractUserKey(key));
+        }
+        r->index_builder->OnKeyAdded(key);
+      }
+      WriteRawBlock(block->contents, block->type, &r->pending_handle,
+                    true /* is_data_block */);
+    }
+    if (ok()) {
+      if (r->filter_builder != nullptr) {
+        r->filter_builder->StartBlock(r->offset);
+      }
+      r->props.data_size = r->offset;
+      ++r->props.num_data_blocks;
+      pc->written_raw_bytes += block->raw.size();
+      Slice next_key(block->next_key);
+      r->index_builder->AddIndexEntry(
+          &block->last_key, block->has_next_key ? &next_key : nullptr,
+          r->pending_handle);
+    }
+    lock.lock();
+  }
+}
+
+void BlockBasedTableBuilder::BGWorkCompression(size_t thread_index) {
+  ParallelCompressionRep* pc = rep_->pc_rep.get();
+  CompressionContext* compression_ctx =
+      pc->compression_ctxs[thread_index].get();
+  UncompressionContext* verify_ctx = pc->verify_ctxs[thread_index].get();
+  std::unique_lock<std::mutex> lock(pc->mu);
+  while (true) {
+    while (!pc->shutdown && pc->compression_queue.empty()) {
+      pc->work_cv.wait(lock);
+    }
+    if (pc->shutdown) {
+      return;
+    }
+    ParallelCompressionRep::BlockRep* block = pc->compression_queue.front();
+    pc->compression_queue.pop_front();
+    lock.unlock();
+    if (rep_->adaptive_rep != nullptr) {
+      CompressDataBlockAdaptively(block->raw, block->index,
+                                  pc->adaptive_ctxs[thread_index].get(),
+                                  &block->compressed, &block->contents,
+                                  &block->type, &block->status);
+    } else {
+      CompressAndVerifyBlock(block->raw, true /* is_data_block */,
+                             compression_ctx, verify_ctx, &block->compressed,
+                             &block->contents, &block->type, &block->status);
+    }
+    lock.lock();
+    block->compressed_done = true;
+    pc->done_cv.notify_all();
+  }
+}
+
+void BlockBasedTableBuilder::StopParallelCompression() {
+  ParallelCompressionRep* pc = rep_->pc_rep.get();
+  {
+    std::lock_guard<std::mutex> lock(pc->mu);
+    pc->shutdown = true;
+  }
+  pc->work_cv.notify_all();
+  for (auto& thread : pc->threads) {
+    thread.join();
+  }
+  pc->threads.clear();
+}
+
 void BlockBasedTableBuilder::WriteBlock(BlockBuilder* block,
                                         BlockHandle* handle,
                                         bool is_data_block) {
@@ -504,42 +885,69 @@ void BlockBasedTableBuilder::WriteBlock(const Slice& raw_block_contents,
   assert(ok());
   Rep* r = rep_;
 
-  auto type = r->compression_ctx.type();
   Slice block_contents;
+  CompressionType type;
+  Status compress_status;
+  if (is_data_block && r->adaptive_rep != nullptr) {
+    CompressDataBlockAdaptively(raw_block_contents, r->props.num_data_blocks,
+                                r->adaptive_ctxs.get(), &r->compressed_output,
+                                &block_contents, &type, &compress_status);
+  } else {
+    CompressAndVerifyBlock(raw_block_contents, is_data_block,
+                           &r->compression_ctx, r->verify_ctx.get(),
+                           &r->compressed_output, &block_contents, &type,
+                           &compress_status);
+  }
+  if (!compress_status.ok()) {
+    r->status = compress_status;
+    r->compressed_output.clear();
+    return;
+  }
+
+  WriteRawBlock(block_contents, type, handle, is_data_block);
+  r->compressed_output.clear();
+}
+
+void BlockBasedTableBuilder::CompressAndVerifyBlock(
+    const Slice& raw_block_contents, bool is_data_block,
+    CompressionContext* compression_ctx, UncompressionContext* verify_ctx,
+    std::string* compressed_output, Slice* block_contents,
+    CompressionType* type, Status* out_status) {
+  Rep* r = rep_;
+  *type = compression_ctx->type();
   bool abort_compression = false;
 
   StopWatchNano timer(r->ioptions.env,
     ShouldReportDetailedTime(r->ioptions.env, r->ioptions.statistics));
 
   if (raw_block_contents.size() < kCompressionSizeLimit) {
-    Slice compression_dict;
     if (is_data_block && r->compression_dict && r->compression_dict->size()) {
-      r->compression_ctx.dict() = *r->compression_dict;
+      compression_ctx->dict() = *r->compression_dict;
       if (r->table_options.verify_compression) {
-        assert(r->verify_ctx != nullptr);
-        r->verify_ctx->dict() = *r->compression_dict;
+        assert(verify_ctx != nullptr);
+        verify_ctx->dict() = *r->compression_dict;
       }
     } else {
       // Clear dictionary
-      r->compression_ctx.dict() = Slice();
+      compression_ctx->dict() = Slice();
       if (r->table_options.verify_compression) {
-        assert(r->verify_ctx != nullptr);
-        r->verify_ctx->dict() = Slice();
+        assert(verify_ctx != nullptr);
+        verify_ctx->dict() = Slice();
       }
     }
 
-    block_contents =
-        CompressBlock(raw_block_contents, r->compression_ctx, &type,
-                      r->table_options.format_version, &r->compressed_output);
+    *block_contents =
+        CompressBlock(raw_block_contents, *compression_ctx, type,
+                      r->table_options.format_version, compressed_output);
 
     // Some of the compression algorithms are known to be unreliable. If
     // the verify_compression flag is set then try to de-compress the
     // compressed data and compare to the input.
-    if (type != kNoCompression && r->table_options.verify_compression) {
+    if (*type != kNoCompression && r->table_options.verify_compression) {
       // Retrieve the uncompressed contents into a new buffer
       BlockContents contents;
       Status stat = UncompressBlockContentsForCompressionType(
-          *r->verify_ctx, block_contents.data(), block_contents.size(),
+          *verify_ctx, block_contents->data(), block_contents->size(),
           &contents, r->table_options.format_version, r->ioptions);
 
       if (stat.ok()) {
@@ -549,12 +957,12 @@ void BlockBasedTableBuilder::WriteBlock(const Slice& raw_block_contents,
           abort_compression = true;
           ROCKS_LOG_ERROR(r->ioptions.info_log,
                           "Decompressed block did not match raw block");
-          r->status =
+          *out_status =
               Status::Corruption("Decompressed block did not match raw block");
         }
       } else {
         // Decompression reported an error. abort.
-        r->status = Status::Corruption("Could not decompress");
+        *out_status = Status::Corruption("Could not decompress");
         abort_compression = true;
       }
     }
@@ -567,9 +975,9 @@ void BlockBasedTableBuilder::WriteBlock(const Slice& raw_block_contents,
   // verification.
   if (abort_compression) {
     RecordTick(r->ioptions.statistics, NUMBER_BLOCK_NOT_COMPRESSED);
-    type = kNoCompression;
-    block_contents = raw_block_contents;
-  } else if (type != kNoCompression) {
+    *type = kNoCompression;
+    *block_contents = raw_block_contents;
+  } else if (*type != kNoCompression) {
     if (ShouldReportDetailedTime(r->ioptions.env, r->ioptions.statistics)) {
       MeasureTime(r->ioptions.statistics, COMPRESSION_TIMES_NANOS,
                   timer.ElapsedNanos());
@@ -578,9 +986,80 @@ void BlockBasedTableBuilder::WriteBlock(const Slice& raw_block_contents,
                 raw_block_contents.size());
     RecordTick(r->ioptions.statistics, NUMBER_BLOCK_COMPRESSED);
   }
+}
 
-  WriteRawBlock(block_contents, type, handle, is_data_block);
-  r->compressed_output.clear();
+void BlockBasedTableBuilder::CompressDataBlockAdaptively(
+    const Slice& raw_block_contents, uint64_t block_index,
+    AdaptiveCompressionContexts* ctxs, std::string* compressed_output,
+    Slice* block_contents, CompressionType* type, Status* out_status) {
+  Rep* r = rep_;
+  AdaptiveCompressionRep* ac = r->adaptive_rep.get();
+  const uint64_t region = block_index / AdaptiveCompressionRep::kRegionBlocks;
+  const size_t num_types = ac->types.size();
+  size_t chosen;
+  if (block_index % AdaptiveCompressionRep::kRegionBlocks <
+      AdaptiveCompressionRep::kSampleBlocks) {
+    // Compress the block with each type, and use the best one for the block
+    std::vector<uint64_t> sizes(num_types);
+    std::vector<uint64_t> nanos(num_types);
+    for (size_t i = 0; i < num_types; i++) {
+      CompressionContext* compression_ctx = ctxs->compression_ctxs[i].get();
+      if (r->compression_dict && r->compression_dict->size()) {
+        compression_ctx->dict() = *r->compression_dict;
+      } else {
+        compression_ctx->dict() = Slice();
+      }
+      CompressionType sample_type;
+      const uint64_t start_nanos = r->ioptions.env->NowNanos();
+      Slice sample =
+          CompressBlock(raw_block_contents, *compression_ctx, &sample_type,
+                        r->table_options.format_version, compressed_output);
+      nanos[i] = r->ioptions.env->NowNanos() - start_nanos;
+      sizes[i] = sample.size();
+      compressed_output->clear();
+    }
+    RecordTick(r->ioptions.statistics, ADAPTIVE_COMPRESSION_SAMPLED_BLOCKS);
+    chosen = ChooseCompressionType(raw_block_contents.size(), sizes, nanos,
+                                   ac->min_ratio);
+
+    // Choose the type of the rest of the region once all its samples are in
+    std::lock_guard<std::mutex> lock(ac->mu);
+    if (region > ac->region || ac->num_samples == 0) {
+      ac->region = region;
+      ac->num_samples = 0;
+      ac->sampled_raw_bytes = 0;
+      std::fill(ac->sampled_bytes.begin(), ac->sampled_bytes.end(), 0);
+      std::fill(ac->sampled_nanos.begin(), ac->sampled_nanos.end(), 0);
+    }
+    if (region == ac->region) {
+      ac->sampled_raw_bytes += raw_block_contents.size();
+      for (size_t i = 0; i < num_types; i++) {
+        ac->sampled_bytes[i] += sizes[i];
+        ac->sampled_nanos[i] += nanos[i];
+      }
+      if (++ac->num_samples == AdaptiveCompressionRep::kSampleBlocks) {
+        ac->chosen =
+            ChooseCompressionType(ac->sampled_raw_bytes, ac->sampled_bytes,
+                                  ac->sampled_nanos, ac->min_ratio);
+      }
+    }
+  } else {
+    std::lock_guard<std::mutex> lock(ac->mu);
+    chosen = ac->chosen;
+    if (chosen == num_types) {
+      RecordTick(r->ioptions.statistics, ADAPTIVE_COMPRESSION_SKIPPED_BLOCKS);
+    }
+  }
+
+  if (chosen == num_types) {
+    *type = kNoCompression;
+    *block_contents = raw_block_contents;
+    return;
+  }
+  CompressAndVerifyBlock(raw_block_contents, true /* is_data_block */,
+                         ctxs->compression_ctxs[chosen].get(),
+                         ctxs->verify_ctxs[chosen].get(), compressed_output,
+                         block_contents, type, out_status);
 }
 
 void BlockBasedTableBuilder::WriteRawBlock(const Slice& block_contents,
@@ -589,6 +1068,13 @@ void BlockBasedTableBuilder::WriteRawBlock(const Slice& block_contents,
                                            bool is_data_block) {
   Rep* r = rep_;
   StopWatch sw(r->ioptions.env, r->ioptions.statistics, WRITE_RAW_BLOCK_MICROS);
+  if (is_data_block && r->adaptive_rep != nullptr) {
+    r->adaptive_rep->block_counts[type]++;
+    if (type != kNoCompression && type != r->compression_ctx.type()) {
+      RecordTick(r->ioptions.statistics,
+                 ADAPTIVE_COMPRESSION_ALTERNATE_BLOCKS);
+    }
+  }
   handle->set_offset(r->offset);
   handle->set_size(block_contents.size());
   assert(r->status.ok());
@@ -878,13 +1364,19 @@ void BlockBasedTableBuilder::WriteRangeDelBlock(
 Status BlockBasedTableBuilder::Finish() {
   Rep* r = rep_;
   bool empty_data_block = r->data_block.empty();
-  Flush();
+  if (r->pc_rep != nullptr) {
+    ParallelFlush(nullptr /* first_key_in_next_block */);
+    WriteCompressedBlocks(0 /* max_pending_blocks */);
+    StopParallelCompression();
+  } else {
+    Flush();
+  }
   assert(!r->closed);
   r->closed = true;
 
   // To make sure properties block is able to keep the accurate size of index
   // block, we will finish writing all index entries first.
-  if (ok() && !empty_data_block) {
+  if (ok() && !empty_data_block && r->pc_rep == nullptr) {
     r->index_builder->AddIndexEntry(
         &r->last_key, nullptr /* no next data block */, r->pending_handle);
   }
@@ -943,6 +1435,9 @@ Status BlockBasedTableBuilder::Finish() {
 void BlockBasedTableBuilder::Abandon() {
   Rep* r = rep_;
   assert(!r->closed);
+  if (r->pc_rep != nullptr) {
+    StopParallelCompression();
+  }
   r->closed = true;
 }
 
@@ -951,6 +1446,18 @@ uint64_t BlockBasedTableBuilder::NumEntries() const {
 }
 
 uint64_t BlockBasedTableBuilder::FileSize() const {
+  const ParallelCompressionRep* pc = rep_->pc_rep.get();
+  if (pc != nullptr && pc->pending_raw_bytes > 0) {
+    // Estimate the size of the blocks not written yet with the compression
+    // ratio of the blocks written so far
+    double ratio = pc->written_raw_bytes > 0
+                       ? static_cast<double>(rep_->props.data_size) /
+                             static_cast<double>(pc->written_raw_bytes)
+                       : 1.0;
+    return rep_->offset +
+           static_cast<uint64_t>(static_cast<double>(pc->pending_raw_bytes) *
+                                 ratio);
+  }
   return rep_->offset;
 }
 
@@ -101,6 +101,26 @@ class BlockBasedTableBuilder : public TableBuilder {
   // Compress and write block content to the file.
   void WriteBlock(const Slice& block_contents, BlockHandle* handle,
                   bool is_data_block);
+  // Compress block content with the given contexts, and verify the result if
+  // table_options.verify_compression is set. *block_contents points to
+  // either raw_block_contents or *compressed_output.
+  void CompressAndVerifyBlock(const Slice& raw_block_contents,
+                              bool is_data_block,
+                              CompressionContext* compression_ctx,
+                              UncompressionContext* verify_ctx,
+                              std::string* compressed_output,
+                              Slice* block_contents, CompressionType* type,
+                              Status* out_status);
+  // Compress a data block with the compression type the adaptive compression
+  // chose for its region, after sampling the compression types if the block
+  // is one of the first blocks of its region.
+  struct AdaptiveCompressionContexts;
+  void CompressDataBlockAdaptively(const Slice& raw_block_contents,
+                                   uint64_t block_index,
+                                   AdaptiveCompressionContexts* ctxs,
+                                   std::string* compressed_output,
+                                   Slice* block_contents,
+                                   CompressionType* type, Status* out_status);
   // Directly write data to the file.
   void WriteRawBlock(const Slice& data, CompressionType, BlockHandle* handle,
                      bool is_data_block = false);
@@ -116,6 +136,8 @@ class BlockBasedTableBuilder : public TableBuilder {
   void WriteRangeDelBlock(MetaIndexBuilder* meta_index_builder);
 
   struct Rep;
+  struct ParallelCompressionRep;
+  struct AdaptiveCompressionRep;
   class BlockBasedTablePropertiesCollectorFactory;
   class BlockBasedTablePropertiesCollector;
   Rep* rep_;
@@ -126,6 +148,18 @@ class BlockBasedTableBuilder : public TableBuilder {
   // REQUIRES: Finish(), Abandon() have not been called
   void Flush();
 
+  // With parallel compression, hand the data block over to the compression
+  // threads instead of writing it. first_key_in_next_block is nullptr for
+  // the last data block.
+  void ParallelFlush(const Slice* first_key_in_next_block);
+  // Write the data blocks that are compressed, in order, and add them to
+  // the index and filter. Waits for the compression of the oldest blocks
+  // while more than max_pending_blocks are left.
+  void WriteCompressedBlocks(size_t max_pending_blocks);
+  // Body of the compression threads
+  void BGWorkCompression(size_t thread_index);
+  void StopParallelCompression();
+
   // Some compression libraries fail when the raw size is bigger than int. If
   // uncompressed size is bigger than kCompressionSizeLimit, don't compress it
   const uint64_t kCompressionSizeLimit = std::numeric_limits<int>::max();
@@ -480,6 +480,23 @@ std::string ParseBlockBasedTableOption(const std::string& name,
     } else if (name == "filter_policy") {
       // Expect the following format
       // bloomfilter:int:bool
+      // blockedbloomfilter:int
+      // ribbonfilter:double
+      const std::string kBlockedName = "blockedbloomfilter:";
+      if (value.compare(0, kBlockedName.size(), kBlockedName) == 0) {
+        int bits_per_key = ParseInt(trim(value.substr(kBlockedName.size())));
+        new_options->filter_policy.reset(
+            NewBlockedBloomFilterPolicy(bits_per_key));
+        return "";
+      }
+      const std::string kRibbonName = "ribbonfilter:";
+      if (value.compare(0, kRibbonName.size(), kRibbonName) == 0) {
+        double bloom_equivalent_bits_per_key =
+            ParseDouble(trim(value.substr(kRibbonName.size())));
+        new_options->filter_policy.reset(
+            NewRibbonFilterPolicy(bloom_equivalent_bits_per_key));
+        return "";
+      }
       const std::string kName = "bloomfilter:";
       if (value.compare(0, kName.size(), kName) != 0) {
         return "Invalid filter policy name";
@@ -611,9 +628,13 @@ const std::string BlockBasedTablePropertyNames::kWholeKeyFiltering =
     "rocksdb.block.based.table.whole.key.filtering";
 const std::string BlockBasedTablePropertyNames::kPrefixFiltering =
     "rocksdb.block.based.table.prefix.filtering";
+const std::string BlockBasedTablePropertyNames::kCompressionTypes =
+    "rocksdb.block.based.table.compression.types";
 const std::string kHashIndexPrefixesBlock = "rocksdb.hashindex.prefixes";
 const std::string kHashIndexPrefixesMetadataBlock =
     "rocksdb.hashindex.metadata";
+const std::string kIndexKeyPrefixesBlock =
+    "rocksdb.interpolationindex.keyprefixes";
 const std::string kPropTrue = "1";
 const std::string kPropFalse = "0";
 
@@ -85,6 +85,7 @@ class BlockBasedTableFactory : public TableFactory {
 
 extern const std::string kHashIndexPrefixesBlock;
 extern const std::string kHashIndexPrefixesMetadataBlock;
+extern const std::string kIndexKeyPrefixesBlock;
 extern const std::string kPropTrue;
 extern const std::string kPropFalse;
 
@@ -41,6 +41,7 @@
 #include "table/meta_blocks.h"
 #include "table/partitioned_filter_block.h"
 #include "table/persistent_cache_helper.h"
+#include "table/restart_key_prefixes.h"
 #include "table/sst_file_writer_collectors.h"
 #include "table/two_level_iterator.h"
 
@@ -50,12 +51,14 @@
 #include "util/stop_watch.h"
 #include "util/string_util.h"
 #include "util/sync_point.h"
+#include "util/xxhash.h"
 
 namespace rocksdb {
 
 extern const uint64_t kBlockBasedTableMagicNumber;
 extern const std::string kHashIndexPrefixesBlock;
 extern const std::string kHashIndexPrefixesMetadataBlock;
+extern const std::string kIndexKeyPrefixesBlock;
 using std::unique_ptr;
 
 typedef BlockBasedTable::IndexReader IndexReader;
@@ -72,20 +75,21 @@ namespace {
 // The only relevant option is options.verify_checksums for now.
 // On failure return non-OK.
 // On success fill *result and return OK - caller owns *result
-// @param compression_dict Data for presetting the compression library's
+// @param uncompression_dict Data for presetting the compression library's
 //    dictionary.
 Status ReadBlockFromFile(
     RandomAccessFileReader* file, FilePrefetchBuffer* prefetch_buffer,
     const Footer& footer, const ReadOptions& options, const BlockHandle& handle,
     std::unique_ptr<Block>* result, const ImmutableCFOptions& ioptions,
-    bool do_uncompress, bool maybe_compressed, const Slice& compression_dict,
+    bool do_uncompress, bool maybe_compressed,
+    const UncompressionDict& uncompression_dict,
     const PersistentCacheOptions& cache_options, SequenceNumber global_seqno,
     size_t read_amp_bytes_per_bit, MemoryAllocator* memory_allocator) {
   BlockContents contents;
   BlockFetcher block_fetcher(file, prefetch_buffer, footer, options, handle,
                              &contents, ioptions, do_uncompress,
-                             maybe_compressed, compression_dict, cache_options,
-                             memory_allocator);
+                             maybe_compressed, uncompression_dict,
+                             cache_options, memory_allocator);
   Status s = block_fetcher.ReadBlockContents();
   if (s.ok()) {
     result->reset(new Block(std::move(contents), global_seqno,
@@ -122,9 +126,26 @@ void DeleteCachedEntry(const Slice& /*key*/, void* value) {
   delete entry;
 }
 
+// Prefix of the block cache keys of the uncompression dictionaries. The block
+// keys are prefixed by a unique id of the table, and can't collide with it.
+const std::string kUncompressionDictCacheKeyPrefix = "rocksdb.cdict.";
+
 void DeleteCachedFilterEntry(const Slice& key, void* value);
 void DeleteCachedIndexEntry(const Slice& key, void* value);
 
+// Saves the blocks that a block cache with a compressed tier demotes
+size_t GetBlockSizeForCache(void* value) {
+  return reinterpret_cast<Block*>(value)->size();
+}
+
+void SaveBlockForCache(void* value, char* buf) {
+  const Block* block = reinterpret_cast<Block*>(value);
+  memcpy(buf, block->data(), block->size());
+}
+
+const Cache::CacheItemHelper kBlockCacheItemHelper = {
+    &GetBlockSizeForCache, &SaveBlockForCache, &DeleteCachedEntry<Block>};
+
 // Release the cached entry and decrement its ref count.
 void ReleaseCachedEntry(void* arg, void* h) {
   Cache* cache = reinterpret_cast<Cache*>(arg);
@@ -156,8 +177,18 @@ Cache::Handle* GetEntryFromCache(Cache* block_cache, const Slice& key,
                                  uint64_t* block_cache_miss_stats,
                                  uint64_t* block_cache_hit_stats,
                                  Statistics* statistics,
-                                 GetContext* get_context) {
-  auto cache_handle = block_cache->Lookup(key, statistics);
+                                 GetContext* get_context,
+                                 const Cache::CreateCallback* create_cb =
+                                     nullptr,
+                                 Cache::Priority priority =
+                                     Cache::Priority::LOW) {
+  // Blocks are looked up with their helper, so that they can be promoted
+  // from the compressed tier of the cache, if any
+  auto cache_handle =
+      create_cb != nullptr
+          ? block_cache->LookupWithHelper(key, &kBlockCacheItemHelper,
+                                          *create_cb, priority, statistics)
+          : block_cache->Lookup(key, statistics);
   if (cache_handle != nullptr) {
     PERF_COUNTER_ADD(block_cache_hit_count, 1);
     if (get_context != nullptr) {
@@ -236,9 +267,9 @@ class PartitionIndexReader : public IndexReader, public Cleanable {
     auto s = ReadBlockFromFile(
         file, prefetch_buffer, footer, ReadOptions(), index_handle,
         &index_block, ioptions, true /* decompress */,
-        true /*maybe_compressed*/, Slice() /*compression dict*/, cache_options,
-        kDisableGlobalSequenceNumber, 0 /* read_amp_bytes_per_bit */,
-        memory_allocator);
+        true /*maybe_compressed*/, UncompressionDict::GetEmptyDict(),
+        cache_options, kDisableGlobalSequenceNumber,
+        0 /* read_amp_bytes_per_bit */, memory_allocator);
 
     if (s.ok()) {
       *index_reader = new PartitionIndexReader(
@@ -328,16 +359,12 @@ class PartitionIndexReader : public IndexReader, public Cleanable {
     for (; biter.Valid(); biter.Next()) {
       handle = biter.value();
       BlockBasedTable::CachableEntry<Block> block;
-      Slice compression_dict;
-      if (rep->compression_dict_block) {
-        compression_dict = rep->compression_dict_block->data;
-      }
       const bool is_index = true;
       // TODO: Support counter batch update for partitioned index and
       // filter blocks
       s = table_->MaybeReadBlockAndLoadToCache(
-          prefetch_buffer.get(), rep, ro, handle, compression_dict, &block,
-          is_index, nullptr /* get_context */);
+          prefetch_buffer.get(), rep, ro, handle, rep->GetUncompressionDict(),
+          &block, is_index, nullptr /* get_context */);
 
       assert(s.ok() || block.value == nullptr);
       if (s.ok() && block.value != nullptr) {
@@ -417,9 +444,9 @@ class BinarySearchIndexReader : public IndexReader {
     auto s = ReadBlockFromFile(
         file, prefetch_buffer, footer, ReadOptions(), index_handle,
         &index_block, ioptions, true /* decompress */,
-        true /*maybe_compressed*/, Slice() /*compression dict*/, cache_options,
-        kDisableGlobalSequenceNumber, 0 /* read_amp_bytes_per_bit */,
-        memory_allocator);
+        true /*maybe_compressed*/, UncompressionDict::GetEmptyDict(),
+        cache_options, kDisableGlobalSequenceNumber,
+        0 /* read_amp_bytes_per_bit */, memory_allocator);
 
     if (s.ok()) {
       *index_reader = new BinarySearchIndexReader(
@@ -491,9 +518,9 @@ class HashIndexReader : public IndexReader {
     auto s = ReadBlockFromFile(
         file, prefetch_buffer, footer, ReadOptions(), index_handle,
         &index_block, ioptions, true /* decompress */,
-        true /*maybe_compressed*/, Slice() /*compression dict*/, cache_options,
-        kDisableGlobalSequenceNumber, 0 /* read_amp_bytes_per_bit */,
-        memory_allocator);
+        true /*maybe_compressed*/, UncompressionDict::GetEmptyDict(),
+        cache_options, kDisableGlobalSequenceNumber,
+        0 /* read_amp_bytes_per_bit */, memory_allocator);
 
     if (!s.ok()) {
       return s;
@@ -526,13 +553,12 @@ class HashIndexReader : public IndexReader {
       return Status::OK();
     }
 
-    Slice dummy_comp_dict;
     // Read contents for the blocks
     BlockContents prefixes_contents;
     BlockFetcher prefixes_block_fetcher(
         file, prefetch_buffer, footer, ReadOptions(), prefixes_handle,
         &prefixes_contents, ioptions, true /*decompress*/,
-        true /*maybe_compressed*/, dummy_comp_dict /*compression dict*/,
+        true /*maybe_compressed*/, UncompressionDict::GetEmptyDict(),
         cache_options, memory_allocator);
     s = prefixes_block_fetcher.ReadBlockContents();
     if (!s.ok()) {
@@ -542,7 +568,7 @@ class HashIndexReader : public IndexReader {
     BlockFetcher prefixes_meta_block_fetcher(
         file, prefetch_buffer, footer, ReadOptions(), prefixes_meta_handle,
         &prefixes_meta_contents, ioptions, true /*decompress*/,
-        true /*maybe_compressed*/, dummy_comp_dict /*compression dict*/,
+        true /*maybe_compressed*/, UncompressionDict::GetEmptyDict(),
         cache_options, memory_allocator);
     s = prefixes_meta_block_fetcher.ReadBlockContents();
     if (!s.ok()) {
@@ -614,6 +640,131 @@ class HashIndexReader : public IndexReader {
   const bool index_value_is_full_;
 };
 
+// Binary search index whose seeks are narrowed down by looking the key up in
+// an array of integers first, see RestartKeyPrefixes.
+class InterpolationSearchIndexReader : public IndexReader {
+ public:
+  static Status Create(
+      const Footer& footer, RandomAccessFileReader* file,
+      FilePrefetchBuffer* prefetch_buffer, const ImmutableCFOptions& ioptions,
+      const InternalKeyComparator* icomparator, const BlockHandle& index_handle,
+      InternalIterator* meta_index_iter, IndexReader** index_reader,
+      const PersistentCacheOptions& cache_options,
+      const bool index_key_includes_seq, const bool index_value_is_full,
+      MemoryAllocator* memory_allocator) {
+    std::unique_ptr<Block> index_block;
+    auto s = ReadBlockFromFile(
+        file, prefetch_buffer, footer, ReadOptions(), index_handle,
+        &index_block, ioptions, true /* decompress */,
+        true /*maybe_compressed*/, UncompressionDict::GetEmptyDict(),
+        cache_options, kDisableGlobalSequenceNumber,
+        0 /* read_amp_bytes_per_bit */, memory_allocator);
+
+    if (!s.ok()) {
+      return s;
+    }
+
+    // Like for the hash index, the index can do without the key prefixes, so
+    // failing to load them is not an error.
+    auto new_index_reader = new InterpolationSearchIndexReader(
+        icomparator, std::move(index_block), ioptions.statistics,
+        index_key_includes_seq, index_value_is_full);
+    *index_reader = new_index_reader;
+
+    // The metablock is missing if the comparator is not bytewise
+    BlockHandle key_prefixes_handle;
+    s = FindMetaBlock(meta_index_iter, kIndexKeyPrefixesBlock,
+                      &key_prefixes_handle);
+    if (!s.ok()) {
+      return Status::OK();
+    }
+
+    BlockContents key_prefixes_contents;
+    BlockFetcher key_prefixes_block_fetcher(
+        file, prefetch_buffer, footer, ReadOptions(), key_prefixes_handle,
+        &key_prefixes_contents, ioptions, true /*decompress*/,
+        true /*maybe_compressed*/, UncompressionDict::GetEmptyDict(),
+        cache_options, memory_allocator);
+    s = key_prefixes_block_fetcher.ReadBlockContents();
+    if (!s.ok()) {
+      ROCKS_LOG_WARN(ioptions.info_log,
+                     "Unable to read the index key prefixes: %s",
+                     s.ToString().c_str());
+      return Status::OK();
+    }
+
+    size_t key_prefixes_size = 0;
+    s = new_index_reader->key_prefixes_.Initialize(key_prefixes_contents.data,
+                                                   &key_prefixes_size);
+    if (s.ok() && (key_prefixes_size != key_prefixes_contents.data.size() ||
+                   new_index_reader->key_prefixes_.num_restarts() !=
+                       new_index_reader->index_block_->NumRestarts())) {
+      s = Status::Corruption("index key prefixes do not match the index");
+    }
+    if (s.ok()) {
+      // The key prefixes point into the contents
+      new_index_reader->key_prefixes_contents_ =
+          std::move(key_prefixes_contents);
+    } else {
+      new_index_reader->key_prefixes_ = RestartKeyPrefixes();
+      ROCKS_LOG_WARN(ioptions.info_log,
+                     "Unable to load the index key prefixes: %s",
+                     s.ToString().c_str());
+    }
+
+    return Status::OK();
+  }
+
+  virtual InternalIteratorBase<BlockHandle>* NewIterator(
+      IndexBlockIter* iter = nullptr, bool /*dont_care*/ = true,
+      bool /*dont_care*/ = true) override {
+    Statistics* kNullStats = nullptr;
+    // We don't return pinned datat from index blocks, so no need
+    // to set `block_contents_pinned`.
+    return index_block_->NewIterator<IndexBlockIter>(
+        icomparator_, icomparator_->user_comparator(), iter, kNullStats, true,
+        index_key_includes_seq_, index_value_is_full_,
+        false /* block_contents_pinned */, nullptr /* prefix_index */,
+        key_prefixes_.Valid() ? &key_prefixes_ : nullptr);
+  }
+
+  virtual size_t size() const override { return index_block_->size(); }
+  virtual size_t usable_size() const override {
+    return index_block_->usable_size();
+  }
+
+  virtual size_t ApproximateMemoryUsage() const override {
+    assert(index_block_);
+    size_t usage = index_block_->ApproximateMemoryUsage();
+    usage += key_prefixes_contents_.usable_size();
+#ifdef ROCKSDB_MALLOC_USABLE_SIZE
+    usage += malloc_usable_size((void*)this);
+#else
+    usage += sizeof(*this);
+#endif  // ROCKSDB_MALLOC_USABLE_SIZE
+    return usage;
+  }
+
+ private:
+  InterpolationSearchIndexReader(const InternalKeyComparator* icomparator,
+                                 std::unique_ptr<Block>&& index_block,
+                                 Statistics* stats,
+                                 const bool index_key_includes_seq,
+                                 const bool index_value_is_full)
+      : IndexReader(icomparator, stats),
+        index_block_(std::move(index_block)),
+        index_key_includes_seq_(index_key_includes_seq),
+        index_value_is_full_(index_value_is_full) {
+    assert(index_block_ != nullptr);
+  }
+
+  std::unique_ptr<Block> index_block_;
+  BlockContents key_prefixes_contents_;
+  RestartKeyPrefixes key_prefixes_;
+  const bool index_key_includes_seq_;
+  const bool index_value_is_full_;
+};
+
 // Helper function to setup the cache key's prefix for the Table.
 void BlockBasedTable::SetupCacheKeyPrefix(Rep* rep, uint64_t file_size) {
   assert(kMaxCacheKeyPrefixSize >= 10);
@@ -958,7 +1109,7 @@ Status BlockBasedTable::Open(const ImmutableCFOptions& ioptions,
         rep->file.get(), prefetch_buffer.get(), rep->footer, read_options,
         compression_dict_handle, compression_dict_cont.get(), rep->ioptions,
         false /* decompress */, false /*maybe_compressed*/,
-        Slice() /*compression dict*/, cache_options);
+        UncompressionDict::GetEmptyDict(), cache_options);
     s = compression_block_fetcher.ReadBlockContents();
 
     if (!s.ok()) {
@@ -968,7 +1119,7 @@ Status BlockBasedTable::Open(const ImmutableCFOptions& ioptions,
           "block %s",
           s.ToString().c_str());
     } else {
-      rep->compression_dict_block = std::move(compression_dict_cont);
+      s = SetUncompressionDict(rep, compression_dict_cont->data);
     }
   }
 
@@ -1003,7 +1154,7 @@ Status BlockBasedTable::Open(const ImmutableCFOptions& ioptions,
     ReadOptions read_options;
     s = MaybeReadBlockAndLoadToCache(
         prefetch_buffer.get(), rep, read_options, rep->range_del_handle,
-        Slice() /* compression_dict */, &rep->range_del_entry,
+        UncompressionDict::GetEmptyDict(), &rep->range_del_entry,
         false /* is_index */, nullptr /* get_context */);
     if (!s.ok()) {
       ROCKS_LOG_WARN(
@@ -1175,6 +1326,53 @@ size_t BlockBasedTable::ApproximateMemoryUsage() const {
 
 // Load the meta-block from the file. On success, return the loaded meta block
 // and its iterator.
+Status BlockBasedTable::SetUncompressionDict(Rep* rep, const Slice& dict) {
+  const bool using_zstd =
+      rep->table_properties != nullptr &&
+      (rep->table_properties->compression_name ==
+           CompressionTypeToString(kZSTD) ||
+       rep->table_properties->compression_name ==
+           CompressionTypeToString(kZSTDNotFinalCompression));
+  Cache* block_cache = rep->table_options.block_cache.get();
+  if (block_cache != nullptr) {
+    // The tables compressed with the same dictionary share a single digested
+    // copy of it through the block cache, keyed by its contents.
+    std::string key = kUncompressionDictCacheKeyPrefix;
+    PutFixed64(&key, XXH64(dict.data(), dict.size(), 0));
+    PutFixed32(&key, static_cast<uint32_t>(dict.size()));
+    key.push_back(using_zstd ? 1 : 0);
+    Cache::Handle* handle = block_cache->Lookup(key);
+    if (handle != nullptr) {
+      auto cached_dict =
+          reinterpret_cast<UncompressionDict*>(block_cache->Value(handle));
+      if (cached_dict->GetRawDict() == dict) {
+        rep->uncompression_dict = cached_dict;
+        rep->uncompression_dict_handle = handle;
+        return Status::OK();
+      }
+      // Hash collision, keep a private copy
+      block_cache->Release(handle);
+    } else {
+      std::unique_ptr<UncompressionDict> new_dict(
+          new UncompressionDict(dict.ToString(), using_zstd));
+      size_t charge = new_dict->ApproximateMemoryUsage();
+      Status s = block_cache->Insert(key, new_dict.get(), charge,
+                                     &DeleteCachedEntry<UncompressionDict>,
+                                     &handle, Cache::Priority::HIGH);
+      if (s.ok()) {
+        rep->uncompression_dict = new_dict.release();
+        rep->uncompression_dict_handle = handle;
+        return Status::OK();
+      }
+      // The cache is full, keep a private copy
+    }
+  }
+  rep->owned_uncompression_dict.reset(
+      new UncompressionDict(dict.ToString(), using_zstd));
+  rep->uncompression_dict = rep->owned_uncompression_dict.get();
+  return Status::OK();
+}
+
 Status BlockBasedTable::ReadMetaBlock(Rep* rep,
                                       FilePrefetchBuffer* prefetch_buffer,
                                       std::unique_ptr<Block>* meta_block,
@@ -1186,7 +1384,7 @@ Status BlockBasedTable::ReadMetaBlock(Rep* rep,
       rep->file.get(), prefetch_buffer, rep->footer, ReadOptions(),
       rep->footer.metaindex_handle(), &meta, rep->ioptions,
       true /* decompress */, true /*maybe_compressed*/,
-      Slice() /*compression dict*/, rep->persistent_cache_options,
+      UncompressionDict::GetEmptyDict(), rep->persistent_cache_options,
       kDisableGlobalSequenceNumber, 0 /* read_amp_bytes_per_bit */,
       GetMemoryAllocator(rep->table_options));
 
@@ -1209,7 +1407,8 @@ Status BlockBasedTable::GetDataBlockFromCache(
     const Slice& block_cache_key, const Slice& compressed_block_cache_key,
     Cache* block_cache, Cache* block_cache_compressed, Rep* rep,
     const ReadOptions& read_options,
-    BlockBasedTable::CachableEntry<Block>* block, const Slice& compression_dict,
+    BlockBasedTable::CachableEntry<Block>* block,
+    const UncompressionDict& uncompression_dict,
     size_t read_amp_bytes_per_bit, bool is_index, GetContext* get_context) {
   Status s;
   BlockContents* compressed_block = nullptr;
@@ -1218,6 +1417,35 @@ Status BlockBasedTable::GetDataBlockFromCache(
 
   // Lookup uncompressed cache first
   if (block_cache != nullptr) {
+    // Creates the block back if the cache has it in its compressed tier.
+    // The callback only captures a pointer, so that it is not allocated.
+    struct {
+      Rep* rep;
+      SequenceNumber global_seqno;
+      size_t read_amp_bytes_per_bit;
+      Statistics* statistics;
+    } create_args = {rep, rep->get_global_seqno(is_index),
+                     read_amp_bytes_per_bit, statistics};
+    Cache::CreateCallback create_cb = [&create_args](const Slice& buf,
+                                                     void** value,
+                                                     size_t* charge) {
+      BlockContents contents(
+          AllocateBlock(buf.size(),
+                        GetMemoryAllocator(create_args.rep->table_options)),
+          buf.size());
+      memcpy(const_cast<char*>(contents.data.data()), buf.data(), buf.size());
+      Block* new_block = new Block(
+          std::move(contents), create_args.global_seqno,
+          create_args.read_amp_bytes_per_bit, create_args.statistics);
+      *value = new_block;
+      *charge = new_block->ApproximateMemoryUsage();
+      return Status::OK();
+    };
+    const Cache::Priority priority =
+        is_index && rep->table_options
+                        .cache_index_and_filter_blocks_with_high_priority
+            ? Cache::Priority::HIGH
+            : Cache::Priority::LOW;
     block->cache_handle = GetEntryFromCache(
         block_cache, block_cache_key,
         is_index ? BLOCK_CACHE_INDEX_MISS : BLOCK_CACHE_DATA_MISS,
@@ -1230,7 +1458,7 @@ Status BlockBasedTable::GetDataBlockFromCache(
             ? (is_index ? &get_context->get_context_stats_.num_cache_index_hit
                         : &get_context->get_context_stats_.num_cache_data_hit)
             : nullptr,
-        statistics, get_context);
+        statistics, get_context, &create_cb, priority);
     if (block->cache_handle != nullptr) {
       block->value =
           reinterpret_cast<Block*>(block_cache->Value(block->cache_handle));
@@ -1264,7 +1492,8 @@ Status BlockBasedTable::GetDataBlockFromCache(
 
   // Retrieve the uncompressed contents into a new buffer
   BlockContents contents;
-  UncompressionContext uncompresssion_ctx(compression_type, compression_dict);
+  UncompressionContext uncompresssion_ctx(compression_type,
+                                          uncompression_dict);
   s = UncompressBlockContents(uncompresssion_ctx, compressed_block->data.data(),
                               compressed_block->data.size(), &contents,
                               rep->table_options.format_version, rep->ioptions,
@@ -1279,9 +1508,9 @@ Status BlockBasedTable::GetDataBlockFromCache(
     if (block_cache != nullptr && block->value->own_bytes() &&
         read_options.fill_cache) {
       size_t charge = block->value->ApproximateMemoryUsage();
-      s = block_cache->Insert(block_cache_key, block->value, charge,
-                              &DeleteCachedEntry<Block>,
-                              &(block->cache_handle));
+      s = block_cache->InsertWithHelper(block_cache_key, block->value,
+                                        &kBlockCacheItemHelper, charge,
+                                        &(block->cache_handle));
 #ifndef NDEBUG
       block_cache->TEST_mark_as_data_block(block_cache_key, charge);
 #endif  // NDEBUG
@@ -1331,7 +1560,7 @@ Status BlockBasedTable::PutDataBlockToCache(
     const ReadOptions& /*read_options*/, const ImmutableCFOptions& ioptions,
     CachableEntry<Block>* cached_block, BlockContents* raw_block_contents,
     CompressionType raw_block_comp_type, uint32_t format_version,
-    const Slice& compression_dict, SequenceNumber seq_no,
+    const UncompressionDict& uncompression_dict, SequenceNumber seq_no,
     size_t read_amp_bytes_per_bit, MemoryAllocator* memory_allocator,
     bool is_index, Cache::Priority priority, GetContext* get_context) {
   assert(raw_block_comp_type == kNoCompression ||
@@ -1343,7 +1572,7 @@ Status BlockBasedTable::PutDataBlockToCache(
   Statistics* statistics = ioptions.statistics;
   if (raw_block_comp_type != kNoCompression) {
     UncompressionContext uncompression_ctx(raw_block_comp_type,
-                                           compression_dict);
+                                           uncompression_dict);
     s = UncompressBlockContents(
         uncompression_ctx, raw_block_contents->data.data(),
         raw_block_contents->data.size(), &uncompressed_block_contents,
@@ -1392,9 +1621,9 @@ Status BlockBasedTable::PutDataBlockToCache(
   // insert into uncompressed block cache
   if (block_cache != nullptr && cached_block->value->own_bytes()) {
     size_t charge = cached_block->value->ApproximateMemoryUsage();
-    s = block_cache->Insert(block_cache_key, cached_block->value, charge,
-                            &DeleteCachedEntry<Block>,
-                            &(cached_block->cache_handle), priority);
+    s = block_cache->InsertWithHelper(block_cache_key, cached_block->value,
+                                      &kBlockCacheItemHelper, charge,
+                                      &(cached_block->cache_handle), priority);
 #ifndef NDEBUG
     block_cache->TEST_mark_as_data_block(block_cache_key, charge);
 #endif  // NDEBUG
@@ -1449,12 +1678,11 @@ FilterBlockReader* BlockBasedTable::ReadFilter(
   }
   BlockContents block;
 
-  Slice dummy_comp_dict;
 
   BlockFetcher block_fetcher(
       rep->file.get(), prefetch_buffer, rep->footer, ReadOptions(),
       filter_handle, &block, rep->ioptions, false /* decompress */,
-      false /*maybe_compressed*/, dummy_comp_dict,
+      false /*maybe_compressed*/, UncompressionDict::GetEmptyDict(),
       rep->persistent_cache_options, GetMemoryAllocator(rep->table_options));
   Status s = block_fetcher.ReadBlockContents();
 
@@ -1727,14 +1955,10 @@ TBlockIter* BlockBasedTable::NewDataBlockIterator(
   const bool no_io = (ro.read_tier == kBlockCacheTier);
   Cache* block_cache = rep->table_options.block_cache.get();
   CachableEntry<Block> block;
-  Slice compression_dict;
   if (s.ok()) {
-    if (rep->compression_dict_block) {
-      compression_dict = rep->compression_dict_block->data;
-    }
     s = MaybeReadBlockAndLoadToCache(prefetch_buffer, rep, ro, handle,
-                                     compression_dict, &block, is_index,
-                                     get_context);
+                                     rep->GetUncompressionDict(), &block,
+                                     is_index, get_context);
   }
 
   TBlockIter* iter;
@@ -1758,7 +1982,7 @@ TBlockIter* BlockBasedTable::NewDataBlockIterator(
           rep->file.get(), prefetch_buffer, rep->footer, ro, handle,
           &block_value, rep->ioptions,
           rep->blocks_maybe_compressed /*do_decompress*/,
-          rep->blocks_maybe_compressed, compression_dict,
+          rep->blocks_maybe_compressed, rep->GetUncompressionDict(),
           rep->persistent_cache_options,
           is_index ? kDisableGlobalSequenceNumber : rep->global_seqno,
           rep->table_options.read_amp_bytes_per_bit,
@@ -1832,7 +2056,7 @@ TBlockIter* BlockBasedTable::NewDataBlockIterator(
 
 Status BlockBasedTable::MaybeReadBlockAndLoadToCache(
     FilePrefetchBuffer* prefetch_buffer, Rep* rep, const ReadOptions& ro,
-    const BlockHandle& handle, Slice compression_dict,
+    const BlockHandle& handle, const UncompressionDict& uncompression_dict,
     CachableEntry<Block>* block_entry, bool is_index, GetContext* get_context) {
   assert(block_entry != nullptr);
   const bool no_io = (ro.read_tier == kBlockCacheTier);
@@ -1865,7 +2089,7 @@ Status BlockBasedTable::MaybeReadBlockAndLoadToCache(
     }
 
     s = GetDataBlockFromCache(key, ckey, block_cache, block_cache_compressed,
-                              rep, ro, block_entry, compression_dict,
+                              rep, ro, block_entry, uncompression_dict,
                               rep->table_options.read_amp_bytes_per_bit,
                               is_index, get_context);
 
@@ -1883,7 +2107,7 @@ Status BlockBasedTable::MaybeReadBlockAndLoadToCache(
             rep->file.get(), prefetch_buffer, rep->footer, ro, handle,
             &raw_block_contents, rep->ioptions,
             do_decompress /* do uncompress */, rep->blocks_maybe_compressed,
-            compression_dict, rep->persistent_cache_options,
+            uncompression_dict, rep->persistent_cache_options,
             GetMemoryAllocator(rep->table_options),
             GetMemoryAllocatorForCompressedBlock(rep->table_options));
         s = block_fetcher.ReadBlockContents();
@@ -1897,7 +2121,7 @@ Status BlockBasedTable::MaybeReadBlockAndLoadToCache(
         s = PutDataBlockToCache(
             key, ckey, block_cache, block_cache_compressed, ro, rep->ioptions,
             block_entry, &raw_block_contents, raw_block_comp_type,
-            rep->table_options.format_version, compression_dict, seq_no,
+            rep->table_options.format_version, uncompression_dict, seq_no,
             rep->table_options.read_amp_bytes_per_bit,
             GetMemoryAllocator(rep->table_options), is_index,
             is_index && rep->table_options
@@ -2213,7 +2437,16 @@ void BlockBasedTableIterator<TBlockIter, TValue>::InitDataBlock() {
     if (!for_compaction_ && read_options_.readahead_size == 0) {
       num_file_reads_++;
       if (num_file_reads_ > 2) {
-        if (!rep->file->use_direct_io() &&
+        if (read_options_.readahead_buffers_in_flight > 0 &&
+            !rep->ioptions.allow_mmap_reads) {
+          // Asynchronous readahead, for both buffered and direct I/O
+          if (!prefetch_buffer_) {
+            prefetch_buffer_.reset(new FilePrefetchBuffer(
+                rep->file.get(), kInitReadaheadSize, kMaxReadaheadSize,
+                true /* enable */, false /* track_min_offset */,
+                read_options_.readahead_buffers_in_flight));
+          }
+        } else if (!rep->file->use_direct_io() &&
             (data_block_handle.offset() +
                  static_cast<size_t>(data_block_handle.size()) +
                  kBlockTrailerSize >
@@ -2532,6 +2765,281 @@ Status BlockBasedTable::Get(const ReadOptions& read_options, const Slice& key,
   return s;
 }
 
+void BlockBasedTable::MultiGet(const ReadOptions& read_options,
+                               const MultiGetRange& keys,
+                               const SliceTransform* prefix_extractor,
+                               bool skip_filters) {
+  if (keys.empty()) {
+    return;
+  }
+  const bool no_io = read_options.read_tier == kBlockCacheTier;
+  CachableEntry<FilterBlockReader> filter_entry;
+  if (!skip_filters) {
+    filter_entry = GetFilter(prefix_extractor, /*prefetch_buffer*/ nullptr,
+                             no_io, keys[0]->get_context);
+  }
+  FilterBlockReader* filter = filter_entry.value;
+
+  // First check the full filter for all the keys of the batch
+  MultiGetRange candidates;
+  for (auto* key : keys) {
+    *key->s = Status::OK();
+    if (!FullFilterKeyMayMatch(read_options, filter, key->internal_key(),
+                               no_io, prefix_extractor)) {
+      RecordTick(rep_->ioptions.statistics, BLOOM_FILTER_USEFUL);
+      PERF_COUNTER_BY_LEVEL_ADD(bloom_filter_useful, 1, rep_->level);
+    } else {
+      candidates.push_back(key);
+    }
+  }
+
+  if (!candidates.empty()) {
+    IndexBlockIter iiter_on_stack;
+    // if prefix_extractor found in block differs from options, disable
+    // BlockPrefixIndex. Only do this check when index_type is kHashSearch.
+    bool need_upper_bound_check = false;
+    if (rep_->index_type == BlockBasedTableOptions::kHashSearch) {
+      need_upper_bound_check = PrefixExtractorChanged(
+          rep_->table_properties.get(), prefix_extractor);
+    }
+    auto iiter = NewIndexIterator(read_options, need_upper_bound_check,
+                                  &iiter_on_stack, /* index_entry */ nullptr,
+                                  candidates[0]->get_context);
+    std::unique_ptr<InternalIteratorBase<BlockHandle>> iiter_unique_ptr;
+    if (iiter != &iiter_on_stack) {
+      iiter_unique_ptr.reset(iiter);
+    }
+
+    autovector<CachableEntry<Block>> pinned_blocks;
+    if (!no_io && candidates.size() > 1) {
+      MultiGetReadDataBlocks(read_options, iiter, filter, prefix_extractor,
+                             candidates, &pinned_blocks);
+    }
+
+    // The data block iterator is kept across keys, so that a run of keys
+    // falling into the same block only looks the block up once.
+    DataBlockIter biter;
+    bool biter_loaded = false;
+    uint64_t biter_offset = 0;
+    for (auto* key : candidates) {
+      const Slice& ikey = key->internal_key();
+      GetContext* get_context = key->get_context;
+      Status s;
+      bool matched = false;  // if such user key mathced a key in SST
+      bool done = false;
+      for (iiter->Seek(ikey); iiter->Valid() && !done; iiter->Next()) {
+        BlockHandle handle = iiter->value();
+
+        bool not_exist_in_filter =
+            filter != nullptr && filter->IsBlockBased() == true &&
+            !filter->KeyMayMatch(ExtractUserKey(ikey), prefix_extractor,
+                                 handle.offset(), no_io);
+
+        if (not_exist_in_filter) {
+          // Not found
+          RecordTick(rep_->ioptions.statistics, BLOOM_FILTER_USEFUL);
+          PERF_COUNTER_BY_LEVEL_ADD(bloom_filter_useful, 1, rep_->level);
+          break;
+        }
+        // The block can only be reused while biter still holds it, i.e. if
+        // no value read from it has taken over its cleanup.
+        if (!biter_loaded || biter_offset != handle.offset() ||
+            !biter.status().ok() || !biter.HasCleanups()) {
+          biter.Invalidate(Status::OK());
+          NewDataBlockIterator<DataBlockIter>(
+              rep_, read_options, handle, &biter, false,
+              true /* key_includes_seq */, true /* index_key_is_full */,
+              get_context);
+          biter_loaded = true;
+          biter_offset = handle.offset();
+        }
+
+        if (read_options.read_tier == kBlockCacheTier &&
+            biter.status().IsIncomplete()) {
+          // couldn't get block from block_cache
+          // Update Saver.state to Found because we are only looking for
+          // whether we can guarantee the key is not there when "no_io" is set
+          get_context->MarkKeyMayExist();
+          break;
+        }
+        if (!biter.status().ok()) {
+          s = biter.status();
+          break;
+        }
+
+        bool may_exist = biter.SeekForGet(ikey);
+        if (!may_exist) {
+          // HashSeek cannot find the key this block and the the iter is not
+          // the end of the block, i.e. cannot be in the following blocks
+          // either.
+          break;
+        }
+
+        // Call the *saver function on each entry/block until it returns false
+        for (; biter.Valid(); biter.Next()) {
+          ParsedInternalKey parsed_key;
+          if (!ParseInternalKey(biter.key(), &parsed_key)) {
+            s = Status::Corruption(Slice());
+          }
+
+          if (!get_context->SaveValue(
+                  parsed_key, biter.value(), &matched,
+                  biter.IsValuePinned() ? &biter : nullptr)) {
+            done = true;
+            break;
+          }
+        }
+        s = biter.status();
+        if (done) {
+          // Avoid the extra Next which is expensive in two-level indexes
+          break;
+        }
+      }
+      if (matched && filter != nullptr && !filter->IsBlockBased()) {
+        RecordTick(rep_->ioptions.statistics,
+                   BLOOM_FILTER_FULL_TRUE_POSITIVE);
+        PERF_COUNTER_BY_LEVEL_ADD(bloom_filter_full_true_positive, 1,
+                                  rep_->level);
+      }
+      if (s.ok()) {
+        s = iiter->status();
+      }
+      *key->s = s;
+    }
+
+    for (auto& block : pinned_blocks) {
+      block.Release(rep_->table_options.block_cache.get());
+    }
+  }
+
+  // if rep_->filter_entry is not set, we should call Release(); otherwise
+  // don't call, in this case we have a local copy in rep_->filter_entry,
+  // it's pinned to the cache and will be released in the destructor
+  if (!rep_->filter_entry.IsSet()) {
+    filter_entry.Release(rep_->table_options.block_cache.get());
+  }
+}
+
+void BlockBasedTable::MultiGetReadDataBlocks(
+    const ReadOptions& ro, InternalIteratorBase<BlockHandle>* iiter,
+    FilterBlockReader* filter, const SliceTransform* prefix_extractor,
+    const MultiGetRange& keys,
+    autovector<CachableEntry<Block>>* pinned_blocks) {
+  Cache* block_cache = rep_->table_options.block_cache.get();
+  // The blocks read here must end up in the block cache for the lookups to
+  // find them. Leave the more involved setups (compressed block cache,
+  // persistent cache, mmap reads) to the regular one-block-at-a-time path.
+  if (block_cache == nullptr || !ro.fill_cache ||
+      (!rep_->immortal_table &&
+       rep_->table_options.block_cache_compressed != nullptr) ||
+      rep_->persistent_cache_options.persistent_cache != nullptr ||
+      rep_->ioptions.allow_mmap_reads) {
+    return;
+  }
+
+  // Collect the distinct blocks that the keys start their search in and that
+  // are not cached yet. The keys are sorted, so duplicates are adjacent.
+  autovector<BlockHandle> handles;
+  autovector<GetContext*> get_contexts;
+  char cache_key[kMaxCacheKeyPrefixSize + kMaxVarint64Length];
+  for (auto* key : keys) {
+    iiter->Seek(key->internal_key());
+    if (!iiter->Valid()) {
+      continue;
+    }
+    BlockHandle handle = iiter->value();
+    if (!handles.empty() && handles.back().offset() == handle.offset()) {
+      continue;
+    }
+    if (filter != nullptr && filter->IsBlockBased() &&
+        !filter->KeyMayMatch(key->user_key(), prefix_extractor,
+                             handle.offset(), false /* no_io */)) {
+      continue;
+    }
+    Slice ckey = GetCacheKey(rep_->cache_key_prefix,
+                             rep_->cache_key_prefix_size, handle, cache_key);
+    Cache::Handle* cache_handle = block_cache->Lookup(ckey);
+    if (cache_handle != nullptr) {
+      block_cache->Release(cache_handle);
+      continue;
+    }
+    handles.push_back(handle);
+    get_contexts.push_back(key->get_context);
+  }
+  if (handles.size() <= 1) {
+    // Nothing to gain over a regular read
+    return;
+  }
+
+  size_t total_len = 0;
+  for (const auto& handle : handles) {
+    total_len += static_cast<size_t>(handle.size()) + kBlockTrailerSize;
+  }
+  std::unique_ptr<char[]> buf(new char[total_len]);
+  std::vector<ReadRequest> read_reqs;
+  read_reqs.reserve(handles.size());
+  size_t buf_offset = 0;
+  for (const auto& handle : handles) {
+    ReadRequest req;
+    req.offset = handle.offset();
+    req.len = static_cast<size_t>(handle.size()) + kBlockTrailerSize;
+    req.scratch = buf.get() + buf_offset;
+    buf_offset += req.len;
+    read_reqs.push_back(req);
+  }
+
+  {
+    PERF_TIMER_GUARD(block_read_time);
+    StopWatch sw(rep_->ioptions.env, rep_->ioptions.statistics,
+                 READ_BLOCK_GET_MICROS);
+    Status s = rep_->file->MultiRead(read_reqs.data(), read_reqs.size());
+    if (!s.ok()) {
+      return;
+    }
+  }
+  PERF_COUNTER_ADD(block_read_count, read_reqs.size());
+  PERF_COUNTER_ADD(block_read_byte, total_len);
+
+  const UncompressionDict& uncompression_dict = rep_->GetUncompressionDict();
+  for (size_t i = 0; i < read_reqs.size(); ++i) {
+    const ReadRequest& req = read_reqs[i];
+    if (!req.status.ok()) {
+      continue;
+    }
+    BlockContents raw_block_contents;
+    BlockFetcher block_fetcher(
+        rep_->file.get(), nullptr /* prefetch_buffer */, rep_->footer, ro,
+        handles[i], &raw_block_contents, rep_->ioptions,
+        rep_->blocks_maybe_compressed /* do uncompress */,
+        rep_->blocks_maybe_compressed, uncompression_dict,
+        rep_->persistent_cache_options, GetMemoryAllocator(rep_->table_options),
+        GetMemoryAllocatorForCompressedBlock(rep_->table_options));
+    Status s = block_fetcher.ReadBlockContentsFromBuffer(req.result);
+    if (!s.ok()) {
+      continue;
+    }
+    Slice ckey = GetCacheKey(rep_->cache_key_prefix,
+                             rep_->cache_key_prefix_size, handles[i],
+                             cache_key);
+    CachableEntry<Block> block_entry;
+    s = PutDataBlockToCache(
+        ckey, Slice() /* compressed_block_cache_key */, block_cache,
+        nullptr /* block_cache_compressed */, ro, rep_->ioptions,
+        &block_entry, &raw_block_contents,
+        block_fetcher.get_compression_type(),
+        rep_->table_options.format_version, uncompression_dict,
+        rep_->get_global_seqno(false /* is_index */),
+        rep_->table_options.read_amp_bytes_per_bit,
+        GetMemoryAllocator(rep_->table_options), false /* is_index */,
+        Cache::Priority::LOW, get_contexts[i]);
+    if (s.ok() && block_entry.IsSet()) {
+      pinned_blocks->push_back(block_entry);
+    } else {
+      delete block_entry.value;
+    }
+  }
+}
+
 Status BlockBasedTable::Prefetch(const Slice* const begin,
                                  const Slice* const end) {
   auto& comparator = rep_->internal_comparator;
@@ -2630,12 +3138,11 @@ Status BlockBasedTable::VerifyChecksumInBlocks(
     }
     BlockHandle handle = index_iter->value();
     BlockContents contents;
-    Slice dummy_comp_dict;
     BlockFetcher block_fetcher(
         rep_->file.get(), nullptr /* prefetch buffer */, rep_->footer,
         ReadOptions(), handle, &contents, rep_->ioptions,
         false /* decompress */, false /*maybe_compressed*/,
-        dummy_comp_dict /*compression dict*/, rep_->persistent_cache_options);
+        UncompressionDict::GetEmptyDict(), rep_->persistent_cache_options);
     s = block_fetcher.ReadBlockContents();
     if (!s.ok()) {
       break;
@@ -2656,12 +3163,11 @@ Status BlockBasedTable::VerifyChecksumInBlocks(
     Slice input = index_iter->value();
     s = handle.DecodeFrom(&input);
     BlockContents contents;
-    Slice dummy_comp_dict;
     BlockFetcher block_fetcher(
         rep_->file.get(), nullptr /* prefetch buffer */, rep_->footer,
         ReadOptions(), handle, &contents, rep_->ioptions,
         false /* decompress */, false /*maybe_compressed*/,
-        dummy_comp_dict /*compression dict*/, rep_->persistent_cache_options);
+        UncompressionDict::GetEmptyDict(), rep_->persistent_cache_options);
     s = block_fetcher.ReadBlockContents();
     if (!s.ok()) {
       break;
@@ -2691,9 +3197,7 @@ bool BlockBasedTable::TEST_KeyInCache(const ReadOptions& options,
   Status s;
   s = GetDataBlockFromCache(
       cache_key, ckey, block_cache, nullptr, rep_, options, &block,
-      rep_->compression_dict_block ? rep_->compression_dict_block->data
-                                   : Slice(),
-      0 /* read_amp_bytes_per_bit */);
+      rep_->GetUncompressionDict(), 0 /* read_amp_bytes_per_bit */);
   assert(s.ok());
   bool in_cache = block.value != nullptr;
   if (in_cache) {
@@ -2800,6 +3304,40 @@ Status BlockBasedTable::CreateIndexReader(
               rep_->table_properties->index_value_is_delta_encoded == 0,
           GetMemoryAllocator(rep_->table_options));
     }
+    case BlockBasedTableOptions::kInterpolationSearch: {
+      std::unique_ptr<Block> meta_guard;
+      std::unique_ptr<InternalIterator> meta_iter_guard;
+      auto meta_index_iter = preloaded_meta_index_iter;
+      if (meta_index_iter == nullptr) {
+        auto s =
+            ReadMetaBlock(rep_, prefetch_buffer, &meta_guard, &meta_iter_guard);
+        if (!s.ok()) {
+          ROCKS_LOG_WARN(rep_->ioptions.info_log,
+                         "Unable to read the metaindex block."
+                         " Fall back to binary search index.");
+          return BinarySearchIndexReader::Create(
+              file, prefetch_buffer, footer, footer.index_handle(),
+              rep_->ioptions, icomparator, index_reader,
+              rep_->persistent_cache_options,
+              rep_->table_properties == nullptr ||
+                  rep_->table_properties->index_key_is_user_key == 0,
+              rep_->table_properties == nullptr ||
+                  rep_->table_properties->index_value_is_delta_encoded == 0,
+              GetMemoryAllocator(rep_->table_options));
+        }
+        meta_index_iter = meta_iter_guard.get();
+      }
+
+      return InterpolationSearchIndexReader::Create(
+          footer, file, prefetch_buffer, rep_->ioptions, icomparator,
+          footer.index_handle(), meta_index_iter, index_reader,
+          rep_->persistent_cache_options,
+          rep_->table_properties == nullptr ||
+              rep_->table_properties->index_key_is_user_key == 0,
+          rep_->table_properties == nullptr ||
+              rep_->table_properties->index_value_is_delta_encoded == 0,
+          GetMemoryAllocator(rep_->table_options));
+    }
     default: {
       std::string error_message =
           "Unrecognized index type: " + ToString(index_type_on_file);
@@ -2963,12 +3501,11 @@ Status BlockBasedTable::DumpTable(WritableFile* out_file,
         BlockHandle handle;
         if (FindMetaBlock(meta_iter.get(), filter_block_key, &handle).ok()) {
           BlockContents block;
-          Slice dummy_comp_dict;
           BlockFetcher block_fetcher(
               rep_->file.get(), nullptr /* prefetch_buffer */, rep_->footer,
               ReadOptions(), handle, &block, rep_->ioptions,
               false /*decompress*/, false /*maybe_compressed*/,
-              dummy_comp_dict /*compression dict*/,
+              UncompressionDict::GetEmptyDict(),
               rep_->persistent_cache_options);
           s = block_fetcher.ReadBlockContents();
           if (!s.ok()) {
@@ -2997,8 +3534,8 @@ Status BlockBasedTable::DumpTable(WritableFile* out_file,
   }
 
   // Output compression dictionary
-  if (rep_->compression_dict_block != nullptr) {
-    auto compression_dict = rep_->compression_dict_block->data;
+  if (rep_->uncompression_dict != nullptr) {
+    const Slice& compression_dict = rep_->uncompression_dict->GetRawDict();
     out_file->Append(
         "Compression Dictionary:\n"
         "--------------------------------------\n");
@@ -3039,6 +3576,11 @@ void BlockBasedTable::Close() {
   rep_->filter_entry.Release(rep_->table_options.block_cache.get());
   rep_->index_entry.Release(rep_->table_options.block_cache.get());
   rep_->range_del_entry.Release(rep_->table_options.block_cache.get());
+  if (rep_->uncompression_dict_handle != nullptr) {
+    rep_->table_options.block_cache->Release(rep_->uncompression_dict_handle);
+    rep_->uncompression_dict_handle = nullptr;
+    rep_->uncompression_dict = nullptr;
+  }
   // cleanup index and filter blocks to avoid accessing dangling pointer
   if (!rep_->table_options.no_block_cache) {
     char cache_key[kMaxCacheKeyPrefixSize + kMaxVarint64Length];
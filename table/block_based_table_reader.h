@@ -32,6 +32,7 @@
 #include "table/table_reader.h"
 #include "table/two_level_iterator.h"
 #include "util/coding.h"
+#include "util/compression.h"
 #include "util/file_reader_writer.h"
 
 namespace rocksdb {
@@ -122,6 +123,14 @@ class BlockBasedTable : public TableReader {
              GetContext* get_context, const SliceTransform* prefix_extractor,
              bool skip_filters = false) override;
 
+  // Looks up a sorted batch of keys. The filter and the index are fetched
+  // once for the whole batch, and consecutive keys that map to the same data
+  // block share a single block lookup.
+  // @param skip_filters Disables loading/accessing the filter block
+  void MultiGet(const ReadOptions& readOptions, const MultiGetRange& keys,
+                const SliceTransform* prefix_extractor,
+                bool skip_filters = false) override;
+
   // Pre-fetch the disk blocks that correspond to the key range specified by
   // (kbegin, kend). The call will return error status in the event of
   // IO or iteration error.
@@ -259,10 +268,22 @@ class BlockBasedTable : public TableReader {
   //    block.
   static Status MaybeReadBlockAndLoadToCache(
       FilePrefetchBuffer* prefetch_buffer, Rep* rep, const ReadOptions& ro,
-      const BlockHandle& handle, Slice compression_dict,
+      const BlockHandle& handle, const UncompressionDict& uncompression_dict,
       CachableEntry<Block>* block_entry, bool is_index = false,
       GetContext* get_context = nullptr);
 
+  // Reads the first data block of each of the keys in a MultiGet batch that
+  // is not in the block cache yet with a single RandomAccessFileReader::
+  // MultiRead(), so that the reads are issued to the device in parallel, and
+  // loads them into the block cache. The blocks are pinned in
+  // pinned_blocks until the caller releases them. Errors are ignored, the
+  // blocks are simply read again one at a time by the lookup itself.
+  void MultiGetReadDataBlocks(
+      const ReadOptions& ro, InternalIteratorBase<BlockHandle>* iiter,
+      FilterBlockReader* filter, const SliceTransform* prefix_extractor,
+      const MultiGetRange& keys,
+      autovector<CachableEntry<Block>>* pinned_blocks);
+
   // For the following two functions:
   // if `no_io == true`, we will not try to read filter/index from sst file
   // were they not present in cache yet.
@@ -295,14 +316,15 @@ class BlockBasedTable : public TableReader {
   // block_cache_compressed.
   // On success, Status::OK with be returned and @block will be populated with
   // pointer to the block as well as its block handle.
-  // @param compression_dict Data for presetting the compression library's
+  // @param uncompression_dict Data for presetting the compression library's
   //    dictionary.
   static Status GetDataBlockFromCache(
       const Slice& block_cache_key, const Slice& compressed_block_cache_key,
       Cache* block_cache, Cache* block_cache_compressed, Rep* rep,
       const ReadOptions& read_options,
       BlockBasedTable::CachableEntry<Block>* block,
-      const Slice& compression_dict, size_t read_amp_bytes_per_bit,
+      const UncompressionDict& uncompression_dict,
+      size_t read_amp_bytes_per_bit,
       bool is_index = false, GetContext* get_context = nullptr);
 
   // Put a raw block (maybe compressed) to the corresponding block caches.
@@ -313,7 +335,7 @@ class BlockBasedTable : public TableReader {
   //
   // Allocated memory managed by raw_block_contents will be transferred to
   // PutDataBlockToCache(). After the call, the object will be invalid.
-  // @param compression_dict Data for presetting the compression library's
+  // @param uncompression_dict Data for presetting the compression library's
   //    dictionary.
   static Status PutDataBlockToCache(
       const Slice& block_cache_key, const Slice& compressed_block_cache_key,
@@ -321,7 +343,7 @@ class BlockBasedTable : public TableReader {
       const ReadOptions& read_options, const ImmutableCFOptions& ioptions,
       CachableEntry<Block>* block, BlockContents* raw_block_contents,
       CompressionType raw_block_comp_type, uint32_t format_version,
-      const Slice& compression_dict, SequenceNumber seq_no,
+      const UncompressionDict& uncompression_dict, SequenceNumber seq_no,
       size_t read_amp_bytes_per_bit, MemoryAllocator* memory_allocator,
       bool is_index = false, Cache::Priority pri = Cache::Priority::LOW,
       GetContext* get_context = nullptr);
@@ -351,6 +373,10 @@ class BlockBasedTable : public TableReader {
       const Slice& user_key, const bool no_io,
       const SliceTransform* prefix_extractor = nullptr) const;
 
+  // Set the dictionary the data blocks of the table were compressed with,
+  // sharing it with the other tables using it through the block cache.
+  static Status SetUncompressionDict(Rep* rep, const Slice& dict);
+
   // Read the meta block from sst.
   static Status ReadMetaBlock(Rep* rep, FilePrefetchBuffer* prefetch_buffer,
                               std::unique_ptr<Block>* meta_block,
@@ -487,11 +513,12 @@ struct BlockBasedTable::Rep {
   BlockHandle filter_handle;
 
   std::shared_ptr<const TableProperties> table_properties;
-  // Block containing the data for the compression dictionary. We take ownership
-  // for the entire block struct, even though we only use its Slice member. This
-  // is easier because the Slice member depends on the continued existence of
-  // another member ("allocation").
-  std::unique_ptr<const BlockContents> compression_dict_block;
+  // The dictionary the data blocks were compressed with, if any. It is shared
+  // with the other tables using the same dictionary through the block cache
+  // when there is one, in which case uncompression_dict_handle references it.
+  const UncompressionDict* uncompression_dict = nullptr;
+  Cache::Handle* uncompression_dict_handle = nullptr;
+  std::unique_ptr<UncompressionDict> owned_uncompression_dict;
   BlockBasedTableOptions::IndexType index_type;
   bool hash_index_allow_collision;
   bool whole_key_filtering;
@@ -538,6 +565,11 @@ struct BlockBasedTable::Rep {
   SequenceNumber get_global_seqno(bool is_index) const {
     return is_index ? kDisableGlobalSequenceNumber : global_seqno;
   }
+
+  const UncompressionDict& GetUncompressionDict() const {
+    return uncompression_dict != nullptr ? *uncompression_dict
+                                         : UncompressionDict::GetEmptyDict();
+  }
 };
 
 template <class TBlockIter, typename TValue = Slice>
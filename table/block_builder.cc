@@ -28,7 +28,8 @@
 //
 // The trailer of the block has the form:
 //     restarts: uint32[num_restarts]
-//     num_restarts: uint32
+//     [hash index or restart key prefixes, see data_block_index_type]
+//     num_restarts: uint32, packed with the data block index type
 // restarts[i] contains the offset within the block of the ith restart point.
 
 #include "table/block_builder.h"
@@ -52,7 +53,8 @@ BlockBuilder::BlockBuilder(
       use_value_delta_encoding_(use_value_delta_encoding),
       restarts_(),
       counter_(0),
-      finished_(false) {
+      finished_(false),
+      use_key_prefixes_(false) {
   switch (index_type) {
     case BlockBasedTableOptions::kDataBlockBinarySearch:
       break;
@@ -60,6 +62,9 @@ BlockBuilder::BlockBuilder(
       data_block_hash_index_builder_.Initialize(
           data_block_hash_table_util_ratio);
       break;
+    case BlockBasedTableOptions::kDataBlockBinaryAndKeyPrefixes:
+      use_key_prefixes_ = true;
+      break;
     default:
       assert(0);
   }
@@ -79,6 +84,7 @@ void BlockBuilder::Reset() {
   if (data_block_hash_index_builder_.Valid()) {
     data_block_hash_index_builder_.Reset();
   }
+  key_prefixes_builder_.Reset();
 }
 
 size_t BlockBuilder::EstimateSizeAfterKV(const Slice& key, const Slice& value)
@@ -122,6 +128,13 @@ Slice BlockBuilder::Finish() {
       CurrentSizeEstimate() <= kMaxBlockSizeSupportedByHashIndex) {
     data_block_hash_index_builder_.Finish(buffer_);
     index_type = BlockBasedTableOptions::kDataBlockBinaryAndHash;
+  } else if (use_key_prefixes_ && key_prefixes_builder_.size() > 0 &&
+             CurrentSizeEstimate() <= kMaxBlockSizeSupportedByHashIndex) {
+    // Larger blocks do not have their index type in the footer, see
+    // Block::NumRestarts()
+    assert(key_prefixes_builder_.size() == num_restarts);
+    key_prefixes_builder_.Finish(&buffer_);
+    index_type = BlockBasedTableOptions::kDataBlockBinaryAndKeyPrefixes;
   }
 
   // footer is a packed format of data_block_index_type and num_restarts
@@ -188,6 +201,9 @@ void BlockBuilder::Add(const Slice& key, const Slice& value,
     data_block_hash_index_builder_.Add(ExtractUserKey(key),
                                        restarts_.size() - 1);
   }
+  if (use_key_prefixes_ && counter_ == 0) {
+    key_prefixes_builder_.Add(ExtractUserKey(key));
+  }
 
   counter_++;
   estimate_ += buffer_.size() - curr_size;
@@ -14,6 +14,7 @@
 #include "rocksdb/slice.h"
 #include "rocksdb/table.h"
 #include "table/data_block_hash_index.h"
+#include "table/restart_key_prefixes.h"
 
 namespace rocksdb {
 
@@ -45,9 +46,11 @@ class BlockBuilder {
   // Returns an estimate of the current (uncompressed) size of the block
   // we are building.
   inline size_t CurrentSizeEstimate() const {
-    return estimate_ + (data_block_hash_index_builder_.Valid()
-                            ? data_block_hash_index_builder_.EstimateSize()
-                            : 0);
+    return estimate_ +
+           (data_block_hash_index_builder_.Valid()
+                ? data_block_hash_index_builder_.EstimateSize()
+                : 0) +
+           (use_key_prefixes_ ? key_prefixes_builder_.EstimateSize() : 0);
   }
 
   // Returns an estimated block size after appending key and value.
@@ -72,6 +75,10 @@ class BlockBuilder {
   bool                  finished_;  // Has Finish() been called?
   std::string           last_key_;
   DataBlockHashIndexBuilder data_block_hash_index_builder_;
+  // Whether to write the key prefixes of the restart points, for
+  // kDataBlockBinaryAndKeyPrefixes
+  bool use_key_prefixes_;
+  RestartKeyPrefixesBuilder key_prefixes_builder_;
 };
 
 }  // namespace rocksdb
@@ -250,6 +250,31 @@ Status BlockFetcher::ReadBlockContents() {
     }
   }
 
+  return ProcessRawBlock();
+}
+
+Status BlockFetcher::ReadBlockContentsFromBuffer(const Slice& raw_block) {
+  block_size_ = static_cast<size_t>(handle_.size());
+  if (raw_block.size() != block_size_ + kBlockTrailerSize) {
+    return Status::Corruption("truncated block read from " +
+                              file_->file_name() + " offset " +
+                              ToString(handle_.offset()) + ", expected " +
+                              ToString(block_size_ + kBlockTrailerSize) +
+                              " bytes, got " + ToString(raw_block.size()));
+  }
+  slice_ = raw_block;
+  CheckBlockChecksum();
+  if (!status_.ok()) {
+    return status_;
+  }
+  // Like a prefetch buffer, the buffer belongs to the caller, so the block
+  // has to be copied out of it
+  got_from_prefetch_buffer_ = true;
+  used_buf_ = const_cast<char*>(slice_.data());
+  return ProcessRawBlock();
+}
+
+Status BlockFetcher::ProcessRawBlock() {
   PERF_TIMER_GUARD(block_decompress_time);
 
   compression_type_ = get_block_compression_type(slice_.data(), block_size_);
@@ -257,7 +282,7 @@ Status BlockFetcher::ReadBlockContents() {
   if (do_uncompress_ && compression_type_ != kNoCompression) {
     // compressed page, uncompress, update cache
     UncompressionContext uncompression_ctx(compression_type_,
-                                           compression_dict_);
+                                           uncompression_dict_);
     status_ = UncompressBlockContents(uncompression_ctx, slice_.data(),
                                       block_size_, contents_, footer_.version(),
                                       ioptions_, memory_allocator_);
@@ -10,6 +10,7 @@
 #pragma once
 #include "table/block.h"
 #include "table/format.h"
+#include "util/compression.h"
 #include "util/memory_allocator.h"
 
 namespace rocksdb {
@@ -19,14 +20,14 @@ class BlockFetcher {
   // The only relevant option is options.verify_checksums for now.
   // On failure return non-OK.
   // On success fill *result and return OK - caller owns *result
-  // @param compression_dict Data for presetting the compression library's
+  // @param uncompression_dict Data for presetting the compression library's
   //    dictionary.
   BlockFetcher(RandomAccessFileReader* file,
                FilePrefetchBuffer* prefetch_buffer, const Footer& footer,
                const ReadOptions& read_options, const BlockHandle& handle,
                BlockContents* contents, const ImmutableCFOptions& ioptions,
                bool do_uncompress, bool maybe_compressed,
-               const Slice& compression_dict,
+               const UncompressionDict& uncompression_dict,
                const PersistentCacheOptions& cache_options,
                MemoryAllocator* memory_allocator = nullptr,
                MemoryAllocator* memory_allocator_compressed = nullptr)
@@ -39,11 +40,16 @@ class BlockFetcher {
         ioptions_(ioptions),
         do_uncompress_(do_uncompress),
         maybe_compressed_(maybe_compressed),
-        compression_dict_(compression_dict),
+        uncompression_dict_(uncompression_dict),
         cache_options_(cache_options),
         memory_allocator_(memory_allocator),
         memory_allocator_compressed_(memory_allocator_compressed) {}
   Status ReadBlockContents();
+  // Same as ReadBlockContents(), but the raw block, including its trailer,
+  // has already been read by the caller into raw_block, e.g. as part of a
+  // RandomAccessFileReader::MultiRead(). raw_block must stay valid until this
+  // returns.
+  Status ReadBlockContentsFromBuffer(const Slice& raw_block);
   CompressionType get_compression_type() const { return compression_type_; }
 
  private:
@@ -58,7 +64,7 @@ class BlockFetcher {
   const ImmutableCFOptions& ioptions_;
   bool do_uncompress_;
   bool maybe_compressed_;
-  const Slice& compression_dict_;
+  const UncompressionDict& uncompression_dict_;
   const PersistentCacheOptions& cache_options_;
   MemoryAllocator* memory_allocator_;
   MemoryAllocator* memory_allocator_compressed_;
@@ -84,5 +90,7 @@ class BlockFetcher {
   void InsertCompressedBlockToPersistentCacheIfNeeded();
   void InsertUncompressedBlockToPersistentCacheIfNeeded();
   void CheckBlockChecksum();
+  // Uncompress or take ownership of the raw block in slice_
+  Status ProcessRawBlock();
 };
 }  // namespace rocksdb
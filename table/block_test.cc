@@ -603,6 +603,120 @@ TEST_F(BlockTest, ReadAmpBitmapPow2) {
   ASSERT_EQ(BlockReadAmpBitmap(100, 35, stats.get()).GetBytesPerBit(), 32);
 }
 
+TEST_F(BlockTest, DataBlockKeyPrefixes) {
+  const InternalKeyComparator icmp(BytewiseComparator());
+  // Keys that share a long prefix, keys that only differ after the bytes
+  // stored in the key prefixes, keys that are prefixes of other keys
+  std::vector<std::string> user_keys = {"key", "key_", "key_a"};
+  for (int i = 0; i < 200; i++) {
+    char buf[32];
+    snprintf(buf, sizeof(buf), "key_%016d", i * 7);
+    user_keys.push_back(buf);
+    snprintf(buf, sizeof(buf), "key_samebytes%04d", i);
+    user_keys.push_back(buf);
+  }
+  std::sort(user_keys.begin(), user_keys.end());
+  // Several versions of some user keys, that span restart points
+  std::vector<std::string> keys;
+  for (size_t i = 0; i < user_keys.size(); i++) {
+    for (SequenceNumber seq = 100; seq > 100 - i % 4; seq--) {
+      keys.push_back(InternalKey(user_keys[i], seq, kTypeValue).Encode()
+                         .ToString());
+    }
+  }
+  std::vector<std::string> user_targets = {"", "a", "key", "key_", "kez",
+                                           "zzz", "key_samebytes",
+                                           "key_samebytes9"};
+  for (const auto& user_key : user_keys) {
+    user_targets.push_back(user_key);
+    user_targets.push_back(user_key + '\0');
+    user_targets.push_back(user_key.substr(0, user_key.size() - 1));
+  }
+  std::vector<std::string> targets;
+  for (const auto& user_target : user_targets) {
+    for (SequenceNumber seq : {kMaxSequenceNumber, SequenceNumber{99}}) {
+      targets.push_back(
+          InternalKey(user_target, seq, kTypeValue).Encode().ToString());
+    }
+  }
+  auto less = [&](const std::string& a, const std::string& b) {
+    return icmp.Compare(a, b) < 0;
+  };
+
+  for (int restart_interval : {1, 3, 16}) {
+    BlockBuilder builder(restart_interval, true /* use_delta_encoding */,
+                         false /* use_value_delta_encoding */,
+                         BlockBasedTableOptions::kDataBlockBinaryAndKeyPrefixes);
+    for (const auto& key : keys) {
+      builder.Add(key, "value");
+    }
+    BlockContents contents;
+    contents.data = builder.Finish();
+    Block reader(std::move(contents), kDisableGlobalSequenceNumber);
+    ASSERT_EQ(BlockBasedTableOptions::kDataBlockBinaryAndKeyPrefixes,
+              reader.IndexType());
+    ASSERT_EQ((keys.size() + restart_interval - 1) / restart_interval,
+              reader.NumRestarts());
+
+    std::unique_ptr<InternalIterator> iter(
+        reader.NewIterator<DataBlockIter>(&icmp, icmp.user_comparator()));
+    size_t count = 0;
+    for (iter->SeekToFirst(); iter->Valid(); iter->Next(), count++) {
+      ASSERT_EQ(keys[count], iter->key().ToString());
+    }
+    ASSERT_EQ(keys.size(), count);
+
+    for (const auto& target : targets) {
+      auto expected = std::lower_bound(keys.begin(), keys.end(), target, less);
+      iter->Seek(target);
+      if (expected == keys.end()) {
+        ASSERT_FALSE(iter->Valid());
+      } else {
+        ASSERT_TRUE(iter->Valid());
+        ASSERT_EQ(*expected, iter->key().ToString());
+      }
+
+      expected = std::upper_bound(keys.begin(), keys.end(), target, less);
+      iter->SeekForPrev(target);
+      if (expected == keys.begin()) {
+        ASSERT_FALSE(iter->Valid());
+      } else {
+        ASSERT_TRUE(iter->Valid());
+        ASSERT_EQ(*(expected - 1), iter->key().ToString());
+      }
+    }
+  }
+}
+
+TEST_F(BlockTest, DataBlockKeyPrefixesLargeBlock) {
+  const InternalKeyComparator icmp(BytewiseComparator());
+  std::vector<std::string> keys;
+  std::vector<std::string> values;
+  GenerateRandomKVs(&keys, &values, 0, 1000);
+  BlockBuilder builder(16, true /* use_delta_encoding */,
+                       false /* use_value_delta_encoding */,
+                       BlockBasedTableOptions::kDataBlockBinaryAndKeyPrefixes);
+  for (size_t i = 0; i < keys.size(); i++) {
+    builder.Add(InternalKey(keys[i], 1, kTypeValue).Encode(), values[i]);
+  }
+  BlockContents contents;
+  contents.data = builder.Finish();
+  // Blocks larger than 64KiB cannot record their index type, so they do not
+  // get the key prefixes
+  ASSERT_GT(contents.data.size(), kMaxBlockSizeSupportedByHashIndex);
+  Block reader(std::move(contents), kDisableGlobalSequenceNumber);
+  ASSERT_EQ(BlockBasedTableOptions::kDataBlockBinarySearch,
+            reader.IndexType());
+
+  std::unique_ptr<InternalIterator> iter(
+      reader.NewIterator<DataBlockIter>(&icmp, icmp.user_comparator()));
+  for (size_t i = 0; i < keys.size(); i++) {
+    iter->Seek(InternalKey(keys[i], kMaxSequenceNumber, kTypeValue).Encode());
+    ASSERT_TRUE(iter->Valid());
+    ASSERT_EQ(values[i], iter->value().ToString());
+  }
+}
+
 }  // namespace rocksdb
 
 int main(int argc, char **argv) {
@@ -15,11 +15,15 @@ namespace rocksdb {
 
 const int kDataBlockIndexTypeBitShift = 31;
 
-// 0x7FFFFFFF
-const uint32_t kMaxNumRestarts = (1u << kDataBlockIndexTypeBitShift) - 1u;
+// Set instead of the bit above for kDataBlockBinaryAndKeyPrefixes. Blocks
+// that fit kMaxBlockSizeSupportedByHashIndex never have that many restarts.
+const int kDataBlockKeyPrefixesBitShift = 30;
 
-// 0x7FFFFFFF
-const uint32_t kNumRestartsMask = (1u << kDataBlockIndexTypeBitShift) - 1u;
+// 0x3FFFFFFF
+const uint32_t kMaxNumRestarts = (1u << kDataBlockKeyPrefixesBitShift) - 1u;
+
+// 0x3FFFFFFF
+const uint32_t kNumRestartsMask = (1u << kDataBlockKeyPrefixesBitShift) - 1u;
 
 uint32_t PackIndexTypeAndNumRestarts(
     BlockBasedTableOptions::DataBlockIndexType index_type,
@@ -31,6 +35,9 @@ uint32_t PackIndexTypeAndNumRestarts(
   uint32_t block_footer = num_restarts;
   if (index_type == BlockBasedTableOptions::kDataBlockBinaryAndHash) {
     block_footer |= 1u << kDataBlockIndexTypeBitShift;
+  } else if (index_type ==
+             BlockBasedTableOptions::kDataBlockBinaryAndKeyPrefixes) {
+    block_footer |= 1u << kDataBlockKeyPrefixesBitShift;
   } else if (index_type != BlockBasedTableOptions::kDataBlockBinarySearch) {
     assert(0);
   }
@@ -45,6 +52,8 @@ void UnPackIndexTypeAndNumRestarts(
   if (index_type) {
     if (block_footer & 1u << kDataBlockIndexTypeBitShift) {
       *index_type = BlockBasedTableOptions::kDataBlockBinaryAndHash;
+    } else if (block_footer & 1u << kDataBlockKeyPrefixesBitShift) {
+      *index_type = BlockBasedTableOptions::kDataBlockBinaryAndKeyPrefixes;
     } else {
       *index_type = BlockBasedTableOptions::kDataBlockBinarySearch;
     }
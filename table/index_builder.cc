@@ -49,6 +49,12 @@ IndexBuilder* IndexBuilder::CreateIndexBuilder(
           comparator, use_value_delta_encoding, table_opt);
     }
     break;
+    case BlockBasedTableOptions::kInterpolationSearch: {
+      result = new InterpolationSearchIndexBuilder(
+          comparator, table_opt.index_block_restart_interval,
+          table_opt.format_version, use_value_delta_encoding);
+    }
+    break;
     default: {
       assert(!"Do not recognize the index type ");
     }
@@ -11,6 +11,7 @@
 
 #include <assert.h>
 #include <inttypes.h>
+#include <string.h>
 
 #include <list>
 #include <string>
@@ -20,6 +21,7 @@
 #include "table/block_based_table_factory.h"
 #include "table/block_builder.h"
 #include "table/format.h"
+#include "table/restart_key_prefixes.h"
 
 namespace rocksdb {
 // The interface for building index.
@@ -320,6 +322,70 @@ class HashIndexBuilder : public IndexBuilder {
   uint64_t current_restart_index_ = 0;
 };
 
+// InterpolationSearchIndexBuilder builds a binary-searchable primary index,
+// and a metablock that stores an integer made of the first bytes of the user
+// key of each restart point of the primary index, past the prefix they all
+// share. See RestartKeyPrefixes for the format and how it is searched.
+//
+// The integers only sort like the keys with a bytewise comparator. With other
+// comparators, the metablock is not written and the index is a plain binary
+// search index.
+class InterpolationSearchIndexBuilder : public IndexBuilder {
+ public:
+  explicit InterpolationSearchIndexBuilder(
+      const InternalKeyComparator* comparator,
+      int index_block_restart_interval, int format_version,
+      bool use_value_delta_encoding)
+      : IndexBuilder(comparator),
+        primary_index_builder_(comparator, index_block_restart_interval,
+                               format_version, use_value_delta_encoding),
+        index_block_restart_interval_(index_block_restart_interval),
+        bytewise_(strcmp(comparator->user_comparator()->Name(),
+                         BytewiseComparator()->Name()) == 0) {}
+
+  virtual void AddIndexEntry(std::string* last_key_in_current_block,
+                             const Slice* first_key_in_next_block,
+                             const BlockHandle& block_handle) override {
+    primary_index_builder_.AddIndexEntry(last_key_in_current_block,
+                                         first_key_in_next_block, block_handle);
+    // The separator has been written back to last_key_in_current_block. The
+    // index block starts a restart point every index_block_restart_interval
+    // entries.
+    if (bytewise_ && num_entries_ % index_block_restart_interval_ == 0) {
+      key_prefixes_builder_.Add(ExtractUserKey(*last_key_in_current_block));
+    }
+    ++num_entries_;
+  }
+
+  virtual Status Finish(
+      IndexBlocks* index_blocks,
+      const BlockHandle& last_partition_block_handle) override {
+    primary_index_builder_.Finish(index_blocks, last_partition_block_handle);
+    if (bytewise_ && num_entries_ > 0) {
+      key_prefixes_builder_.Finish(&key_prefixes_block_);
+      index_blocks->meta_blocks.insert(
+          {kIndexKeyPrefixesBlock.c_str(), key_prefixes_block_});
+    }
+    return Status::OK();
+  }
+
+  virtual size_t IndexSize() const override {
+    return primary_index_builder_.IndexSize() + key_prefixes_block_.size();
+  }
+
+  virtual bool seperator_is_key_plus_seq() override {
+    return primary_index_builder_.seperator_is_key_plus_seq();
+  }
+
+ private:
+  ShortenedIndexBuilder primary_index_builder_;
+  const uint64_t index_block_restart_interval_;
+  const bool bytewise_;
+  RestartKeyPrefixesBuilder key_prefixes_builder_;
+  std::string key_prefixes_block_;
+  uint64_t num_entries_ = 0;
+};
+
 /**
  * IndexBuilder for two-level indexing. Internally it creates a new index for
  * each partition and Finish then in order when Finish is called on it
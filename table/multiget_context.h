@@ -0,0 +1,52 @@
+//  Copyright (c) 2011-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#pragma once
+#include "db/dbformat.h"
+#include "db/merge_context.h"
+#include "rocksdb/slice.h"
+#include "rocksdb/status.h"
+#include "util/autovector.h"
+
+namespace rocksdb {
+
+class GetContext;
+
+// State of a single key in a batched MultiGet. It is created by DBImpl and
+// carried through the memtables, Version::MultiGet() and
+// TableReader::MultiGet(), so each layer can update the result of every key
+// of the batch in place.
+struct KeyContext {
+  KeyContext(const Slice& user_key, SequenceNumber snapshot,
+             PinnableSlice* val, Status* stat)
+      : lkey(user_key, snapshot),
+        value(val),
+        s(stat),
+        max_covering_tombstone_seq(0),
+        get_context(nullptr) {}
+
+  LookupKey lkey;
+  PinnableSlice* value;
+  Status* s;
+  MergeContext merge_context;
+  SequenceNumber max_covering_tombstone_seq;
+  // Set by Version::MultiGet() before the key is passed to a TableReader
+  GetContext* get_context;
+
+  Slice user_key() const { return lkey.user_key(); }
+  Slice internal_key() const { return lkey.internal_key(); }
+
+ private:
+  // No copying allowed
+  KeyContext(const KeyContext&);
+  void operator=(const KeyContext&);
+};
+
+// A batch of keys of the same column family, sorted in ascending user key
+// order, that are looked up together. The first 32 entries are kept on the
+// stack.
+typedef autovector<KeyContext*, 32> MultiGetRange;
+
+}  // namespace rocksdb
@@ -0,0 +1,161 @@
+//  Copyright (c) 2011-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "table/restart_key_prefixes.h"
+
+#include <assert.h>
+#include <string.h>
+#include <algorithm>
+
+#include "util/coding.h"
+
+namespace rocksdb {
+
+namespace {
+
+// After this many interpolation steps without finding the result, e.g.
+// because the keys are not evenly distributed, Search() falls back to plain
+// binary search.
+const int kMaxInterpolationSteps = 4;
+
+// Encodes the first 8 bytes of key, padded with zeros, as a big endian
+// integer, so that the integers compare like the keys
+inline uint64_t KeyToInteger(const Slice& key) {
+  uint64_t result = 0;
+  for (size_t i = 0; i < sizeof(uint64_t); i++) {
+    result <<= 8;
+    if (i < key.size()) {
+      result |= static_cast<unsigned char>(key[i]);
+    }
+  }
+  return result;
+}
+
+}  // namespace
+
+Status RestartKeyPrefixes::Initialize(const Slice& data, size_t* size) {
+  if (data.size() < 2 * sizeof(uint32_t)) {
+    return Status::Corruption("bad restart key prefixes");
+  }
+  const char* footer = data.data() + data.size() - 2 * sizeof(uint32_t);
+  const uint32_t common_prefix_size = DecodeFixed32(footer);
+  const uint32_t num_restarts = DecodeFixed32(footer + sizeof(uint32_t));
+  const uint64_t total_size = uint64_t{num_restarts} * sizeof(uint64_t) +
+                              common_prefix_size + 2 * sizeof(uint32_t);
+  if (num_restarts == 0 || total_size > data.size()) {
+    return Status::Corruption("bad restart key prefixes");
+  }
+  data_ = data.data() + data.size() - total_size;
+  num_restarts_ = num_restarts;
+  common_prefix_size_ = common_prefix_size;
+  *size = static_cast<size_t>(total_size);
+  return Status::OK();
+}
+
+inline uint64_t RestartKeyPrefixes::KeyPrefixAt(uint32_t i) const {
+  assert(i < num_restarts_);
+  return DecodeFixed64(data_ + i * sizeof(uint64_t));
+}
+
+uint32_t RestartKeyPrefixes::Search(uint64_t target, bool strict,
+                                    uint32_t left) const {
+  uint32_t right = num_restarts_;
+  int interpolation_steps = 0;
+  // The result is in [left, right]
+  while (left < right) {
+    uint32_t mid = left + (right - left) / 2;
+    if (interpolation_steps < kMaxInterpolationSteps) {
+      interpolation_steps++;
+      // Guess the position of target from the integers at both ends, as if
+      // they were evenly distributed in between
+      const uint64_t low = KeyPrefixAt(left);
+      const uint64_t high = KeyPrefixAt(right - 1);
+      if (low < target && target < high) {
+        const double fraction = static_cast<double>(target - low) /
+                                static_cast<double>(high - low);
+        mid = left + static_cast<uint32_t>(fraction * (right - 1 - left));
+        mid = std::min(mid, right - 1);
+      }
+    }
+    const uint64_t key_prefix = KeyPrefixAt(mid);
+    if (key_prefix < target || (strict && key_prefix == target)) {
+      left = mid + 1;
+    } else {
+      right = mid;
+    }
+  }
+  return left;
+}
+
+void RestartKeyPrefixes::Narrow(const Slice& user_key, uint32_t* left,
+                                uint32_t* right) const {
+  const Slice common_prefix = this->common_prefix();
+  if (!user_key.starts_with(common_prefix)) {
+    // All the keys of the restart points start with the common prefix, so
+    // they are either all greater or all smaller than user_key
+    if (user_key.compare(common_prefix) < 0) {
+      *left = *right = 0;
+    } else {
+      *left = *right = num_restarts_ - 1;
+    }
+    return;
+  }
+  const uint64_t target = KeyToInteger(
+      Slice(user_key.data() + common_prefix.size(),
+            user_key.size() - common_prefix.size()));
+  const uint32_t first_not_less = Search(target, false /* strict */, 0);
+  uint32_t first_greater = first_not_less;
+  if (first_not_less < num_restarts_ &&
+      KeyPrefixAt(first_not_less) == target) {
+    first_greater = Search(target, true /* strict */, first_not_less);
+  }
+  // The last restart point with a smaller key is a candidate, the restart
+  // points with a greater key are not
+  *left = first_not_less > 0 ? first_not_less - 1 : 0;
+  *right = std::max(*left, first_greater > 0 ? first_greater - 1 : 0);
+}
+
+void RestartKeyPrefixesBuilder::Add(const Slice& user_key) {
+  assert(key_offsets_.empty() || KeyAt(size() - 1).compare(user_key) <= 0);
+  key_offsets_.push_back(static_cast<uint32_t>(keys_.size()));
+  keys_.append(user_key.data(), user_key.size());
+}
+
+Slice RestartKeyPrefixesBuilder::KeyAt(size_t i) const {
+  const uint32_t end = i + 1 < key_offsets_.size()
+                           ? key_offsets_[i + 1]
+                           : static_cast<uint32_t>(keys_.size());
+  return Slice(keys_.data() + key_offsets_[i], end - key_offsets_[i]);
+}
+
+size_t RestartKeyPrefixesBuilder::EstimateSize() const {
+  // The common prefix is at most as long as the first key
+  return size() * sizeof(uint64_t) + (size() > 0 ? KeyAt(0).size() : 0) +
+         2 * sizeof(uint32_t);
+}
+
+void RestartKeyPrefixesBuilder::Finish(std::string* buffer) const {
+  const uint32_t num_restarts = static_cast<uint32_t>(size());
+
+  // The keys are sorted, so the prefix common to all of them is the one of
+  // the first and the last
+  size_t common_prefix_size = 0;
+  if (num_restarts > 0) {
+    const Slice first = KeyAt(0);
+    const Slice last = KeyAt(num_restarts - 1);
+    common_prefix_size = first.difference_offset(last);
+  }
+
+  for (uint32_t i = 0; i < num_restarts; i++) {
+    Slice key = KeyAt(i);
+    key.remove_prefix(common_prefix_size);
+    PutFixed64(buffer, KeyToInteger(key));
+  }
+  buffer->append(keys_.data(), common_prefix_size);
+  PutFixed32(buffer, static_cast<uint32_t>(common_prefix_size));
+  PutFixed32(buffer, num_restarts);
+}
+
+}  // namespace rocksdb
@@ -0,0 +1,103 @@
+//  Copyright (c) 2011-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+#pragma once
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+#include "rocksdb/slice.h"
+#include "rocksdb/status.h"
+
+namespace rocksdb {
+
+// RestartKeyPrefixes maps every restart point of a block to a fixed-width
+// integer made of the first 8 bytes of its user key that follow the prefix
+// common to all of them, padded with zeros. They are stored in the
+// "rocksdb.interpolationindex.keyprefixes" metablock for the index block of
+// the kInterpolationSearch index type, and at the end of the data blocks of
+// the kDataBlockBinaryAndKeyPrefixes data block index type.
+//
+// With a bytewise comparator these integers are sorted like the keys, and a
+// strictly smaller (resp. greater) integer means a strictly smaller (resp.
+// greater) key. A seek first looks the integer of the target up in this
+// contiguous array, with an interpolation search, which narrows the binary
+// search over the restart points of the block down to the restart points
+// that have the same integer as the target. Usually there are at most a
+// couple of them, so that few or no keys of the block get decoded.
+//
+// The key prefixes are laid out as:
+//
+// +-------------------------+-----+-------------------------+
+// | fixed64 of restart 0    | ... | fixed64 of restart n-1  |
+// +-------------------------+-----+-------------------------+
+// | common prefix: L bytes  | L: fixed32 | n: fixed32       |
+// +-------------------------+------------+------------------+
+class RestartKeyPrefixes {
+ public:
+  RestartKeyPrefixes()
+      : data_(nullptr), num_restarts_(0), common_prefix_size_(0) {}
+
+  // Reads the key prefixes that end where `data` ends, and returns in *size
+  // the number of bytes they take. The bytes must outlive this object.
+  // Returns Corruption if they are not well formed.
+  Status Initialize(const Slice& data, size_t* size);
+
+  bool Valid() const { return data_ != nullptr; }
+
+  // Looks up user_key, and returns in [*left, *right] the range of restart
+  // points that BlockIter::BinarySeek() has to search: all the restart
+  // points before *left have a smaller key, the ones after *right a greater
+  // key.
+  void Narrow(const Slice& user_key, uint32_t* left, uint32_t* right) const;
+
+  uint32_t num_restarts() const { return num_restarts_; }
+
+ private:
+  uint64_t KeyPrefixAt(uint32_t i) const;
+  // Follows the integers
+  Slice common_prefix() const {
+    return Slice(data_ + num_restarts_ * sizeof(uint64_t),
+                 common_prefix_size_);
+  }
+  // Index of the first restart point, from `left` on, whose integer is
+  // greater than (or equal to, if !strict) target
+  uint32_t Search(uint64_t target, bool strict, uint32_t left) const;
+
+  // Kept small, as every Block embeds one
+  const char* data_;
+  uint32_t num_restarts_;
+  uint32_t common_prefix_size_;
+};
+
+// Collects the user keys of the restart points of a block and encodes them
+// for RestartKeyPrefixes.
+class RestartKeyPrefixesBuilder {
+ public:
+  // REQUIRES: user_key is >= the keys added before, in bytewise order
+  void Add(const Slice& user_key);
+
+  // Number of keys added
+  size_t size() const { return key_offsets_.size(); }
+
+  // Upper bound of the number of bytes Finish() appends
+  size_t EstimateSize() const;
+
+  // Appends the key prefixes to buffer
+  void Finish(std::string* buffer) const;
+
+  void Reset() {
+    keys_.clear();
+    key_offsets_.clear();
+  }
+
+ private:
+  Slice KeyAt(size_t i) const;
+
+  std::string keys_;
+  std::vector<uint32_t> key_offsets_;
+};
+
+}  // namespace rocksdb
@@ -12,6 +12,7 @@
 #include "db/range_tombstone_fragmenter.h"
 #include "rocksdb/slice_transform.h"
 #include "table/internal_iterator.h"
+#include "table/multiget_context.h"
 
 namespace rocksdb {
 
@@ -86,6 +87,23 @@ class TableReader {
                      const SliceTransform* prefix_extractor,
                      bool skip_filters = false) = 0;
 
+  // Batched version of Get(). keys are sorted in ascending order and each
+  // key carries its own GetContext. The result of the lookup of every key is
+  // stored in its KeyContext::s.
+  //
+  // The default implementation looks the keys up one at a time. Table
+  // formats that can share work between keys, e.g. the index and filter
+  // lookups, should override it.
+  virtual void MultiGet(const ReadOptions& readOptions,
+                        const MultiGetRange& keys,
+                        const SliceTransform* prefix_extractor,
+                        bool skip_filters = false) {
+    for (auto* key : keys) {
+      *key->s = Get(readOptions, key->internal_key(), key->get_context,
+                    prefix_extractor, skip_filters);
+    }
+  }
+
   // Prefetch data corresponding to a give range of keys
   // Typically this functionality is required for table implementations that
   // persists the data on a non volatile storage medium like disk/SSD
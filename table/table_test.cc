@@ -1796,6 +1796,91 @@ TEST_P(BlockBasedTableTest, HashIndexTest) {
   IndexTest(table_options);
 }
 
+TEST_P(BlockBasedTableTest, InterpolationIndexTest) {
+  BlockBasedTableOptions table_options = GetBlockBasedTableOptions();
+  table_options.index_type = BlockBasedTableOptions::kInterpolationSearch;
+  IndexTest(table_options);
+}
+
+TEST_P(BlockBasedTableTest, InterpolationIndexSeek) {
+  // Keys that share a long prefix, keys that only differ after the bytes
+  // stored in the key prefixes, keys that are prefixes of other keys
+  std::vector<std::string> user_keys = {"key", "key_", "key_a"};
+  for (int i = 0; i < 300; i++) {
+    char buf[32];
+    snprintf(buf, sizeof(buf), "key_%016d", i * 7);
+    user_keys.push_back(buf);
+    snprintf(buf, sizeof(buf), "key_samebytes%04d", i);
+    user_keys.push_back(buf);
+  }
+  std::vector<std::string> targets = {"", "a", "key", "key_", "kez", "zzz",
+                                      "key_samebytes", "key_samebytes9"};
+  for (const auto& user_key : user_keys) {
+    targets.push_back(user_key);
+    targets.push_back(user_key + '\0');
+    targets.push_back(user_key.substr(0, user_key.size() - 1));
+  }
+
+  for (const Comparator* comparator :
+       {BytewiseComparator(), ReverseBytewiseComparator()}) {
+    for (int restart_interval : {1, 3}) {
+      uint64_t index_size[2];
+      for (int interpolation = 0; interpolation < 2; interpolation++) {
+        Options options;
+        options.comparator = comparator;
+        BlockBasedTableOptions table_options = GetBlockBasedTableOptions();
+        // Make each key/value an individual block
+        table_options.block_size = 64;
+        table_options.index_block_restart_interval = restart_interval;
+        table_options.index_type =
+            interpolation ? BlockBasedTableOptions::kInterpolationSearch
+                          : BlockBasedTableOptions::kBinarySearch;
+        options.table_factory.reset(new BlockBasedTableFactory(table_options));
+
+        TableConstructor c(comparator, true /* convert_to_internal_key_ */);
+        for (const auto& user_key : user_keys) {
+          c.Add(user_key, std::string(64, 'v'));
+        }
+        std::vector<std::string> keys;
+        stl_wrappers::KVMap kvmap;
+        const ImmutableCFOptions ioptions(options);
+        const MutableCFOptions moptions(options);
+        const InternalKeyComparator icomparator(comparator);
+        c.Finish(options, ioptions, moptions, table_options, icomparator,
+                 &keys, &kvmap);
+        auto props = c.GetTableReader()->GetTableProperties();
+        ASSERT_EQ(user_keys.size(), props->num_data_blocks);
+        index_size[interpolation] = props->index_size;
+
+        std::unique_ptr<InternalIterator> iter(c.GetTableReader()->NewIterator(
+            ReadOptions(), moptions.prefix_extractor.get()));
+        for (const auto& target : targets) {
+          iter->Seek(InternalKey(target, kMaxSequenceNumber, kTypeValue)
+                         .Encode());
+          ASSERT_OK(iter->status());
+          auto expected = kvmap.lower_bound(target);
+          if (expected == kvmap.end()) {
+            ASSERT_FALSE(iter->Valid()) << target;
+          } else {
+            ASSERT_TRUE(iter->Valid()) << target;
+            ASSERT_EQ(expected->first, ExtractUserKey(iter->key()).ToString())
+                << target;
+          }
+        }
+        c.ResetTableReader();
+      }
+      // The key prefixes are only written with a bytewise comparator
+      const uint64_t num_restarts =
+          (user_keys.size() + restart_interval - 1) / restart_interval;
+      if (comparator == BytewiseComparator()) {
+        ASSERT_GE(index_size[1], index_size[0] + num_restarts * 8);
+      } else {
+        ASSERT_EQ(index_size[1], index_size[0]);
+      }
+    }
+  }
+}
+
 TEST_P(BlockBasedTableTest, PartitionIndexTest) {
   const int max_index_keys = 5;
   const int est_max_index_key_value_size = 32;
@@ -3576,13 +3661,13 @@ TEST_P(BlockBasedTableTest, PropertiesBlockRestartPointTest) {
                                 BlockContents* contents) {
       ReadOptions read_options;
       read_options.verify_checksums = false;
-      Slice compression_dict;
       PersistentCacheOptions cache_options;
 
       BlockFetcher block_fetcher(
           file, nullptr /* prefetch_buffer */, footer, read_options, handle,
           contents, ioptions, false /* decompress */,
-          false /*maybe_compressed*/, compression_dict, cache_options);
+          false /*maybe_compressed*/, UncompressionDict::GetEmptyDict(),
+          cache_options);
 
       ASSERT_OK(block_fetcher.ReadBlockContents());
     };
@@ -3663,13 +3748,12 @@ TEST_P(BlockBasedTableTest, PropertiesMetaBlockLast) {
   // read metaindex
   auto metaindex_handle = footer.metaindex_handle();
   BlockContents metaindex_contents;
-  Slice compression_dict;
   PersistentCacheOptions pcache_opts;
   BlockFetcher block_fetcher(
       table_reader.get(), nullptr /* prefetch_buffer */, footer, ReadOptions(),
       metaindex_handle, &metaindex_contents, ioptions, false /* decompress */,
-      false /*maybe_compressed*/, compression_dict, pcache_opts,
-      nullptr /*memory_allocator*/);
+      false /*maybe_compressed*/, UncompressionDict::GetEmptyDict(),
+      pcache_opts, nullptr /*memory_allocator*/);
   ASSERT_OK(block_fetcher.ReadBlockContents());
   Block metaindex_block(std::move(metaindex_contents),
                         kDisableGlobalSequenceNumber);
@@ -3717,6 +3801,253 @@ TEST_P(BlockBasedTableTest, BadOptions) {
   ASSERT_NOK(rocksdb::DB::Open(options, kDBPath, &db));
 }
 
+TEST_P(BlockBasedTableTest, ParallelCompression) {
+  // The blocks of compression types that are not supported are written
+  // uncompressed, but still go through the compression threads
+  CompressionType compression_type =
+      ZSTD_Supported() ? kZSTD : kSnappyCompression;
+  Options options;
+  options.compression = compression_type;
+  InternalKeyComparator ikc(options.comparator);
+  std::vector<std::unique_ptr<IntTblPropCollectorFactory>>
+      int_tbl_prop_collector_factories;
+  std::string column_family_name;
+
+  auto build_table = [&](const BlockBasedTableOptions& bbto,
+                         uint32_t parallel_threads, std::string* contents) {
+    options.table_factory.reset(NewBlockBasedTableFactory(bbto));
+    const ImmutableCFOptions ioptions(options);
+    const MutableCFOptions moptions(options);
+    CompressionOptions compression_opts;
+    compression_opts.parallel_threads = parallel_threads;
+    test::StringSink* sink = new test::StringSink();
+    std::unique_ptr<WritableFileWriter> file_writer(
+        test::GetWritableFileWriter(sink, "" /* don't care */));
+    std::unique_ptr<TableBuilder> builder(
+        options.table_factory->NewTableBuilder(
+            TableBuilderOptions(ioptions, moptions, ikc,
+                                &int_tbl_prop_collector_factories,
+                                compression_type, compression_opts,
+                                nullptr /* compression_dict */,
+                                false /* skip_filters */, column_family_name,
+                                -1),
+            TablePropertiesCollectorFactory::Context::kUnknownColumnFamily,
+            file_writer.get()));
+    Random rnd(301);
+    for (int i = 0; i < 20000; ++i) {
+      char key[16];
+      snprintf(key, sizeof(key), "%08d", i);
+      std::string value;
+      test::CompressibleString(&rnd, 0.5, 100, &value);
+      InternalKey ik(key, 0, kTypeValue);
+      builder->Add(ik.Encode(), value);
+      ASSERT_OK(builder->status());
+    }
+    ASSERT_OK(builder->Finish());
+    ASSERT_OK(file_writer->Flush());
+    ASSERT_EQ(sink->contents().size(), builder->FileSize());
+    *contents = sink->contents();
+  };
+
+  BlockBasedTableOptions full_filter = GetBlockBasedTableOptions();
+  full_filter.filter_policy.reset(NewBloomFilterPolicy(10, false));
+  BlockBasedTableOptions block_based_filter = GetBlockBasedTableOptions();
+  block_based_filter.filter_policy.reset(NewBloomFilterPolicy(10, true));
+  BlockBasedTableOptions partitioned = GetBlockBasedTableOptions();
+  partitioned.index_type = BlockBasedTableOptions::kTwoLevelIndexSearch;
+  partitioned.partition_filters = true;
+  partitioned.metadata_block_size = 512;
+  partitioned.filter_policy.reset(NewBloomFilterPolicy(10, false));
+
+  // The data blocks, and the index and filter built from their handles, are
+  // the same as with a single thread
+  for (const auto& bbto : {full_filter, block_based_filter, partitioned}) {
+    std::string expected;
+    build_table(bbto, 1, &expected);
+    std::string contents;
+    build_table(bbto, 4, &contents);
+    ASSERT_EQ(expected, contents);
+  }
+}
+
+TEST_P(BlockBasedTableTest, SharedUncompressionDict) {
+  Options options;
+  options.compression = ZSTD_Supported() ? kZSTD : kNoCompression;
+  BlockBasedTableOptions bbto = GetBlockBasedTableOptions();
+  bbto.block_cache = NewLRUCache(8 << 20);
+  options.table_factory.reset(NewBlockBasedTableFactory(bbto));
+  const ImmutableCFOptions ioptions(options);
+  const MutableCFOptions moptions(options);
+  InternalKeyComparator ikc(options.comparator);
+  std::vector<std::unique_ptr<IntTblPropCollectorFactory>>
+      int_tbl_prop_collector_factories;
+  std::string column_family_name;
+  uint64_t next_file_id = 1;
+
+  auto open_table = [&](const std::string& compression_dict,
+                        std::unique_ptr<TableReader>* table_reader) {
+    test::StringSink* sink = new test::StringSink();
+    std::unique_ptr<WritableFileWriter> file_writer(
+        test::GetWritableFileWriter(sink, "" /* don't care */));
+    std::unique_ptr<TableBuilder> builder(
+        options.table_factory->NewTableBuilder(
+            TableBuilderOptions(ioptions, moptions, ikc,
+                                &int_tbl_prop_collector_factories,
+                                options.compression, CompressionOptions(),
+                                &compression_dict, false /* skip_filters */,
+                                column_family_name, -1),
+            TablePropertiesCollectorFactory::Context::kUnknownColumnFamily,
+            file_writer.get()));
+    for (char c = 'a'; c <= 'z'; ++c) {
+      std::string key(8, c);
+      InternalKey ik(key, 0, kTypeValue);
+      builder->Add(ik.Encode(), compression_dict + key);
+    }
+    ASSERT_OK(builder->Finish());
+    ASSERT_OK(file_writer->Flush());
+
+    std::unique_ptr<RandomAccessFileReader> file_reader(
+        test::GetRandomAccessFileReader(
+            new test::StringSource(sink->contents(), next_file_id++, false)));
+    ASSERT_OK(options.table_factory->NewTableReader(
+        TableReaderOptions(ioptions, moptions.prefix_extractor.get(),
+                           EnvOptions(), ikc),
+        std::move(file_reader), sink->contents().size(), table_reader));
+
+    std::unique_ptr<InternalIterator> iter((*table_reader)->NewIterator(
+        ReadOptions(), moptions.prefix_extractor.get()));
+    iter->SeekToFirst();
+    ASSERT_TRUE(iter->Valid());
+    ASSERT_EQ(compression_dict + "aaaaaaaa", iter->value().ToString());
+  };
+
+  const std::string dict1(1000, 'x');
+  const std::string dict2(1000, 'y');
+  std::unique_ptr<TableReader> table1;
+  open_table(dict1, &table1);
+  size_t dict1_usage = bbto.block_cache->GetPinnedUsage();
+  ASSERT_GE(dict1_usage, dict1.size());
+
+  // The tables using the same dictionary share it through the block cache
+  std::unique_ptr<TableReader> table2;
+  open_table(dict1, &table2);
+  ASSERT_EQ(dict1_usage, bbto.block_cache->GetPinnedUsage());
+  std::unique_ptr<TableReader> table3;
+  open_table(dict2, &table3);
+  ASSERT_GT(bbto.block_cache->GetPinnedUsage(), dict1_usage);
+
+  table1.reset();
+  table2.reset();
+  table3.reset();
+  ASSERT_EQ(0, bbto.block_cache->GetPinnedUsage());
+}
+
+TEST_P(BlockBasedTableTest, AdaptiveCompression) {
+  // Without the compression libraries, none of the types compresses the
+  // samples and the data blocks are written uncompressed
+  Options options;
+  options.compression = ZSTD_Supported() ? kZSTD : kSnappyCompression;
+  options.adaptive_compression_types = {kLZ4Compression, kZSTD,
+                                        kSnappyCompression};
+  options.statistics = CreateDBStatistics();
+  options.table_factory.reset(
+      NewBlockBasedTableFactory(GetBlockBasedTableOptions()));
+  const ImmutableCFOptions ioptions(options);
+  const MutableCFOptions moptions(options);
+  InternalKeyComparator ikc(options.comparator);
+  std::vector<std::unique_ptr<IntTblPropCollectorFactory>>
+      int_tbl_prop_collector_factories;
+  std::string column_family_name;
+  const int kNumKeys = 20000;
+
+  for (uint32_t parallel_threads : {1, 4}) {
+    options.statistics->Reset();
+    CompressionOptions compression_opts;
+    compression_opts.parallel_threads = parallel_threads;
+    test::StringSink* sink = new test::StringSink();
+    std::unique_ptr<WritableFileWriter> file_writer(
+        test::GetWritableFileWriter(sink, "" /* don't care */));
+    std::unique_ptr<TableBuilder> builder(
+        options.table_factory->NewTableBuilder(
+            TableBuilderOptions(ioptions, moptions, ikc,
+                                &int_tbl_prop_collector_factories,
+                                options.compression, compression_opts,
+                                nullptr /* compression_dict */,
+                                false /* skip_filters */, column_family_name,
+                                -1),
+            TablePropertiesCollectorFactory::Context::kUnknownColumnFamily,
+            file_writer.get()));
+    Random rnd(301);
+    std::vector<std::string> values;
+    for (int i = 0; i < kNumKeys; ++i) {
+      char key[16];
+      snprintf(key, sizeof(key), "%08d", i);
+      std::string value;
+      // Alternate compressible and incompressible ranges of keys
+      test::CompressibleString(&rnd, (i / 4000) % 2 ? 1.0 : 0.3, 100, &value);
+      InternalKey ik(key, 0, kTypeValue);
+      builder->Add(ik.Encode(), value);
+      ASSERT_OK(builder->status());
+      values.push_back(value);
+    }
+    ASSERT_OK(builder->Finish());
+    ASSERT_OK(file_writer->Flush());
+
+    std::unique_ptr<RandomAccessFileReader> file_reader(
+        test::GetRandomAccessFileReader(
+            new test::StringSource(sink->contents(), 73342, false)));
+    std::unique_ptr<TableReader> table_reader;
+    ASSERT_OK(options.table_factory->NewTableReader(
+        TableReaderOptions(ioptions, moptions.prefix_extractor.get(),
+                           EnvOptions(), ikc),
+        std::move(file_reader), sink->contents().size(), &table_reader));
+
+    // The data blocks counted per compression type add up to all of them
+    auto props = table_reader->GetTableProperties();
+    auto it = props->user_collected_properties.find(
+        BlockBasedTablePropertyNames::kCompressionTypes);
+    ASSERT_TRUE(it != props->user_collected_properties.end());
+    uint64_t num_blocks = 0;
+    uint64_t num_uncompressed = 0;
+    for (const auto& type_count : StringSplit(it->second, ',')) {
+      size_t sep = type_count.find(':');
+      ASSERT_NE(std::string::npos, sep);
+      uint64_t count = ParseUint64(type_count.substr(sep + 1));
+      num_blocks += count;
+      if (type_count.substr(0, sep) ==
+          CompressionTypeToString(kNoCompression)) {
+        num_uncompressed = count;
+      }
+    }
+    ASSERT_EQ(props->num_data_blocks, num_blocks);
+    // The first 4 data blocks of each region of 64 are sampled
+    ASSERT_EQ(num_blocks / 64 * 4 + std::min<uint64_t>(num_blocks % 64, 4),
+              options.statistics->getTickerCount(
+                  ADAPTIVE_COMPRESSION_SAMPLED_BLOCKS));
+    ASSERT_LE(options.statistics->getTickerCount(
+                  ADAPTIVE_COMPRESSION_SKIPPED_BLOCKS),
+              num_uncompressed);
+    if (!Snappy_Supported() && !ZSTD_Supported() && !LZ4_Supported()) {
+      ASSERT_EQ(num_blocks, num_uncompressed);
+      ASSERT_EQ(0, options.statistics->getTickerCount(
+                       ADAPTIVE_COMPRESSION_ALTERNATE_BLOCKS));
+    } else {
+      // The incompressible ranges are not compressed
+      ASSERT_GT(num_uncompressed, 0);
+      ASSERT_LT(num_uncompressed, num_blocks);
+    }
+
+    std::unique_ptr<InternalIterator> iter(table_reader->NewIterator(
+        ReadOptions(), moptions.prefix_extractor.get()));
+    int i = 0;
+    for (iter->SeekToFirst(); iter->Valid(); iter->Next(), ++i) {
+      ASSERT_EQ(values[i], iter->value().ToString());
+    }
+    ASSERT_OK(iter->status());
+    ASSERT_EQ(kNumKeys, i);
+  }
+}
+
 TEST_F(BBTTailPrefetchTest, TestTailPrefetchStats) {
   TailPrefetchStats tpstats;
   ASSERT_EQ(0, tpstats.GetSuggestedPrefetchSize());
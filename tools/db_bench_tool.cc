@@ -413,6 +413,20 @@ DEFINE_double(cache_high_pri_pool_ratio, 0.0,
 DEFINE_bool(use_clock_cache, false,
             "Replace default LRU block cache with clock cache.");
 
+DEFINE_double(compressed_tier_ratio, 0.0,
+              "If > 0.0, replace default LRU block cache with a "
+              "CompressedTieredCache that gives this fraction of cache_size "
+              "to its compressed tier.");
+
+DEFINE_string(compressed_tier_compression_type, "lz4",
+              "Algorithm of the compressed tier of the block cache, if "
+              "compressed_tier_ratio > 0.0.");
+
+DEFINE_bool(cache_admission_filter, false,
+            "Only admit a block into the LRU block cache if it is read more "
+            "often than the block it would evict, see "
+            "LRUCacheOptions::use_admission_filter.");
+
 DEFINE_int64(simcache_size, -1,
              "Number of bytes to use as a simcache of "
              "uncompressed data. Nagative value disables simcache.");
@@ -476,6 +490,11 @@ DEFINE_bool(use_data_block_hash_index, false,
             "instead of kDataBlockBinarySearch. "
             "This is valid if only we use BlockTable");
 
+DEFINE_bool(use_data_block_key_prefixes, false,
+            "if use kDataBlockBinaryAndKeyPrefixes "
+            "instead of kDataBlockBinarySearch. "
+            "This is valid if only we use BlockTable");
+
 DEFINE_double(data_block_hash_table_util_ratio, 0.75,
               "util ratio for data block hash index table. "
               "This is only valid if use_data_block_hash_index is "
@@ -512,6 +531,9 @@ DEFINE_int32(bloom_bits, -1, "Bloom filter bits per key. Negative means"
 DEFINE_double(memtable_bloom_size_ratio, 0,
               "Ratio of memtable size used for bloom filter. 0 means no bloom "
               "filter.");
+DEFINE_double(memtable_hash_index_size_ratio, 0,
+              "Ratio of memtable size used for the hash index of the user "
+              "keys. 0 means no hash index.");
 DEFINE_bool(memtable_use_huge_page, false,
             "Try to use huge page in memtables.");
 
@@ -801,6 +823,27 @@ DEFINE_int32(compression_zstd_max_train_bytes,
              "Maximum size of training data passed to zstd's dictionary "
              "trainer.");
 
+DEFINE_int32(compression_parallel_threads,
+             rocksdb::CompressionOptions().parallel_threads,
+             "Number of threads compressing the data blocks of each SST "
+             "file.");
+
+DEFINE_int32(compression_shared_dict_max_files,
+             rocksdb::CompressionOptions().shared_dict_max_files,
+             "If positive, the compression dictionary trained by a bottommost "
+             "compaction is reused for this many output files.");
+
+DEFINE_string(adaptive_compression_types, "",
+              "Comma separated list of compression types the data blocks "
+              "may be compressed with instead of the compression type of "
+              "their file, chosen by sampling them.");
+
+DEFINE_double(adaptive_compression_min_ratio,
+              rocksdb::Options().adaptive_compression_min_ratio,
+              "Data blocks are left uncompressed when no compression type "
+              "reaches this compression ratio on the samples of their "
+              "region.");
+
 DEFINE_int32(min_level_to_compress, -1, "If non-negative, compression starts"
              " from this level. Levels with number < min_level_to_compress are"
              " not compressed. Otherwise, apply compression_type to "
@@ -874,6 +917,23 @@ DEFINE_uint64(delayed_write_rate, 8388608u,
 DEFINE_bool(enable_pipelined_write, true,
             "Allow WAL and memtable writes to be pipelined");
 
+DEFINE_bool(unordered_write, false,
+            "Let each writer insert into the memtables on its own, after the "
+            "write group leader wrote the WAL. Requires "
+            "--enable_pipelined_write=false");
+
+DEFINE_string(wal_compression, "none",
+              "Algorithm used to compress the WAL records: none, zlib, lz4 "
+              "or zstd");
+
+DEFINE_int32(wal_recovery_threads, 1,
+             "Number of threads used to recover the WAL files when opening "
+             "the DB");
+
+DEFINE_int32(max_flush_subranges, 1,
+             "Maximum number of key ranges a flush is split into, each one "
+             "written to its own L0 file in parallel");
+
 DEFINE_bool(allow_concurrent_memtable_write, true,
             "Allow multi-writers to update mem tables in parallel.");
 
@@ -1082,6 +1142,9 @@ DEFINE_double(cuckoo_hash_ratio, 0.9, "Hash ratio for Cuckoo SST table.");
 DEFINE_bool(use_hash_search, false, "if use kHashSearch "
             "instead of kBinarySearch. "
             "This is valid if only we use BlockTable");
+DEFINE_bool(use_interpolation_search, false, "if use kInterpolationSearch "
+            "instead of kBinarySearch. "
+            "This is valid if only we use BlockTable");
 DEFINE_bool(use_block_based_filter, false, "if use kBlockBasedFilter "
             "instead of kFullFilter for filter block. "
             "This is valid if only we use BlockTable");
@@ -2287,10 +2350,28 @@ class Benchmark {
         exit(1);
       }
       return cache;
+    } else if (FLAGS_compressed_tier_ratio > 0.0) {
+      CompressedTieredCacheOptions cache_opts;
+      cache_opts.capacity = (size_t)capacity;
+      cache_opts.compressed_tier_ratio = FLAGS_compressed_tier_ratio;
+      cache_opts.compression_type = StringToCompressionType(
+          FLAGS_compressed_tier_compression_type.c_str());
+      cache_opts.num_shard_bits = FLAGS_cache_numshardbits;
+      cache_opts.high_pri_pool_ratio = FLAGS_cache_high_pri_pool_ratio;
+      cache_opts.statistics = dbstats;
+      auto cache = NewCompressedTieredCache(cache_opts);
+      if (!cache) {
+        fprintf(stderr, "Invalid compressed_tier_ratio.\n");
+        exit(1);
+      }
+      return cache;
     } else {
-      return NewLRUCache((size_t)capacity, FLAGS_cache_numshardbits,
-                         false /*strict_capacity_limit*/,
-                         FLAGS_cache_high_pri_pool_ratio);
+      LRUCacheOptions cache_opts((size_t)capacity, FLAGS_cache_numshardbits,
+                                 false /*strict_capacity_limit*/,
+                                 FLAGS_cache_high_pri_pool_ratio);
+      cache_opts.use_admission_filter = FLAGS_cache_admission_filter;
+      cache_opts.statistics = dbstats;
+      return NewLRUCache(cache_opts);
     }
   }
 
@@ -3188,6 +3269,8 @@ void VerifyDBFromDB(std::string& truth_db_name) {
     }
     options.memtable_huge_page_size = FLAGS_memtable_use_huge_page ? 2048 : 0;
     options.memtable_prefix_bloom_size_ratio = FLAGS_memtable_bloom_size_ratio;
+    options.memtable_hash_index_size_ratio =
+        FLAGS_memtable_hash_index_size_ratio;
     if (FLAGS_memtable_insert_with_hint_prefix_size > 0) {
       options.memtable_insert_with_hint_prefix_extractor.reset(
           NewCappedPrefixTransform(
@@ -3296,6 +3379,9 @@ void VerifyDBFromDB(std::string& truth_db_name) {
           exit(1);
         }
         block_based_options.index_type = BlockBasedTableOptions::kHashSearch;
+      } else if (FLAGS_use_interpolation_search) {
+        block_based_options.index_type =
+            BlockBasedTableOptions::kInterpolationSearch;
       } else {
         block_based_options.index_type = BlockBasedTableOptions::kBinarySearch;
       }
@@ -3341,6 +3427,9 @@ void VerifyDBFromDB(std::string& truth_db_name) {
       if (FLAGS_use_data_block_hash_index) {
         block_based_options.data_block_index_type =
             rocksdb::BlockBasedTableOptions::kDataBlockBinaryAndHash;
+      } else if (FLAGS_use_data_block_key_prefixes) {
+        block_based_options.data_block_index_type =
+            rocksdb::BlockBasedTableOptions::kDataBlockBinaryAndKeyPrefixes;
       } else {
         block_based_options.data_block_index_type =
             rocksdb::BlockBasedTableOptions::kDataBlockBinarySearch;
@@ -3434,6 +3523,12 @@ void VerifyDBFromDB(std::string& truth_db_name) {
     options.enable_write_thread_adaptive_yield =
         FLAGS_enable_write_thread_adaptive_yield;
     options.enable_pipelined_write = FLAGS_enable_pipelined_write;
+    options.unordered_write = FLAGS_unordered_write;
+    options.wal_compression =
+        StringToCompressionType(FLAGS_wal_compression.c_str());
+    options.wal_recovery_threads = FLAGS_wal_recovery_threads;
+    options.max_flush_subranges =
+        static_cast<uint32_t>(FLAGS_max_flush_subranges);
     options.write_thread_max_yield_usec = FLAGS_write_thread_max_yield_usec;
     options.write_thread_slow_yield_usec = FLAGS_write_thread_slow_yield_usec;
     options.rate_limit_delay_max_milliseconds =
@@ -3512,6 +3607,17 @@ void VerifyDBFromDB(std::string& truth_db_name) {
     options.compression_opts.max_dict_bytes = FLAGS_compression_max_dict_bytes;
     options.compression_opts.zstd_max_train_bytes =
         FLAGS_compression_zstd_max_train_bytes;
+    options.compression_opts.parallel_threads =
+        static_cast<uint32_t>(FLAGS_compression_parallel_threads);
+    options.compression_opts.shared_dict_max_files =
+        static_cast<uint32_t>(FLAGS_compression_shared_dict_max_files);
+    for (const auto& type :
+         StringSplit(FLAGS_adaptive_compression_types, ',')) {
+      options.adaptive_compression_types.push_back(
+          StringToCompressionType(type.c_str()));
+    }
+    options.adaptive_compression_min_ratio =
+        FLAGS_adaptive_compression_min_ratio;
     // If this is a block based table, set some related options
     if (options.table_factory->Name() == BlockBasedTableFactory::kName &&
         options.table_factory->GetOptions() != nullptr) {
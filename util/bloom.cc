@@ -16,6 +16,16 @@
 #include "util/coding.h"
 #include "util/hash.h"
 
+#if defined(__x86_64__) || defined(_M_X64)
+#if defined(__GNUC__) || defined(_MSC_VER)
+#define BLOCKED_BLOOM_X86
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+#endif
+
 namespace rocksdb {
 
 class BlockBasedFilterBlockBuilder;
@@ -265,12 +275,282 @@ bool FullFilterBitsReader::HashMayMatch(const uint32_t& hash,
   return true;
 }
 
+// Blocked Bloom filter, a.k.a. split block Bloom filter
+//
+// The filter is an array of 32 byte blocks, each made of 8 32-bit words. A
+// key picks a block, then sets exactly one bit in each of its 8 words. All
+// the probes of a key are thus in the same cache line, and can be checked at
+// once: build the 8 word mask of the key, and test that all its bits are set
+// in the block, which is a single instruction with AVX2. The false positive
+// rate is slightly higher than with the legacy format, in exchange for a
+// constant number of branch-free probes.
+//
+// Format:
+// +----------------------------------------------------------------+
+// |           blocks, num_blocks * 32 bytes                        |
+// +----------------------------------------------------------------+
+// | kBlockedBloomMarker : 1 byte | 0 : 1 byte | num_blocks : 4 bytes |
+// +----------------------------------------------------------------+
+// The 0 byte is where the legacy full filter stores its number of probes.
+// Readers that do not know this format take a filter with 0 probes as
+// broken, and treat it as matching everything.
+const uint32_t kBlockedBloomBlockSize = 32;
+const uint32_t kBlockedBloomMetadataLen = 6;
+const char kBlockedBloomMarker = 1;
+
+// Odd constants, the bit set in word i is given by the top 5 bits of
+// hash * kBlockedBloomSalt[i]
+const uint32_t kBlockedBloomSalt[8] = {0x47b6137bU, 0x44974d91U, 0x8824ad5bU,
+                                       0xa2b7289dU, 0x705495c7U, 0x2df1424bU,
+                                       0x9efc4947U, 0x5c6bfb31U};
+
+inline uint32_t BlockedBloomBlock(uint32_t hash, uint32_t num_blocks) {
+  return static_cast<uint32_t>((uint64_t{hash} * num_blocks) >> 32);
+}
+
+inline void BlockedBloomMask(uint32_t hash, uint32_t mask[8]) {
+  for (int i = 0; i < 8; i++) {
+    mask[i] = uint32_t{1} << ((hash * kBlockedBloomSalt[i]) >> 27);
+  }
+}
+
+bool BlockedBloomMayMatchPortable(uint32_t hash, const char* block) {
+  uint32_t mask[8];
+  BlockedBloomMask(hash, mask);
+  uint32_t missing = 0;
+  for (int i = 0; i < 8; i++) {
+    missing |= mask[i] & ~DecodeFixed32(block + 4 * i);
+  }
+  return missing == 0;
+}
+
+#ifdef BLOCKED_BLOOM_X86
+#ifdef _MSC_VER
+#define BLOCKED_BLOOM_TARGET(isa)
+#else
+#define BLOCKED_BLOOM_TARGET(isa) __attribute__((__target__(isa)))
+#endif
+
+BLOCKED_BLOOM_TARGET("avx2")
+bool BlockedBloomMayMatchAVX2(uint32_t hash, const char* block) {
+  const __m256i salt = _mm256_loadu_si256(
+      reinterpret_cast<const __m256i*>(kBlockedBloomSalt));
+  __m256i shift =
+      _mm256_srli_epi32(_mm256_mullo_epi32(_mm256_set1_epi32(hash), salt), 27);
+  __m256i mask = _mm256_sllv_epi32(_mm256_set1_epi32(1), shift);
+  __m256i bits = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block));
+  // All the bits of mask are set in bits
+  return _mm256_testc_si256(bits, mask) != 0;
+}
+
+BLOCKED_BLOOM_TARGET("sse4.1")
+bool BlockedBloomMayMatchSSE41(uint32_t hash, const char* block) {
+  const __m128i h = _mm_set1_epi32(hash);
+  const __m128i* salt = reinterpret_cast<const __m128i*>(kBlockedBloomSalt);
+  const __m128i* bits = reinterpret_cast<const __m128i*>(block);
+  for (int i = 0; i < 2; i++) {
+    __m128i shift = _mm_srli_epi32(
+        _mm_mullo_epi32(h, _mm_loadu_si128(salt + i)), 27);
+    // 1 << shift, without per lane shifts: build the float 2^shift, and
+    // truncate it to an integer. 2^31 is out of range and converts to
+    // 0x80000000, which happens to be the right mask.
+    __m128i mask = _mm_cvttps_epi32(_mm_castsi128_ps(
+        _mm_slli_epi32(_mm_add_epi32(shift, _mm_set1_epi32(127)), 23)));
+    if (!_mm_testc_si128(_mm_loadu_si128(bits + i), mask)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Returns the bits of CPUID leaf `leaf` in {eax, ebx, ecx, edx}
+void BlockedBloomCpuid(uint32_t leaf, uint32_t regs[4]) {
+#ifdef _MSC_VER
+  int info[4];
+  __cpuidex(info, static_cast<int>(leaf), 0);
+  for (int i = 0; i < 4; i++) {
+    regs[i] = static_cast<uint32_t>(info[i]);
+  }
+#else
+  __asm__("cpuid"
+          : "=a"(regs[0]), "=b"(regs[1]), "=c"(regs[2]), "=d"(regs[3])
+          : "a"(leaf), "c"(0));
+#endif
+}
+
+bool BlockedBloomHasAVX2() {
+  uint32_t regs[4];
+  BlockedBloomCpuid(0, regs);
+  if (regs[0] < 7) {
+    return false;
+  }
+  BlockedBloomCpuid(1, regs);
+  // The OS must save the AVX registers (OSXSAVE, then XCR0 bits 1 and 2)
+  if ((regs[2] & (1U << 27)) == 0 || (regs[2] & (1U << 28)) == 0) {
+    return false;
+  }
+#ifdef _MSC_VER
+  uint64_t xcr0 = _xgetbv(0);
+#else
+  uint32_t xcr0_lo, xcr0_hi;
+  __asm__("xgetbv" : "=a"(xcr0_lo), "=d"(xcr0_hi) : "c"(0));
+  uint64_t xcr0 = (uint64_t{xcr0_hi} << 32) | xcr0_lo;
+#endif
+  if ((xcr0 & 6) != 6) {
+    return false;
+  }
+  BlockedBloomCpuid(7, regs);
+  return (regs[1] & (1U << 5)) != 0;
+}
+
+bool BlockedBloomHasSSE41() {
+  uint32_t regs[4];
+  BlockedBloomCpuid(1, regs);
+  return (regs[2] & (1U << 19)) != 0;
+}
+#endif  // BLOCKED_BLOOM_X86
+
+typedef bool (*BlockedBloomMayMatchFunc)(uint32_t hash, const char* block);
+
+BlockedBloomMayMatchFunc ChooseBlockedBloomMayMatch() {
+#ifdef BLOCKED_BLOOM_X86
+  if (BlockedBloomHasAVX2()) {
+    return BlockedBloomMayMatchAVX2;
+  }
+  if (BlockedBloomHasSSE41()) {
+    return BlockedBloomMayMatchSSE41;
+  }
+#endif
+  return BlockedBloomMayMatchPortable;
+}
+
+inline bool BlockedBloomMayMatch(uint32_t hash, const char* block) {
+  static const BlockedBloomMayMatchFunc func = ChooseBlockedBloomMayMatch();
+  return func(hash, block);
+}
+
+bool IsBlockedBloomFilter(const Slice& contents) {
+  size_t len = contents.size();
+  return len >= kBlockedBloomMetadataLen &&
+         contents.data()[len - 6] == kBlockedBloomMarker &&
+         contents.data()[len - 5] == 0;
+}
+
+class BlockedBloomBitsBuilder : public FilterBitsBuilder {
+ public:
+  explicit BlockedBloomBitsBuilder(size_t bits_per_key)
+      : bits_per_key_(bits_per_key) {
+    assert(bits_per_key_);
+  }
+
+  virtual void AddKey(const Slice& key) override {
+    uint32_t hash = BloomHash(key);
+    if (hash_entries_.size() == 0 || hash != hash_entries_.back()) {
+      hash_entries_.push_back(hash);
+    }
+  }
+
+  virtual Slice Finish(std::unique_ptr<const char[]>* buf) override {
+    uint32_t num_blocks = CalculateNumBlocks(hash_entries_.size());
+    uint32_t len = num_blocks * kBlockedBloomBlockSize;
+    char* data = new char[len + kBlockedBloomMetadataLen];
+    memset(data, 0, len);
+    for (uint32_t hash : hash_entries_) {
+      char* block =
+          data + BlockedBloomBlock(hash, num_blocks) * kBlockedBloomBlockSize;
+      uint32_t mask[8];
+      BlockedBloomMask(hash, mask);
+      for (int i = 0; i < 8; i++) {
+        EncodeFixed32(block + 4 * i, DecodeFixed32(block + 4 * i) | mask[i]);
+      }
+    }
+    data[len] = kBlockedBloomMarker;
+    data[len + 1] = 0;
+    EncodeFixed32(data + len + 2, num_blocks);
+
+    const char* const_data = data;
+    buf->reset(const_data);
+    hash_entries_.clear();
+
+    return Slice(data, len + kBlockedBloomMetadataLen);
+  }
+
+  virtual int CalculateNumEntry(const uint32_t space) override {
+    assert(space > 0);
+    if (space < kBlockedBloomMetadataLen + kBlockedBloomBlockSize) {
+      return 0;
+    }
+    uint32_t num_blocks =
+        (space - kBlockedBloomMetadataLen) / kBlockedBloomBlockSize;
+    int n = static_cast<int>(uint64_t{num_blocks} * kBlockedBloomBlockSize *
+                             8 / bits_per_key_);
+    assert(CalculateNumBlocks(n) <= num_blocks);
+    return n;
+  }
+
+ private:
+  uint32_t CalculateNumBlocks(size_t num_entry) const {
+    if (num_entry == 0) {
+      return 0;
+    }
+    uint64_t total_bits = uint64_t{num_entry} * bits_per_key_;
+    return static_cast<uint32_t>(
+        (total_bits + kBlockedBloomBlockSize * 8 - 1) /
+        (kBlockedBloomBlockSize * 8));
+  }
+
+  size_t bits_per_key_;
+  std::vector<uint32_t> hash_entries_;
+
+  // No Copy allowed
+  BlockedBloomBitsBuilder(const BlockedBloomBitsBuilder&);
+  void operator=(const BlockedBloomBitsBuilder&);
+};
+
+class BlockedBloomBitsReader : public FilterBitsReader {
+ public:
+  explicit BlockedBloomBitsReader(const Slice& contents)
+      : data_(contents.data()), num_blocks_(0), broken_(false) {
+    assert(IsBlockedBloomFilter(contents));
+    uint32_t len = static_cast<uint32_t>(contents.size());
+    num_blocks_ = DecodeFixed32(data_ + len - 4);
+    if (uint64_t{num_blocks_} * kBlockedBloomBlockSize !=
+        len - kBlockedBloomMetadataLen) {
+      broken_ = true;
+    }
+  }
+
+  virtual bool MayMatch(const Slice& entry) override {
+    if (broken_) {
+      return true;
+    }
+    if (num_blocks_ == 0) {
+      return false;
+    }
+    uint32_t hash = BloomHash(entry);
+    return BlockedBloomMayMatch(
+        hash, data_ + BlockedBloomBlock(hash, num_blocks_) *
+                          kBlockedBloomBlockSize);
+  }
+
+ private:
+  const char* data_;
+  uint32_t num_blocks_;
+  bool broken_;
+
+  // No Copy allowed
+  BlockedBloomBitsReader(const BlockedBloomBitsReader&);
+  void operator=(const BlockedBloomBitsReader&);
+};
+
 // An implementation of filter policy
 class BloomFilterPolicy : public FilterPolicy {
  public:
-  explicit BloomFilterPolicy(int bits_per_key, bool use_block_based_builder)
+  explicit BloomFilterPolicy(int bits_per_key, bool use_block_based_builder,
+                             bool use_blocked_format = false)
       : bits_per_key_(bits_per_key), hash_func_(BloomHash),
-        use_block_based_builder_(use_block_based_builder) {
+        use_block_based_builder_(use_block_based_builder),
+        use_blocked_format_(use_blocked_format) {
     initialize();
   }
 
@@ -342,11 +622,18 @@ class BloomFilterPolicy : public FilterPolicy {
       return nullptr;
     }
 
+    if (use_blocked_format_) {
+      return new BlockedBloomBitsBuilder(bits_per_key_);
+    }
     return new FullFilterBitsBuilder(bits_per_key_, num_probes_);
   }
 
+  // Both full filter formats are read regardless of use_blocked_format_
   virtual FilterBitsReader* GetFilterBitsReader(const Slice& contents)
       const override {
+    if (IsBlockedBloomFilter(contents)) {
+      return new BlockedBloomBitsReader(contents);
+    }
     return new FullFilterBitsReader(contents);
   }
 
@@ -359,6 +646,7 @@ class BloomFilterPolicy : public FilterPolicy {
   uint32_t (*hash_func_)(const Slice& key);
 
   const bool use_block_based_builder_;
+  const bool use_blocked_format_;
 
   void initialize() {
     // We intentionally round down to reduce probing cost a little bit
@@ -375,4 +663,9 @@ const FilterPolicy* NewBloomFilterPolicy(int bits_per_key,
   return new BloomFilterPolicy(bits_per_key, use_block_based_builder);
 }
 
+const FilterPolicy* NewBlockedBloomFilterPolicy(int bits_per_key) {
+  return new BloomFilterPolicy(bits_per_key, false /* use_block_based_builder */,
+                               true /* use_blocked_format */);
+}
+
 }  // namespace rocksdb
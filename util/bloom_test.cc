@@ -17,6 +17,7 @@ int main() {
 
 #include <vector>
 
+#include "rocksdb/env.h"
 #include "rocksdb/filter_policy.h"
 #include "table/full_filter_bits_builder.h"
 #include "util/arena.h"
@@ -28,6 +29,8 @@ int main() {
 using GFLAGS_NAMESPACE::ParseCommandLineFlags;
 
 DEFINE_int32(bits_per_key, 10, "");
+DEFINE_int32(bench_keys, 0,
+             "If positive, time the lookups into filters of that many keys");
 
 namespace rocksdb {
 
@@ -186,9 +189,11 @@ class FullBloomTest : public testing::Test {
   size_t filter_size_;
 
  public:
-  FullBloomTest() :
-      policy_(NewBloomFilterPolicy(FLAGS_bits_per_key, false)),
-      filter_size_(0) {
+  explicit FullBloomTest(bool use_blocked_format = false)
+      : policy_(use_blocked_format
+                    ? NewBlockedBloomFilterPolicy(FLAGS_bits_per_key)
+                    : NewBloomFilterPolicy(FLAGS_bits_per_key, false)),
+        filter_size_(0) {
     Reset();
   }
 
@@ -200,6 +205,8 @@ class FullBloomTest : public testing::Test {
     return dynamic_cast<FullFilterBitsBuilder*>(bits_builder_.get());
   }
 
+  FilterBitsBuilder* GetBitsBuilder() { return bits_builder_.get(); }
+
   void Reset() {
     bits_builder_.reset(policy_->GetFilterBitsBuilder());
     bits_reader_.reset(nullptr);
@@ -238,6 +245,30 @@ class FullBloomTest : public testing::Test {
     }
     return result / 10000.0;
   }
+
+  // Times FLAGS_bench_keys lookups of keys that were not added, into a
+  // filter of FLAGS_bench_keys keys
+  void Bench(const char* name) {
+    if (FLAGS_bench_keys <= 0) {
+      return;
+    }
+    char buffer[sizeof(int)];
+    Reset();
+    for (int i = 0; i < FLAGS_bench_keys; i++) {
+      Add(Key(i, buffer));
+    }
+    Build();
+    Env* env = Env::Default();
+    int hits = 0;
+    uint64_t start = env->NowNanos();
+    for (int i = 0; i < FLAGS_bench_keys; i++) {
+      hits += Matches(Key(i + 1000000000, buffer)) ? 1 : 0;
+    }
+    uint64_t elapsed = env->NowNanos() - start;
+    fprintf(stderr, "%s: %.1f ns per lookup, %.2f%% false positives\n", name,
+            static_cast<double>(elapsed) / FLAGS_bench_keys,
+            hits * 100.0 / FLAGS_bench_keys);
+  }
 };
 
 TEST_F(FullBloomTest, FilterSize) {
@@ -309,6 +340,229 @@ TEST_F(FullBloomTest, FullVaryingLengths) {
   ASSERT_LE(mediocre_filters, good_filters/5);
 }
 
+TEST_F(FullBloomTest, Bench) { Bench("Full filter"); }
+
+class BlockedBloomTest : public FullBloomTest {
+ public:
+  BlockedBloomTest() : FullBloomTest(true /* use_blocked_format */) {}
+};
+
+TEST_F(BlockedBloomTest, EmptyFilter) {
+  ASSERT_TRUE(!Matches("hello"));
+  ASSERT_TRUE(!Matches("world"));
+}
+
+TEST_F(BlockedBloomTest, Small) {
+  Add("hello");
+  Add("world");
+  ASSERT_TRUE(Matches("hello"));
+  ASSERT_TRUE(Matches("world"));
+  ASSERT_TRUE(!Matches("x"));
+  ASSERT_TRUE(!Matches("foo"));
+}
+
+TEST_F(BlockedBloomTest, FilterSize) {
+  char buffer[sizeof(int)];
+  for (int n = 1; n < 10000; n = NextLength(n)) {
+    Reset();
+    for (int i = 0; i < n; i++) {
+      Add(Key(i, buffer));
+    }
+    Build();
+    // A filter of that size is large enough for n keys
+    ASSERT_GE(GetBitsBuilder()->CalculateNumEntry(
+                  static_cast<uint32_t>(FilterSize())),
+              n);
+  }
+}
+
+TEST_F(BlockedBloomTest, VaryingLengths) {
+  char buffer[sizeof(int)];
+
+  for (int length = 1; length <= 10000; length = NextLength(length)) {
+    Reset();
+    for (int i = 0; i < length; i++) {
+      Add(Key(i, buffer));
+    }
+    Build();
+
+    ASSERT_LE(FilterSize(), (size_t)((length * 10 / 8) + 32 + 6)) << length;
+
+    // All added keys must match
+    for (int i = 0; i < length; i++) {
+      ASSERT_TRUE(Matches(Key(i, buffer)))
+          << "Length " << length << "; key " << i;
+    }
+
+    // Check false positive rate
+    double rate = FalsePositiveRate();
+    if (kVerbose >= 1) {
+      fprintf(stderr, "False positives: %5.2f%% @ length = %6d ; bytes = %6d\n",
+              rate * 100.0, length, static_cast<int>(FilterSize()));
+    }
+    ASSERT_LE(rate, 0.025);
+  }
+}
+
+TEST_F(BlockedBloomTest, ReadBothFormats) {
+  std::unique_ptr<const FilterPolicy> legacy(
+      NewBloomFilterPolicy(FLAGS_bits_per_key, false));
+  std::unique_ptr<const FilterPolicy> blocked(
+      NewBlockedBloomFilterPolicy(FLAGS_bits_per_key));
+  ASSERT_STREQ(legacy->Name(), blocked->Name());
+
+  char buffer[sizeof(int)];
+  for (const FilterPolicy* builder_policy : {legacy.get(), blocked.get()}) {
+    std::unique_ptr<FilterBitsBuilder> builder(
+        builder_policy->GetFilterBitsBuilder());
+    for (int i = 0; i < 1000; i++) {
+      builder->AddKey(Key(i, buffer));
+    }
+    std::unique_ptr<const char[]> buf;
+    Slice filter = builder->Finish(&buf);
+    for (const FilterPolicy* reader_policy : {legacy.get(), blocked.get()}) {
+      std::unique_ptr<FilterBitsReader> reader(
+          reader_policy->GetFilterBitsReader(filter));
+      int false_positives = 0;
+      for (int i = 0; i < 1000; i++) {
+        ASSERT_TRUE(reader->MayMatch(Key(i, buffer)));
+        if (reader->MayMatch(Key(i + 1000000000, buffer))) {
+          false_positives++;
+        }
+      }
+      ASSERT_LT(false_positives, 50);
+    }
+  }
+}
+
+TEST_F(BlockedBloomTest, Bench) { Bench("Blocked filter"); }
+
+class RibbonFilterTest : public testing::Test {
+ private:
+  std::unique_ptr<const FilterPolicy> policy_;
+  std::unique_ptr<FilterBitsBuilder> bits_builder_;
+  std::unique_ptr<FilterBitsReader> bits_reader_;
+  std::unique_ptr<const char[]> buf_;
+  size_t filter_size_;
+
+ public:
+  RibbonFilterTest()
+      : policy_(NewRibbonFilterPolicy(FLAGS_bits_per_key)), filter_size_(0) {
+    Reset();
+  }
+
+  FilterBitsBuilder* GetBitsBuilder() { return bits_builder_.get(); }
+
+  void Reset() {
+    bits_builder_.reset(policy_->GetFilterBitsBuilder());
+    bits_reader_.reset(nullptr);
+    buf_.reset(nullptr);
+    filter_size_ = 0;
+  }
+
+  void Add(const Slice& s) {
+    bits_builder_->AddKey(s);
+  }
+
+  void Build() {
+    Slice filter = bits_builder_->Finish(&buf_);
+    bits_reader_.reset(policy_->GetFilterBitsReader(filter));
+    filter_size_ = filter.size();
+  }
+
+  size_t FilterSize() const {
+    return filter_size_;
+  }
+
+  bool Matches(const Slice& s) {
+    if (bits_reader_ == nullptr) {
+      Build();
+    }
+    return bits_reader_->MayMatch(s);
+  }
+
+  double FalsePositiveRate() {
+    char buffer[sizeof(int)];
+    int result = 0;
+    for (int i = 0; i < 10000; i++) {
+      if (Matches(Key(i + 1000000000, buffer))) {
+        result++;
+      }
+    }
+    return result / 10000.0;
+  }
+};
+
+TEST_F(RibbonFilterTest, FilterSize) {
+  char buffer[sizeof(int)];
+  for (int n = 1; n < 10000; n = NextLength(n)) {
+    Reset();
+    for (int i = 0; i < n; i++) {
+      Add(Key(i, buffer));
+    }
+    Build();
+    // A filter of that size is large enough for n keys
+    ASSERT_GE(GetBitsBuilder()->CalculateNumEntry(
+                  static_cast<uint32_t>(FilterSize())),
+              n);
+  }
+}
+
+TEST_F(RibbonFilterTest, EmptyFilter) {
+  ASSERT_TRUE(!Matches("hello"));
+  ASSERT_TRUE(!Matches("world"));
+}
+
+TEST_F(RibbonFilterTest, Small) {
+  Add("hello");
+  Add("world");
+  ASSERT_TRUE(Matches("hello"));
+  ASSERT_TRUE(Matches("world"));
+  ASSERT_TRUE(!Matches("x"));
+  ASSERT_TRUE(!Matches("foo"));
+}
+
+TEST_F(RibbonFilterTest, DuplicateKeys) {
+  Add("hello");
+  Add("world");
+  Add("hello");
+  Add("world");
+  ASSERT_TRUE(Matches("hello"));
+  ASSERT_TRUE(Matches("world"));
+}
+
+TEST_F(RibbonFilterTest, VaryingLengths) {
+  char buffer[sizeof(int)];
+
+  for (int length = 1; length <= 100000; length = NextLength(length)) {
+    Reset();
+    for (int i = 0; i < length; i++) {
+      Add(Key(i, buffer));
+    }
+    Build();
+
+    // 30% smaller than the Bloom filter with the same bits_per_key, once
+    // the fixed overhead is amortized
+    ASSERT_LE(FilterSize(),
+              (size_t)(length * FLAGS_bits_per_key * 0.75 / 8) + 200)
+        << length;
+
+    // All added keys must match
+    for (int i = 0; i < length; i++) {
+      ASSERT_TRUE(Matches(Key(i, buffer)))
+          << "Length " << length << "; key " << i;
+    }
+
+    // Check false positive rate
+    double rate = FalsePositiveRate();
+    if (kVerbose >= 1) {
+      fprintf(stderr, "False positives: %5.2f%% @ length = %6d ; bytes = %6d\n",
+              rate * 100.0, length, static_cast<int>(FilterSize()));
+    }
+    ASSERT_LE(rate, 0.0125);
+  }
+}
+
 }  // namespace rocksdb
 
 int main(int argc, char** argv) {
@@ -41,6 +41,9 @@
 #if ZSTD_VERSION_NUMBER >= 10103  // v1.1.3+
 #include <zdict.h>
 #endif  // ZSTD_VERSION_NUMBER >= 10103
+#if ZSTD_VERSION_NUMBER >= 700  // v0.7.0+
+#define ROCKSDB_ZSTD_DDICT
+#endif  // ZSTD_VERSION_NUMBER >= 700
 namespace rocksdb {
 // Need this for the context allocation override
 // On windows we need to do this explicitly
@@ -189,11 +192,74 @@ class CompressionContext {
   Slice& dict() { return dict_; }
 };
 
+// A dictionary for uncompressing blocks. With ZSTD, it is also digested into
+// a ZSTD_DDict once, instead of for every block it uncompresses. It can be
+// shared by the readers of all the tables compressed with the dictionary.
+class UncompressionDict {
+ public:
+  UncompressionDict() {}
+  UncompressionDict(std::string dict, bool using_zstd)
+      : dict_(std::move(dict)), slice_(dict_) {
+#ifdef ROCKSDB_ZSTD_DDICT
+    if (using_zstd && !slice_.empty()) {
+      zstd_ddict_ = ZSTD_createDDict(slice_.data(), slice_.size());
+      assert(zstd_ddict_ != nullptr);
+    }
+#else   // ROCKSDB_ZSTD_DDICT
+    (void)using_zstd;
+#endif  // ROCKSDB_ZSTD_DDICT
+  }
+  ~UncompressionDict() {
+#ifdef ROCKSDB_ZSTD_DDICT
+    if (zstd_ddict_ != nullptr) {
+      ZSTD_freeDDict(zstd_ddict_);
+    }
+#endif  // ROCKSDB_ZSTD_DDICT
+  }
+  UncompressionDict(const UncompressionDict&) = delete;
+  UncompressionDict& operator=(const UncompressionDict&) = delete;
+
+  const Slice& GetRawDict() const { return slice_; }
+#ifdef ROCKSDB_ZSTD_DDICT
+  const ZSTD_DDict* GetDigestedZstdDDict() const { return zstd_ddict_; }
+#endif  // ROCKSDB_ZSTD_DDICT
+
+  size_t ApproximateMemoryUsage() const {
+    size_t usage = sizeof(*this) + dict_.capacity();
+#ifdef ROCKSDB_ZSTD_DDICT
+    if (zstd_ddict_ != nullptr) {
+#if ZSTD_VERSION_NUMBER >= 10400  // v1.4.0+
+      usage += ZSTD_sizeof_DDict(zstd_ddict_);
+#else   // ZSTD_VERSION_NUMBER >= 10400
+      // The digested dictionary keeps a copy of the dictionary
+      usage += dict_.size();
+#endif  // ZSTD_VERSION_NUMBER >= 10400
+    }
+#endif  // ROCKSDB_ZSTD_DDICT
+    return usage;
+  }
+
+  static const UncompressionDict& GetEmptyDict() {
+    static UncompressionDict empty_dict;
+    return empty_dict;
+  }
+
+ private:
+  std::string dict_;
+  Slice slice_;
+#ifdef ROCKSDB_ZSTD_DDICT
+  ZSTD_DDict* zstd_ddict_ = nullptr;
+#endif  // ROCKSDB_ZSTD_DDICT
+};
+
 // Instantiate this class and pass it to the uncompression API below
 class UncompressionContext {
  private:
   CompressionType type_;
   Slice dict_;
+#ifdef ROCKSDB_ZSTD_DDICT
+  const ZSTD_DDict* zstd_ddict_ = nullptr;
+#endif  // ROCKSDB_ZSTD_DDICT
   CompressionContextCache* ctx_cache_ = nullptr;
   ZSTDUncompressCachedData uncomp_cached_data_;
 
@@ -210,6 +276,13 @@ class UncompressionContext {
       uncomp_cached_data_ = ctx_cache_->GetCachedZSTDUncompressData();
     }
   }
+  UncompressionContext(CompressionType comp_type,
+                       const UncompressionDict& uncomp_dict)
+      : UncompressionContext(comp_type, uncomp_dict.GetRawDict()) {
+#ifdef ROCKSDB_ZSTD_DDICT
+    zstd_ddict_ = uncomp_dict.GetDigestedZstdDDict();
+#endif  // ROCKSDB_ZSTD_DDICT
+  }
   ~UncompressionContext() {
     if ((type_ == kZSTD || type_ == kZSTDNotFinalCompression) &&
         uncomp_cached_data_.GetCacheIndex() != -1) {
@@ -227,6 +300,9 @@ class UncompressionContext {
   CompressionType type() const { return type_; }
   const Slice& dict() const { return dict_; }
   Slice& dict() { return dict_; }
+#ifdef ROCKSDB_ZSTD_DDICT
+  const ZSTD_DDict* zstd_ddict() const { return zstd_ddict_; }
+#endif  // ROCKSDB_ZSTD_DDICT
 };
 
 inline bool Snappy_Supported() {
@@ -1047,9 +1123,19 @@ inline CacheAllocationPtr ZSTD_Uncompress(
 #if ZSTD_VERSION_NUMBER >= 500  // v0.5.0+
   ZSTD_DCtx* context = ctx.GetZSTDContext();
   assert(context != nullptr);
-  actual_output_length = ZSTD_decompress_usingDict(
-      context, output.get(), output_len, input_data, input_length,
-      ctx.dict().data(), ctx.dict().size());
+#ifdef ROCKSDB_ZSTD_DDICT
+  if (ctx.zstd_ddict() != nullptr) {
+    actual_output_length = ZSTD_decompress_usingDDict(
+        context, output.get(), output_len, input_data, input_length,
+        ctx.zstd_ddict());
+  } else {
+#endif  // ROCKSDB_ZSTD_DDICT
+    actual_output_length = ZSTD_decompress_usingDict(
+        context, output.get(), output_len, input_data, input_length,
+        ctx.dict().data(), ctx.dict().size());
+#ifdef ROCKSDB_ZSTD_DDICT
+  }
+#endif  // ROCKSDB_ZSTD_DDICT
 #else   // up to v0.4.x
   actual_output_length =
       ZSTD_decompress(output.get(), output_len, input_data, input_length);
@@ -15,6 +15,8 @@
 #include "monitoring/histogram.h"
 #include "monitoring/iostats_context_imp.h"
 #include "port/port.h"
+#include "rocksdb/threadpool.h"
+#include "util/mutexlock.h"
 #include "util/random.h"
 #include "util/rate_limiter.h"
 #include "util/sync_point.h"
@@ -181,6 +183,54 @@ Status RandomAccessFileReader::Read(uint64_t offset, size_t n, Slice* result,
   return s;
 }
 
+Status RandomAccessFileReader::MultiRead(ReadRequest* read_reqs,
+                                         size_t num_reqs) const {
+  Status s;
+  if (use_direct_io() || (for_compaction_ && rate_limiter_ != nullptr)) {
+    // Direct IO needs aligned buffers and rate limited reads need to be
+    // chunked, both of which Read() takes care of.
+    for (size_t i = 0; i < num_reqs; ++i) {
+      ReadRequest& req = read_reqs[i];
+      req.status = Read(req.offset, req.len, &req.result, req.scratch);
+    }
+    return s;
+  }
+
+  uint64_t elapsed = 0;
+  {
+    StopWatch sw(env_, stats_, hist_type_,
+                 (stats_ != nullptr) ? &elapsed : nullptr, true /*overwrite*/,
+                 true /*delay_enabled*/);
+    IOSTATS_TIMER_GUARD(read_nanos);
+#ifndef ROCKSDB_LITE
+    time_t start_ts = 0;
+    if (ShouldNotifyListeners()) {
+      start_ts = std::chrono::system_clock::to_time_t(
+          std::chrono::system_clock::now());
+    }
+#endif  // ROCKSDB_LITE
+    s = file_->MultiRead(read_reqs, num_reqs);
+    for (size_t i = 0; i < num_reqs; ++i) {
+      ReadRequest& req = read_reqs[i];
+      if (!s.ok()) {
+        req.status = s;
+        req.result = Slice();
+      }
+#ifndef ROCKSDB_LITE
+      if (ShouldNotifyListeners()) {
+        NotifyOnFileReadFinish(req.offset, req.result.size(), start_ts,
+                               req.status);
+      }
+#endif  // ROCKSDB_LITE
+      IOSTATS_ADD_IF_POSITIVE(bytes_read, req.result.size());
+    }
+  }
+  if (stats_ != nullptr && file_read_hist_ != nullptr) {
+    file_read_hist_->Add(elapsed);
+  }
+  return s;
+}
+
 Status WritableFileWriter::Append(const Slice& data) {
   const char* src = data.data();
   size_t left = data.size();
@@ -761,6 +811,120 @@ Status FilePrefetchBuffer::Prefetch(RandomAccessFileReader* reader,
   return s;
 }
 
+namespace {
+// Threads shared by all the FilePrefetchBuffers doing asynchronous readahead.
+// They only wait for I/O, so there can be more of them than CPUs.
+const int kAsyncReadaheadThreads = 16;
+
+ThreadPool* GetAsyncReadaheadThreadPool() {
+  // Never deleted, so that it can be used until the very end of the process
+  static ThreadPool* thread_pool = NewThreadPool(kAsyncReadaheadThreads);
+  return thread_pool;
+}
+}  // anonymous namespace
+
+FilePrefetchBuffer::~FilePrefetchBuffer() { AbortAsyncReads(); }
+
+void FilePrefetchBuffer::WaitForAsyncRead(AsyncRead* read) {
+  MutexLock l(&read->mu);
+  while (!read->done) {
+    read->cv.Wait();
+  }
+}
+
+void FilePrefetchBuffer::AbortAsyncReads() {
+  // The reads use file_reader_ and may not outlive this object
+  for (auto& read : async_reads_) {
+    WaitForAsyncRead(read.get());
+  }
+  async_reads_.clear();
+}
+
+void FilePrefetchBuffer::ScheduleAsyncReads() {
+  size_t alignment = file_reader_->file()->GetRequiredBufferAlignment();
+  uint64_t next_offset =
+      async_reads_.empty()
+          ? buffer_offset_ + buffer_.CurrentSize()
+          : async_reads_.back()->offset + async_reads_.back()->len;
+  while (async_reads_.size() < async_buffers_) {
+    std::shared_ptr<AsyncRead> read(new AsyncRead());
+    read->offset = next_offset;
+    read->len = Roundup(readahead_size_, alignment);
+    read->buffer.Alignment(alignment);
+    read->buffer.AllocateNewBuffer(read->len);
+    RandomAccessFileReader* reader = file_reader_;
+    GetAsyncReadaheadThreadPool()->SubmitJob([reader, read]() {
+      Slice result;
+      Status s = reader->Read(read->offset, read->len, &result,
+                              read->buffer.BufferStart());
+      if (s.ok()) {
+        if (result.data() != read->buffer.BufferStart()) {
+          memcpy(read->buffer.BufferStart(), result.data(), result.size());
+        }
+        read->buffer.Size(result.size());
+      }
+      MutexLock l(&read->mu);
+      read->status = s;
+      read->done = true;
+      read->cv.SignalAll();
+    });
+    next_offset += read->len;
+    async_reads_.push_back(std::move(read));
+  }
+}
+
+Status FilePrefetchBuffer::PrefetchAsync(uint64_t offset, size_t n) {
+  size_t alignment = file_reader_->file()->GetRequiredBufferAlignment();
+  uint64_t buffer_end = buffer_offset_ + buffer_.CurrentSize();
+  bool switched = false;
+  // The oldest buffer in flight starts where buffer_ ends, so it can be used
+  // if the request starts in buffer_ or in it and ends in it.
+  if (!async_reads_.empty() && async_reads_.front()->offset == buffer_end &&
+      offset >= buffer_offset_ &&
+      offset + n <= async_reads_.front()->offset + async_reads_.front()->len) {
+    std::shared_ptr<AsyncRead> read = std::move(async_reads_.front());
+    async_reads_.pop_front();
+    WaitForAsyncRead(read.get());
+    if (read->status.ok()) {
+      size_t keep_from = offset >= buffer_end
+                             ? buffer_.CurrentSize()
+                             : Rounddown(static_cast<size_t>(
+                                             offset - buffer_offset_),
+                                         alignment);
+      if (keep_from < buffer_.CurrentSize()) {
+        // The request straddles both buffers. Join the tail of the current
+        // buffer and the new one.
+        size_t tail_len = buffer_.CurrentSize() - keep_from;
+        AlignedBuffer joined;
+        joined.Alignment(alignment);
+        joined.AllocateNewBuffer(
+            Roundup(tail_len + read->buffer.CurrentSize(), alignment));
+        joined.Append(buffer_.BufferStart() + keep_from, tail_len);
+        joined.Append(read->buffer.BufferStart(), read->buffer.CurrentSize());
+        buffer_ = std::move(joined);
+        buffer_offset_ += keep_from;
+      } else {
+        buffer_ = std::move(read->buffer);
+        buffer_offset_ = read->offset;
+      }
+      switched = offset + n <= buffer_offset_ + buffer_.CurrentSize();
+    }
+  }
+
+  Status s;
+  if (!switched) {
+    // The scan moved somewhere else, a background read failed or came back
+    // short. Start over from a synchronous read.
+    AbortAsyncReads();
+    s = Prefetch(file_reader_, offset, n + readahead_size_);
+    if (!s.ok()) {
+      return s;
+    }
+  }
+  ScheduleAsyncReads();
+  return s;
+}
+
 bool FilePrefetchBuffer::TryReadFromCache(uint64_t offset, size_t n,
                                           Slice* result) {
   if (track_min_offset_ && offset < min_offset_read_) {
@@ -779,7 +943,9 @@ bool FilePrefetchBuffer::TryReadFromCache(uint64_t offset, size_t n,
       assert(file_reader_ != nullptr);
       assert(max_readahead_size_ >= readahead_size_);
 
-      Status s = Prefetch(file_reader_, offset, n + readahead_size_);
+      Status s = async_buffers_ > 0
+                     ? PrefetchAsync(offset, n)
+                     : Prefetch(file_reader_, offset, n + readahead_size_);
       if (!s.ok()) {
         return false;
       }
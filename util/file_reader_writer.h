@@ -8,6 +8,8 @@
 // found in the LICENSE file. See the AUTHORS file for names of contributors.
 #pragma once
 #include <atomic>
+#include <deque>
+#include <memory>
 #include <sstream>
 #include <string>
 #include "port/port.h"
@@ -142,6 +144,11 @@ class RandomAccessFileReader {
 
   Status Read(uint64_t offset, size_t n, Slice* result, char* scratch) const;
 
+  // Issues all the reads of reqs to the file at once, so that the
+  // underlying file can serve them in parallel. The status of each read is
+  // stored in its ReadRequest::status.
+  Status MultiRead(ReadRequest* reqs, size_t num_reqs) const;
+
   Status Prefetch(uint64_t offset, size_t n) const {
     return file_->Prefetch(offset, n);
   }
@@ -285,16 +292,24 @@ class WritableFileWriter {
 class FilePrefetchBuffer {
  public:
   // If `track_min_offset` is true, track minimum offset ever read.
+  // If `async_buffers` is non-zero, readahead is asynchronous: once the
+  // buffer had to be refilled, up to `async_buffers` readahead buffers
+  // following it are read in the background, and TryReadFromCache() switches
+  // to the next one when it reaches the end of the current buffer.
   FilePrefetchBuffer(RandomAccessFileReader* file_reader = nullptr,
                      size_t readadhead_size = 0, size_t max_readahead_size = 0,
-                     bool enable = true, bool track_min_offset = false)
+                     bool enable = true, bool track_min_offset = false,
+                     size_t async_buffers = 0)
       : buffer_offset_(0),
         file_reader_(file_reader),
         readahead_size_(readadhead_size),
         max_readahead_size_(max_readahead_size),
         min_offset_read_(port::kMaxSizet),
         enable_(enable),
-        track_min_offset_(track_min_offset) {}
+        track_min_offset_(track_min_offset),
+        async_buffers_(async_buffers) {}
+  // Waits for the reads still in flight
+  ~FilePrefetchBuffer();
   Status Prefetch(RandomAccessFileReader* reader, uint64_t offset, size_t n);
   bool TryReadFromCache(uint64_t offset, size_t n, Slice* result);
 
@@ -303,6 +318,26 @@ class FilePrefetchBuffer {
   size_t min_offset_read() const { return min_offset_read_; }
 
  private:
+  // A readahead buffer being filled in the background
+  struct AsyncRead {
+    AsyncRead() : cv(&mu), offset(0), len(0), done(false) {}
+    port::Mutex mu;
+    port::CondVar cv;
+    AlignedBuffer buffer;
+    uint64_t offset;
+    size_t len;
+    // Protected by mu
+    Status status;
+    bool done;
+  };
+
+  // Makes [offset, offset + n) available in buffer_, preferably by switching
+  // to the oldest buffer in flight, and schedules more background reads.
+  Status PrefetchAsync(uint64_t offset, size_t n);
+  void ScheduleAsyncReads();
+  static void WaitForAsyncRead(AsyncRead* read);
+  void AbortAsyncReads();
+
   AlignedBuffer buffer_;
   uint64_t buffer_offset_;
   RandomAccessFileReader* file_reader_;
@@ -316,6 +351,10 @@ class FilePrefetchBuffer {
   // If true, track minimum `offset` ever passed to TryReadFromCache(), which
   // can be fetched from min_offset_read().
   bool track_min_offset_;
+  // Maximum number of readahead buffers read in the background
+  size_t async_buffers_;
+  // Background reads of the buffers following buffer_, in file order
+  std::deque<std::shared_ptr<AsyncRead>> async_reads_;
 };
 
 extern Status NewWritableFile(Env* env, const std::string& fname,
@@ -322,6 +322,42 @@ INSTANTIATE_TEST_CASE_P(
     NExceedReadaheadTest, ReadaheadRandomAccessFileTest,
     ::testing::ValuesIn(ReadaheadRandomAccessFileTest::GetReadaheadSizeList()));
 
+class FilePrefetchBufferTest : public testing::Test,
+                               public testing::WithParamInterface<size_t> {};
+
+TEST_P(FilePrefetchBufferTest, SequentialScanWithSkips) {
+  const size_t kInitReadaheadSize = 8 * 1024;
+  const size_t kMaxReadaheadSize = 256 * 1024;
+  Random rng(301);
+  std::string str = test::RandomHumanReadableString(&rng, 4 << 20);
+  std::unique_ptr<RandomAccessFileReader> reader(new RandomAccessFileReader(
+      std::unique_ptr<RandomAccessFile>(new test::StringSource(str)),
+      "" /* don't care */));
+  FilePrefetchBuffer prefetch_buffer(reader.get(), kInitReadaheadSize,
+                                     kMaxReadaheadSize, true /* enable */,
+                                     false /* track_min_offset */, GetParam());
+
+  // Read "blocks" of random sizes back to back, and sometimes skip ahead
+  // like an iterator seeking forward would.
+  size_t offset = 0;
+  while (true) {
+    size_t n = 1 + rng.Uniform(16 * 1024);
+    if (offset + n > str.size()) {
+      break;
+    }
+    Slice result;
+    ASSERT_TRUE(prefetch_buffer.TryReadFromCache(offset, n, &result));
+    ASSERT_EQ(Slice(str.data() + offset, n), result);
+    offset += n;
+    if (rng.OneIn(20)) {
+      offset += rng.Uniform(1 << 20);
+    }
+  }
+}
+
+INSTANTIATE_TEST_CASE_P(FilePrefetchBufferTest, FilePrefetchBufferTest,
+                        ::testing::Values(0, 1, 3));
+
 }  // namespace rocksdb
 
 int main(int argc, char** argv) {
@@ -0,0 +1,441 @@
+//  Copyright (c) 2011-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+//
+// Ribbon filter, see "Ribbon filter: practically smaller than Bloom and Xor"
+// by Peter C. Dillinger and Stefan Walzer (https://arxiv.org/abs/2103.02515).
+//
+// Each key is hashed to a row of a linear system over GF(2): a start slot s,
+// a 128 bit coefficient vector c whose lowest bit is set, and an fp_bits wide
+// result r. The filter stores a solution S, fp_bits per slot, such that for
+// every key
+//
+//   XOR over j in [0, 128) with bit j of c set, of S[s + j]  ==  r
+//
+// A key that was not added satisfies its equation with probability
+// 2^-fp_bits, which is the false positive rate. The system is solved by
+// Gaussian elimination restricted to the band of 128 slots after the start
+// of each row, which almost always succeeds when there are a few percent more
+// slots than keys. When it does not, the filter is built again with another
+// hash seed. So the filter costs about 1.05 * fp_bits bits per key, against
+// about 1.44 * fp_bits for a Bloom filter with the same false positive rate.
+
+#include "rocksdb/filter_policy.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "port/port.h"
+#include "rocksdb/slice.h"
+#include "util/coding.h"
+#include "util/xxhash.h"
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace rocksdb {
+
+namespace {
+
+// Width of the band, i.e. of the coefficient vectors
+const uint32_t kRibbonWidth = 128;
+// The solution is stored in blocks of that many slots
+const uint32_t kBlockSlots = 64;
+// Slots per key the filter is first built with, and the slots it always
+// has on top of that. With a band of 128 slots they are enough for the
+// elimination to succeed most of the time, for up to millions of keys.
+const double kSlotsPerKey = 1.05;
+const uint32_t kExtraSlots = 128;
+// Number of hash seeds tried with a given number of slots before adding
+// more slots
+const uint32_t kSeedsPerSize = 8;
+const uint32_t kMaxSeeds = 256;
+// 1 byte for the seed, 1 for fp_bits, 4 for num_blocks
+const uint32_t kMetadataLen = 6;
+const uint32_t kMaxFpBits = 32;
+
+inline int BitParity(uint64_t v) {
+#ifdef _MSC_VER
+  return static_cast<int>(__popcnt64(v) & 1);
+#else
+  return __builtin_parityll(v);
+#endif
+}
+
+inline int CountTrailingZeros(uint64_t v) {
+  assert(v != 0);
+#ifdef _MSC_VER
+  unsigned long index;
+  _BitScanForward64(&index, v);
+  return static_cast<int>(index);
+#else
+  return __builtin_ctzll(v);
+#endif
+}
+
+// 128 bit vector, the slot of bit 0 first
+struct RibbonBits {
+  uint64_t lo;
+  uint64_t hi;
+
+  bool IsZero() const { return (lo | hi) == 0; }
+
+  void Xor(const RibbonBits& other) {
+    lo ^= other.lo;
+    hi ^= other.hi;
+  }
+
+  int CountTrailingZeros() const {
+    return lo != 0 ? rocksdb::CountTrailingZeros(lo)
+                   : 64 + rocksdb::CountTrailingZeros(hi);
+  }
+
+  // 0 < n < 128
+  void ShiftRight(int n) {
+    if (n >= 64) {
+      lo = hi >> (n - 64);
+      hi = 0;
+    } else {
+      lo = (lo >> n) | (hi << (64 - n));
+      hi >>= n;
+    }
+  }
+
+  // Parity of the bits set in both
+  int DotProduct(const RibbonBits& other) const {
+    return BitParity((lo & other.lo) ^ (hi & other.hi));
+  }
+};
+
+inline uint64_t RibbonKeyHash(const Slice& key) {
+  return XXH64(key.data(), key.size(), 0);
+}
+
+// Derives the row of a key from its hash and the seed of the filter
+inline void GetRibbonRow(uint64_t key_hash, uint32_t seed, uint32_t num_starts,
+                         uint32_t fp_bits, uint32_t* start, RibbonBits* coeff,
+                         uint32_t* result) {
+  // Re-mix with the seed (finalizer of MurmurHash3), so that retrying with
+  // another seed gives unrelated rows
+  uint64_t h = key_hash ^ (uint64_t{seed} * 0x9E3779B97F4A7C15ULL);
+  h ^= h >> 33;
+  h *= 0xFF51AFD7ED558CCDULL;
+  h ^= h >> 33;
+  h *= 0xC4CEB9FE1A85EC53ULL;
+  h ^= h >> 33;
+
+  *start = static_cast<uint32_t>(((h >> 32) * num_starts) >> 32);
+  coeff->lo = (h * 0x9E3779B97F4A7C13ULL) | 1;
+  coeff->hi = h * 0xB1A83721F4C2E7D5ULL;
+  coeff->hi ^= coeff->hi >> 29;
+  *result = static_cast<uint32_t>((h * 0xD6E8FEB86659FD93ULL) >> 32) &
+            static_cast<uint32_t>((uint64_t{1} << fp_bits) - 1);
+}
+
+class RibbonFilterBitsBuilder : public FilterBitsBuilder {
+ public:
+  explicit RibbonFilterBitsBuilder(uint32_t fp_bits) : fp_bits_(fp_bits) {
+    assert(fp_bits_ >= 1 && fp_bits_ <= kMaxFpBits);
+  }
+
+  virtual void AddKey(const Slice& key) override {
+    uint64_t hash = RibbonKeyHash(key);
+    if (hash_entries_.empty() || hash != hash_entries_.back()) {
+      hash_entries_.push_back(hash);
+    }
+  }
+
+  // +----------------------------------------------------------------+
+  // | solution, num_blocks * fp_bits 64 bit words. Word               |
+  // | (b * fp_bits + k) holds bit k of the solution of the slots       |
+  // | [64 * b, 64 * b + 64)                                            |
+  // +----------------------------------------------------------------+
+  // | ... | seed : 1 byte | fp_bits : 1 byte | num_blocks : 4 bytes    |
+  // +----------------------------------------------------------------+
+  // fp_bits == 0 means that the filter could not be built and matches
+  // everything.
+  virtual Slice Finish(std::unique_ptr<const char[]>* buf) override {
+    uint32_t num_blocks = CalculateNumBlocks(hash_entries_.size());
+    uint32_t fp_bits = fp_bits_;
+    uint32_t seed = 0;
+    std::vector<uint64_t> solution;
+    if (num_blocks > 0) {
+      for (;; seed++) {
+        if (seed == kMaxSeeds) {
+          // Should never happen. Give up, and build a filter that matches
+          // everything
+          num_blocks = 0;
+          fp_bits = 0;
+          seed = 0;
+          solution.clear();
+          break;
+        }
+        if (seed > 0 && seed % kSeedsPerSize == 0) {
+          num_blocks += num_blocks / 16 + 1;
+        }
+        if (Solve(num_blocks, seed, &solution)) {
+          break;
+        }
+      }
+    }
+
+    size_t solution_len = solution.size() * sizeof(uint64_t);
+    char* data = new char[solution_len + kMetadataLen];
+    for (size_t i = 0; i < solution.size(); i++) {
+      EncodeFixed64(data + i * sizeof(uint64_t), solution[i]);
+    }
+    data[solution_len] = static_cast<char>(seed);
+    data[solution_len + 1] = static_cast<char>(fp_bits);
+    EncodeFixed32(data + solution_len + 2, num_blocks);
+
+    const char* const_data = data;
+    buf->reset(const_data);
+    hash_entries_.clear();
+
+    return Slice(data, solution_len + kMetadataLen);
+  }
+
+  virtual int CalculateNumEntry(const uint32_t space) override {
+    assert(space > 0);
+    if (space <= kMetadataLen) {
+      return 0;
+    }
+    // Largest n that fits, CalculateSpace(high) is known to be too large
+    int low = 0;
+    int high = static_cast<int>((space - kMetadataLen) * 8 / fp_bits_ + 1);
+    while (high - low > 1) {
+      int mid = low + (high - low) / 2;
+      if (CalculateSpace(mid) <= space) {
+        low = mid;
+      } else {
+        high = mid;
+      }
+    }
+    return low;
+  }
+
+  uint32_t CalculateSpace(size_t num_entry) const {
+    return CalculateNumBlocks(num_entry) * fp_bits_ *
+               static_cast<uint32_t>(sizeof(uint64_t)) +
+           kMetadataLen;
+  }
+
+ private:
+  uint32_t CalculateNumBlocks(size_t num_entry) const {
+    if (num_entry == 0) {
+      return 0;
+    }
+    double num_slots = num_entry * kSlotsPerKey + kExtraSlots;
+    return static_cast<uint32_t>(
+        (static_cast<uint64_t>(num_slots) + kBlockSlots - 1) / kBlockSlots);
+  }
+
+  // Bands the rows of all the keys, then solves the system by back
+  // substitution. Returns false if the rows turned out to be linearly
+  // dependent, i.e. a different seed is needed.
+  bool Solve(uint32_t num_blocks, uint32_t seed,
+             std::vector<uint64_t>* solution) {
+    const uint32_t num_slots = num_blocks * kBlockSlots;
+    assert(num_slots >= kRibbonWidth);
+    const uint32_t num_starts = num_slots - kRibbonWidth + 1;
+    // Row i of the banded system, its coefficients start at slot i
+    const RibbonBits kZero = {0, 0};
+    coeffs_.assign(num_slots, kZero);
+    results_.assign(num_slots, 0);
+
+    for (uint64_t key_hash : hash_entries_) {
+      uint32_t start;
+      RibbonBits coeff;
+      uint32_t result;
+      GetRibbonRow(key_hash, seed, num_starts, fp_bits_, &start, &coeff,
+                   &result);
+      while (true) {
+        if (coeffs_[start].IsZero()) {
+          coeffs_[start] = coeff;
+          results_[start] = result;
+          break;
+        }
+        coeff.Xor(coeffs_[start]);
+        result ^= results_[start];
+        if (coeff.IsZero()) {
+          if (result != 0) {
+            return false;
+          }
+          // Implied by the other rows, e.g. the same key added twice
+          break;
+        }
+        int shift = coeff.CountTrailingZeros();
+        start += shift;
+        coeff.ShiftRight(shift);
+      }
+    }
+
+    // Back substitution, from the last slot to the first. state[k] holds
+    // bit k of the solution of the current slot and the next 127 slots, the
+    // current one in bit 0.
+    solution->assign(num_blocks * fp_bits_, 0);
+    RibbonBits state[kMaxFpBits];
+    for (uint32_t k = 0; k < fp_bits_; k++) {
+      state[k] = kZero;
+    }
+    for (uint32_t i = num_slots; i-- > 0;) {
+      const RibbonBits& coeff = coeffs_[i];
+      uint32_t result = results_[i];
+      if (coeff.IsZero()) {
+        // Free variable. Random rather than zero, so that the false positive
+        // rate does not depend on how many slots are free.
+        result = static_cast<uint32_t>(
+            XXH64(&i, sizeof(i), seed) & ((uint64_t{1} << fp_bits_) - 1));
+      }
+      uint64_t* block = &(*solution)[(i / kBlockSlots) * fp_bits_];
+      for (uint32_t k = 0; k < fp_bits_; k++) {
+        // Make room for slot i. Bit 0 of coeff is set, so the solution of
+        // slot i is the one that satisfies the row with the others.
+        state[k].hi = (state[k].hi << 1) | (state[k].lo >> 63);
+        state[k].lo <<= 1;
+        uint64_t bit = ((result >> k) & 1) ^ coeff.DotProduct(state[k]);
+        state[k].lo |= bit;
+        block[k] |= bit << (i % kBlockSlots);
+      }
+    }
+    return true;
+  }
+
+  const uint32_t fp_bits_;
+  std::vector<uint64_t> hash_entries_;
+  std::vector<RibbonBits> coeffs_;
+  std::vector<uint32_t> results_;
+
+  // No Copy allowed
+  RibbonFilterBitsBuilder(const RibbonFilterBitsBuilder&);
+  void operator=(const RibbonFilterBitsBuilder&);
+};
+
+class RibbonFilterBitsReader : public FilterBitsReader {
+ public:
+  explicit RibbonFilterBitsReader(const Slice& contents)
+      : data_(contents.data()), seed_(0), fp_bits_(0), num_blocks_(0) {
+    uint32_t len = static_cast<uint32_t>(contents.size());
+    if (len < kMetadataLen) {
+      // Broken, regarded as match
+      return;
+    }
+    seed_ = static_cast<uint8_t>(data_[len - kMetadataLen]);
+    fp_bits_ = static_cast<uint8_t>(data_[len - kMetadataLen + 1]);
+    num_blocks_ = DecodeFixed32(data_ + len - 4);
+    if (fp_bits_ > kMaxFpBits ||
+        uint64_t{num_blocks_} * fp_bits_ * sizeof(uint64_t) !=
+            len - kMetadataLen ||
+        (num_blocks_ != 0 && num_blocks_ * kBlockSlots < kRibbonWidth)) {
+      fp_bits_ = 0;
+      num_blocks_ = 0;
+    }
+  }
+
+  virtual bool MayMatch(const Slice& entry) override {
+    if (fp_bits_ == 0) {
+      // Could not be built or broken, regarded as match
+      return true;
+    }
+    if (num_blocks_ == 0) {
+      // No keys
+      return false;
+    }
+    uint32_t start;
+    RibbonBits coeff;
+    uint32_t expected;
+    GetRibbonRow(RibbonKeyHash(entry), seed_,
+                 num_blocks_ * kBlockSlots - kRibbonWidth + 1, fp_bits_,
+                 &start, &coeff, &expected);
+    // The 128 slots from start on span two or three blocks
+    const uint32_t shift = start % kBlockSlots;
+    const size_t block_len = fp_bits_ * sizeof(uint64_t);
+    const char* block0 = data_ + (start / kBlockSlots) * block_len;
+    const char* block1 = block0 + block_len;
+    const char* block2 = block1 + block_len;
+    for (uint32_t k = 0; k < fp_bits_; k++) {
+      const size_t off = k * sizeof(uint64_t);
+      RibbonBits s;
+      s.lo = DecodeFixed64(block0 + off);
+      s.hi = DecodeFixed64(block1 + off);
+      if (shift != 0) {
+        uint64_t w2 = DecodeFixed64(block2 + off);
+        s.lo = (s.lo >> shift) | (s.hi << (kBlockSlots - shift));
+        s.hi = (s.hi >> shift) | (w2 << (kBlockSlots - shift));
+      }
+      if (static_cast<uint32_t>(coeff.DotProduct(s)) !=
+          ((expected >> k) & 1)) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+ private:
+  const char* data_;
+  uint32_t seed_;
+  uint32_t fp_bits_;
+  uint32_t num_blocks_;
+
+  // No Copy allowed
+  RibbonFilterBitsReader(const RibbonFilterBitsReader&);
+  void operator=(const RibbonFilterBitsReader&);
+};
+
+class RibbonFilterPolicy : public FilterPolicy {
+ public:
+  explicit RibbonFilterPolicy(double bloom_equivalent_bits_per_key) {
+    // A Bloom filter with b bits per key and the optimal number of probes
+    // has a false positive rate of about 0.6185^b = 2^(-0.6931 * b)
+    double fp_bits = std::round(bloom_equivalent_bits_per_key * 0.6931);
+    fp_bits_ = static_cast<uint32_t>(
+        std::min(std::max(fp_bits, 1.0), static_cast<double>(kMaxFpBits)));
+  }
+
+  virtual const char* Name() const override {
+    return "rocksdb.RibbonFilter";
+  }
+
+  // The block based filter format is not worth a separate implementation,
+  // use the full filter format for each block.
+  virtual void CreateFilter(const Slice* keys, int n,
+                            std::string* dst) const override {
+    RibbonFilterBitsBuilder builder(fp_bits_);
+    for (int i = 0; i < n; i++) {
+      builder.AddKey(keys[i]);
+    }
+    std::unique_ptr<const char[]> buf;
+    Slice filter = builder.Finish(&buf);
+    dst->append(filter.data(), filter.size());
+  }
+
+  virtual bool KeyMayMatch(const Slice& key,
+                           const Slice& filter) const override {
+    RibbonFilterBitsReader reader(filter);
+    return reader.MayMatch(key);
+  }
+
+  virtual FilterBitsBuilder* GetFilterBitsBuilder() const override {
+    return new RibbonFilterBitsBuilder(fp_bits_);
+  }
+
+  virtual FilterBitsReader* GetFilterBitsReader(
+      const Slice& contents) const override {
+    return new RibbonFilterBitsReader(contents);
+  }
+
+ private:
+  uint32_t fp_bits_;
+};
+
+}  // namespace
+
+const FilterPolicy* NewRibbonFilterPolicy(
+    double bloom_equivalent_bits_per_key) {
+  return new RibbonFilterPolicy(bloom_equivalent_bits_per_key);
+}
+
+}  // namespace rocksdb
@@ -0,0 +1,355 @@
+//  Copyright (c) 2011-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "util/streaming_compression.h"
+
+#include <string.h>
+
+#include "util/coding.h"
+#include "util/compression.h"
+
+// LZ4_decompress_safe_usingDict() and LZ4_loadDict() are available since r124
+#if defined(LZ4) && LZ4_VERSION_NUMBER >= 10400  // r124+
+#define ROCKSDB_LZ4_STREAMING
+#endif
+
+// ZSTD_CStream and ZSTD_DStream are available since v1.0.0
+#if defined(ZSTD) && ZSTD_VERSION_NUMBER >= 10000  // v1.0.0+
+#define ROCKSDB_ZSTD_STREAMING
+#endif
+
+namespace rocksdb {
+
+// Every compressed record starts with the varint32 size of the record, so
+// that it can be uncompressed into a buffer of the right size.
+
+namespace {
+
+#ifdef ZLIB
+// Raw deflate stream, without zlib header and trailer
+const int kZlibWindowBits = -15;
+
+class ZlibStreamingCompress : public StreamingCompress {
+ public:
+  ZlibStreamingCompress() : initialized_(false) {
+    memset(&stream_, 0, sizeof(z_stream));
+    // The WAL is on the write path, hence the fastest level
+    initialized_ = deflateInit2(&stream_, Z_BEST_SPEED, Z_DEFLATED,
+                                kZlibWindowBits, 8 /* memLevel */,
+                                Z_DEFAULT_STRATEGY) == Z_OK;
+  }
+
+  ~ZlibStreamingCompress() {
+    if (initialized_) {
+      deflateEnd(&stream_);
+    }
+  }
+
+  virtual Status Compress(const Slice& record, std::string* output) override {
+    if (!initialized_) {
+      return Status::Corruption("Failed to initialize zlib stream");
+    }
+    PutVarint32(output, static_cast<uint32_t>(record.size()));
+    stream_.next_in =
+        reinterpret_cast<Bytef*>(const_cast<char*>(record.data()));
+    stream_.avail_in = static_cast<unsigned int>(record.size());
+    // Z_SYNC_FLUSH emits all the pending output, aligned on a byte boundary,
+    // while keeping the history for the next records
+    do {
+      const size_t pos = output->size();
+      const size_t avail = deflateBound(&stream_, stream_.avail_in) + 16;
+      output->resize(pos + avail);
+      stream_.next_out = reinterpret_cast<Bytef*>(&(*output)[pos]);
+      stream_.avail_out = static_cast<unsigned int>(avail);
+      int st = deflate(&stream_, Z_SYNC_FLUSH);
+      output->resize(pos + avail - stream_.avail_out);
+      if (st != Z_OK && st != Z_BUF_ERROR) {
+        return Status::Corruption("Failed to compress with zlib");
+      }
+    } while (stream_.avail_out == 0);
+    return Status::OK();
+  }
+
+ private:
+  z_stream stream_;
+  bool initialized_;
+};
+
+class ZlibStreamingUncompress : public StreamingUncompress {
+ public:
+  ZlibStreamingUncompress() : initialized_(false) {
+    memset(&stream_, 0, sizeof(z_stream));
+    initialized_ = inflateInit2(&stream_, kZlibWindowBits) == Z_OK;
+  }
+
+  ~ZlibStreamingUncompress() {
+    if (initialized_) {
+      inflateEnd(&stream_);
+    }
+  }
+
+  virtual Status Uncompress(const Slice& compressed,
+                            std::string* output) override {
+    Slice input = compressed;
+    uint32_t size;
+    if (!initialized_ || !GetVarint32(&input, &size)) {
+      return Status::Corruption("Failed to uncompress with zlib");
+    }
+    // One more byte of room, so that the inflate does not stop at the end of
+    // the record before the flush marker
+    output->resize(size + 1);
+    stream_.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(input.data()));
+    stream_.avail_in = static_cast<unsigned int>(input.size());
+    stream_.next_out = reinterpret_cast<Bytef*>(&(*output)[0]);
+    stream_.avail_out = size + 1;
+    int st = inflate(&stream_, Z_SYNC_FLUSH);
+    if ((st != Z_OK && st != Z_BUF_ERROR) || stream_.avail_out != 1 ||
+        stream_.avail_in != 0) {
+      return Status::Corruption("Failed to uncompress with zlib");
+    }
+    output->resize(size);
+    return Status::OK();
+  }
+
+ private:
+  z_stream stream_;
+  bool initialized_;
+};
+#endif  // ZLIB
+
+#ifdef ROCKSDB_LZ4_STREAMING
+// LZ4 refers to up to 64KB of history
+const size_t kLZ4WindowSize = 64 << 10;
+// The history is kept in a buffer of that capacity, and is shifted back to
+// the last kLZ4WindowSize bytes when a record does not fit
+const size_t kLZ4HistoryCapacity = 4 * kLZ4WindowSize;
+
+// Makes room in *history for a record of the given size, shifting the
+// history back to its last kLZ4WindowSize bytes if the record does not fit
+// in its capacity. Returns true if the history was shifted.
+bool ReserveLZ4History(size_t size, std::string* history) {
+  if (history->size() + size <= history->capacity()) {
+    return false;
+  }
+  const size_t keep = std::min(history->size(), kLZ4WindowSize);
+  memmove(&(*history)[0], history->data() + history->size() - keep, keep);
+  history->resize(keep);
+  history->reserve(std::max(kLZ4HistoryCapacity, keep + size));
+  return true;
+}
+
+class LZ4StreamingCompress : public StreamingCompress {
+ public:
+  LZ4StreamingCompress() : stream_(LZ4_createStream()) {
+    history_.reserve(kLZ4HistoryCapacity);
+  }
+
+  ~LZ4StreamingCompress() { LZ4_freeStream(stream_); }
+
+  virtual Status Compress(const Slice& record, std::string* output) override {
+    if (record.size() > static_cast<size_t>(LZ4_MAX_INPUT_SIZE)) {
+      return Status::Corruption("Record is too large to compress with LZ4");
+    }
+    PutVarint32(output, static_cast<uint32_t>(record.size()));
+    // LZ4 finds the matches in the previous records where they were
+    // compressed, hence the copy in a history buffer that outlives them
+    if (ReserveLZ4History(record.size(), &history_)) {
+      LZ4_loadDict(stream_, history_.data(), static_cast<int>(history_.size()));
+    }
+    const size_t src = history_.size();
+    history_.append(record.data(), record.size());
+
+    const int bound = LZ4_compressBound(static_cast<int>(record.size()));
+    const size_t pos = output->size();
+    output->resize(pos + bound);
+    int compressed_size = LZ4_compress_fast_continue(
+        stream_, history_.data() + src, &(*output)[pos],
+        static_cast<int>(record.size()), bound, 1 /* acceleration */);
+    if (compressed_size <= 0) {
+      return Status::Corruption("Failed to compress with LZ4");
+    }
+    output->resize(pos + compressed_size);
+    return Status::OK();
+  }
+
+ private:
+  LZ4_stream_t* stream_;
+  std::string history_;
+};
+
+class LZ4StreamingUncompress : public StreamingUncompress {
+ public:
+  LZ4StreamingUncompress() { history_.reserve(kLZ4HistoryCapacity); }
+
+  virtual Status Uncompress(const Slice& compressed,
+                            std::string* output) override {
+    Slice input = compressed;
+    uint32_t size;
+    if (!GetVarint32(&input, &size) ||
+        size > static_cast<uint32_t>(LZ4_MAX_INPUT_SIZE)) {
+      return Status::Corruption("Failed to uncompress with LZ4");
+    }
+    ReserveLZ4History(size, &history_);
+    const size_t dst = history_.size();
+    const size_t dict_size = std::min(dst, kLZ4WindowSize);
+    history_.resize(dst + size);
+    int uncompressed_size = LZ4_decompress_safe_usingDict(
+        input.data(), &history_[dst], static_cast<int>(input.size()),
+        static_cast<int>(size), history_.data() + dst - dict_size,
+        static_cast<int>(dict_size));
+    if (uncompressed_size != static_cast<int>(size)) {
+      history_.resize(dst);
+      return Status::Corruption("Failed to uncompress with LZ4");
+    }
+    output->assign(history_.data() + dst, size);
+    return Status::OK();
+  }
+
+ private:
+  std::string history_;
+};
+#endif  // ROCKSDB_LZ4_STREAMING
+
+#ifdef ROCKSDB_ZSTD_STREAMING
+class ZSTDStreamingCompress : public StreamingCompress {
+ public:
+  ZSTDStreamingCompress() : stream_(ZSTD_createCStream()) {
+    // The WAL is on the write path, hence the fastest level
+    ZSTD_initCStream(stream_, 1 /* compressionLevel */);
+  }
+
+  ~ZSTDStreamingCompress() { ZSTD_freeCStream(stream_); }
+
+  virtual Status Compress(const Slice& record, std::string* output) override {
+    PutVarint32(output, static_cast<uint32_t>(record.size()));
+    ZSTD_inBuffer input = {record.data(), record.size(), 0};
+    size_t remaining;
+    do {
+      const size_t pos = output->size();
+      const size_t avail = ZSTD_CStreamOutSize();
+      output->resize(pos + avail);
+      ZSTD_outBuffer out = {&(*output)[pos], avail, 0};
+      // Flushing ends the current block, so that the record can be
+      // uncompressed without the following ones
+      remaining = input.pos < input.size
+                      ? ZSTD_compressStream(stream_, &out, &input)
+                      : ZSTD_flushStream(stream_, &out);
+      output->resize(pos + out.pos);
+      if (ZSTD_isError(remaining)) {
+        return Status::Corruption("Failed to compress with ZSTD",
+                                  ZSTD_getErrorName(remaining));
+      }
+    } while (input.pos < input.size || remaining > 0);
+    return Status::OK();
+  }
+
+ private:
+  ZSTD_CStream* stream_;
+};
+
+class ZSTDStreamingUncompress : public StreamingUncompress {
+ public:
+  ZSTDStreamingUncompress() : stream_(ZSTD_createDStream()) {
+    ZSTD_initDStream(stream_);
+  }
+
+  ~ZSTDStreamingUncompress() { ZSTD_freeDStream(stream_); }
+
+  virtual Status Uncompress(const Slice& compressed,
+                            std::string* output) override {
+    Slice record = compressed;
+    uint32_t size;
+    if (!GetVarint32(&record, &size)) {
+      return Status::Corruption("Failed to uncompress with ZSTD");
+    }
+    // One more byte of room, so that a record larger than its size is
+    // detected
+    output->resize(size + 1);
+    ZSTD_inBuffer input = {record.data(), record.size(), 0};
+    ZSTD_outBuffer out = {&(*output)[0], size + 1, 0};
+    while (input.pos < input.size) {
+      const size_t input_pos = input.pos;
+      const size_t out_pos = out.pos;
+      size_t ret = ZSTD_decompressStream(stream_, &out, &input);
+      if (ZSTD_isError(ret)) {
+        return Status::Corruption("Failed to uncompress with ZSTD",
+                                  ZSTD_getErrorName(ret));
+      }
+      if (input.pos == input_pos && out.pos == out_pos) {
+        break;
+      }
+    }
+    if (input.pos != input.size || out.pos != size) {
+      return Status::Corruption("Failed to uncompress with ZSTD");
+    }
+    output->resize(size);
+    return Status::OK();
+  }
+
+ private:
+  ZSTD_DStream* stream_;
+};
+#endif  // ROCKSDB_ZSTD_STREAMING
+
+}  // namespace
+
+bool StreamingCompressionTypeSupported(CompressionType type) {
+  switch (type) {
+#ifdef ZLIB
+    case kZlibCompression:
+      return true;
+#endif
+#ifdef ROCKSDB_LZ4_STREAMING
+    case kLZ4Compression:
+      return true;
+#endif
+#ifdef ROCKSDB_ZSTD_STREAMING
+    case kZSTD:
+      return true;
+#endif
+    default:
+      return false;
+  }
+}
+
+StreamingCompress* StreamingCompress::Create(CompressionType type) {
+  switch (type) {
+#ifdef ZLIB
+    case kZlibCompression:
+      return new ZlibStreamingCompress();
+#endif
+#ifdef ROCKSDB_LZ4_STREAMING
+    case kLZ4Compression:
+      return new LZ4StreamingCompress();
+#endif
+#ifdef ROCKSDB_ZSTD_STREAMING
+    case kZSTD:
+      return new ZSTDStreamingCompress();
+#endif
+    default:
+      return nullptr;
+  }
+}
+
+StreamingUncompress* StreamingUncompress::Create(CompressionType type) {
+  switch (type) {
+#ifdef ZLIB
+    case kZlibCompression:
+      return new ZlibStreamingUncompress();
+#endif
+#ifdef ROCKSDB_LZ4_STREAMING
+    case kLZ4Compression:
+      return new LZ4StreamingUncompress();
+#endif
+#ifdef ROCKSDB_ZSTD_STREAMING
+    case kZSTD:
+      return new ZSTDStreamingUncompress();
+#endif
+    default:
+      return nullptr;
+  }
+}
+
+}  // namespace rocksdb
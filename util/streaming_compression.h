@@ -0,0 +1,55 @@
+//  Copyright (c) 2011-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+//
+// Streaming compression of a sequence of records, such as the records of a
+// WAL file. A single compression context is kept across the records, so that
+// a record is compressed with the data of the previous ones as history,
+// which compresses small records much better than on their own.
+
+#pragma once
+
+#include <string>
+
+#include "rocksdb/options.h"
+#include "rocksdb/slice.h"
+#include "rocksdb/status.h"
+
+namespace rocksdb {
+
+// Returns true if records can be compressed with type by StreamingCompress,
+// i.e. type is kZSTD, kLZ4Compression or kZlibCompression and the library
+// is linked in.
+extern bool StreamingCompressionTypeSupported(CompressionType type);
+
+// Compresses records one after the other. Each compressed record is flushed:
+// it can be uncompressed as soon as the previous ones were, by a
+// StreamingUncompress of the same type.
+class StreamingCompress {
+ public:
+  virtual ~StreamingCompress() {}
+
+  // Appends the compressed record to *output
+  virtual Status Compress(const Slice& record, std::string* output) = 0;
+
+  // Returns nullptr if type is not supported, see
+  // StreamingCompressionTypeSupported()
+  static StreamingCompress* Create(CompressionType type);
+};
+
+// Uncompresses the records of a StreamingCompress, in the same order
+class StreamingUncompress {
+ public:
+  virtual ~StreamingUncompress() {}
+
+  // Stores the uncompressed record in *output. Once a record fails to
+  // uncompress, the following ones can no longer be uncompressed either.
+  virtual Status Uncompress(const Slice& compressed, std::string* output) = 0;
+
+  // Returns nullptr if type is not supported, see
+  // StreamingCompressionTypeSupported()
+  static StreamingUncompress* Create(CompressionType type);
+};
+
+}  // namespace rocksdb